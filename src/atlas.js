@@ -0,0 +1,511 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+/** @namespace Atlas */
+
+const fs = require("fs");
+const path = require("path");
+const zlib = require("zlib");
+
+const utils = require("./utils");
+
+const PNG_SIGNATURE = Buffer.from([137, 80, 78, 71, 13, 10, 26, 10]);
+const TABLE_MAGIC = "CATL";
+const TABLE_VERSION = 1;
+
+const defaultAtlasConfig = {
+  pageSize: 2048,
+  padding: 1,
+};
+
+var crcTable = null;
+
+/**
+ * Computes the CRC32 of a buffer, as used by PNG chunks
+ * @param {Buffer} buffer
+ * @returns {number}
+ * @memberof Atlas
+ */
+function crc32(buffer) {
+  if (crcTable == null) {
+    crcTable = new Uint32Array(256);
+    for (let n = 0; n < 256; n++) {
+      let c = n;
+      for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+      crcTable[n] = c >>> 0;
+    }
+  }
+
+  let crc = 0xffffffff;
+  for (let i = 0; i < buffer.length; i++)
+    crc = crcTable[(crc ^ buffer[i]) & 0xff] ^ (crc >>> 8);
+  return (crc ^ 0xffffffff) >>> 0;
+}
+
+/**
+ * Hashes a sprite name with 32 bit FNV-1a. The runtime atlas uses the same
+ * hash to look up sprites.
+ * @param {string} name
+ * @returns {number}
+ * @memberof Atlas
+ */
+function hashName(name) {
+  let hash = 0x811c9dc5;
+  for (const byte of Buffer.from(name, "utf8")) {
+    hash ^= byte;
+    hash = Math.imul(hash, 0x01000193) >>> 0;
+  }
+  return hash >>> 0;
+}
+
+/**
+ * Decodes a non interlaced 8 bit PNG into RGBA pixels
+ * @param {Buffer} data the contents of the PNG file
+ * @returns {{width: number, height: number, pixels: Buffer}}
+ * @memberof Atlas
+ */
+function decodePNG(data) {
+  if (!data.subarray(0, 8).equals(PNG_SIGNATURE))
+    throw new Error("Not a PNG file");
+
+  let header = null;
+  let palette = null;
+  let transparency = null;
+  let idat = [];
+
+  for (let offset = 8; offset < data.length; ) {
+    let length = data.readUInt32BE(offset);
+    let type = data.toString("ascii", offset + 4, offset + 8);
+    let chunk = data.subarray(offset + 8, offset + 8 + length);
+    offset += 12 + length;
+
+    if (type == "IHDR")
+      header = {
+        width: chunk.readUInt32BE(0),
+        height: chunk.readUInt32BE(4),
+        bitDepth: chunk[8],
+        colorType: chunk[9],
+        interlace: chunk[12],
+      };
+    else if (type == "PLTE") palette = chunk;
+    else if (type == "tRNS") transparency = chunk;
+    else if (type == "IDAT") idat.push(chunk);
+    else if (type == "IEND") break;
+  }
+
+  if (header == null) throw new Error("PNG has no header");
+  if (header.bitDepth != 8 || header.interlace != 0)
+    throw new Error("Only 8 bit non interlaced PNGs are supported");
+
+  const channels = { 0: 1, 2: 3, 3: 1, 4: 2, 6: 4 }[header.colorType];
+  if (channels == null) throw new Error("Unknown PNG color type");
+
+  const { width, height } = header;
+  const stride = width * channels;
+  const raw = zlib.inflateSync(Buffer.concat(idat));
+  const rows = Buffer.alloc(stride * height);
+
+  // Undo the filter of every scanline
+  for (let y = 0; y < height; y++) {
+    const filter = raw[y * (stride + 1)];
+    const line = raw.subarray(y * (stride + 1) + 1, (y + 1) * (stride + 1));
+    const out = rows.subarray(y * stride, (y + 1) * stride);
+    const previous = y > 0 ? rows.subarray((y - 1) * stride, y * stride) : null;
+
+    for (let x = 0; x < stride; x++) {
+      const a = x >= channels ? out[x - channels] : 0;
+      const b = previous != null ? previous[x] : 0;
+      const c = previous != null && x >= channels ? previous[x - channels] : 0;
+
+      let value = line[x];
+      if (filter == 1) value += a;
+      else if (filter == 2) value += b;
+      else if (filter == 3) value += (a + b) >> 1;
+      else if (filter == 4) {
+        const p = a + b - c;
+        const pa = Math.abs(p - a);
+        const pb = Math.abs(p - b);
+        const pc = Math.abs(p - c);
+        value += pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+      }
+      out[x] = value & 0xff;
+    }
+  }
+
+  const pixels = Buffer.alloc(width * height * 4);
+  for (let i = 0; i < width * height; i++) {
+    const source = rows.subarray(i * channels, (i + 1) * channels);
+    let rgba;
+    switch (header.colorType) {
+      case 0:
+        rgba = [source[0], source[0], source[0], 255];
+        break;
+      case 2:
+        rgba = [source[0], source[1], source[2], 255];
+        break;
+      case 3:
+        rgba = [
+          palette[source[0] * 3],
+          palette[source[0] * 3 + 1],
+          palette[source[0] * 3 + 2],
+          transparency != null && source[0] < transparency.length
+            ? transparency[source[0]]
+            : 255,
+        ];
+        break;
+      case 4:
+        rgba = [source[0], source[0], source[0], source[1]];
+        break;
+      default:
+        rgba = source;
+    }
+    pixels.set(rgba, i * 4);
+  }
+
+  return { width, height, pixels };
+}
+
+/**
+ * Encodes RGBA pixels into a PNG file
+ * @param {number} width
+ * @param {number} height
+ * @param {Buffer} pixels the RGBA pixels, row by row
+ * @returns {Buffer}
+ * @memberof Atlas
+ */
+function encodePNG(width, height, pixels) {
+  const chunk = (type, body) => {
+    const length = Buffer.alloc(4);
+    length.writeUInt32BE(body.length);
+    const typed = Buffer.concat([Buffer.from(type, "ascii"), body]);
+    const crc = Buffer.alloc(4);
+    crc.writeUInt32BE(crc32(typed));
+    return Buffer.concat([length, typed, crc]);
+  };
+
+  const header = Buffer.alloc(13);
+  header.writeUInt32BE(width, 0);
+  header.writeUInt32BE(height, 4);
+  header[8] = 8; // bit depth
+  header[9] = 6; // RGBA
+
+  // Every scanline uses the "none" filter
+  const raw = Buffer.alloc((width * 4 + 1) * height);
+  for (let y = 0; y < height; y++)
+    pixels.copy(raw, y * (width * 4 + 1) + 1, y * width * 4,
+      (y + 1) * width * 4);
+
+  return Buffer.concat([
+    PNG_SIGNATURE,
+    chunk("IHDR", header),
+    chunk("IDAT", zlib.deflateSync(raw)),
+    chunk("IEND", Buffer.alloc(0)),
+  ]);
+}
+
+/**
+ * @brief Packs rectangles into a fixed size page using the MaxRects
+ * algorithm with the best short side fit heuristic.
+ *
+ * @memberof Atlas
+ */
+class MaxRectsPacker {
+  /**
+   * Default Constructor
+   * @param {number} width the width of the page
+   * @param {number} height the height of the page
+   */
+  constructor(width, height) {
+    this.width = width;
+    this.height = height;
+    this.free = [{ x: 0, y: 0, width: width, height: height }];
+  }
+
+  /**
+   * Places a rectangle in the page
+   * @param {number} width
+   * @param {number} height
+   * @returns {{x: number, y: number} | null} the position of the rectangle,
+   * or null if it does not fit
+   */
+  insert(width, height) {
+    let best = null;
+    let bestShort = Infinity;
+    let bestLong = Infinity;
+
+    for (const rect of this.free) {
+      if (rect.width < width || rect.height < height) continue;
+
+      const leftoverX = rect.width - width;
+      const leftoverY = rect.height - height;
+      const short = Math.min(leftoverX, leftoverY);
+      const long = Math.max(leftoverX, leftoverY);
+
+      if (short < bestShort || (short == bestShort && long < bestLong)) {
+        best = { x: rect.x, y: rect.y, width: width, height: height };
+        bestShort = short;
+        bestLong = long;
+      }
+    }
+
+    if (best == null) return null;
+
+    // Split every free rectangle that overlaps the placed one
+    let split = [];
+    for (const rect of this.free) {
+      if (
+        best.x >= rect.x + rect.width ||
+        best.x + best.width <= rect.x ||
+        best.y >= rect.y + rect.height ||
+        best.y + best.height <= rect.y
+      ) {
+        split.push(rect);
+        continue;
+      }
+
+      if (best.x > rect.x)
+        split.push({ x: rect.x, y: rect.y, width: best.x - rect.x,
+          height: rect.height });
+      if (best.x + best.width < rect.x + rect.width)
+        split.push({ x: best.x + best.width, y: rect.y,
+          width: rect.x + rect.width - best.x - best.width,
+          height: rect.height });
+      if (best.y > rect.y)
+        split.push({ x: rect.x, y: rect.y, width: rect.width,
+          height: best.y - rect.y });
+      if (best.y + best.height < rect.y + rect.height)
+        split.push({ x: rect.x, y: best.y + best.height, width: rect.width,
+          height: rect.y + rect.height - best.y - best.height });
+    }
+
+    // Drop the free rectangles contained in another one
+    this.free = split.filter((rect, i) =>
+      !split.some((other, j) =>
+        i != j &&
+        rect.x >= other.x &&
+        rect.y >= other.y &&
+        rect.x + rect.width <= other.x + other.width &&
+        rect.y + rect.height <= other.y + other.height &&
+        // Keep one of two identical rectangles
+        (j < i || rect.x != other.x || rect.y != other.y ||
+          rect.width != other.width || rect.height != other.height),
+      ),
+    );
+
+    return { x: best.x, y: best.y };
+  }
+}
+
+/**
+ * Packs sprites into as few pages as possible. The biggest sprites are
+ * placed first.
+ * @param {Array<{name: string, width: number, height: number}>} sprites
+ * @param {number} pageSize the width and height of every page
+ * @param {number} padding the empty pixels kept around every sprite
+ * @returns {Array<{name: string, page: number, x: number, y: number}>}
+ * @memberof Atlas
+ */
+function packSprites(sprites, pageSize, padding = 0) {
+  const sorted = [...sprites].sort(
+    (a, b) =>
+      Math.max(b.width, b.height) - Math.max(a.width, a.height) ||
+      b.width * b.height - a.width * a.height ||
+      (a.name < b.name ? -1 : 1),
+  );
+
+  let pages = [];
+  let placements = [];
+
+  for (const sprite of sorted) {
+    const width = sprite.width + padding * 2;
+    const height = sprite.height + padding * 2;
+    if (width > pageSize || height > pageSize)
+      throw new Error(`${sprite.name} does not fit in a ${pageSize} page`);
+
+    let position = null;
+    let page = 0;
+    for (; page < pages.length && position == null; page++)
+      position = pages[page].insert(width, height);
+
+    if (position == null) {
+      pages.push(new MaxRectsPacker(pageSize, pageSize));
+      page = pages.length;
+      position = pages[page - 1].insert(width, height);
+    }
+
+    placements.push({
+      ...sprite,
+      page: page - 1,
+      x: position.x + padding,
+      y: position.y + padding,
+    });
+  }
+
+  return placements;
+}
+
+/**
+ * Writes the binary UV table read by `Engine::Graphics::TextureAtlas`. All
+ * values are little endian:
+ * - `"CATL"`, the version, the page count and the sprite count (4 bytes each)
+ * - the width and height of every page (4 bytes each)
+ * - for every sprite, sorted by hash: the FNV-1a hash of its name, its page,
+ *   and its UV rectangle `u0 v0 u1 v1` as floats (4 bytes each)
+ * @param {Array<{width: number, height: number}>} pages
+ * @param {Array<{name: string, page: number, x: number, y: number,
+ * width: number, height: number}>} placements
+ * @returns {Buffer}
+ * @memberof Atlas
+ */
+function writeTable(pages, placements) {
+  const entries = placements
+    .map((sprite) => ({ hash: hashName(sprite.name), ...sprite }))
+    .sort((a, b) => a.hash - b.hash);
+
+  for (let i = 1; i < entries.length; i++)
+    if (entries[i].hash == entries[i - 1].hash)
+      throw new Error(
+        `${entries[i].name} and ${entries[i - 1].name} have the same hash`,
+      );
+
+  const table = Buffer.alloc(16 + pages.length * 8 + entries.length * 24);
+  table.write(TABLE_MAGIC, 0, "ascii");
+  table.writeUInt32LE(TABLE_VERSION, 4);
+  table.writeUInt32LE(pages.length, 8);
+  table.writeUInt32LE(entries.length, 12);
+
+  let offset = 16;
+  for (const page of pages) {
+    table.writeUInt32LE(page.width, offset);
+    table.writeUInt32LE(page.height, offset + 4);
+    offset += 8;
+  }
+
+  for (const entry of entries) {
+    const page = pages[entry.page];
+    table.writeUInt32LE(entry.hash, offset);
+    table.writeUInt32LE(entry.page, offset + 4);
+    table.writeFloatLE(entry.x / page.width, offset + 8);
+    table.writeFloatLE(entry.y / page.height, offset + 12);
+    table.writeFloatLE((entry.x + entry.width) / page.width, offset + 16);
+    table.writeFloatLE((entry.y + entry.height) / page.height, offset + 20);
+    offset += 24;
+  }
+
+  return table;
+}
+
+/**
+ * Reads a table written by `writeTable`
+ * @param {Buffer} table
+ * @returns {{pages: Array, entries: Map<number, Object>}}
+ * @memberof Atlas
+ */
+function readTable(table) {
+  if (table.toString("ascii", 0, 4) != TABLE_MAGIC)
+    throw new Error("Not an atlas table");
+  if (table.readUInt32LE(4) != TABLE_VERSION)
+    throw new Error("Unsupported atlas table version");
+
+  const pageCount = table.readUInt32LE(8);
+  const entryCount = table.readUInt32LE(12);
+
+  let offset = 16;
+  let pages = [];
+  for (let i = 0; i < pageCount; i++, offset += 8)
+    pages.push({
+      width: table.readUInt32LE(offset),
+      height: table.readUInt32LE(offset + 4),
+    });
+
+  let entries = new Map();
+  for (let i = 0; i < entryCount; i++, offset += 24)
+    entries.set(table.readUInt32LE(offset), {
+      page: table.readUInt32LE(offset + 4),
+      uv: [
+        table.readFloatLE(offset + 8),
+        table.readFloatLE(offset + 12),
+        table.readFloatLE(offset + 16),
+        table.readFloatLE(offset + 20),
+      ],
+    });
+
+  return { pages, entries };
+}
+
+/**
+ * Packs every PNG in a folder into atlas pages. The name of each sprite is
+ * its path relative to the folder without the extension, using `/` as the
+ * separator (`player/idle_0` for `player/idle_0.png`).
+ *
+ * The pages are written as `<output>_<page>.png` and the UV table as
+ * `<output>.catl`.
+ *
+ * @param {string} input the folder of sprites
+ * @param {string} output the path of the atlas without extension
+ * @param {Object} config - The configuration object; see defaultAtlasConfig
+ * @returns {{pages: number, sprites: number}}
+ * @memberof Atlas
+ */
+function packAtlas(input, output, config = defaultAtlasConfig) {
+  config = { ...defaultAtlasConfig, ...config };
+
+  let sprites = [];
+  utils.processFiles(input, ".png", (file, folder) => {
+    const image = decodePNG(fs.readFileSync(path.join(folder, file + ".png")));
+    const name = path
+      .relative(input, path.join(folder, file))
+      .split(path.sep)
+      .join("/");
+    sprites.push({ name, ...image });
+  });
+
+  const placements = packSprites(sprites, config.pageSize, config.padding);
+  const pageCount = placements.reduce((n, p) => Math.max(n, p.page + 1), 0);
+
+  // Every page has the same size so they can be loaded as a texture array
+  let pages = [];
+  for (let i = 0; i < pageCount; i++)
+    pages.push({
+      width: config.pageSize,
+      height: config.pageSize,
+      pixels: Buffer.alloc(config.pageSize * config.pageSize * 4),
+    });
+
+  for (const sprite of placements) {
+    const page = pages[sprite.page];
+    for (let y = 0; y < sprite.height; y++)
+      sprite.pixels.copy(
+        page.pixels,
+        ((sprite.y + y) * page.width + sprite.x) * 4,
+        y * sprite.width * 4,
+        (y + 1) * sprite.width * 4,
+      );
+  }
+
+  fs.mkdirSync(path.dirname(output), { recursive: true });
+  pages.forEach((page, i) =>
+    fs.writeFileSync(
+      `${output}_${i}.png`,
+      encodePNG(page.width, page.height, page.pixels),
+    ),
+  );
+  fs.writeFileSync(`${output}.catl`, writeTable(pages, placements));
+
+  return { pages: pageCount, sprites: sprites.length };
+}
+
+module.exports = {
+  crc32: crc32,
+  hashName: hashName,
+  decodePNG: decodePNG,
+  encodePNG: encodePNG,
+  MaxRectsPacker: MaxRectsPacker,
+  packSprites: packSprites,
+  writeTable: writeTable,
+  readTable: readTable,
+  packAtlas: packAtlas,
+};
@@ -12,6 +12,7 @@ const path = require("path");
 const os = require("os");
 
 const utils = require("./utils");
+const atlas = require("./atlas");
 const CPPObject = require("./classes/CPPObject");
 
 var buildConfig;
@@ -35,11 +36,20 @@ const EMAR =
 const srcLocation = buildConfig.inputPath || process.cwd() + "/src";
 const outputLocation = buildConfig.outputPath || process.cwd() + "/objs";
 
+// Threaded games link a framework built with threads, since the objects of
+// both must agree on shared memory and on the layout of the engine classes
 const FrameworkLibrary =
   buildConfig.frameworkPath != null
     ? buildConfig.frameworkPath
     : "./node_modules/@mesaguilde/carpenter-engine/build/carpenterengine.a";
 
+const ThreadedFrameworkLibrary =
+  buildConfig.threadedFrameworkPath != null
+    ? buildConfig.threadedFrameworkPath
+    : buildConfig.frameworkPath == ""
+      ? ""
+      : "./node_modules/@mesaguilde/carpenter-engine/build/carpenterengine-threaded.a";
+
 const includeDir =
   buildConfig.includeDir != null
     ? buildConfig.includeDir
@@ -51,22 +61,48 @@ const staticDir =
     : "node_modules/@mesaguilde/carpenter-engine/src/static/";
 
 const defaultBuildSteps = {
+  runAtlas: true,
   runBuild: true,
   runLink: true,
   runPackage: false,
   mainFile: "",
   debug: false,
+  threading: false,
   libMode: false,
 };
 
+/**
+ * Packs every atlas listed under `atlases` in tableconf.json. Each entry
+ * takes an `input` folder of sprites, an `output` path without extension,
+ * and optionally a `pageSize` and a `padding`.
+ *
+ * @memberof Build
+ */
+function packAtlases() {
+  for (const entry of buildConfig.atlases || []) {
+    try {
+      const result = atlas.packAtlas(entry.input, entry.output, entry);
+      console.log(
+        `${utils.Asciis.Success} Packed ${result.sprites} sprites from ${entry.input} into ${result.pages} page(s)`,
+      );
+    } catch (exception) {
+      utils.throwError(`Failed to pack ${entry.input}: ${exception.message}`);
+      return process.exit(1);
+    }
+  }
+}
+
 /**
  * Goes through the whole build process of the game and its engine:
- * 1. Starts with building each C++ file in the src folder through the `-c` flag
- * 2. Then links all the object files together through the `-l` flag
- * 3. Finally packages the game into a static webpage through the `-p` flag
+ * 1. Packs the sprite folders listed in tableconf.json into atlases through
+ * the `-a` flag
+ * 2. Starts with building each C++ file in the src folder through the `-c` flag
+ * 3. Then links all the object files together through the `-l` flag
+ * 4. Finally packages the game into a static webpage through the `-p` flag
  *
  * If you wish to include a custom main file for testing, you can use the `-m`
- * flag with the path to the file.
+ * flag with the path to the file. Threads are enabled by the `-t` flag, or by
+ * `"threading": true` in tableconf.json.
  *
  * @param {Object} config - The configuration object; see defaultBuildSteps
  * @returns {process} The exit code
@@ -74,10 +110,16 @@ const defaultBuildSteps = {
  * @author Roberto Selles
  */
 function buildGame(config = defaultBuildSteps) {
-  // Build process
+  // Asset process
+  if (config.runAtlas) packAtlases();
+
+  const threading = config.threading == true || buildConfig.threading == true;
+  let threadingFlags = threading ? "-pthread -DENGINE_THREADING" : "";
+
+  // Build process, objects built with other flags are built again
   if (config.runBuild)
     utils.processFiles(srcLocation, ".cpp", (file, folder) => {
-      new CPPObject(`${folder}/${file}.cpp}`).build();
+      new CPPObject(`${folder}/${file}.cpp}`).build(`-msimd128 ${threadingFlags}`.trim());
     });
 
   // Link process
@@ -88,11 +130,16 @@ function buildGame(config = defaultBuildSteps) {
     });
 
     let debugMethods = config.debug == true ? "-g -gsource-map" : "";
+    let threadingMethods = threading
+      ? `${threadingFlags} -sPTHREAD_POOL_SIZE=navigator.hardwareConcurrency`
+      : "";
+
+    let framework = threading ? ThreadedFrameworkLibrary : FrameworkLibrary;
 
-    let exec = `${EMCC} ${filesList} ${config.mainFile != "" && config.mainFile != null ? config.mainFile + " -I" + includeDir : ""} ${FrameworkLibrary} -o ./build/engine.js -std=c++20 -sEXPORTED_FUNCTIONS=_Engine_CallUpdate,_Engine_CallDraw -sEXPORTED_RUNTIME_METHODS=ccall,cwrap --bind -sALLOW_MEMORY_GROWTH -sMAX_WEBGL_VERSION=2 -sASYNCIFY -sASYNCIFY_STACK_SIZE=4096 ${debugMethods}`;
+    let exec = `${EMCC} ${filesList} ${config.mainFile != "" && config.mainFile != null ? config.mainFile + " -I" + includeDir : ""} ${framework} -o ./build/engine.js -std=c++20 -sEXPORTED_FUNCTIONS=_Engine_CallUpdate,_Engine_CallDraw -sEXPORTED_RUNTIME_METHODS=ccall,cwrap --bind -sALLOW_MEMORY_GROWTH -sMAX_WEBGL_VERSION=2 -sASYNCIFY -sASYNCIFY_STACK_SIZE=4096 ${debugMethods} ${threadingMethods}`;
 
     if (config.libMode == true)
-      exec = `${EMAR} rcs ./build/carpenterengine.a ${filesList}`;
+      exec = `${EMAR} rcs ./build/carpenterengine${threading ? "-threaded" : ""}.a ${filesList}`;
 
     utils.execCommand(exec, "Linking Game");
   }
@@ -108,4 +155,5 @@ function buildGame(config = defaultBuildSteps) {
 
 module.exports = {
   buildGame: buildGame,
+  packAtlases: packAtlases,
 };
@@ -50,6 +50,7 @@ class CPPObject {
 
     this.lastModification = null;
     this.lastBuild = null;
+    this.lastFlags = null;
 
     // Will assume that this does not create an error since this file should exist.
 
@@ -65,25 +66,42 @@ class CPPObject {
     } catch (e) {
       this.lastBuild = null;
     }
+
+    // The flags of the last build are stamped next to the object file
+    try {
+      this.lastFlags = fs.readFileSync(
+        `${outputLocation}/${this.name}.flags`,
+        "utf8",
+      );
+    } catch (e) {
+      this.lastFlags = null;
+    }
   }
 
   /**
    * A method that returns if this file needs to be built
+   * @param {string} [flags] The flags the file would be built with. Objects
+   * built with other flags (e.g. without threads) are built again, since the
+   * flags can change the layout of the engine classes
    * @returns {boolean}
    */
-  needsBuild() {
+  needsBuild(flags) {
     if (!fs.existsSync(`${this.path}/${this.name}.cpp`)) return false;
+    if (flags != null && flags != this.lastFlags) return true;
     return this.lastBuild == null || this.lastModification > this.lastBuild;
   }
 
   /**
-   * Builds the file if it has not been built since it's last modification
+   * Builds the file if it has not been built since it's last modification,
+   * or if it was built with other flags
+   * @param {string} flags Extra flags given to the compiler
    */
-  build() {
-    if (!this.needsBuild()) return;
+  build(flags = "") {
+    if (!this.needsBuild(flags)) return;
 
-    let execCmd = `${EMCC} -c "${this.path}/${this.name}.cpp" -o "${outputLocation}/${this.name}.o" -std=c++20 -I${includeDir} -Iinclude/`;
+    let execCmd = `${EMCC} -c "${this.path}/${this.name}.cpp" -o "${outputLocation}/${this.name}.o" -std=c++20 -I${includeDir} -Iinclude/ ${flags}`;
     utils.execCommand(execCmd, `Compiling ${this.name}.cpp`);
+    fs.writeFileSync(`${outputLocation}/${this.name}.flags`, flags);
   }
 
   /**
@@ -7,6 +7,10 @@
 #include "Sound.hpp"
 #include <emscripten.h>
 
+#ifdef ENGINE_THREADING
+#include <thread>
+#endif
+
 Engine::Audio::Sound::Sound(const char* filename) : Engine::Audio::Audio::Audio(filename) {
   EM_ASM({
     game.sounds[UTF8ToString($0)].makeSound();
@@ -32,7 +36,7 @@ void Engine::Audio::Sound::Play() {
 
 void Engine::Audio::Sound::Play(Vec3f position) {
   // Threads are funny in Emscripten. Add the parameter in the build system when we are ready to use it
-  #ifdef ENGNINE_THREADING
+  #ifdef ENGINE_THREADING
   std::thread t(&Engine::Audio::Sound::m_playThreadMethod, this, position);
   t.detach();
   #else
@@ -0,0 +1,56 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "EntityObject.hpp"
+
+Engine::ECS::EntityObject::EntityObject(std::string name, World& world)
+  : GameObject(name) {
+  m_world = &world;
+  m_entity = world.Create(GetLocalTransform(), NodeLink{GetHandle()});
+
+  // The entity takes its object along when it is destroyed. The hook is
+  // the same for every object, so it is set once per world
+  if (!world.HasRemoveHook<NodeLink>())
+    world.SetRemoveHook<NodeLink>([](Entity entity, NodeLink& link) {
+      if (Node* node = link.node.Get())
+        node->Destroy();
+    });
+}
+
+Engine::ECS::EntityObject::~EntityObject() {
+  if (NodeLink* link = m_world->Get<NodeLink>(m_entity))
+    link->node = INVALID_NODE;
+
+  m_world->Destroy(m_entity);
+}
+
+Engine::ECS::Entity Engine::ECS::EntityObject::GetEntity() {
+  return m_entity;
+}
+
+Engine::ECS::World& Engine::ECS::EntityObject::GetWorld() {
+  return *m_world;
+}
+
+void Engine::ECS::SyncTransforms(World& world) {
+  world.EachChunk<Transform, NodeLink>([](size_t count,
+    const Entity* entities, Transform* transforms, NodeLink* links) {
+    for (size_t i = 0; i < count; i++) {
+      Node* node = links[i].node.Get();
+      if (node == nullptr)
+        continue;
+
+      // Writing marks the transform dirty, so objects that did not move are
+      // left alone and keep their world matrix
+      GameObject* object = static_cast<GameObject*>(node);
+      Transform local = object->GetLocalTransform();
+      if (!(local.Position == transforms[i].Position
+        && local.Scale == transforms[i].Scale
+        && local.Rotation == transforms[i].Rotation))
+        object->SetLocalTransform(transforms[i]);
+    }
+  });
+}
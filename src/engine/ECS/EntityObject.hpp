@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_ECS_ENTITYOBJECT
+#define ENGINE_ECS_ENTITYOBJECT
+
+#include "World.hpp"
+#include "../GameObject.hpp"
+#include "../NodePool.hpp"
+
+namespace Engine::ECS {
+
+  /**
+   * @brief The component of an entity that backs a node
+   */
+  struct NodeLink {
+    NodeHandle node;
+  };
+
+  /**
+   * @brief A game object backed by an entity
+   *
+   * The entity holds the local transform of the object as an
+   * `Engine::Transform` component, so systems can move the object along with
+   * plain entities. The object follows its component each time
+   * `SyncTransforms` runs, which `WorldNode` does after the systems, so move
+   * the object through its component rather than `SetPosition` and friends.
+   *
+   * Destroying the entity destroys the object at the end of the frame, and
+   * deleting the object destroys its entity. The world must outlive the
+   * object.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class Unit : public Engine::ECS::EntityObject {
+   *   public:
+   *   Unit(Engine::ECS::World& world) : EntityObject("Unit", world) {
+   *     world.Add(GetEntity(), Velocity{1, 0, 0});
+   *   }
+   *
+   *   void Draw() override { ... }
+   * };
+   * ```
+   */
+  class EntityObject : public GameObject {
+    private:
+    World* m_world;
+    Entity m_entity;
+
+    public:
+
+    /**
+     * @brief Creates the object and its entity, with the transform of the
+     * object
+     */
+    EntityObject(std::string name, World& world);
+
+    /**
+     * @brief Destroys the entity of the object
+     */
+    ~EntityObject();
+
+    /**
+     * @brief Returns the entity backing the object
+     */
+    Entity GetEntity();
+
+    /**
+     * @brief Returns the world of the entity
+     */
+    World& GetWorld();
+  };
+
+  /**
+   * @brief Copies the transform component of every entity backing a game
+   * object into the object
+   *
+   * Only the transforms that differ from the object are copied, so objects
+   * that did not move are not recomputed by the transform pool.
+   */
+  extern void SyncTransforms(World& world);
+}
+
+#endif
@@ -0,0 +1,362 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "World.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+  std::vector<Engine::ECS::ComponentInfo>& GetComponentInfos() {
+    static std::vector<Engine::ECS::ComponentInfo> infos;
+    return infos;
+  }
+}
+
+Engine::ECS::ComponentId Engine::ECS::RegisterComponent(size_t size,
+  size_t alignment) {
+  std::vector<ComponentInfo>& infos = GetComponentInfos();
+  if (infos.size() == MAX_COMPONENTS) {
+    std::cerr << "ERROR: Too many component types, the maximum is "
+      << MAX_COMPONENTS << std::endl;
+    std::abort();
+  }
+
+  infos.push_back({size, alignment});
+  return infos.size() - 1;
+}
+
+const Engine::ECS::ComponentInfo& Engine::ECS::GetComponentInfo(
+  ComponentId id) {
+  return GetComponentInfos()[id];
+}
+
+Engine::ECS::Archetype::Archetype(const std::vector<ComponentId>& components) {
+  this->components = components;
+  columns.fill(-1);
+
+  size_t rowSize = sizeof(Entity);
+  size_t padding = 0;
+  for (size_t i = 0; i < components.size(); i++) {
+    const ComponentInfo& info = GetComponentInfo(components[i]);
+    signature.set(components[i]);
+    columns[components[i]] = i;
+    sizes.push_back(info.size);
+    rowSize += info.size;
+    padding += info.alignment;
+  }
+
+  chunkCapacity = std::max<size_t>(1, (CHUNK_SIZE - padding) / rowSize);
+
+  // The entities come first, then each column at its alignment
+  size_t offset = chunkCapacity * sizeof(Entity);
+  for (size_t i = 0; i < components.size(); i++) {
+    size_t alignment = GetComponentInfo(components[i]).alignment;
+    offset = (offset + alignment - 1) / alignment * alignment;
+    offsets.push_back(offset);
+    offset += chunkCapacity * sizes[i];
+  }
+  chunkBytes = offset;
+}
+
+uint32_t Engine::ECS::Archetype::Push(Entity entity) {
+  if (count == chunks.size() * chunkCapacity)
+    chunks.emplace_back(new unsigned char[chunkBytes]);
+
+  size_t row = count++;
+  GetEntities(row / chunkCapacity)[row % chunkCapacity] = entity;
+  return row;
+}
+
+Engine::ECS::Entity Engine::ECS::Archetype::SwapRemove(uint32_t row) {
+  size_t last = --count;
+  Entity moved = INVALID_ENTITY;
+
+  if (row != last) {
+    moved = GetEntities(last / chunkCapacity)[last % chunkCapacity];
+    GetEntities(row / chunkCapacity)[row % chunkCapacity] = moved;
+    for (size_t i = 0; i < components.size(); i++)
+      std::memcpy(Get(row, i), Get(last, i), sizes[i]);
+  }
+
+  // One empty chunk is kept, so an entity going back and forth at the end of
+  // a chunk does not allocate each time
+  size_t used = (count + chunkCapacity - 1) / chunkCapacity;
+  while (chunks.size() > used + 1)
+    chunks.pop_back();
+
+  return moved;
+}
+
+Engine::ECS::Archetype* Engine::ECS::World::GetArchetype(
+  std::vector<ComponentId> components) {
+  if (components.empty())
+    return nullptr;
+
+  std::sort(components.begin(), components.end());
+
+  Signature signature;
+  for (ComponentId component : components)
+    signature.set(component);
+
+  auto archetype = m_archetypeIndex.find(signature);
+  if (archetype != m_archetypeIndex.end())
+    return archetype->second;
+
+  m_archetypes.push_back(std::make_unique<Archetype>(components));
+  m_archetypeIndex[signature] = m_archetypes.back().get();
+  return m_archetypes.back().get();
+}
+
+Engine::ECS::Archetype* Engine::ECS::World::GetEdge(Archetype* archetype,
+  ComponentId component) {
+  if (archetype == nullptr)
+    return GetArchetype({component});
+
+  auto edge = archetype->edges.find(component);
+  if (edge != archetype->edges.end())
+    return edge->second;
+
+  std::vector<ComponentId> components = archetype->components;
+  auto position = std::find(components.begin(), components.end(), component);
+  if (position == components.end())
+    components.push_back(component);
+  else
+    components.erase(position);
+
+  // The archetypes are never freed, so the edges stay valid
+  Archetype* target = GetArchetype(components);
+  archetype->edges[component] = target;
+  return target;
+}
+
+void Engine::ECS::World::Move(Entity entity, Archetype* target) {
+  Record& record = m_records[entity.index];
+  Archetype* source = record.archetype;
+  uint32_t row = target != nullptr ? target->Push(entity) : 0;
+
+  if (source != nullptr) {
+    if (target != nullptr) {
+      for (size_t i = 0; i < target->components.size(); i++) {
+        int column = source->FindColumn(target->components[i]);
+        if (column >= 0)
+          std::memcpy(target->Get(row, i), source->Get(record.row, column),
+            target->sizes[i]);
+      }
+    }
+
+    RemoveRow(source, record.row);
+  }
+
+  record.archetype = target;
+  record.row = row;
+}
+
+void Engine::ECS::World::RemoveRow(Archetype* archetype, uint32_t row) {
+  Entity moved = archetype->SwapRemove(row);
+  if (moved != INVALID_ENTITY)
+    m_records[moved.index].row = row;
+}
+
+void Engine::ECS::World::RunRemoveHooks(Entity entity, Archetype* archetype) {
+  // Changes made by the hooks wait until the entity is gone
+  m_iterating++;
+  for (size_t i = 0; i < archetype->components.size(); i++) {
+    auto& hook = m_removeHooks[archetype->components[i]];
+    if (hook)
+      hook(entity, archetype->Get(m_records[entity.index].row, i));
+  }
+  m_iterating--;
+}
+
+void Engine::ECS::World::Defer(CommandType type, Entity entity,
+  ComponentId component, const void* data) {
+  size_t offset = m_commandData.size();
+  if (type == ADD) {
+    size_t size = GetComponentInfo(component).size;
+    m_commandData.resize(offset + size);
+    std::memcpy(m_commandData.data() + offset, data, size);
+  }
+
+  m_commands.push_back({type, entity, component, offset});
+}
+
+void Engine::ECS::World::Flush() {
+  if (m_flushing)
+    return;
+
+  m_flushing = true;
+
+  // Hooks can queue more commands, which are applied in the same pass
+  for (size_t i = 0; i < m_commands.size(); i++) {
+    Command command = m_commands[i];
+    switch (command.type) {
+      case ADD:
+        // Adding never queues commands here, so the data stays in place
+        AddComponent(command.entity, command.component,
+          m_commandData.data() + command.data);
+        break;
+      case REMOVE:
+        RemoveComponent(command.entity, command.component);
+        break;
+      case DESTROY:
+        Destroy(command.entity);
+        break;
+    }
+  }
+
+  m_commands.clear();
+  m_commandData.clear();
+  m_flushing = false;
+}
+
+Engine::ECS::Entity Engine::ECS::World::Create() {
+  uint32_t index;
+  if (!m_freeEntities.empty()) {
+    index = m_freeEntities.back();
+    m_freeEntities.pop_back();
+  } else {
+    index = m_records.size();
+    m_records.push_back({nullptr, 0, 0});
+  }
+
+  // Entities without components are not stored in any archetype
+  m_records[index].archetype = nullptr;
+  m_entityCount++;
+  return {index, m_records[index].generation};
+}
+
+void Engine::ECS::World::Destroy(Entity entity) {
+  if (!IsAlive(entity))
+    return;
+
+  if (m_iterating > 0) {
+    Defer(DESTROY, entity, 0, nullptr);
+    return;
+  }
+
+  if (m_records[entity.index].archetype != nullptr)
+    RunRemoveHooks(entity, m_records[entity.index].archetype);
+
+  // The hooks may have created entities, which moves the records
+  Record& record = m_records[entity.index];
+  if (record.archetype != nullptr)
+    RemoveRow(record.archetype, record.row);
+
+  record.archetype = nullptr;
+  record.generation++;
+  m_freeEntities.push_back(entity.index);
+  m_entityCount--;
+
+  if (!m_commands.empty())
+    Flush();
+}
+
+bool Engine::ECS::World::IsAlive(Entity entity) const {
+  return entity.index < m_records.size()
+    && m_records[entity.index].generation == entity.generation;
+}
+
+void Engine::ECS::World::AddComponent(Entity entity, ComponentId component,
+  const void* data) {
+  if (!IsAlive(entity))
+    return;
+
+  if (m_iterating > 0) {
+    Defer(ADD, entity, component, data);
+    return;
+  }
+
+  Record& record = m_records[entity.index];
+  if (record.archetype == nullptr
+    || record.archetype->FindColumn(component) < 0)
+    Move(entity, GetEdge(record.archetype, component));
+
+  int column = record.archetype->FindColumn(component);
+  std::memcpy(record.archetype->Get(record.row, column), data,
+    record.archetype->sizes[column]);
+}
+
+void Engine::ECS::World::RemoveComponent(Entity entity,
+  ComponentId component) {
+  if (!IsAlive(entity))
+    return;
+
+  if (m_iterating > 0) {
+    Defer(REMOVE, entity, component, nullptr);
+    return;
+  }
+
+  Record& record = m_records[entity.index];
+  if (record.archetype == nullptr)
+    return;
+
+  int column = record.archetype->FindColumn(component);
+  if (column < 0)
+    return;
+
+  if (m_removeHooks[component]) {
+    m_iterating++;
+    m_removeHooks[component](entity,
+      record.archetype->Get(record.row, column));
+    m_iterating--;
+  }
+
+  Move(entity, GetEdge(m_records[entity.index].archetype, component));
+
+  if (!m_commands.empty())
+    Flush();
+}
+
+void* Engine::ECS::World::GetComponent(Entity entity, ComponentId component) {
+  if (!IsAlive(entity))
+    return nullptr;
+
+  Record& record = m_records[entity.index];
+  if (record.archetype == nullptr)
+    return nullptr;
+
+  int column = record.archetype->FindColumn(component);
+  if (column < 0)
+    return nullptr;
+
+  return record.archetype->Get(record.row, column);
+}
+
+void Engine::ECS::World::AddSystem(std::string name,
+  std::function<void(World&, float)> system, int order) {
+  auto position = std::upper_bound(m_systems.begin(), m_systems.end(), order,
+    [](int order, const System& system) {
+      return order < system.order;
+    });
+
+  m_systems.insert(position, {name, system, order});
+}
+
+Engine::Success Engine::ECS::World::RemoveSystem(const std::string& name) {
+  size_t count = m_systems.size();
+  std::erase_if(m_systems, [&name](const System& system) {
+    return system.name == name;
+  });
+
+  return m_systems.size() != count ? SUCCESS : FAILURE;
+}
+
+void Engine::ECS::World::Update(float dt) {
+  // Systems added or removed by a system take effect from the next frame
+  std::vector<System> systems = m_systems;
+  for (System& system : systems)
+    system.run(*this, dt);
+}
+
+size_t Engine::ECS::World::GetEntityCount() const {
+  return m_entityCount;
+}
+
+size_t Engine::ECS::World::GetArchetypeCount() const {
+  return m_archetypes.size();
+}
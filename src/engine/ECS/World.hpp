@@ -0,0 +1,468 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_ECS_WORLD
+#define ENGINE_ECS_WORLD
+
+#include "../Utils.hpp"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Engine::ECS {
+
+  /**
+   * @brief The amount of component types a program can use
+   */
+  constexpr size_t MAX_COMPONENTS = 64;
+
+  /**
+   * @brief The size in bytes of the chunks entities are stored in
+   */
+  constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+  typedef uint32_t ComponentId;
+  typedef std::bitset<MAX_COMPONENTS> Signature;
+
+  /**
+   * @brief An index into the entities of a world and the generation of its
+   * slot, so the ids of destroyed entities are never mistaken for new ones
+   */
+  struct Entity {
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& other) const = default;
+  };
+
+  /**
+   * @brief An entity that is never alive
+   */
+  constexpr Entity INVALID_ENTITY = {};
+
+  /**
+   * @brief The size and alignment of a component type
+   */
+  struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+  };
+
+  /**
+   * @brief Gives a new id to a component type
+   */
+  extern ComponentId RegisterComponent(size_t size, size_t alignment);
+
+  /**
+   * @brief Returns the size and alignment of a component type
+   */
+  extern const ComponentInfo& GetComponentInfo(ComponentId id);
+
+  /**
+   * @brief Returns the id of a component type, registering it the first time
+   *
+   * Components are plain data: they are moved between chunks with `memcpy`
+   * and never destructed.
+   */
+  template <typename T>
+  ComponentId GetComponentId() {
+    static_assert(std::is_trivially_copyable_v<T>
+      && std::is_trivially_destructible_v<T>,
+      "Components must be plain data");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+      "Components can not be aligned more than std::max_align_t");
+
+    static const ComponentId id = RegisterComponent(sizeof(T), alignof(T));
+    return id;
+  }
+
+  /**
+   * @brief The entities that have exactly the same set of components
+   *
+   * Entities are stored in chunks of `CHUNK_SIZE` bytes. Each chunk holds an
+   * array of entities followed by one array per component, so a system goes
+   * through each component as a dense array.
+   */
+  class Archetype {
+    public:
+    Signature signature;
+    std::vector<ComponentId> components;
+
+    // The byte offset and size of each column in a chunk
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+    std::array<int8_t, MAX_COMPONENTS> columns;
+
+    size_t chunkCapacity;
+    size_t chunkBytes;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;
+    size_t count = 0;
+
+    // The archetype with one component added or removed
+    std::unordered_map<ComponentId, Archetype*> edges;
+
+    /**
+     * @param components the sorted ids of the components
+     */
+    Archetype(const std::vector<ComponentId>& components);
+
+    /**
+     * @brief Returns the column of a component, or -1 if it has none
+     */
+    int FindColumn(ComponentId id) const {
+      return columns[id];
+    }
+
+    /**
+     * @brief Returns the amount of entities in a chunk
+     */
+    size_t GetChunkCount(size_t chunk) const {
+      size_t first = chunk * chunkCapacity;
+      return count - first < chunkCapacity ? count - first : chunkCapacity;
+    }
+
+    Entity* GetEntities(size_t chunk) {
+      return (Entity*)chunks[chunk].get();
+    }
+
+    void* GetColumn(size_t chunk, int column) {
+      return chunks[chunk].get() + offsets[column];
+    }
+
+    /**
+     * @brief Returns the component in a column of an entity
+     */
+    void* Get(size_t row, int column) {
+      return chunks[row / chunkCapacity].get() + offsets[column]
+        + row % chunkCapacity * sizes[column];
+    }
+
+    /**
+     * @brief Adds an entity, with its components left uninitialized
+     *
+     * @return The row of the entity
+     */
+    uint32_t Push(Entity entity);
+
+    /**
+     * @brief Removes an entity, the last one takes its row
+     *
+     * @return The entity moved to the row, or `INVALID_ENTITY` if there is
+     * none
+     */
+    Entity SwapRemove(uint32_t row);
+  };
+
+  /**
+   * @brief A collection of entities and the systems that run on them
+   *
+   * Each entity is a set of components, stored with the entities that have
+   * the same components (see `Archetype`). Systems are functions that go
+   * over every entity with some components, as dense arrays:
+   *
+   * ```cpp
+   * struct Position { float x, y; };
+   * struct Velocity { float x, y; };
+   *
+   * Engine::ECS::World world;
+   * for (int i = 0; i < 100000; i++)
+   *   world.Create(Position{0, 0}, Velocity{1, 2});
+   *
+   * world.AddSystem("Move", [](Engine::ECS::World& world, float dt) {
+   *   world.EachChunk<Position, Velocity>([dt](size_t count,
+   *     const Engine::ECS::Entity* entities, Position* p, Velocity* v) {
+   *     for (size_t i = 0; i < count; i++) {
+   *       p[i].x += v[i].x * dt;
+   *       p[i].y += v[i].y * dt;
+   *     }
+   *   });
+   * });
+   *
+   * world.Update(dt);
+   * ```
+   *
+   * Adding or removing components and destroying entities while going over
+   * a world is deferred until the outermost `Each` or `EachChunk` returns.
+   * Entities created meanwhile get their components at that point too.
+   *
+   * To mix entities with the node tree, see `EntityObject` and `WorldNode`.
+   */
+  class World {
+    private:
+
+    struct Record {
+      Archetype* archetype;
+      uint32_t row;
+      uint32_t generation;
+    };
+
+    enum CommandType { ADD, REMOVE, DESTROY };
+
+    struct Command {
+      CommandType type;
+      Entity entity;
+      ComponentId component;
+      size_t data;
+    };
+
+    struct System {
+      std::string name;
+      std::function<void(World&, float)> run;
+      int order;
+    };
+
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<Signature, Archetype*> m_archetypeIndex;
+
+    std::vector<Record> m_records;
+    std::vector<uint32_t> m_freeEntities;
+    size_t m_entityCount = 0;
+
+    std::vector<Command> m_commands;
+    std::vector<unsigned char> m_commandData;
+    unsigned m_iterating = 0;
+    bool m_flushing = false;
+
+    std::vector<System> m_systems;
+    std::array<std::function<void(Entity, void*)>, MAX_COMPONENTS> m_removeHooks;
+
+    /**
+     * @brief Returns the archetype with a set of components, creating it if
+     * needed, or null for no components
+     */
+    Archetype* GetArchetype(std::vector<ComponentId> components);
+
+    /**
+     * @brief Returns the archetype with a component added or removed
+     */
+    Archetype* GetEdge(Archetype* archetype, ComponentId component);
+
+    /**
+     * @brief Moves an entity to another archetype, with the components both
+     * archetypes have
+     */
+    void Move(Entity entity, Archetype* target);
+
+    void RemoveRow(Archetype* archetype, uint32_t row);
+
+    void RunRemoveHooks(Entity entity, Archetype* archetype);
+
+    void Defer(CommandType type, Entity entity, ComponentId component,
+      const void* data);
+
+    /**
+     * @brief Applies the changes made while going over the world
+     */
+    void Flush();
+
+    template <typename... Ts>
+    static Signature MakeSignature() {
+      Signature signature;
+      (signature.set(GetComponentId<Ts>()), ...);
+      return signature;
+    }
+
+    template <typename... Ts, typename F, size_t... I>
+    static void CallChunk(F& f, Archetype& archetype, size_t chunk,
+      const int* columns, std::index_sequence<I...>) {
+      f(archetype.GetChunkCount(chunk),
+        (const Entity*)archetype.GetEntities(chunk),
+        (Ts*)archetype.GetColumn(chunk, columns[I])...);
+    }
+
+    public:
+
+    World() = default;
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    /**
+     * @brief Creates an entity without components
+     */
+    Entity Create();
+
+    /**
+     * @brief Creates an entity with components
+     */
+    template <typename... Ts>
+    Entity Create(const Ts&... components) {
+      Entity entity = Create();
+      (Add(entity, components), ...);
+      return entity;
+    }
+
+    /**
+     * @brief Destroys an entity and its components
+     */
+    void Destroy(Entity entity);
+
+    /**
+     * @brief Returns true if the entity was not destroyed
+     */
+    bool IsAlive(Entity entity) const;
+
+    /**
+     * @brief Adds a component to an entity, or replaces it
+     */
+    void AddComponent(Entity entity, ComponentId component, const void* data);
+
+    /**
+     * @brief Removes a component from an entity
+     */
+    void RemoveComponent(Entity entity, ComponentId component);
+
+    /**
+     * @brief Returns a component of an entity, or null if it has none
+     */
+    void* GetComponent(Entity entity, ComponentId component);
+
+    template <typename T>
+    void Add(Entity entity, const T& component = T{}) {
+      AddComponent(entity, GetComponentId<T>(), &component);
+    }
+
+    template <typename T>
+    void Remove(Entity entity) {
+      RemoveComponent(entity, GetComponentId<T>());
+    }
+
+    /**
+     * @brief Returns a component of an entity, or null if it has none
+     *
+     * The pointer is valid until a component is added to or removed from
+     * any entity.
+     */
+    template <typename T>
+    T* Get(Entity entity) {
+      return (T*)GetComponent(entity, GetComponentId<T>());
+    }
+
+    template <typename T>
+    bool Has(Entity entity) {
+      return Get<T>(entity) != nullptr;
+    }
+
+    /**
+     * @brief Calls a function when a component is removed, or its entity is
+     * destroyed
+     *
+     * @param hook a function taking the entity and the component
+     */
+    template <typename T>
+    void SetRemoveHook(std::function<void(Entity, T&)> hook) {
+      m_removeHooks[GetComponentId<T>()] = [hook](Entity entity, void* data) {
+        hook(entity, *(T*)data);
+      };
+    }
+
+    /**
+     * @brief Returns true if a function is called when a component is removed
+     */
+    template <typename T>
+    bool HasRemoveHook() {
+      return (bool)m_removeHooks[GetComponentId<T>()];
+    }
+
+    /**
+     * @brief Calls a function for every chunk of entities with components
+     *
+     * The function takes the amount of entities in the chunk, their ids and
+     * an array per component: `f(size_t, const Entity*, Ts*...)`.
+     */
+    template <typename... Ts, typename F>
+    void EachChunk(F&& f) {
+      Signature signature = MakeSignature<Ts...>();
+
+      m_iterating++;
+      for (size_t a = 0; a < m_archetypes.size(); a++) {
+        Archetype& archetype = *m_archetypes[a];
+        if ((archetype.signature & signature) != signature)
+          continue;
+
+        int columns[] = {archetype.FindColumn(GetComponentId<Ts>())..., -1};
+        for (size_t chunk = 0; chunk * archetype.chunkCapacity
+          < archetype.count; chunk++)
+          CallChunk<Ts...>(f, archetype, chunk, columns,
+            std::index_sequence_for<Ts...>());
+      }
+
+      if (--m_iterating == 0)
+        Flush();
+    }
+
+    /**
+     * @brief Calls a function for every entity with components
+     *
+     * The function takes the entity and a reference to each component:
+     * `f(Entity, Ts&...)`.
+     */
+    template <typename... Ts, typename F>
+    void Each(F&& f) {
+      EachChunk<Ts...>([&f](size_t count, const Entity* entities,
+        Ts*... components) {
+        for (size_t i = 0; i < count; i++)
+          f(entities[i], components[i]...);
+      });
+    }
+
+    /**
+     * @brief Returns the amount of entities with components
+     */
+    template <typename... Ts>
+    size_t Count() {
+      Signature signature = MakeSignature<Ts...>();
+      size_t count = 0;
+      for (std::unique_ptr<Archetype>& archetype : m_archetypes)
+        if ((archetype->signature & signature) == signature)
+          count += archetype->count;
+
+      return count;
+    }
+
+    /**
+     * @brief Adds a system, run by `Update`
+     *
+     * @param name the name of the system
+     * @param system the function to run each frame
+     * @param order systems with a lower order run first, then the ones added
+     * first
+     */
+    void AddSystem(std::string name, std::function<void(World&, float)> system,
+      int order = 0);
+
+    /**
+     * @brief Removes the systems with a name
+     *
+     * @return Success if a system was removed
+     */
+    Success RemoveSystem(const std::string& name);
+
+    /**
+     * @brief Runs every system
+     */
+    void Update(float dt);
+
+    /**
+     * @brief Returns the amount of entities alive
+     */
+    size_t GetEntityCount() const;
+
+    /**
+     * @brief Returns the amount of archetypes created
+     */
+    size_t GetArchetypeCount() const;
+  };
+}
+
+#endif
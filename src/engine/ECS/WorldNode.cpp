@@ -0,0 +1,24 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "WorldNode.hpp"
+#include "EntityObject.hpp"
+
+Engine::ECS::WorldNode::WorldNode(std::string name, World& world)
+  : Node(name) {
+  m_world = &world;
+}
+
+Engine::ECS::World& Engine::ECS::WorldNode::GetWorld() {
+  return *m_world;
+}
+
+void Engine::ECS::WorldNode::Update(float dt) {
+  m_world->Update(dt);
+  SyncTransforms(*m_world);
+
+  Node::Update(dt);
+}
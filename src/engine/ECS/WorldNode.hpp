@@ -0,0 +1,53 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_ECS_WORLDNODE
+#define ENGINE_ECS_WORLDNODE
+
+#include "World.hpp"
+#include "../Node.hpp"
+
+namespace Engine::ECS {
+
+  /**
+   * @brief A node that runs the systems of a world each frame
+   *
+   * After the systems, the game objects backed by entities follow their
+   * transform components (see `EntityObject`). Put it before the objects in
+   * the scene, so they are updated after the world.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class Battle : public Scene {
+   *   public:
+   *   Engine::ECS::World world;
+   *   Engine::ECS::WorldNode simulation{"Simulation", world};
+   *
+   *   Battle() : Scene("Battle") {
+   *     AddChild(&simulation);
+   *   }
+   * };
+   * ```
+   */
+  class WorldNode : public Node {
+    private:
+    World* m_world;
+
+    public:
+
+    WorldNode(std::string name, World& world);
+
+    /**
+     * @brief Returns the world ran by the node
+     */
+    World& GetWorld();
+
+    void Update(float dt) override;
+  };
+}
+
+#endif
@@ -0,0 +1,274 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_FLATHASHMAP
+#define ENGINE_FLATHASHMAP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+
+  /**
+   * @brief A hash map that stores its entries in one array
+   *
+   * Entries are placed with linear probing, so a lookup reads consecutive
+   * slots instead of following the nodes of `std::map` or
+   * `std::unordered_map`. Erasing shifts the entries that follow back into
+   * place, so there are no tombstones to slow lookups down.
+   *
+   * Inserting or erasing can move every entry, which invalidates pointers
+   * and iterators to them. The order of iteration is unspecified.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * FlatHashMap<StringId, Scene*> scenes;
+   * scenes["Main"] = &mainScene;
+   *
+   * if (Scene** scene = scenes.Find("Main"))
+   *   SwitchTo(*scene);
+   *
+   * for (auto& [id, scene] : scenes)
+   *   ...
+   * ```
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class FlatHashMap {
+    public:
+
+    struct Entry {
+      Key first;
+      Value second;
+    };
+
+    template <typename E>
+    class Iterator {
+      private:
+      E* m_entries;
+      const bool* m_used;
+      size_t m_index;
+      size_t m_capacity;
+
+      void Skip() {
+        while (m_index < m_capacity && !m_used[m_index])
+          m_index++;
+      }
+
+      public:
+      Iterator(E* entries, const bool* used, size_t index, size_t capacity)
+        : m_entries(entries), m_used(used), m_index(index),
+          m_capacity(capacity) {
+        Skip();
+      }
+
+      E& operator*() const { return m_entries[m_index]; }
+      E* operator->() const { return &m_entries[m_index]; }
+
+      Iterator& operator++() {
+        m_index++;
+        Skip();
+        return *this;
+      }
+
+      bool operator==(const Iterator& other) const {
+        return m_index == other.m_index;
+      }
+    };
+
+    typedef Iterator<Entry> iterator;
+    typedef Iterator<const Entry> const_iterator;
+
+    private:
+
+    std::vector<Entry> m_entries;
+    std::unique_ptr<bool[]> m_used;
+    size_t m_size = 0;
+    size_t m_mask = 0;
+
+    size_t IndexOf(const Key& key) const {
+      // Spread the hash, since the low bits of some hashes are poor
+      uint64_t hash = (uint64_t)Hash()(key) * 0x9E3779B97F4A7C15ull;
+      return (size_t)(hash >> 32) & m_mask;
+    }
+
+    /**
+     * @brief Returns the slot of a key, or of the free slot it would take
+     */
+    size_t Probe(const Key& key) const {
+      size_t index = IndexOf(key);
+      while (m_used[index] && !(m_entries[index].first == key))
+        index = (index + 1) & m_mask;
+
+      return index;
+    }
+
+    void Rehash(size_t capacity) {
+      std::vector<Entry> entries = std::move(m_entries);
+      std::unique_ptr<bool[]> used = std::move(m_used);
+      size_t oldCapacity = entries.size();
+
+      m_entries = std::vector<Entry>(capacity);
+      m_used = std::unique_ptr<bool[]>(new bool[capacity]());
+      m_mask = capacity - 1;
+
+      for (size_t i = 0; i < oldCapacity; i++) {
+        if (!used[i])
+          continue;
+
+        size_t index = Probe(entries[i].first);
+        m_entries[index] = std::move(entries[i]);
+        m_used[index] = true;
+      }
+    }
+
+    public:
+
+    FlatHashMap() = default;
+
+    FlatHashMap(FlatHashMap&&) = default;
+    FlatHashMap& operator=(FlatHashMap&&) = default;
+
+    /**
+     * @brief Returns the value of a key, or null if the key is not in the map
+     */
+    Value* Find(const Key& key) {
+      if (m_size == 0)
+        return nullptr;
+
+      size_t index = Probe(key);
+      return m_used[index] ? &m_entries[index].second : nullptr;
+    }
+
+    const Value* Find(const Key& key) const {
+      return const_cast<FlatHashMap*>(this)->Find(key);
+    }
+
+    bool Contains(const Key& key) const {
+      return Find(key) != nullptr;
+    }
+
+    /**
+     * @brief Returns the value of a key, and throws if it is not in the map
+     */
+    Value& at(const Key& key) {
+      Value* value = Find(key);
+      if (value == nullptr)
+        throw std::out_of_range("Key is not in the map");
+
+      return *value;
+    }
+
+    /**
+     * @brief Returns the value of a key, inserting a default one if needed
+     */
+    Value& operator[](const Key& key) {
+      return Emplace(key).first->second;
+    }
+
+    /**
+     * @brief Inserts a key, unless it is already in the map
+     *
+     * @return The entry of the key, and true if it was inserted
+     */
+    template <typename... Args>
+    std::pair<Entry*, bool> Emplace(const Key& key, Args&&... args) {
+      // Keep the map at most 3/4 full, so probes stay short
+      if ((m_size + 1) * 4 > m_entries.size() * 3)
+        Rehash(m_entries.empty() ? 16 : m_entries.size() * 2);
+
+      size_t index = Probe(key);
+      if (m_used[index])
+        return {&m_entries[index], false};
+
+      m_entries[index].first = key;
+      m_entries[index].second = Value(std::forward<Args>(args)...);
+      m_used[index] = true;
+      m_size++;
+      return {&m_entries[index], true};
+    }
+
+    /**
+     * @brief Sets the value of a key, inserting it if needed
+     */
+    template <typename V>
+    Value& InsertOrAssign(const Key& key, V&& value) {
+      Value& slot = (*this)[key];
+      slot = std::forward<V>(value);
+      return slot;
+    }
+
+    /**
+     * @brief Removes a key from the map
+     *
+     * @return true if the key was in the map
+     */
+    bool Erase(const Key& key) {
+      if (m_size == 0)
+        return false;
+
+      size_t index = Probe(key);
+      if (!m_used[index])
+        return false;
+
+      // Shift back the entries that probed past the freed slot
+      size_t next = (index + 1) & m_mask;
+      while (m_used[next]) {
+        size_t home = IndexOf(m_entries[next].first);
+        if (((next - home) & m_mask) >= ((next - index) & m_mask)) {
+          m_entries[index] = std::move(m_entries[next]);
+          index = next;
+        }
+        next = (next + 1) & m_mask;
+      }
+
+      m_entries[index] = Entry();
+      m_used[index] = false;
+      m_size--;
+      return true;
+    }
+
+    void Clear() {
+      m_entries.clear();
+      m_used.reset();
+      m_size = 0;
+      m_mask = 0;
+    }
+
+    size_t Size() const {
+      return m_size;
+    }
+
+    bool Empty() const {
+      return m_size == 0;
+    }
+
+    iterator begin() {
+      return {m_entries.data(), m_used.get(), 0, m_entries.size()};
+    }
+
+    iterator end() {
+      return {m_entries.data(), m_used.get(), m_entries.size(),
+        m_entries.size()};
+    }
+
+    const_iterator begin() const {
+      return {m_entries.data(), m_used.get(), 0, m_entries.size()};
+    }
+
+    const_iterator end() const {
+      return {m_entries.data(), m_used.get(), m_entries.size(),
+        m_entries.size()};
+    }
+  };
+}
+
+#endif
@@ -5,7 +5,10 @@
  */
 
 #include "Game.hpp"
+#include "TransformPool.hpp"
+#include "Spatial/SceneIndex.hpp"
 #include <emscripten.h>
+#include <iostream>
 
 Engine::Game& Engine::Game::getInstance(Engine::Scene* startingScene) {
   static Game instance(startingScene);
@@ -15,52 +18,95 @@ Engine::Game& Engine::Game::getInstance(Engine::Scene* startingScene) {
 Engine::Game::Game(Scene* startingScene) {
   AddScene("Scene0", startingScene);
   SwitchScene("Scene0");
-  m_renderer = Graphics::Renderer();
 
   EM_ASM(
     game.canvases["canvas"].width = window.innerWidth;
     game.canvases["canvas"].height = window.innerHeight;
-    game.gl["canvas"].viewport(0, 0, window.innerWidth, window.innerHeight);
 
     game.uiContainer = document.getElementById('ui-layer');
     game.ready = true;
   );
 }
 
-Engine::Success Engine::Game::AddScene(const char* id, Scene* scene) {
-  if (m_loadedScenes.find(id) != m_loadedScenes.end())
+Engine::Success Engine::Game::AddScene(std::string_view id, Scene* scene) {
+  if (!m_loadedScenes.Emplace(StringId::Intern(id), scene).second)
     return FAILURE;
-  m_loadedScenes.emplace(id, scene);
   scene->Init();
   return SUCCESS;
 }
 
-Engine::Success Engine::Game::SwitchScene(const char* id) {
+Engine::Success Engine::Game::AddScene(std::string_view id, Scene* scene,
+  std::unique_ptr<SceneArena> arena) {
+  if (arena == nullptr || !arena->Owns(scene)) {
+    std::cerr << "ERROR: The scene " << id << " must be created in its arena"
+      << std::endl;
+    return FAILURE;
+  }
+
+  if (AddScene(id, scene) == FAILURE)
+    return FAILURE;
+
+  m_sceneArenas.Emplace(StringId(id), std::move(arena));
+  return SUCCESS;
+}
+
+Engine::SceneArena* Engine::Game::GetSceneArena(StringId id) {
+  std::unique_ptr<SceneArena>* arena = m_sceneArenas.Find(id);
+  return arena != nullptr ? arena->get() : nullptr;
+}
+
+Engine::Success Engine::Game::SwitchScene(StringId id) {
   if (m_currentScene != nullptr)
     m_currentScene->SetEnabled(false);
 
-  if (m_loadedScenes.find(id) == m_loadedScenes.end())
+  Scene** scene = m_loadedScenes.Find(id);
+  if (scene == nullptr)
     return FAILURE;
 
-  m_currentScene = m_loadedScenes[id];
+  m_currentScene = *scene;
   m_currentScene->SetEnabled(true);
+  m_traversal.SetRoot(m_currentScene);
   return SUCCESS;
 }
 
-Engine::Success Engine::Game::UnloadScene(const char* id) {
-  if (m_loadedScenes.find(id) == m_loadedScenes.end())
+Engine::Success Engine::Game::UnloadScene(StringId id) {
+  Scene** scene = m_loadedScenes.Find(id);
+  if (scene == nullptr)
     return FAILURE;
-  m_loadedScenes.erase(id);
+
+  std::unique_ptr<SceneArena>* arena = m_sceneArenas.Find(id);
+  if (arena != nullptr) {
+    if (*scene == m_currentScene) {
+      std::cerr << "ERROR: The scene " << id << " can not be unloaded while "
+        << "it is running" << std::endl;
+      return FAILURE;
+    }
+
+    // The whole scene goes at once, with the rest of its arena
+    (*arena)->Release();
+    m_sceneArenas.Erase(id);
+  }
+
+  m_loadedScenes.Erase(id);
   return SUCCESS;
 }
 
 void Engine::Game::DrawScene() {
   m_renderer.ClearBuffer();
-  m_currentScene->Draw();
+  m_renderer.BeginFrame();
+
+  // Only the objects that moved since the last frame are recomputed
+  GetTransformPool().Update();
+  Spatial::GetSceneIndex().Update();
+  m_traversal.Draw();
+  m_renderer.Flush();
+
+  // Nodes destroyed during the frame are only freed once nothing uses them
+  Node::FlushDestroyed();
 }
 
 void Engine::Game::UpdateScene(float dt) {
-  m_currentScene->Update(dt);
+  m_traversal.Update(dt);
 }
 
 Engine::Graphics::Renderer& Engine::Game::GetRenderer() {
@@ -8,8 +8,12 @@
 #define ENGINE_GAME
 
 #include "Node.hpp"
+#include "FlatHashMap.hpp"
+#include "SceneArena.hpp"
+#include "SceneTraversal.hpp"
 #include "Graphics/Renderer.hpp"
-#include <map>
+#include <memory>
+#include <string_view>
 
 namespace Engine {
   
@@ -35,7 +39,9 @@ namespace Engine {
   class Game {
     private:
     Scene* m_currentScene;
-    std::map<const char*, Scene*> m_loadedScenes;
+    FlatHashMap<StringId, Scene*> m_loadedScenes;
+    FlatHashMap<StringId, std::unique_ptr<SceneArena>> m_sceneArenas;
+    SceneTraversal m_traversal;
 
     Graphics::Renderer m_renderer;
 
@@ -55,13 +61,39 @@ namespace Engine {
 
     /**
      * Adds a scene to the game
+     *
+     * Scenes are found by the `StringId` of their ID, so the ID does not
+     * have to be the same pointer when switching to the scene.
      * 
      * @param id The loaded scene ID
      * @param scene The scene to add
      * 
      * @return Success if there is no scene with the same ID
      */
-    Success AddScene(const char* id, Scene* scene);
+    Success AddScene(std::string_view id, Scene* scene);
+
+    /**
+     * Adds a scene that lives in an arena
+     *
+     * The game takes the arena, and releases it when the scene is unloaded,
+     * which frees the whole scene at once.
+     *
+     * @param id The loaded scene ID
+     * @param scene The scene to add, created in the arena
+     * @param arena The arena holding the scene
+     *
+     * @return Success if there is no scene with the same ID and the scene is
+     * in the arena
+     */
+    Success AddScene(std::string_view id, Scene* scene,
+      std::unique_ptr<SceneArena> arena);
+
+    /**
+     * Returns the arena of a loaded scene, or null if it has none
+     *
+     * @param id The ID of the scene
+     */
+    SceneArena* GetSceneArena(StringId id);
 
     /**
      * Switches the scene requested
@@ -69,15 +101,18 @@ namespace Engine {
      * @param id The ID of the scene to switch to
      * @return Success if the scene exists
      */
-    Success SwitchScene(const char* id);
+    Success SwitchScene(StringId id);
 
     /**
      * Deletes a loaded scene from the game
+     *
+     * If the scene has an arena, the scene is destroyed with it. The current
+     * scene can not be unloaded that way.
      * 
      * @param id The ID of the scene to delete
      * @return Success if the scene exists
      */
-    Success UnloadScene(const char* id);
+    Success UnloadScene(StringId id);
 
     // For the game Loop //
 
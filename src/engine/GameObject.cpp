@@ -5,15 +5,120 @@
  */
 
 #include "GameObject.hpp"
+#include "Spatial/SceneIndex.hpp"
+#include <cmath>
 
 Engine::GameObject::GameObject(std::string name): Engine::Node(name) {
   m_nodeType = "GameObject";
+
+  // Created first so that it outlives every object it tracks
+  Spatial::GetSceneIndex();
+  m_transform = GetTransformPool().Create();
+}
+
+Engine::GameObject::~GameObject() {
+  Spatial::GetSceneIndex().Untrack(this);
+  GetTransformPool().Destroy(m_transform);
+}
+
+Engine::TransformHandle Engine::GameObject::GetTransformHandle() {
+  return m_transform;
+}
+
+Engine::GameObject* Engine::GameObject::GetParentObject() {
+  for (Node* node = m_parent; node != nullptr; node = node->GetParent()) {
+    GameObject* object = dynamic_cast<GameObject*>(node);
+    if (object != nullptr)
+      return object;
+  }
+
+  return nullptr;
+}
+
+Engine::Vec3f Engine::GameObject::GetPosition() {
+  return GetTransformPool().GetPosition(m_transform);
+}
+
+void Engine::GameObject::SetPosition(Vec3f position) {
+  GetTransformPool().SetPosition(m_transform, position);
+}
+
+Engine::Vec3f Engine::GameObject::GetScale() {
+  return GetTransformPool().GetScale(m_transform);
+}
+
+void Engine::GameObject::SetScale(Vec3f scale) {
+  GetTransformPool().SetScale(m_transform, scale);
+}
+
+Engine::Quatf Engine::GameObject::GetRotation() {
+  return GetTransformPool().GetRotation(m_transform);
+}
+
+void Engine::GameObject::SetRotation(Quatf rotation) {
+  GetTransformPool().SetRotation(m_transform, rotation);
+}
+
+Engine::Vec3f Engine::GameObject::GetEulerRotation() {
+  return GetRotation().ToEuler();
+}
+
+void Engine::GameObject::SetEulerRotation(Vec3f rotation) {
+  SetRotation(Quatf::FromEuler(rotation));
+}
+
+void Engine::GameObject::Rotate(Quatf rotation) {
+  // Renormalized so that the error of many small rotations does not add up
+  SetRotation((rotation * GetRotation()).Normalized());
+}
+
+Engine::Transform Engine::GameObject::GetLocalTransform() {
+  return GetTransformPool().GetLocal(m_transform);
+}
+
+void Engine::GameObject::SetLocalTransform(const Transform& transform) {
+  GetTransformPool().SetLocal(m_transform, transform);
+}
+
+const float* Engine::GameObject::GetWorldMatrix() {
+  return GetTransformPool().GetWorldMatrix(m_transform);
 }
 
 Engine::Vec3f Engine::GameObject::GetGlobalPosition() { 
-  return Position;
+  const float* world = GetWorldMatrix();
+  return {world[12], world[13], world[14]};
 }
 
-Engine::Vec3f Engine::GameObject::GetGlobalRotation() { 
-  return Rotation;
-}
\ No newline at end of file
+Engine::Quatf Engine::GameObject::GetGlobalRotation() { 
+  const float* m = GetWorldMatrix();
+
+  // The columns are scaled by the global scale
+  float scaleX = sqrtf(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+  float scaleY = sqrtf(m[4] * m[4] + m[5] * m[5] + m[6] * m[6]);
+  float scaleZ = sqrtf(m[8] * m[8] + m[9] * m[9] + m[10] * m[10]);
+  if (scaleX == 0.0f || scaleY == 0.0f || scaleZ == 0.0f)
+    return GetRotation();
+
+  return Quatf::FromMat3({{
+    m[0] / scaleX, m[1] / scaleX, m[2] / scaleX,
+    m[4] / scaleY, m[5] / scaleY, m[6] / scaleY,
+    m[8] / scaleZ, m[9] / scaleZ, m[10] / scaleZ
+  }}).Normalized();
+}
+
+Engine::Vec3f Engine::GameObject::GetGlobalEulerRotation() {
+  return GetGlobalRotation().ToEuler();
+}
+
+Engine::BoundingBox Engine::GameObject::GetLocalBounds() {
+  return BoundingBox::Empty();
+}
+
+void Engine::GameObject::AttachTransforms() {
+  // The children of this object stay attached to it
+  GameObject* parent = GetParentObject();
+  GetTransformPool().SetParent(m_transform, parent != nullptr
+    ? parent->m_transform : INVALID_TRANSFORM);
+
+  Spatial::GetSceneIndex().Track(this);
+}
@@ -8,6 +8,7 @@
 #define ENGINE_GAMEOBJECT
 
 #include "Node.hpp"
+#include "TransformPool.hpp"
 
 namespace Engine {
 
@@ -16,6 +17,13 @@ namespace Engine {
    * 
    * Each game object is a node. However it also has its own position, rotation,
    * and scale allowing it to be moved around in space.
+   *
+   * The position, scale and rotation are relative to the closest game object
+   * above it. Rotations are stored as quaternions, which compose and
+   * interpolate (`Slerp`) without gimbal lock. The Euler accessors convert
+   * from and to angles in degrees. They live in the `TransformPool` along
+   * with a cached world matrix, and the matrices that changed are recomputed
+   * once per frame, so objects that did not move cost nothing.
    * 
    * ## Example
    * 
@@ -25,11 +33,12 @@ namespace Engine {
    *   public:
    *   Cube mesh;
    *   CubeObject() : GameObject("Cube") {
-   *     Position = {0, 3, 4};
+   *     SetPosition({0, 3, 4});
    *   }
    *  
    *   void Draw() override {
-   *     Engine::Game::getInstance().GetRenderer().DrawMesh(&mesh, Position, Scale, Rotation);
+   *     Engine::Game::getInstance().GetRenderer().DrawMesh(&mesh,
+   *       GetWorldMatrix());
    *   }
    * };
    * 
@@ -48,11 +57,22 @@ namespace Engine {
    * @author Roberto Selles
    */
   class GameObject : public Node {
+    private:
+    TransformHandle m_transform;
+
+    /**
+     * @brief Returns the closest game object above this one, if any
+     */
+    GameObject* GetParentObject();
+
     public:
-    
-    Vec3f Position{0.0f, 0.0f, 0.0f};
-    Vec3f Scale{1.0f, 1.0f, 1.0f};
-    Vec3f Rotation{0.0f, 0.0f, 0.0f};
+
+    /**
+     * @brief Marks the object as static geometry that never moves
+     *
+     * Static objects can be baked together by a `StaticBatch`.
+     */
+    bool Static = false;
 
     /**
      * @brief Default constructor
@@ -61,6 +81,92 @@ namespace Engine {
      */
     GameObject(std::string name);
 
+    /**
+     * @brief Frees the transform of the object
+     */
+    ~GameObject();
+
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
+
+    /**
+     * @brief Returns the handle of the transform in the transform pool
+     */
+    TransformHandle GetTransformHandle();
+
+    /**
+     * @brief Returns the position relative to the parent
+     */
+    Vec3f GetPosition();
+
+    /**
+     * @brief Sets the position relative to the parent
+     */
+    void SetPosition(Vec3f position);
+
+    /**
+     * @brief Returns the scale relative to the parent
+     */
+    Vec3f GetScale();
+
+    /**
+     * @brief Sets the scale relative to the parent
+     */
+    void SetScale(Vec3f scale);
+
+    /**
+     * @brief Returns the rotation relative to the parent
+     */
+    Quatf GetRotation();
+
+    /**
+     * @brief Sets the rotation relative to the parent
+     */
+    void SetRotation(Quatf rotation);
+
+    /**
+     * @brief Returns the rotation relative to the parent, in degrees
+     */
+    Vec3f GetEulerRotation();
+
+    /**
+     * @brief Sets the rotation relative to the parent, in degrees
+     *
+     * The angles are applied as rotateX * rotateY * rotateZ.
+     */
+    void SetEulerRotation(Vec3f rotation);
+
+    /**
+     * @brief Rotates the object by a rotation relative to its parent
+     *
+     * @param rotation the rotation applied after the current one
+     */
+    void Rotate(Quatf rotation);
+
+    /**
+     * @brief Returns the position, scale and rotation relative to the parent
+     */
+    Transform GetLocalTransform();
+
+    /**
+     * @brief Sets the position, scale and rotation relative to the parent
+     */
+    void SetLocalTransform(const Transform& transform);
+
+    /**
+     * @brief Returns the transformation matrix from the object to the world
+     *
+     * The matrix is column-major. If any object moved since the last update
+     * of the transform pool, the pool is updated first.
+     *
+     * @warning Updating is not thread safe. Draws running on worker threads
+     * happen after the update of the frame, where every matrix is up to date.
+     *
+     * @return An array of 16 floats, valid until the next game object is
+     * created or the next update
+     */
+    const float* GetWorldMatrix();
+
     /**
      * @brief Returns the position of the game object relative to the global 0,0
      * 
@@ -70,10 +176,33 @@ namespace Engine {
 
     /**
      * @brief Returns the overall rotation in respect to any parent game objects
+     *
+     * The rotation is extracted from the world matrix, without its scale.
      * 
      * @return The global rotation
      */
-    Vec3f GetGlobalRotation();
+    Quatf GetGlobalRotation();
+
+    /**
+     * @brief Returns the overall rotation in degrees
+     *
+     * The angles may differ from the sum of the rotations while describing
+     * the same orientation.
+     */
+    Vec3f GetGlobalEulerRotation();
+
+    /**
+     * @brief Returns the box around the object, relative to the object
+     *
+     * Objects with bounds are tracked by the scene index once they are added
+     * to a parent. The default box is empty, so plain game objects are not
+     * tracked.
+     *
+     * @see Spatial::SceneIndex
+     */
+    virtual BoundingBox GetLocalBounds();
+
+    void AttachTransforms() override;
   };
 }
 
@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "LODGroup.hpp"
+#include "../Game.hpp"
+#include <cmath>
+
+Engine::LODGroup::LODGroup(std::string name, Graphics::Material* material,
+  Graphics::Texture* texture) : Engine::GameObject(name) {
+  m_material = material;
+  m_texture = texture;
+}
+
+void Engine::LODGroup::AddLevel(Graphics::Mesh* mesh, float screenSize) {
+  m_levels.push_back({mesh, screenSize});
+}
+
+void Engine::LODGroup::SetHysteresis(float hysteresis) {
+  m_hysteresis = hysteresis;
+}
+
+float Engine::LODGroup::GetScreenSize(const float* viewProjection) {
+  if (m_levels.empty())
+    return 0.0f;
+
+  BoundingBox box = GetLocalBounds().Transformed(GetWorldMatrix());
+  Vec3f center = box.Center();
+  float radius = box.Extents().length();
+
+  const float* m = viewProjection;
+  float w = m[3] * center.x + m[7] * center.y + m[11] * center.z + m[15];
+  if (w <= 0.0f)
+    return INFINITY;
+
+  // The height of the canvas is 2 in clip space
+  float scale = sqrtf(m[1] * m[1] + m[5] * m[5] + m[9] * m[9]);
+  return radius * scale / w;
+}
+
+size_t Engine::LODGroup::LevelFor(float screenSize) const {
+  size_t level = 0;
+  while (level < m_levels.size() && screenSize < m_levels[level].screenSize)
+    level++;
+
+  return level;
+}
+
+size_t Engine::LODGroup::SelectLevel(float screenSize) {
+  // A level only changes once the size is past the threshold by a margin
+  size_t coarser = LevelFor(screenSize * (1.0f + m_hysteresis));
+  size_t finer = LevelFor(screenSize * (1.0f - m_hysteresis));
+
+  if (coarser > m_currentLevel)
+    m_currentLevel = coarser;
+  else if (finer < m_currentLevel)
+    m_currentLevel = finer;
+
+  return m_currentLevel;
+}
+
+size_t Engine::LODGroup::GetCurrentLevel() const {
+  return m_currentLevel;
+}
+
+size_t Engine::LODGroup::GetLevelCount() const {
+  return m_levels.size();
+}
+
+Engine::BoundingBox Engine::LODGroup::GetLocalBounds() {
+  if (m_levels.empty())
+    return BoundingBox::Empty();
+
+  return m_levels[0].mesh->GetBoundingBox();
+}
+
+void Engine::LODGroup::Draw() {
+  Graphics::Renderer& renderer = Game::getInstance().GetRenderer();
+
+  size_t level = SelectLevel(GetScreenSize(renderer.GetViewProjection()));
+  if (level < m_levels.size()) {
+    if (m_material != nullptr)
+      renderer.UseMaterial(m_material);
+    else
+      renderer.UseShader(Graphics::DefaultShader());
+
+    if (m_texture != nullptr)
+      renderer.UseTexture(*m_texture, GL_TEXTURE0);
+
+    renderer.DrawMesh(m_levels[level].mesh, GetWorldMatrix());
+  }
+
+  Node::Draw();
+}
@@ -0,0 +1,128 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_LODGROUP
+#define ENGINE_LODGROUP
+
+#include "../GameObject.hpp"
+#include "../Graphics/Mesh.hpp"
+#include "../Graphics/Material.hpp"
+#include "../Graphics/Texture.hpp"
+#include <vector>
+
+namespace Engine {
+
+  /**
+   * @brief A game object that draws a simpler mesh the smaller it looks
+   *
+   * Each level has a mesh and the screen size down to which it is drawn. The
+   * screen size is the radius of the bounding sphere of the first level, as
+   * a fraction of the height of the canvas. Below the screen size of the last
+   * level, nothing is drawn.
+   *
+   * To keep an object that sits right at a threshold from switching level
+   * every frame, it only switches once its size has moved past the threshold
+   * by the hysteresis.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * std::vector<std::unique_ptr<Graphics::Mesh>> lods =
+   *   Graphics::MeshSimplifier::GenerateLODs(statue, 3);
+   *
+   * LODGroup group("Statue");
+   * group.AddLevel(&statue, 0.25f);
+   * group.AddLevel(lods[0].get(), 0.1f);
+   * group.AddLevel(lods[1].get(), 0.05f);
+   * group.AddLevel(lods[2].get(), 0.01f);
+   * ```
+   */
+  class LODGroup : public GameObject {
+    private:
+
+    struct Level {
+      Graphics::Mesh* mesh;
+      float screenSize;
+    };
+
+    std::vector<Level> m_levels;
+    Graphics::Material* m_material;
+    Graphics::Texture* m_texture;
+    float m_hysteresis = 0.1f;
+    size_t m_currentLevel = 0;
+
+    /**
+     * @brief Returns the level drawn at a screen size, without hysteresis
+     */
+    size_t LevelFor(float screenSize) const;
+
+    public:
+
+    /**
+     * @brief Default constructor
+     *
+     * @param name The name of the object
+     * @param material The material to draw the levels with *(optional)*
+     * @param texture The texture bound to `GL_TEXTURE0` *(optional)*
+     */
+    LODGroup(std::string name, Graphics::Material* material = nullptr,
+      Graphics::Texture* texture = nullptr);
+
+    /**
+     * @brief Adds a level after the ones already added
+     *
+     * @param mesh The mesh of the level
+     * @param screenSize The smallest screen size the level is drawn at, lower
+     * than the one of the previous level
+     */
+    void AddLevel(Graphics::Mesh* mesh, float screenSize);
+
+    /**
+     * @brief Sets how far past a threshold the screen size has to move
+     *
+     * @param hysteresis A fraction of the threshold, 0.1 by default
+     */
+    void SetHysteresis(float hysteresis);
+
+    /**
+     * @brief Returns the screen size of the object seen through a camera
+     *
+     * @param viewProjection The column-major view projection of the camera
+     */
+    float GetScreenSize(const float* viewProjection);
+
+    /**
+     * @brief Picks the level to draw at a screen size
+     *
+     * @return The index of the level, or the amount of levels if none is
+     * drawn
+     */
+    size_t SelectLevel(float screenSize);
+
+    /**
+     * @brief Returns the level picked last, or the amount of levels if none
+     * is drawn
+     */
+    size_t GetCurrentLevel() const;
+
+    /**
+     * @brief Returns the amount of levels
+     */
+    size_t GetLevelCount() const;
+
+    /**
+     * @brief Returns the bounding box of the first level
+     */
+    BoundingBox GetLocalBounds() override;
+
+    /**
+     * @brief Draws the level that matches the screen size, then the children
+     */
+    void Draw() override;
+  };
+}
+
+#endif
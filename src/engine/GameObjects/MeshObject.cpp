@@ -0,0 +1,50 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "MeshObject.hpp"
+#include "../Game.hpp"
+
+Engine::MeshObject::MeshObject(std::string name, Graphics::Mesh* mesh,
+  Graphics::Material* material, Graphics::Texture* texture) :
+  Engine::GameObject(name) {
+  m_mesh = mesh;
+  m_material = material;
+  m_texture = texture;
+}
+
+Engine::Graphics::Mesh* Engine::MeshObject::GetMesh() {
+  return m_mesh;
+}
+
+Engine::Graphics::Material* Engine::MeshObject::GetMaterial() {
+  return m_material;
+}
+
+Engine::Graphics::Texture* Engine::MeshObject::GetTexture() {
+  return m_texture;
+}
+
+Engine::BoundingBox Engine::MeshObject::GetLocalBounds() {
+  return m_mesh->GetBoundingBox();
+}
+
+void Engine::MeshObject::Draw() {
+  Graphics::Renderer& renderer = Game::getInstance().GetRenderer();
+
+  if (m_material != nullptr)
+    renderer.UseMaterial(m_material);
+  else
+    renderer.UseShader(Graphics::DefaultShader());
+
+  if (m_texture != nullptr)
+    renderer.UseTexture(*m_texture, GL_TEXTURE0);
+
+  renderer.DrawMesh(m_mesh, GetWorldMatrix());
+  if (Occluder)
+    renderer.AddOccluder(m_mesh, GetWorldMatrix());
+
+  Node::Draw();
+}
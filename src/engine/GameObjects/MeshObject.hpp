@@ -0,0 +1,98 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_MESHOBJECT
+#define ENGINE_MESHOBJECT
+
+#include "../GameObject.hpp"
+#include "../Graphics/Mesh.hpp"
+#include "../Graphics/Material.hpp"
+#include "../Graphics/Texture.hpp"
+
+namespace Engine {
+
+  /**
+   * @brief A game object that draws a mesh at its position
+   *
+   * This saves you from writing a `Draw` override for objects that only need
+   * to draw a mesh with a material or a texture. If no material is given, the
+   * default shader is used.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class ExampleScene : public Scene {
+   *   public:
+   *   Graphics::Cube mesh;
+   *   Graphics::Texture texture;
+   *   MeshObject cube;
+   *
+   *   ExampleScene() : Scene("ExampleScene"), texture("Assets/placeholder.png"),
+   *   cube("Cube", &mesh, nullptr, &texture) {
+   *     AddChild(&cube);
+   *   }
+   * };
+   * ```
+   */
+  class MeshObject : public GameObject {
+    private:
+    Graphics::Mesh* m_mesh;
+    Graphics::Material* m_material;
+    Graphics::Texture* m_texture;
+
+    public:
+
+    /**
+     * @brief Makes the mesh hide the draws behind it
+     *
+     * The mesh is rasterized into the occlusion buffer of the renderer each
+     * frame. Use it for large meshes with few triangles, such as walls.
+     *
+     * @see Graphics::Renderer::AddOccluder
+     */
+    bool Occluder = false;
+
+    /**
+     * @brief Default constructor
+     *
+     * @param name The name of the object
+     * @param mesh The mesh to draw
+     * @param material The material to draw the mesh with *(optional)*
+     * @param texture The texture bound to `GL_TEXTURE0` *(optional)*
+     */
+    MeshObject(std::string name, Graphics::Mesh* mesh,
+      Graphics::Material* material = nullptr,
+      Graphics::Texture* texture = nullptr);
+
+    /**
+     * @brief Returns the mesh drawn by the object
+     */
+    Graphics::Mesh* GetMesh();
+
+    /**
+     * @brief Returns the material of the object, or null if it uses the
+     * default shader
+     */
+    Graphics::Material* GetMaterial();
+
+    /**
+     * @brief Returns the texture of the object, or null if it has none
+     */
+    Graphics::Texture* GetTexture();
+
+    /**
+     * @brief Returns the bounding box of the mesh
+     */
+    BoundingBox GetLocalBounds() override;
+
+    /**
+     * @brief Draws the mesh and then its children
+     */
+    void Draw() override;
+  };
+}
+
+#endif
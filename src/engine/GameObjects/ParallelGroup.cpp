@@ -0,0 +1,145 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ParallelGroup.hpp"
+#include "../Game.hpp"
+#include <algorithm>
+
+Engine::ParallelGroup::ParallelGroup(std::string name, unsigned threadCount) :
+  Engine::GameObject(name) {
+  SetThreadCount(threadCount);
+  SetDrawsChildren(true);
+}
+
+Engine::ParallelGroup::~ParallelGroup() {
+  #ifdef ENGINE_THREADING
+  StopWorkers();
+  #endif
+}
+
+void Engine::ParallelGroup::SetThreadCount(unsigned threadCount) {
+  m_threadCount = threadCount == 0 ? 1 : threadCount;
+}
+
+unsigned Engine::ParallelGroup::GetThreadCount() {
+  return m_threadCount;
+}
+
+#ifdef ENGINE_THREADING
+void Engine::ParallelGroup::StartWorkers() {
+  m_stopping = false;
+  for (size_t range = 1; range < m_threadCount; range++)
+    m_workers.emplace_back(&ParallelGroup::RunWorker, this, range,
+      m_frameNumber);
+}
+
+void Engine::ParallelGroup::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    m_stopping = true;
+  }
+  m_frameStarted.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+  m_workers.clear();
+}
+
+void Engine::ParallelGroup::RunWorker(size_t range,
+  unsigned long frameNumber) {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_workerMutex);
+      m_frameStarted.wait(lock, [&]() {
+        return m_stopping || m_frameNumber != frameNumber;
+      });
+
+      if (m_stopping)
+        return;
+      frameNumber = m_frameNumber;
+    }
+
+    // Workers past the last range only report back
+    if (range < m_frame.ranges)
+      DrawRange(range);
+
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    if (--m_workersLeft == 0)
+      m_frameDone.notify_one();
+  }
+}
+
+void Engine::ParallelGroup::DrawRange(size_t range) {
+  size_t begin = m_frame.children.size() * range / m_frame.ranges;
+  size_t end = m_frame.children.size() * (range + 1) / m_frame.ranges;
+
+  m_frame.renderer->BeginRecording(*m_buffers[range]);
+  for (size_t i = begin; i < end; i++)
+    m_frame.children[i]->Draw();
+  m_frame.renderer->EndRecording();
+}
+#endif
+
+void Engine::ParallelGroup::DrawChildren(Graphics::Renderer& renderer) {
+  #ifdef ENGINE_THREADING
+  // Groups inside of a group that is already being recorded stay on the
+  // worker thread, so that their draws keep their place
+  if (m_threadCount < 2 || renderer.IsRecording()) {
+    GameObject::Draw();
+    return;
+  }
+
+  std::vector<Node*> children;
+  for (size_t i = 0; i < GetChildCount(); i++)
+    if (GetChild(i)->IsEnabled() && !GetChild(i)->IsDestroyed())
+      children.push_back(GetChild(i));
+
+  size_t ranges = std::min<size_t>(m_threadCount, children.size());
+  if (ranges < 2) {
+    GameObject::Draw();
+    return;
+  }
+
+  if (m_workers.size() != m_threadCount - 1) {
+    StopWorkers();
+    StartWorkers();
+  }
+
+  while (m_buffers.size() < ranges)
+    m_buffers.push_back(std::make_unique<Graphics::CommandBuffer>());
+
+  {
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    m_frame.renderer = &renderer;
+    m_frame.children = std::move(children);
+    m_frame.ranges = ranges;
+    m_workersLeft = m_workers.size();
+    m_frameNumber++;
+  }
+  m_frameStarted.notify_all();
+
+  // The calling thread draws the first range while the workers draw theirs
+  DrawRange(0);
+
+  {
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    m_frameDone.wait(lock, [this]() { return m_workersLeft == 0; });
+  }
+
+  // Submitting in order keeps the draws in the order of the children
+  for (size_t range = 0; range < ranges; range++)
+    renderer.Submit(*m_buffers[range]);
+
+  // The next draws continue from the state left by the last child
+  renderer.GetCommandBuffer().CopyState(*m_buffers[ranges - 1]);
+  #else
+  GameObject::Draw();
+  #endif
+}
+
+void Engine::ParallelGroup::Draw() {
+  DrawChildren(Game::getInstance().GetRenderer());
+}
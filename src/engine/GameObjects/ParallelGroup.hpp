@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_PARALLELGROUP
+#define ENGINE_PARALLELGROUP
+
+#include "../GameObject.hpp"
+#include "../Graphics/CommandBuffer.hpp"
+#include <memory>
+#include <vector>
+
+#ifdef ENGINE_THREADING
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Engine::Graphics {
+  class Renderer;
+}
+
+namespace Engine {
+
+  /**
+   * @brief A game object that draws its children on worker threads
+   *
+   * The enabled children are split into even ranges, and each range is drawn
+   * on its own thread into its own `Graphics::CommandBuffer`. The calling
+   * thread draws the first range, and the group keeps its worker threads
+   * from one frame to the next. The buffers are submitted to the renderer in
+   * order once every thread is done, so the result is the same as drawing the
+   * children one after the other.
+   *
+   * Every range starts with the shader, material, textures and layer the
+   * group was drawn with, so children should set the state they draw with
+   * instead of relying on the state left by their previous sibling.
+   *
+   * Threads are only used when the engine is built with `ENGINE_THREADING`
+   * (`carp build -c -l -t`, or `"threading": true` in tableconf.json).
+   * Otherwise the children are drawn on the calling thread. Threaded builds
+   * need the page to be served with the COOP and COEP headers (see
+   * docs/1.2_CLI.md), which the `carp dev` server does not send.
+   *
+   * @warning The `Draw` of every child runs on a worker thread, so it must
+   * only record draws (through the renderer) and not use JavaScript, the
+   * DOM, or GL directly. Children must not draw into shared state without
+   * synchronization.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class Forest : public Scene {
+   *   public:
+   *   ParallelGroup trees;
+   *
+   *   Forest() : Scene("Forest"), trees("Trees", 4) {
+   *     for (int i = 0; i < 10000; i++)
+   *       trees.AddChild(new Tree());
+   *     AddChild(&trees);
+   *   }
+   * };
+   * ```
+   */
+  class ParallelGroup : public GameObject {
+    private:
+    unsigned m_threadCount;
+    std::vector<std::unique_ptr<Graphics::CommandBuffer>> m_buffers;
+
+    #ifdef ENGINE_THREADING
+    /**
+     * @brief The work of a frame, shared with the worker threads
+     */
+    struct Frame {
+      Graphics::Renderer* renderer;
+      std::vector<Node*> children;
+      size_t ranges;
+    };
+
+    Frame m_frame;
+    std::vector<std::thread> m_workers;
+    std::mutex m_workerMutex;
+    std::condition_variable m_frameStarted;
+    std::condition_variable m_frameDone;
+    unsigned long m_frameNumber = 0;
+    size_t m_workersLeft = 0;
+    bool m_stopping = false;
+
+    /**
+     * @brief Starts a worker for every range but the first
+     */
+    void StartWorkers();
+
+    /**
+     * @brief Stops and joins the workers
+     */
+    void StopWorkers();
+
+    /**
+     * @brief Waits for the frames after `frameNumber`, and draws one range of
+     * each
+     */
+    void RunWorker(size_t range, unsigned long frameNumber);
+
+    /**
+     * @brief Draws a range of the children into its buffer
+     */
+    void DrawRange(size_t range);
+    #endif
+
+    public:
+
+    /**
+     * @brief Default constructor
+     *
+     * @param name The name of the group
+     * @param threadCount The amount of threads drawing the children
+     */
+    ParallelGroup(std::string name, unsigned threadCount = 4);
+
+    /**
+     * @brief Stops the worker threads
+     */
+    ~ParallelGroup();
+
+    /**
+     * @brief Sets the amount of threads drawing the children
+     *
+     * The workers are started again the next time the group is drawn.
+     */
+    void SetThreadCount(unsigned threadCount);
+
+    /**
+     * @brief Returns the amount of threads drawing the children
+     */
+    unsigned GetThreadCount();
+
+    /**
+     * @brief Draws the children on the worker threads, recording into a
+     * renderer
+     *
+     * `Draw` calls this with the renderer of the game.
+     */
+    void DrawChildren(Graphics::Renderer& renderer);
+
+    /**
+     * @brief Draws the children on the worker threads
+     */
+    void Draw() override;
+  };
+}
+
+#endif
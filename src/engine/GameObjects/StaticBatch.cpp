@@ -0,0 +1,169 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "StaticBatch.hpp"
+#include "../Game.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+Engine::StaticBatch::StaticBatch(std::string name) :
+  Engine::GameObject(name) {
+  SetDrawsChildren(true);
+}
+
+Engine::StaticBatch::Group* Engine::StaticBatch::FindGroup(MeshObject* child) {
+  for (Group& group : m_groups)
+    if (std::find(group.members.begin(), group.members.end(), child)
+      != group.members.end())
+      return &group;
+
+  return nullptr;
+}
+
+void Engine::StaticBatch::Bake(Group& group) {
+  std::vector<Graphics::Vertex> baked;
+
+  for (; group.bakedMembers < group.members.size(); group.bakedMembers++) {
+    MeshObject* member = group.members[group.bakedMembers];
+    Graphics::Mesh* mesh = member->GetMesh();
+
+    if (!member->IsEnabled())
+      continue;
+
+    if (!mesh->HasCPUData()) {
+      std::cerr << "ERROR: " << member->m_name << " can not be batched since "
+        << "its mesh data was released" << std::endl;
+      continue;
+    }
+
+    float m[16];
+    ComposeTransform(member->GetLocalTransform(), m);
+
+    // Transform the vertices into the space of the batch
+    Graphics::Vertex* vertices = (Graphics::Vertex*)mesh->GetVertices();
+    unsigned long vertexCount = mesh->GetVertexCount();
+    baked.resize(vertexCount);
+
+    for (unsigned long i = 0; i < vertexCount; i++) {
+      Graphics::Vertex v = vertices[i];
+
+      baked[i] = v;
+      baked[i].x = m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12];
+      baked[i].y = m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13];
+      baked[i].z = m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14];
+
+      // Normals follow the same rule as the default vertex shader
+      float nx = m[0] * v.nx + m[4] * v.ny + m[8] * v.nz;
+      float ny = m[1] * v.nx + m[5] * v.ny + m[9] * v.nz;
+      float nz = m[2] * v.nx + m[6] * v.ny + m[10] * v.nz;
+      float length = sqrtf(nx * nx + ny * ny + nz * nz);
+
+      if (length > 0.0f) {
+        baked[i].nx = nx / length;
+        baked[i].ny = ny / length;
+        baked[i].nz = nz / length;
+      }
+    }
+
+    // Split into a new chunk once the current one runs out of indices
+    if (group.chunks.empty() || group.chunks.back()->AddGeometry(baked.data(),
+      vertexCount, mesh->GetIndices(), mesh->GetIndexCount()) != SUCCESS) {
+      group.chunks.push_back(std::make_unique<Chunk>());
+      group.chunks.back()->AddGeometry(baked.data(), vertexCount,
+        mesh->GetIndices(), mesh->GetIndexCount());
+    }
+  }
+}
+
+void Engine::StaticBatch::Rebuild() {
+  for (Group& group : m_groups) {
+    group.chunks.clear();
+    group.bakedMembers = 0;
+  }
+}
+
+size_t Engine::StaticBatch::GetDrawCount() {
+  size_t draws = 0;
+  for (Group& group : m_groups)
+    draws += group.chunks.size();
+
+  return draws;
+}
+
+void Engine::StaticBatch::OnChildAdded(Node* child) {
+  Node::OnChildAdded(child);
+
+  MeshObject* object = dynamic_cast<MeshObject*>(child);
+  if (object == nullptr || !object->Static)
+    return;
+
+  m_batched.insert(child);
+
+  for (Group& group : m_groups) {
+    if (group.material == object->GetMaterial()
+      && group.texture == object->GetTexture()) {
+      group.members.push_back(object);
+      return;
+    }
+  }
+
+  m_groups.push_back({object->GetMaterial(), object->GetTexture(), {object}, 0,
+    {}});
+}
+
+void Engine::StaticBatch::OnChildRemoved(Node* child) {
+  Node::OnChildRemoved(child);
+
+  if (m_batched.erase(child) == 0)
+    return;
+
+  MeshObject* object = (MeshObject*)child;
+  Group* group = FindGroup(object);
+  if (group == nullptr)
+    return;
+
+  std::erase(group->members, object);
+  group->chunks.clear();
+  group->bakedMembers = 0;
+
+  if (group->members.empty())
+    m_groups.erase(m_groups.begin() + (group - m_groups.data()));
+}
+
+void Engine::StaticBatch::DrawBatches(Graphics::Renderer& renderer) {
+  for (Group& group : m_groups) {
+    if (group.bakedMembers < group.members.size())
+      Bake(group);
+
+    if (group.material != nullptr)
+      renderer.UseMaterial(group.material);
+    else
+      renderer.UseShader(Graphics::DefaultShader());
+
+    if (group.texture != nullptr)
+      renderer.UseTexture(*group.texture, GL_TEXTURE0);
+
+    for (std::unique_ptr<Chunk>& chunk : group.chunks)
+      renderer.DrawMesh(chunk.get(), GetWorldMatrix());
+  }
+}
+
+void Engine::StaticBatch::Draw() {
+  DrawBatches(Game::getInstance().GetRenderer());
+
+  for (size_t i = 0; i < GetChildCount(); i++) {
+    Node* child = GetChild(i);
+    if (!child->IsEnabled() || child->IsDestroyed())
+      continue;
+
+    // Batched children only draw their own children
+    if (m_batched.contains(child))
+      child->Node::Draw();
+    else
+      child->Draw();
+  }
+}
@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_STATICBATCH
+#define ENGINE_STATICBATCH
+
+#include "MeshObject.hpp"
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace Engine::Graphics {
+  class Renderer;
+}
+
+namespace Engine {
+
+  /**
+   * @brief A game object that merges its static children into a few draws
+   *
+   * Every child `MeshObject` marked as `Static` is baked into a merged mesh
+   * shared with the other static children that use the same material and
+   * texture. Each merged mesh is drawn in a single draw call. Meshes only hold
+   * up to 65536 vertices, so a group is split into more meshes when it goes
+   * over that limit.
+   *
+   * The children are baked the first time the batch is drawn. Adding a static
+   * child only appends it to the merged meshes of its group, and removing one
+   * rebuilds only the group it belonged to. Children that are not static are
+   * drawn as usual.
+   *
+   * @warning Static children are baked with their position, scale and
+   * rotation relative to the batch. If you move, enable or disable one, call
+   * `Rebuild()`.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class Level : public Scene {
+   *   public:
+   *   Graphics::Cube mesh;
+   *   StaticBatch batch;
+   *   std::vector<MeshObject*> walls;
+   *
+   *   Level() : Scene("Level"), batch("Walls") {
+   *     for (int i = 0; i < 100; i++) {
+   *       MeshObject* wall = new MeshObject("Wall", &mesh);
+   *       wall->SetPosition({(float)i, 0, 10});
+   *       wall->Static = true;
+   *       batch.AddChild(wall);
+   *     }
+   *     AddChild(&batch);
+   *   }
+   * };
+   * ```
+   */
+  class StaticBatch : public GameObject {
+    private:
+
+    /**
+     * @brief A mesh that geometry can be appended to
+     */
+    class Chunk : public Graphics::Mesh {
+      public:
+      using Graphics::Mesh::AddGeometry;
+    };
+
+    /**
+     * @brief The static children that share a material and texture
+     */
+    struct Group {
+      Graphics::Material* material;
+      Graphics::Texture* texture;
+      std::vector<MeshObject*> members;
+      size_t bakedMembers;
+      std::vector<std::unique_ptr<Chunk>> chunks;
+    };
+
+    std::vector<Group> m_groups;
+    std::unordered_set<Node*> m_batched;
+
+    /**
+     * @brief Returns the group of the child if it is batched, or null
+     */
+    Group* FindGroup(MeshObject* child);
+
+    /**
+     * @brief Appends the members that were not baked yet to the chunks
+     */
+    void Bake(Group& group);
+
+    public:
+
+    /**
+     * @brief Default constructor
+     *
+     * @param name The name of the batch
+     */
+    StaticBatch(std::string name);
+
+    /**
+     * @brief Bakes every static child again
+     */
+    void Rebuild();
+
+    /**
+     * @brief Returns the amount of draw calls used by the static children
+     */
+    size_t GetDrawCount();
+
+    /**
+     * @brief Adds the child to its group if it is a static mesh object
+     */
+    void OnChildAdded(Node* child) override;
+
+    /**
+     * @brief Removes the child from its group, and rebuilds the group
+     */
+    void OnChildRemoved(Node* child) override;
+
+    /**
+     * @brief Bakes the static children if needed, and draws the merged meshes
+     * with a renderer
+     *
+     * `Draw` calls this with the renderer of the game. The children that are
+     * not batched are not drawn.
+     */
+    void DrawBatches(Graphics::Renderer& renderer);
+
+    /**
+     * @brief Draws the merged meshes and the children that are not batched
+     */
+    void Draw() override;
+  };
+}
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "Backend.hpp"
+#include "GLBackend.hpp"
+#include "RecordingBackend.hpp"
+#include "StateCache.hpp"
+#include <GLES3/gl3.h>
+
+static Engine::Graphics::Backend* s_backend = nullptr;
+
+int Engine::Graphics::UniformComponents(unsigned type) {
+  switch (type) {
+    case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_BOOL_VEC2:
+      return 2;
+    case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_BOOL_VEC3:
+      return 3;
+    case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_BOOL_VEC4:
+    case GL_FLOAT_MAT2:
+      return 4;
+    case GL_FLOAT_MAT3:
+      return 9;
+    case GL_FLOAT_MAT4:
+      return 16;
+    default:
+      return 1;
+  }
+}
+
+Engine::Graphics::Backend& Engine::Graphics::GetBackend() {
+  if (s_backend == nullptr) {
+    #ifdef __EMSCRIPTEN__
+    static Engine::Graphics::GLBackend defaultBackend;
+    #else
+    static Engine::Graphics::RecordingBackend defaultBackend;
+    #endif
+    s_backend = &defaultBackend;
+  }
+
+  return *s_backend;
+}
+
+void Engine::Graphics::SetBackend(Engine::Graphics::Backend& backend) {
+  s_backend = &backend;
+  GetStateCache().Reset();
+}
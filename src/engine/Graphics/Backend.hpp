@@ -0,0 +1,206 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_BACKEND
+#define ENGINE_BACKEND
+
+#include "../Utils.hpp"
+#include <cstddef>
+#include <string>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief Returns the amount of components of a GL uniform type
+   *
+   * `GL_FLOAT_VEC3` has 3 components and `GL_FLOAT_MAT4` has 16.
+   */
+  int UniformComponents(unsigned type);
+
+  /**
+   * @brief The graphics API used by the engine
+   *
+   * Every call that the renderer, shaders, meshes and textures make to the
+   * GPU (and to the page hosting the canvas) goes through the backend. The
+   * calls follow OpenGL ES 3.0, and take its enums (`GL_ARRAY_BUFFER`,
+   * `GL_TRIANGLES`...), so a backend maps them one to one onto WebGL 2.
+   *
+   * The engine uses `GLBackend` on the web. `RecordingBackend` only records
+   * the calls, so the renderer can run without a GPU or a browser.
+   *
+   * @warning The backend must be set with `SetBackend` before the renderer
+   * is created, and must outlive every GPU object created with it.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::RecordingBackend backend;
+   * Engine::Graphics::SetBackend(backend);
+   *
+   * Engine::Graphics::Renderer renderer;
+   * renderer.BeginFrame();
+   * renderer.DrawMesh(&mesh);
+   * renderer.Flush();
+   *
+   * std::cout << backend.GetCommandCount() << " calls" << std::endl;
+   * ```
+   */
+  class Backend {
+    public:
+    virtual ~Backend() = default;
+
+    /**
+     * @brief Creates the context of a canvas and makes it current
+     *
+     * @param canvas the element id of the html canvas
+     * @returns if the context was created
+     */
+    virtual bool CreateContext(const char* canvas) = 0;
+
+    /**
+     * @brief Returns the size in pixels of a canvas
+     */
+    virtual void GetCanvasSize(const char* canvas, int& width,
+      int& height) = 0;
+
+    /**
+     * @brief Loads a whole file, waiting until it is loaded
+     *
+     * @param path the path of the file
+     * @param contents the string the file is written to
+     * @returns if the file was loaded
+     */
+    virtual bool ReadFile(const char* path, std::string& contents) = 0;
+
+    /**
+     * @brief Starts loading a file without waiting
+     *
+     * The state of the request becomes 1 while loading and 2 once the data
+     * is in the request. The data is allocated with `new[]`.
+     */
+    virtual void FetchFile(const char* path, AssetRequest& request) = 0;
+
+    virtual void Enable(unsigned capability) = 0;
+    virtual void Disable(unsigned capability) = 0;
+    virtual void BlendFunc(unsigned source, unsigned destination) = 0;
+    virtual void DepthMask(bool enabled) = 0;
+    virtual void FrontFace(unsigned mode) = 0;
+    virtual void Viewport(int x, int y, int width, int height) = 0;
+    virtual void ClearColor(float r, float g, float b, float a) = 0;
+    virtual void Clear(unsigned mask) = 0;
+
+    virtual unsigned CreateBuffer() = 0;
+    virtual void DeleteBuffers(int count, const unsigned* buffers) = 0;
+    virtual void BindBuffer(unsigned target, unsigned buffer) = 0;
+    virtual void BindBufferBase(unsigned target, unsigned index,
+      unsigned buffer) = 0;
+    virtual void BufferData(unsigned target, size_t size, const void* data,
+      unsigned usage) = 0;
+    virtual void BufferSubData(unsigned target, size_t offset, size_t size,
+      const void* data) = 0;
+
+    virtual unsigned CreateVertexArray() = 0;
+    virtual void DeleteVertexArrays(int count,
+      const unsigned* vertexArrays) = 0;
+    virtual void BindVertexArray(unsigned vertexArray) = 0;
+    virtual void EnableVertexAttribArray(unsigned index) = 0;
+    virtual void VertexAttribPointer(unsigned index, int size, unsigned type,
+      bool normalized, int stride, size_t offset) = 0;
+    virtual void VertexAttribDivisor(unsigned index, unsigned divisor) = 0;
+
+    virtual unsigned CreateTexture() = 0;
+    virtual void DeleteTextures(int count, const unsigned* textures) = 0;
+    virtual void ActiveTexture(unsigned unit) = 0;
+    virtual void BindTexture(unsigned target, unsigned texture) = 0;
+    virtual void TexParameter(unsigned target, unsigned name, int value) = 0;
+    virtual void TexImage2D(unsigned target, int level, int internalFormat,
+      int width, int height, unsigned format, unsigned type,
+      const void* pixels) = 0;
+    virtual void TexStorage3D(unsigned target, int levels,
+      unsigned internalFormat, int width, int height, int depth) = 0;
+    virtual void TexSubImage3D(unsigned target, int level, int x, int y, int z,
+      int width, int height, int depth, unsigned format, unsigned type,
+      const void* pixels) = 0;
+    virtual void GenerateMipmap(unsigned target) = 0;
+
+    /**
+     * @brief Creates and compiles a shader stage
+     *
+     * @param type `GL_VERTEX_SHADER` or `GL_FRAGMENT_SHADER`
+     * @param source the source of the stage
+     * @param length the length of the source
+     * @param log the string the compilation errors are written to
+     * @returns the shader, or 0 if it failed to compile
+     */
+    virtual unsigned CompileShader(unsigned type, const char* source,
+      int length, std::string& log) = 0;
+    virtual void DeleteShader(unsigned shader) = 0;
+
+    virtual unsigned CreateProgram() = 0;
+    virtual void DeleteProgram(unsigned program) = 0;
+    virtual void AttachShader(unsigned program, unsigned shader) = 0;
+    virtual void BindAttribLocation(unsigned program, unsigned index,
+      const char* name) = 0;
+
+    /**
+     * @brief Links a program
+     *
+     * @param log the string the link errors are written to
+     * @returns if the program was linked
+     */
+    virtual bool LinkProgram(unsigned program, std::string& log) = 0;
+    virtual void UseProgram(unsigned program) = 0;
+
+    virtual int GetActiveUniformCount(unsigned program) = 0;
+    virtual void GetActiveUniform(unsigned program, unsigned index,
+      std::string& name, unsigned& type, int& size) = 0;
+    virtual int GetUniformLocation(unsigned program, const char* name) = 0;
+    virtual unsigned GetUniformBlockIndex(unsigned program,
+      const char* name) = 0;
+    virtual void UniformBlockBinding(unsigned program, unsigned block,
+      unsigned binding) = 0;
+
+    /**
+     * @brief Uploads the value of a float uniform
+     *
+     * @param type the GL type of the uniform (`GL_FLOAT_MAT4`...)
+     * @param location the location of the uniform
+     * @param count the amount of array elements
+     * @param values the values of every element
+     */
+    virtual void Uniform(unsigned type, int location, int count,
+      const float* values) = 0;
+
+    /**
+     * @brief Uploads the value of an integer, boolean or sampler uniform
+     */
+    virtual void Uniform(unsigned type, int location, int count,
+      const int* values) = 0;
+
+    virtual void DrawElements(unsigned mode, int count, unsigned type,
+      size_t offset) = 0;
+    virtual void DrawElementsInstanced(unsigned mode, int count, unsigned type,
+      size_t offset, int instanceCount) = 0;
+  };
+
+  /**
+   * @brief Returns the backend used by the engine
+   *
+   * This is `GLBackend` when built with emscripten, and `RecordingBackend`
+   * otherwise, unless another one was set with `SetBackend`.
+   */
+  extern Backend& GetBackend();
+
+  /**
+   * @brief Sets the backend used by the engine
+   *
+   * The state cache is reset, as it does not know the state of the new
+   * backend.
+   */
+  extern void SetBackend(Backend& backend);
+}
+
+#endif
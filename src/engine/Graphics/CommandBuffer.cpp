@@ -0,0 +1,189 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "CommandBuffer.hpp"
+#include "Material.hpp"
+#include <GLES3/gl3.h>
+#include <cstring>
+#include <iostream>
+
+Engine::Graphics::CommandBuffer::CommandBuffer() :
+  m_currentShader(&DefaultShader()) {
+  // Identity until the first frame begins
+  memset(m_view, 0, sizeof(m_view));
+  m_view[0] = m_view[5] = m_view[10] = m_view[15] = 1.0f;
+}
+
+void Engine::Graphics::CommandBuffer::Begin(const float* view) {
+  memcpy(m_view, view, sizeof(m_view));
+  m_commands.clear();
+  m_instanceData.clear();
+  m_parameterData.clear();
+  m_lastSnapshot = nullptr;
+}
+
+void Engine::Graphics::CommandBuffer::CopyState(const CommandBuffer& other) {
+  m_currentShader = other.m_currentShader;
+  m_currentMaterial = other.m_currentMaterial;
+  memcpy(m_currentTextures, other.m_currentTextures, sizeof(m_currentTextures));
+  m_layer = other.m_layer;
+}
+
+void Engine::Graphics::CommandBuffer::UseShader(Shader& shader) {
+  m_currentShader = &shader;
+  m_currentMaterial = nullptr;
+}
+
+void Engine::Graphics::CommandBuffer::UseMaterial(Material* material) {
+  UseShader(*material->GetShader());
+  m_currentMaterial = material;
+}
+
+void Engine::Graphics::CommandBuffer::UseTexture(Texture& texture,
+  unsigned int textureSlot) {
+  unsigned int slot = textureSlot - GL_TEXTURE0;
+  if (slot >= MAX_TEXTURE_SLOTS) {
+    std::cerr << "ERROR: Texture slot " << slot << " is not supported"
+      << std::endl;
+    return;
+  }
+
+  m_currentTextures[slot] = &texture;
+}
+
+void Engine::Graphics::CommandBuffer::SetLayer(unsigned char layer) {
+  m_layer = layer & 0x7F;
+}
+
+void Engine::Graphics::CommandBuffer::DrawMesh(Mesh* mesh, Vec3f position,
+  Vec3f scale, Vec3f rotation) {
+  DrawMesh(mesh, position, scale, Quatf::FromEuler(rotation));
+}
+
+void Engine::Graphics::CommandBuffer::DrawMesh(Mesh* mesh, Vec3f position,
+  Vec3f scale, Quatf rotation) {
+  // Object Transformation Matrix
+  float transform[16];
+  ComposeMatrix(position, rotation, scale, transform);
+  DrawMesh(mesh, transform);
+}
+
+void Engine::Graphics::CommandBuffer::DrawMesh(Mesh* mesh,
+  const float* transform) {
+  DrawCommand command;
+  command.mesh = mesh;
+  command.drawable = nullptr;
+  command.instanceOffset = 0;
+  command.instanceCount = 0;
+  memcpy(command.transform, transform, sizeof(command.transform));
+
+  command.material = m_currentMaterial;
+  memcpy(command.textures, m_currentTextures, sizeof(command.textures));
+  Record(command, m_currentShader, m_currentMaterial != nullptr
+    && m_currentMaterial->IsTransparent());
+}
+
+void Engine::Graphics::CommandBuffer::DrawMeshInstanced(Mesh* mesh,
+  std::span<const Transform> instances) {
+  if (instances.empty())
+    return;
+
+  DrawCommand command;
+  command.mesh = mesh;
+  command.drawable = nullptr;
+  command.instanceOffset = m_instanceData.size() / 16;
+  command.instanceCount = instances.size();
+
+  m_instanceData.resize(m_instanceData.size() + instances.size() * 16);
+  float* matrices = &m_instanceData[command.instanceOffset * 16];
+  for (size_t i = 0; i < instances.size(); i++)
+    ComposeTransform(instances[i], &matrices[i * 16]);
+
+  // The first instance is used to sort the draw
+  memcpy(command.transform, matrices, sizeof(command.transform));
+
+  Shader* shader = m_currentShader == &DefaultShader() ? &InstancedShader()
+    : m_currentShader;
+
+  command.material = m_currentMaterial;
+  memcpy(command.textures, m_currentTextures, sizeof(command.textures));
+  Record(command, shader, m_currentMaterial != nullptr
+    && m_currentMaterial->IsTransparent());
+}
+
+void Engine::Graphics::CommandBuffer::SubmitDrawable(QueueDrawable* drawable,
+  unsigned int batch, Shader& shader, Vec3f position, bool transparent) {
+  DrawCommand command;
+  command.mesh = nullptr;
+  command.drawable = drawable;
+  command.drawableBatch = batch;
+  command.instanceOffset = 0;
+  command.instanceCount = 0;
+
+  ComposeTransform({position}, command.transform);
+
+  // Drawables bind their own parameters and textures
+  command.material = nullptr;
+  for (unsigned slot = 0; slot < MAX_TEXTURE_SLOTS; slot++)
+    command.textures[slot] = nullptr;
+
+  Record(command, &shader, transparent);
+}
+
+void Engine::Graphics::CommandBuffer::SnapshotMaterial(DrawCommand& command) {
+  command.parameterOffset = 0;
+  command.parameterSize = 0;
+  if (command.material == nullptr)
+    return;
+
+  size_t size = command.material->GetSnapshotSize();
+  size_t offset = m_parameterData.size();
+  m_parameterData.resize(offset + size);
+  command.material->Snapshot(&m_parameterData[offset]);
+
+  if (command.material == m_lastSnapshot
+    && offset - m_lastSnapshotOffset == size
+    && memcmp(&m_parameterData[m_lastSnapshotOffset], &m_parameterData[offset],
+      size) == 0) {
+    m_parameterData.resize(offset);
+    offset = m_lastSnapshotOffset;
+  }
+
+  m_lastSnapshot = command.material;
+  m_lastSnapshotOffset = offset;
+  command.parameterOffset = offset;
+  command.parameterSize = size;
+}
+
+void Engine::Graphics::CommandBuffer::Record(DrawCommand& command,
+  Shader* shader, bool transparent) {
+  command.shader = shader;
+  SnapshotMaterial(command);
+
+  // The projection maps the view z from 0 to 200 into clip space
+  const float* position = &command.transform[12];
+  float depth = (m_view[2] * position[0] + m_view[6] * position[1]
+    + m_view[10] * position[2] + m_view[14]) / 200.0f;
+
+  command.key = RenderQueue::MakeKey(m_layer, transparent, shader,
+    command.material, command.textures[0], depth);
+
+  m_commands.push_back(command);
+}
+
+const std::vector<Engine::Graphics::DrawCommand>&
+  Engine::Graphics::CommandBuffer::GetCommands() {
+  return m_commands;
+}
+
+const std::vector<float>& Engine::Graphics::CommandBuffer::GetInstanceData() {
+  return m_instanceData;
+}
+
+const std::vector<unsigned char>&
+  Engine::Graphics::CommandBuffer::GetParameterData() {
+  return m_parameterData;
+}
@@ -0,0 +1,156 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_COMMANDBUFFER
+#define ENGINE_COMMANDBUFFER
+
+#include "RenderQueue.hpp"
+#include "Shader.hpp"
+#include "../Utils.hpp"
+#include <span>
+#include <vector>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief Records draws without touching the GL context
+   *
+   * A command buffer keeps its own current shader, material, textures and
+   * layer, and turns every draw into a sorted `DrawCommand`. Recording only
+   * writes into the buffer, so a buffer can be recorded on any thread. Once
+   * recorded, the buffer is submitted to the renderer, which merges every
+   * buffer of the frame into its render queue and executes them on the GL
+   * thread.
+   *
+   * The renderer records into its own buffer by default. Draws made through
+   * `Renderer` (such as `DrawMesh`) go into the buffer that the calling thread
+   * is recording, see `Renderer::BeginRecording`.
+   *
+   * @warning Meshes, shaders, materials, textures and drawables must stay
+   * alive until the renderer is flushed.
+   */
+  class CommandBuffer {
+    private:
+    Shader* m_currentShader;
+    Material* m_currentMaterial = nullptr;
+    Texture* m_currentTextures[MAX_TEXTURE_SLOTS] = {nullptr};
+    unsigned char m_layer = 0;
+
+    float m_view[16];
+
+    std::vector<DrawCommand> m_commands;
+    std::vector<float> m_instanceData;
+    std::vector<unsigned char> m_parameterData;
+
+    Material* m_lastSnapshot = nullptr;
+    unsigned int m_lastSnapshotOffset = 0;
+
+    /**
+     * @brief Stores the parameter values of the current material for the
+     * command
+     *
+     * Draws in a row with the same values share their snapshot.
+     */
+    void SnapshotMaterial(DrawCommand& command);
+
+    /**
+     * @brief Computes the sort key of the command and stores it
+     */
+    void Record(DrawCommand& command, Shader* shader, bool transparent);
+
+    public:
+
+    /**
+     * @brief Creates an empty buffer using the default shader
+     */
+    CommandBuffer();
+
+    /**
+     * @brief Clears the buffer to record a new frame
+     *
+     * The current shader, material, textures and layer are kept.
+     *
+     * @param view the view matrix of the frame, used to sort the draws
+     */
+    void Begin(const float* view);
+
+    /**
+     * @brief Takes the current shader, material, textures and layer of
+     * another buffer
+     */
+    void CopyState(const CommandBuffer& other);
+
+    /**
+     * @brief Sets the shader of the next draws
+     */
+    void UseShader(Shader& shader);
+
+    /**
+     * @brief Sets the material (and its shader) of the next draws
+     */
+    void UseMaterial(Material* material);
+
+    /**
+     * @brief Sets the texture of a slot for the next draws
+     *
+     * @param texture the texture to use
+     * @param slot the texture unit, from `GL_TEXTURE0` to `GL_TEXTURE3`
+     */
+    void UseTexture(Texture& texture, unsigned int slot);
+
+    /**
+     * @brief Sets the layer of the next draws (0 to 127)
+     */
+    void SetLayer(unsigned char layer);
+
+    /**
+     * @brief Records a draw of a mesh, see `Renderer::DrawMesh`
+     */
+    void DrawMesh(Mesh* mesh, Vec3f position, Vec3f scale, Vec3f rotation);
+
+    /**
+     * @brief Records a draw of a mesh with a quaternion rotation
+     */
+    void DrawMesh(Mesh* mesh, Vec3f position, Vec3f scale, Quatf rotation);
+
+    /**
+     * @brief Records a draw of a mesh with a transformation matrix
+     */
+    void DrawMesh(Mesh* mesh, const float* transform);
+
+    /**
+     * @brief Records an instanced draw, see `Renderer::DrawMeshInstanced`
+     */
+    void DrawMeshInstanced(Mesh* mesh, std::span<const Transform> instances);
+
+    /**
+     * @brief Records a drawable, see `Renderer::SubmitDrawable`
+     */
+    void SubmitDrawable(QueueDrawable* drawable, unsigned int batch,
+      Shader& shader, Vec3f position, bool transparent);
+
+    /**
+     * @brief Returns the commands recorded since `Begin`
+     *
+     * The instance offsets of the commands refer to `GetInstanceData()`.
+     */
+    const std::vector<DrawCommand>& GetCommands();
+
+    /**
+     * @brief Returns the instance matrices recorded since `Begin`
+     */
+    const std::vector<float>& GetInstanceData();
+
+    /**
+     * @brief Returns the material parameter values recorded since `Begin`
+     *
+     * The parameter offsets of the commands refer to this data.
+     */
+    const std::vector<unsigned char>& GetParameterData();
+  };
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FrameConstants.hpp"
+#include "Backend.hpp"
+#include "StateCache.hpp"
+#include <GLES3/gl3.h>
+#include <cstring>
+#include <utility>
+
+Engine::Graphics::FrameConstants::FrameConstants() {
+  memset(&m_data, 0, sizeof(m_data));
+}
+
+Engine::Graphics::FrameConstants& Engine::Graphics::FrameConstants::operator=(
+  FrameConstants&& other) {
+  // The buffer is swapped so the other one deletes the old buffer
+  std::swap(m_buffer, other.m_buffer);
+  m_data = other.m_data;
+  return *this;
+}
+
+Engine::Graphics::FrameConstants::~FrameConstants() {
+  if (m_buffer != 0)
+    GetStateCache().DeleteBuffers(1, &m_buffer);
+}
+
+void Engine::Graphics::FrameConstants::Update(Camera& camera, float width,
+  float height) {
+  float FOV = camera.getFOV();
+
+  // View Matrix, rotated directly by the quaternion of the camera
+  Vec3f camPos = camera.GetGlobalPosition();
+  Mat4f view = camera.GetGlobalRotation().ToMat4()
+    * Mat4f::Scaling({1.0f / FOV, 1.0f / FOV, 1.0f / FOV})
+    * Mat4f::Translation(camPos / FOV);
+
+  // Projection Matrix (fit the shorter side, z from [0, 200] to [-1, 1])
+  Mat4f projection = Mat4f::Identity();
+  if (height < width)
+    projection.m[0] = height / width;
+  else if (height > 0)
+    projection.m[5] = width / height;
+  projection.m[10] = 1.0f / 100.0f;
+  projection.m[14] = -1.0f;
+
+  Mat4f viewProjection = projection * view;
+
+  memcpy(m_data.View, view.m, sizeof(m_data.View));
+  memcpy(m_data.Projection, projection.m, sizeof(m_data.Projection));
+  memcpy(m_data.ViewProjection, viewProjection.m,
+    sizeof(m_data.ViewProjection));
+  m_data.Window[0] = width;
+  m_data.Window[1] = height;
+}
+
+void Engine::Graphics::FrameConstants::Upload() {
+  if (m_buffer == 0) {
+    m_buffer = GetBackend().CreateBuffer();
+    GetStateCache().BindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    GetBackend().BufferData(GL_UNIFORM_BUFFER, sizeof(m_data), &m_data,
+      GL_DYNAMIC_DRAW);
+  } else {
+    GetStateCache().BindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    GetBackend().BufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(m_data), &m_data);
+  }
+
+  GetStateCache().BindUniformBuffer(FRAME_CONSTANTS_BINDING, m_buffer);
+}
+
+const Engine::Graphics::FrameConstantsData&
+  Engine::Graphics::FrameConstants::GetData() {
+  return m_data;
+}
@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_FRAMECONSTANTS
+#define ENGINE_FRAMECONSTANTS
+
+#include "../GameObjects/Camera.hpp"
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The uniform buffer binding point of the `FrameConstants` block
+   */
+  constexpr unsigned FRAME_CONSTANTS_BINDING = 0;
+
+  /**
+   * @brief The contents of the `FrameConstants` uniform block
+   *
+   * The layout matches the std140 block declared in the default shaders:
+   *
+   * ```glsl
+   * layout(std140) uniform FrameConstants {
+   *   mat4 u_View;
+   *   mat4 u_Projection;
+   *   mat4 u_ViewProjection;
+   *   vec4 u_Window;
+   * };
+   * ```
+   *
+   * `u_Window` holds the width and height of the canvas in `xy`.
+   */
+  struct FrameConstantsData {
+    float View[16];
+    float Projection[16];
+    float ViewProjection[16];
+    float Window[4];
+  };
+
+  /**
+   * @brief The data shared by every draw of a frame
+   *
+   * The view, projection and window size are computed once per frame, and
+   * uploaded to a uniform buffer bound to `FRAME_CONSTANTS_BINDING`. Every
+   * shader that declares the `FrameConstants` block reads from that buffer,
+   * so the only data uploaded per draw is the model matrix.
+   *
+   * The projection does what the vertex shaders used to do by hand: it fits
+   * the shorter side of the canvas to `[-1, 1]` and maps the view z from
+   * `[0, 200]` into clip space.
+   */
+  class FrameConstants {
+    private:
+    FrameConstantsData m_data;
+    unsigned int m_buffer = 0;
+
+    public:
+
+    FrameConstants();
+    FrameConstants(const FrameConstants&) = delete;
+    FrameConstants& operator=(const FrameConstants&) = delete;
+    FrameConstants& operator=(FrameConstants&& other);
+    ~FrameConstants();
+
+    /**
+     * @brief Computes the constants of the frame
+     *
+     * @param camera the camera the frame is drawn from
+     * @param width the width of the canvas
+     * @param height the height of the canvas
+     */
+    void Update(Camera& camera, float width, float height);
+
+    /**
+     * @brief Uploads the constants and binds the buffer to its binding point
+     */
+    void Upload();
+
+    /**
+     * @brief Returns the constants of the current frame
+     */
+    const FrameConstantsData& GetData();
+  };
+}
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "Frustum.hpp"
+#include <cmath>
+
+Engine::Graphics::Frustum::Frustum() {
+  for (unsigned plane = 0; plane < PLANE_COUNT; plane++) {
+    m_a[plane] = m_b[plane] = m_c[plane] = 0.0f;
+    m_d[plane] = 1.0f;
+  }
+}
+
+Engine::Graphics::Frustum::Frustum(const float* viewProjection) {
+  const float* m = viewProjection;
+
+  // Clip space keeps -w <= x, y, z <= w, so each plane is row 3 +- row i
+  for (unsigned plane = 0; plane < PLANE_COUNT; plane++) {
+    unsigned row = plane / 2;
+    float sign = plane % 2 == 0 ? 1.0f : -1.0f;
+    float a = m[3] + sign * m[row];
+    float b = m[7] + sign * m[4 + row];
+    float c = m[11] + sign * m[8 + row];
+    float d = m[15] + sign * m[12 + row];
+
+    // Normalized so that distances can be compared to a radius
+    float length = sqrtf(a * a + b * b + c * c);
+    if (length > 0.0f) {
+      a /= length;
+      b /= length;
+      c /= length;
+      d /= length;
+    }
+
+    m_a[plane] = a;
+    m_b[plane] = b;
+    m_c[plane] = c;
+    m_d[plane] = d;
+  }
+}
+
+bool Engine::Graphics::Frustum::IsVisible(const BoundingSphere& sphere) const {
+  const Vec3f& center = sphere.center;
+  for (unsigned plane = 0; plane < PLANE_COUNT; plane++)
+    if (m_a[plane] * center.x + m_b[plane] * center.y + m_c[plane] * center.z
+      + m_d[plane] < -sphere.radius)
+      return false;
+
+  return true;
+}
+
+bool Engine::Graphics::Frustum::IsVisible(const BoundingBox& box) const {
+  if (box.IsEmpty())
+    return false;
+
+  // Only the corner furthest along the normal needs to be tested
+  for (unsigned plane = 0; plane < PLANE_COUNT; plane++) {
+    float x = m_a[plane] >= 0.0f ? box.max.x : box.min.x;
+    float y = m_b[plane] >= 0.0f ? box.max.y : box.min.y;
+    float z = m_c[plane] >= 0.0f ? box.max.z : box.min.z;
+    if (m_a[plane] * x + m_b[plane] * y + m_c[plane] * z + m_d[plane] < 0.0f)
+      return false;
+  }
+
+  return true;
+}
+
+size_t Engine::Graphics::Frustum::CullSpheres(const float* x, const float* y,
+  const float* z, const float* radius, size_t count, uint8_t* visible) const {
+  size_t visibleCount = 0;
+  size_t i = 0;
+
+  #ifdef ENGINE_SIMD
+  // 4 spheres at a time against each plane
+  const v128_t zero = wasm_f32x4_splat(0.0f);
+  for (; i + 4 <= count; i += 4) {
+    v128_t cx = wasm_v128_load(&x[i]);
+    v128_t cy = wasm_v128_load(&y[i]);
+    v128_t cz = wasm_v128_load(&z[i]);
+    v128_t r = wasm_v128_load(&radius[i]);
+
+    v128_t outside = wasm_f32x4_splat(0.0f);
+    for (unsigned plane = 0; plane < PLANE_COUNT; plane++) {
+      v128_t distance = wasm_f32x4_add(wasm_f32x4_add(
+        wasm_f32x4_mul(cx, wasm_f32x4_splat(m_a[plane])),
+        wasm_f32x4_mul(cy, wasm_f32x4_splat(m_b[plane]))), wasm_f32x4_add(
+        wasm_f32x4_mul(cz, wasm_f32x4_splat(m_c[plane])),
+        wasm_f32x4_splat(m_d[plane])));
+      outside = wasm_v128_or(outside,
+        wasm_f32x4_lt(wasm_f32x4_add(distance, r), zero));
+    }
+
+    int mask = wasm_i32x4_bitmask(outside);
+    for (unsigned lane = 0; lane < 4; lane++) {
+      visible[i + lane] = (mask >> lane & 1) == 0;
+      visibleCount += visible[i + lane];
+    }
+  }
+  #endif
+
+  for (; i < count; i++) {
+    visible[i] = IsVisible(BoundingSphere{{x[i], y[i], z[i]}, radius[i]});
+    visibleCount += visible[i];
+  }
+
+  return visibleCount;
+}
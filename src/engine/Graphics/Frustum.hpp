@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_FRUSTUM
+#define ENGINE_FRUSTUM
+
+#include "../Utils.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The volume seen by a camera, as 6 planes facing inwards
+   *
+   * The planes are extracted from a view projection matrix, so the frustum
+   * follows whatever projection the camera uses. Bounds are tested against
+   * every plane, and anything fully behind one of them is not visible.
+   *
+   * `CullSpheres` tests many spheres at once, 4 at a time with wasm SIMD
+   * when the engine is compiled with `-msimd128`. The renderer uses it to
+   * drop the draws outside of the view before they reach the GPU.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::Frustum frustum(frameConstants.GetData().ViewProjection);
+   * BoundingSphere sphere = mesh.GetBoundingSphere().Transformed(world);
+   * if (frustum.IsVisible(sphere))
+   *   renderer.DrawMesh(&mesh, world);
+   * ```
+   */
+  class Frustum {
+    private:
+    static constexpr unsigned PLANE_COUNT = 6;
+
+    // Plane i keeps the points where a * x + b * y + c * z + d >= 0
+    float m_a[PLANE_COUNT];
+    float m_b[PLANE_COUNT];
+    float m_c[PLANE_COUNT];
+    float m_d[PLANE_COUNT];
+
+    public:
+
+    /**
+     * @brief Creates a frustum that contains everything
+     */
+    Frustum();
+
+    /**
+     * @brief Extracts the planes of a view projection matrix
+     *
+     * @param viewProjection a column-major matrix with OpenGL clip space
+     */
+    Frustum(const float* viewProjection);
+
+    /**
+     * @brief Returns true if part of the sphere may be visible
+     */
+    bool IsVisible(const BoundingSphere& sphere) const;
+
+    /**
+     * @brief Returns true if part of the box may be visible
+     */
+    bool IsVisible(const BoundingBox& box) const;
+
+    /**
+     * @brief Tests many spheres given as one array per component
+     *
+     * Spheres with an infinite radius are always visible.
+     *
+     * @param x the x of the centers
+     * @param y the y of the centers
+     * @param z the z of the centers
+     * @param radius the radius of each sphere
+     * @param count the amount of spheres
+     * @param visible set to 1 for the visible spheres and 0 for the others
+     * @return the amount of visible spheres
+     */
+    size_t CullSpheres(const float* x, const float* y, const float* z,
+      const float* radius, size_t count, uint8_t* visible) const;
+  };
+}
+
+#endif
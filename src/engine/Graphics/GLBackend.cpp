@@ -0,0 +1,378 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "GLBackend.hpp"
+
+// Native builds (such as the headless benchmarks) have no WebGL to talk to
+#ifdef __EMSCRIPTEN__
+
+#include <GLES3/gl3.h>
+#include <emscripten.h>
+#include <emscripten/html5.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+bool Engine::Graphics::GLBackend::CreateContext(const char* canvas) {
+  EmscriptenWebGLContextAttributes attrs;
+  emscripten_webgl_init_context_attributes(&attrs);
+  attrs.alpha = EM_TRUE;
+  attrs.depth = EM_TRUE;
+  attrs.stencil = EM_FALSE;
+  attrs.antialias = EM_TRUE;
+  attrs.majorVersion = 2;
+
+  // Generate the WebGL Context
+  EMSCRIPTEN_WEBGL_CONTEXT_HANDLE context =
+    emscripten_webgl_create_context(canvas, &attrs);
+  if (context <= 0) {
+    std::cerr << "ERROR: Failed to create a WebGL 2 context for " << canvas
+      << std::endl;
+    return false;
+  }
+
+  emscripten_webgl_make_context_current(context);
+
+  EM_ASM({
+    game.canvases[UTF8ToString($0)] = document.getElementById(UTF8ToString($0));
+    game.gl[UTF8ToString($0)] = game.canvases[UTF8ToString($0)]
+      .getContext("webgl2");
+  }, canvas);
+
+  return true;
+}
+
+void Engine::Graphics::GLBackend::GetCanvasSize(const char* canvas,
+  int& width, int& height) {
+  emscripten_get_canvas_element_size(canvas, &width, &height);
+}
+
+bool Engine::Graphics::GLBackend::ReadFile(const char* path,
+  std::string& contents) {
+  char* data = nullptr;
+  int size = 0, error = 0;
+
+  emscripten_wget_data(path, (void**)&data, &size, &error);
+  if (error != 0 || data == nullptr)
+    return false;
+
+  contents.assign(data, size);
+  free(data);
+  return true;
+}
+
+void Engine::Graphics::GLBackend::FetchFile(const char* path,
+  AssetRequest& request) {
+  request.req_state = 1;
+  emscripten_async_wget_data(path, (void*)&request,
+    [](void* arg, void* d, int s) {
+      AssetRequest* req = (AssetRequest*)arg;
+      req->data = new unsigned char[s];
+      memcpy((void*)req->data, d, s);
+      req->size = s;
+      req->req_state = 2;
+    }, [](void* arg) {
+      // The request ends without data so the asset can report the failure
+      AssetRequest* req = (AssetRequest*)arg;
+      req->data = nullptr;
+      req->size = 0;
+      req->req_state = 2;
+    });
+}
+
+void Engine::Graphics::GLBackend::Enable(unsigned capability) {
+  glEnable(capability);
+}
+
+void Engine::Graphics::GLBackend::Disable(unsigned capability) {
+  glDisable(capability);
+}
+
+void Engine::Graphics::GLBackend::BlendFunc(unsigned source,
+  unsigned destination) {
+  glBlendFunc(source, destination);
+}
+
+void Engine::Graphics::GLBackend::DepthMask(bool enabled) {
+  glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void Engine::Graphics::GLBackend::FrontFace(unsigned mode) {
+  glFrontFace(mode);
+}
+
+void Engine::Graphics::GLBackend::Viewport(int x, int y, int width,
+  int height) {
+  glViewport(x, y, width, height);
+}
+
+void Engine::Graphics::GLBackend::ClearColor(float r, float g, float b,
+  float a) {
+  glClearColor(r, g, b, a);
+}
+
+void Engine::Graphics::GLBackend::Clear(unsigned mask) {
+  glClear(mask);
+}
+
+unsigned Engine::Graphics::GLBackend::CreateBuffer() {
+  unsigned buffer = 0;
+  glGenBuffers(1, &buffer);
+  return buffer;
+}
+
+void Engine::Graphics::GLBackend::DeleteBuffers(int count,
+  const unsigned* buffers) {
+  glDeleteBuffers(count, buffers);
+}
+
+void Engine::Graphics::GLBackend::BindBuffer(unsigned target,
+  unsigned buffer) {
+  glBindBuffer(target, buffer);
+}
+
+void Engine::Graphics::GLBackend::BindBufferBase(unsigned target,
+  unsigned index, unsigned buffer) {
+  glBindBufferBase(target, index, buffer);
+}
+
+void Engine::Graphics::GLBackend::BufferData(unsigned target, size_t size,
+  const void* data, unsigned usage) {
+  glBufferData(target, size, data, usage);
+}
+
+void Engine::Graphics::GLBackend::BufferSubData(unsigned target,
+  size_t offset, size_t size, const void* data) {
+  glBufferSubData(target, offset, size, data);
+}
+
+unsigned Engine::Graphics::GLBackend::CreateVertexArray() {
+  unsigned vertexArray = 0;
+  glGenVertexArrays(1, &vertexArray);
+  return vertexArray;
+}
+
+void Engine::Graphics::GLBackend::DeleteVertexArrays(int count,
+  const unsigned* vertexArrays) {
+  glDeleteVertexArrays(count, vertexArrays);
+}
+
+void Engine::Graphics::GLBackend::BindVertexArray(unsigned vertexArray) {
+  glBindVertexArray(vertexArray);
+}
+
+void Engine::Graphics::GLBackend::EnableVertexAttribArray(unsigned index) {
+  glEnableVertexAttribArray(index);
+}
+
+void Engine::Graphics::GLBackend::VertexAttribPointer(unsigned index,
+  int size, unsigned type, bool normalized, int stride, size_t offset) {
+  glVertexAttribPointer(index, size, type, normalized ? GL_TRUE : GL_FALSE,
+    stride, (void*)offset);
+}
+
+void Engine::Graphics::GLBackend::VertexAttribDivisor(unsigned index,
+  unsigned divisor) {
+  glVertexAttribDivisor(index, divisor);
+}
+
+unsigned Engine::Graphics::GLBackend::CreateTexture() {
+  unsigned texture = 0;
+  glGenTextures(1, &texture);
+  return texture;
+}
+
+void Engine::Graphics::GLBackend::DeleteTextures(int count,
+  const unsigned* textures) {
+  glDeleteTextures(count, textures);
+}
+
+void Engine::Graphics::GLBackend::ActiveTexture(unsigned unit) {
+  glActiveTexture(unit);
+}
+
+void Engine::Graphics::GLBackend::BindTexture(unsigned target,
+  unsigned texture) {
+  glBindTexture(target, texture);
+}
+
+void Engine::Graphics::GLBackend::TexParameter(unsigned target,
+  unsigned name, int value) {
+  glTexParameteri(target, name, value);
+}
+
+void Engine::Graphics::GLBackend::TexImage2D(unsigned target, int level,
+  int internalFormat, int width, int height, unsigned format, unsigned type,
+  const void* pixels) {
+  glTexImage2D(target, level, internalFormat, width, height, 0, format, type,
+    pixels);
+}
+
+void Engine::Graphics::GLBackend::TexStorage3D(unsigned target, int levels,
+  unsigned internalFormat, int width, int height, int depth) {
+  glTexStorage3D(target, levels, internalFormat, width, height, depth);
+}
+
+void Engine::Graphics::GLBackend::TexSubImage3D(unsigned target, int level,
+  int x, int y, int z, int width, int height, int depth, unsigned format,
+  unsigned type, const void* pixels) {
+  glTexSubImage3D(target, level, x, y, z, width, height, depth, format, type,
+    pixels);
+}
+
+void Engine::Graphics::GLBackend::GenerateMipmap(unsigned target) {
+  glGenerateMipmap(target);
+}
+
+unsigned Engine::Graphics::GLBackend::CompileShader(unsigned type,
+  const char* source, int length, std::string& log) {
+  unsigned shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, &length);
+  glCompileShader(shader);
+
+  int success;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+  if (!success) {
+    char infoLog[512];
+    glGetShaderInfoLog(shader, sizeof(infoLog), 0, infoLog);
+    log = infoLog;
+  }
+
+  return shader;
+}
+
+void Engine::Graphics::GLBackend::DeleteShader(unsigned shader) {
+  glDeleteShader(shader);
+}
+
+unsigned Engine::Graphics::GLBackend::CreateProgram() {
+  return glCreateProgram();
+}
+
+void Engine::Graphics::GLBackend::DeleteProgram(unsigned program) {
+  glDeleteProgram(program);
+}
+
+void Engine::Graphics::GLBackend::AttachShader(unsigned program,
+  unsigned shader) {
+  glAttachShader(program, shader);
+}
+
+void Engine::Graphics::GLBackend::BindAttribLocation(unsigned program,
+  unsigned index, const char* name) {
+  glBindAttribLocation(program, index, name);
+}
+
+bool Engine::Graphics::GLBackend::LinkProgram(unsigned program,
+  std::string& log) {
+  glLinkProgram(program);
+
+  int success;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+  if (!success) {
+    char infoLog[512];
+    glGetProgramInfoLog(program, sizeof(infoLog), 0, infoLog);
+    log = infoLog;
+  }
+
+  return success;
+}
+
+void Engine::Graphics::GLBackend::UseProgram(unsigned program) {
+  glUseProgram(program);
+}
+
+int Engine::Graphics::GLBackend::GetActiveUniformCount(unsigned program) {
+  int uniformCount = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+  return uniformCount;
+}
+
+void Engine::Graphics::GLBackend::GetActiveUniform(unsigned program,
+  unsigned index, std::string& name, unsigned& type, int& size) {
+  char buffer[128];
+  int length = 0;
+  GLenum glType = 0;
+  glGetActiveUniform(program, index, sizeof(buffer), &length, &size, &glType,
+    buffer);
+
+  name.assign(buffer, length);
+  type = glType;
+}
+
+int Engine::Graphics::GLBackend::GetUniformLocation(unsigned program,
+  const char* name) {
+  return glGetUniformLocation(program, name);
+}
+
+unsigned Engine::Graphics::GLBackend::GetUniformBlockIndex(unsigned program,
+  const char* name) {
+  return glGetUniformBlockIndex(program, name);
+}
+
+void Engine::Graphics::GLBackend::UniformBlockBinding(unsigned program,
+  unsigned block, unsigned binding) {
+  glUniformBlockBinding(program, block, binding);
+}
+
+void Engine::Graphics::GLBackend::Uniform(unsigned type, int location,
+  int count, const float* values) {
+  switch (type) {
+    case GL_FLOAT:
+      glUniform1fv(location, count, values);
+      break;
+    case GL_FLOAT_VEC2:
+      glUniform2fv(location, count, values);
+      break;
+    case GL_FLOAT_VEC3:
+      glUniform3fv(location, count, values);
+      break;
+    case GL_FLOAT_VEC4:
+      glUniform4fv(location, count, values);
+      break;
+    case GL_FLOAT_MAT2:
+      glUniformMatrix2fv(location, count, GL_FALSE, values);
+      break;
+    case GL_FLOAT_MAT3:
+      glUniformMatrix3fv(location, count, GL_FALSE, values);
+      break;
+    case GL_FLOAT_MAT4:
+      glUniformMatrix4fv(location, count, GL_FALSE, values);
+      break;
+  }
+}
+
+void Engine::Graphics::GLBackend::Uniform(unsigned type, int location,
+  int count, const int* values) {
+  switch (UniformComponents(type)) {
+    case 1:
+      glUniform1iv(location, count, values);
+      break;
+    case 2:
+      glUniform2iv(location, count, values);
+      break;
+    case 3:
+      glUniform3iv(location, count, values);
+      break;
+    case 4:
+      glUniform4iv(location, count, values);
+      break;
+  }
+}
+
+void Engine::Graphics::GLBackend::DrawElements(unsigned mode, int count,
+  unsigned type, size_t offset) {
+  glDrawElements(mode, count, type, (void*)offset);
+}
+
+void Engine::Graphics::GLBackend::DrawElementsInstanced(unsigned mode,
+  int count, unsigned type, size_t offset, int instanceCount) {
+  glDrawElementsInstanced(mode, count, type, (void*)offset, instanceCount);
+}
+
+#endif
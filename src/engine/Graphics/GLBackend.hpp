@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_GLBACKEND
+#define ENGINE_GLBACKEND
+
+#include "Backend.hpp"
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The backend drawing to a WebGL 2 canvas
+   *
+   * Every call is forwarded to OpenGL ES 3.0, which emscripten maps onto the
+   * WebGL 2 context of the canvas. Files are loaded from the page with
+   * `emscripten_wget_data`.
+   *
+   * @note This backend is only compiled with emscripten.
+   */
+  class GLBackend : public Backend {
+    public:
+    bool CreateContext(const char* canvas) override;
+    void GetCanvasSize(const char* canvas, int& width, int& height) override;
+    bool ReadFile(const char* path, std::string& contents) override;
+    void FetchFile(const char* path, AssetRequest& request) override;
+
+    void Enable(unsigned capability) override;
+    void Disable(unsigned capability) override;
+    void BlendFunc(unsigned source, unsigned destination) override;
+    void DepthMask(bool enabled) override;
+    void FrontFace(unsigned mode) override;
+    void Viewport(int x, int y, int width, int height) override;
+    void ClearColor(float r, float g, float b, float a) override;
+    void Clear(unsigned mask) override;
+
+    unsigned CreateBuffer() override;
+    void DeleteBuffers(int count, const unsigned* buffers) override;
+    void BindBuffer(unsigned target, unsigned buffer) override;
+    void BindBufferBase(unsigned target, unsigned index,
+      unsigned buffer) override;
+    void BufferData(unsigned target, size_t size, const void* data,
+      unsigned usage) override;
+    void BufferSubData(unsigned target, size_t offset, size_t size,
+      const void* data) override;
+
+    unsigned CreateVertexArray() override;
+    void DeleteVertexArrays(int count, const unsigned* vertexArrays) override;
+    void BindVertexArray(unsigned vertexArray) override;
+    void EnableVertexAttribArray(unsigned index) override;
+    void VertexAttribPointer(unsigned index, int size, unsigned type,
+      bool normalized, int stride, size_t offset) override;
+    void VertexAttribDivisor(unsigned index, unsigned divisor) override;
+
+    unsigned CreateTexture() override;
+    void DeleteTextures(int count, const unsigned* textures) override;
+    void ActiveTexture(unsigned unit) override;
+    void BindTexture(unsigned target, unsigned texture) override;
+    void TexParameter(unsigned target, unsigned name, int value) override;
+    void TexImage2D(unsigned target, int level, int internalFormat, int width,
+      int height, unsigned format, unsigned type, const void* pixels) override;
+    void TexStorage3D(unsigned target, int levels, unsigned internalFormat,
+      int width, int height, int depth) override;
+    void TexSubImage3D(unsigned target, int level, int x, int y, int z,
+      int width, int height, int depth, unsigned format, unsigned type,
+      const void* pixels) override;
+    void GenerateMipmap(unsigned target) override;
+
+    unsigned CompileShader(unsigned type, const char* source, int length,
+      std::string& log) override;
+    void DeleteShader(unsigned shader) override;
+
+    unsigned CreateProgram() override;
+    void DeleteProgram(unsigned program) override;
+    void AttachShader(unsigned program, unsigned shader) override;
+    void BindAttribLocation(unsigned program, unsigned index,
+      const char* name) override;
+    bool LinkProgram(unsigned program, std::string& log) override;
+    void UseProgram(unsigned program) override;
+
+    int GetActiveUniformCount(unsigned program) override;
+    void GetActiveUniform(unsigned program, unsigned index, std::string& name,
+      unsigned& type, int& size) override;
+    int GetUniformLocation(unsigned program, const char* name) override;
+    unsigned GetUniformBlockIndex(unsigned program, const char* name) override;
+    void UniformBlockBinding(unsigned program, unsigned block,
+      unsigned binding) override;
+    void Uniform(unsigned type, int location, int count,
+      const float* values) override;
+    void Uniform(unsigned type, int location, int count,
+      const int* values) override;
+
+    void DrawElements(unsigned mode, int count, unsigned type,
+      size_t offset) override;
+    void DrawElementsInstanced(unsigned mode, int count, unsigned type,
+      size_t offset, int instanceCount) override;
+  };
+}
+
+#endif
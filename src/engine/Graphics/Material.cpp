@@ -5,49 +5,128 @@
  */
 
 #include "Material.hpp"
+#include "Backend.hpp"
 #include <GLES3/gl3.h>
+#include <cstring>
 #include <iostream>
 
+/**
+ * @brief Returns true if a parameter can be uploaded to a uniform of a type
+ */
+static bool MatchesUniform(Engine::Graphics::MaterialParameterType parameter,
+  unsigned type) {
+  switch (parameter) {
+    case Engine::Graphics::MaterialParameterType::FLOAT:
+      return type == GL_FLOAT;
+    case Engine::Graphics::MaterialParameterType::VEC2:
+      return type == GL_FLOAT_VEC2;
+    case Engine::Graphics::MaterialParameterType::VEC3:
+      return type == GL_FLOAT_VEC3;
+    case Engine::Graphics::MaterialParameterType::VEC4:
+      return type == GL_FLOAT_VEC4;
+    case Engine::Graphics::MaterialParameterType::INT:
+      // Bools and samplers are set as single integers too
+      return type != GL_FLOAT && Engine::Graphics::UniformComponents(type) == 1;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Returns the size in bytes of the value of a parameter
+ */
+static size_t ParameterSize(Engine::Graphics::MaterialParameterType type) {
+  switch (type) {
+    case Engine::Graphics::MaterialParameterType::VEC2:
+      return 2 * sizeof(float);
+    case Engine::Graphics::MaterialParameterType::VEC3:
+      return 3 * sizeof(float);
+    case Engine::Graphics::MaterialParameterType::VEC4:
+      return 4 * sizeof(float);
+    default:
+      return sizeof(float);
+  }
+}
+
 Engine::Graphics::Material::Material(Engine::Graphics::Shader* referenceShader) {
   m_referenceShader = referenceShader;
 }
 
-void Engine::Graphics::Material::CreateParameter(const char* name, Engine::Graphics::MaterialParameterType type) {
-  m_parameters.emplace(name, type);
+void Engine::Graphics::Material::CreateParameter(std::string_view name, Engine::Graphics::MaterialParameterType type) {
+  m_parameters.Emplace(StringId::Intern(name), type);
+  m_bindingsDirty = true;
 }
 
-void* Engine::Graphics::Material::SetParameter(const char* name, void* value) {
-  if (m_parameters.find(name) == m_parameters.end()) {
+void* Engine::Graphics::Material::SetParameter(Engine::StringId name, void* value) {
+  if (!m_parameters.Contains(name)) {
     throw std::runtime_error("Parameter does not exist");
   }
   
-  m_parameterValues.emplace(name, value);
+  if (size_t* index = m_parameterValues.Find(name)) {
+    m_values[*index].value = value;
+    return value;
+  }
+
+  MaterialParameterType type = m_parameters.at(name);
+  m_parameterValues.Emplace(name, m_values.size());
+  m_values.push_back({type, value, m_snapshotSize});
+  m_snapshotSize += ParameterSize(type);
+  m_bindingsDirty = true;
   return value;
 }
 
-Engine::Success Engine::Graphics::Material::ApplyMaterialParams() {
-  unsigned shaderProgram = m_referenceShader->GetShaderProgram();
-  Engine::Success success = Engine::Success::SUCCESS;
+void Engine::Graphics::Material::BindParameters() {
+  m_boundParameters.clear();
+  m_bindingsRejected = false;
+
   for (auto& [key, type] : m_parameters) {
-    if (m_parameters.find(key) == m_parameters.end()) continue;
-    int uniformLocation = glGetUniformLocation(shaderProgram, key);
-    void* value = m_parameterValues[key];
+    size_t* value = m_parameterValues.Find(key);
+    if (value == nullptr) continue;
+
+    int handle = m_referenceShader->GetUniformHandle(key.c_str());
+    if (handle < 0) continue;
+
+    unsigned uniformType = m_referenceShader->GetUniformType(handle);
+    if (!MatchesUniform(type, uniformType)
+      || m_referenceShader->GetUniformSize(handle) != 1) {
+      std::cerr << "ERROR: Parameter " << key << " does not match the type "
+        << "of its uniform" << std::endl;
+      m_bindingsRejected = true;
+      continue;
+    }
 
-    switch (type) {
+    m_boundParameters.push_back({handle, type, *value});
+  }
+
+  m_bindingsDirty = false;
+}
+
+Engine::Success Engine::Graphics::Material::ApplyMaterialParams() {
+  return ApplyMaterialParams(nullptr, 0);
+}
+
+Engine::Success Engine::Graphics::Material::ApplyMaterialParams(
+  const unsigned char* snapshot, size_t size) {
+  if (m_bindingsDirty)
+    BindParameters();
+
+  Engine::Success success = m_bindingsRejected
+    ? Engine::Success::FAILURE : Engine::Success::SUCCESS;
+  for (BoundParameter& parameter : m_boundParameters) {
+    ParameterValue& value = m_values[parameter.value];
+    const void* data = value.value;
+    if (value.offset + ParameterSize(value.type) <= size)
+      data = snapshot + value.offset;
+
+    switch (parameter.type) {
       case Engine::Graphics::MaterialParameterType::FLOAT:
-        glUniform1f(uniformLocation, *(float*)value);
-        break;
-      case Engine::Graphics::MaterialParameterType::INT:
-        glUniform1i(uniformLocation, *(int*)value);
-        break;
       case Engine::Graphics::MaterialParameterType::VEC2:
-        glUniform2fv(uniformLocation, 1, (float*)value);
-        break;
       case Engine::Graphics::MaterialParameterType::VEC3:
-        glUniform3fv(uniformLocation, 1, (float*)value);
-        break;
       case Engine::Graphics::MaterialParameterType::VEC4:
-        glUniform4fv(uniformLocation, 1, (float*)value);
+        m_referenceShader->SetUniform(parameter.handle, (const float*)data);
+        break;
+      case Engine::Graphics::MaterialParameterType::INT:
+        m_referenceShader->SetUniform(parameter.handle, (const int*)data);
         break;
       default:
         success = Engine::Success::FAILURE;
@@ -57,6 +136,23 @@ Engine::Success Engine::Graphics::Material::ApplyMaterialParams() {
   return success;
 }
 
+size_t Engine::Graphics::Material::GetSnapshotSize() {
+  return m_snapshotSize;
+}
+
+void Engine::Graphics::Material::Snapshot(unsigned char* snapshot) {
+  for (ParameterValue& value : m_values)
+    std::memcpy(snapshot + value.offset, value.value, ParameterSize(value.type));
+}
+
 Engine::Graphics::Shader* Engine::Graphics::Material::GetShader() {
   return m_referenceShader;
+}
+
+void Engine::Graphics::Material::SetTransparent(bool transparent) {
+  m_transparent = transparent;
+}
+
+bool Engine::Graphics::Material::IsTransparent() {
+  return m_transparent;
 }
\ No newline at end of file
@@ -9,7 +9,10 @@
 
 #include "Shader.hpp"
 #include "../Utils.hpp"
-#include <map>
+#include "../FlatHashMap.hpp"
+#include "../StringId.hpp"
+#include <string_view>
+#include <vector>
 
 namespace Engine::Graphics {
 
@@ -44,8 +47,46 @@ namespace Engine::Graphics {
     private:
     Shader* m_referenceShader;
 
-    std::map<const char*, MaterialParameterType> m_parameters;
-    std::map<const char*, void*> m_parameterValues;
+    FlatHashMap<StringId, MaterialParameterType> m_parameters;
+
+    /**
+     * @brief A parameter with a value, and its place in a snapshot
+     *
+     * Values are only ever appended, so a snapshot taken earlier keeps the
+     * layout it was taken with.
+     */
+    struct ParameterValue {
+      MaterialParameterType type;
+      void* value;
+      size_t offset;
+    };
+
+    FlatHashMap<StringId, size_t> m_parameterValues;
+    std::vector<ParameterValue> m_values;
+    size_t m_snapshotSize = 0;
+
+    /**
+     * @brief A parameter with its uniform handle already resolved
+     */
+    struct BoundParameter {
+      int handle;
+      MaterialParameterType type;
+      size_t value;
+    };
+
+    std::vector<BoundParameter> m_boundParameters;
+    bool m_bindingsDirty = true;
+    bool m_bindingsRejected = false;
+
+    bool m_transparent = false;
+
+    /**
+     * @brief Resolves the uniform handles of every parameter with a value
+     *
+     * Parameters whose type does not match the type of their uniform are
+     * rejected, since the upload reads as many values as the uniform holds.
+     */
+    void BindParameters();
 
     public:
     
@@ -62,11 +103,14 @@ namespace Engine::Graphics {
      * This method takes in a parameter name and a parameter type and keeps track
      * of the parameters in the material. This method will throw an error if the
      * parameter already exists.
+     *
+     * The name is interned, so `SetParameter` can find the parameter from
+     * any copy of the name.
      * 
      * @param name The name of the parameter
      * @param type The type of the parameter
      */
-    void CreateParameter(const char* name, MaterialParameterType type);
+    void CreateParameter(std::string_view name, MaterialParameterType type);
 
     /**
      * @brief Sets the value of a parameter
@@ -89,7 +133,7 @@ namespace Engine::Graphics {
      * If there is a mismatch, the program will potentially segfault, or 
      * lead to undefined behavior.
      */
-    void* SetParameter(const char* name, void* value); 
+    void* SetParameter(StringId name, void* value);
 
     /**
      * @brief Applies both the material values to the shader
@@ -97,17 +141,63 @@ namespace Engine::Graphics {
      * This method gets called by the renderer when the material is applied.
      * 
      * @returns Engine::Success::SUCCESS if the material was applied successfully. If one
-     * parameter failed to apply correctly, then the method returns an
-     * Engine::Success::FAILURE
+     * parameter failed to apply correctly, or does not match the type of its
+     * uniform, then the method returns an Engine::Success::FAILURE
      */
     Engine::Success ApplyMaterialParams();
 
+    /**
+     * @brief Applies the values of a snapshot to the shader
+     *
+     * Parameters given their first value after the snapshot was taken use
+     * their current value.
+     *
+     * @param snapshot The values copied by `Snapshot`
+     * @param size The size of the snapshot, in bytes
+     *
+     * @returns Engine::Success::FAILURE under the same conditions as
+     * `ApplyMaterialParams()`
+     */
+    Engine::Success ApplyMaterialParams(const unsigned char* snapshot,
+      size_t size);
+
+    /**
+     * @brief Returns the size in bytes of a snapshot of the parameter values
+     */
+    size_t GetSnapshotSize();
+
+    /**
+     * @brief Copies the current value of every parameter
+     *
+     * Command buffers take a snapshot for each draw they record, so changing
+     * a value between two draws with the same material changes only the
+     * second one.
+     *
+     * @param snapshot Where to copy the values, `GetSnapshotSize()` bytes long
+     */
+    void Snapshot(unsigned char* snapshot);
+
     /**
      * @brief Gets the shader used by the material
      * 
      * @reutnrs The shader used by the material
      */
     Shader* GetShader();
+
+    /**
+     * @brief Sets if the material is blended with what is behind it
+     *
+     * Transparent materials are drawn after every opaque draw from back to
+     * front, and they do not write to the depth buffer.
+     *
+     * @param transparent true to blend the material
+     */
+    void SetTransparent(bool transparent);
+
+    /**
+     * @brief Returns true if the material is blended
+     */
+    bool IsTransparent();
   };
 }
 
@@ -5,6 +5,11 @@
  */
 
 #include "Mesh.hpp"
+#include "Backend.hpp"
+#include "StateCache.hpp"
+#include <GLES3/gl3.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 void Engine::Graphics::Vertex::CalculateNormals(Vertex& v2, Vertex& v3) {
@@ -38,6 +43,36 @@ bool Engine::Graphics::Vertex::operator==(const Vertex& rhs) {
   return true; 
 };
 
+Engine::Graphics::Mesh::Mesh(const Mesh& other) :
+  m_vertices(other.m_vertices), m_indices(other.m_indices),
+  m_retainCPUData(other.m_retainCPUData),
+  m_boundingBox(other.m_boundingBox),
+  m_boundingSphere(other.m_boundingSphere),
+  m_boundingSphereDirty(other.m_boundingSphereDirty) {}
+
+Engine::Graphics::Mesh& Engine::Graphics::Mesh::operator=(const Mesh& other) {
+  if (this == &other)
+    return *this;
+
+  m_vertices = other.m_vertices;
+  m_indices = other.m_indices;
+  m_retainCPUData = other.m_retainCPUData;
+  m_boundingBox = other.m_boundingBox;
+  m_boundingSphere = other.m_boundingSphere;
+  m_boundingSphereDirty = other.m_boundingSphereDirty;
+  m_dirty = true;
+  return *this;
+}
+
+Engine::Graphics::Mesh::~Mesh() {
+  if (m_vao == 0)
+    return;
+
+  GetStateCache().DeleteVertexArrays(1, &m_vao);
+  GetStateCache().DeleteBuffers(1, &m_vbo);
+  GetStateCache().DeleteBuffers(1, &m_ebo);
+}
+
 Engine::Success Engine::Graphics::Mesh::AddTriangle(Vertex v1, Vertex v2,
   Vertex v3) {
   // TODO: Make this more efficient with the following
@@ -77,7 +112,13 @@ Engine::Success Engine::Graphics::Mesh::AddTriangle(Vertex v1, Vertex v2,
     m_vertices.push_back(n3);
     m_indices.push_back(m_vertices.size() - 1);
   }
-  
+
+  m_boundingBox.Expand({v1.x, v1.y, v1.z});
+  m_boundingBox.Expand({v2.x, v2.y, v2.z});
+  m_boundingBox.Expand({v3.x, v3.y, v3.z});
+  m_boundingSphereDirty = true;
+
+  m_dirty = true;
   return Engine::SUCCESS;
 }
 
@@ -89,11 +130,146 @@ Engine::Success Engine::Graphics::Mesh::AddQuad(Vertex v1, Vertex v2,
   return Engine::SUCCESS;
 }
 
+Engine::Success Engine::Graphics::Mesh::AddGeometry(const Vertex* vertices,
+  unsigned long vertexCount, const unsigned short* indices,
+  unsigned long indexCount) {
+  unsigned long offset = m_vertices.size();
+  if (offset + vertexCount > 65536)
+    return Engine::FAILURE;
+
+  m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+  for (unsigned long i = 0; i < vertexCount; i++)
+    m_boundingBox.Expand({vertices[i].x, vertices[i].y, vertices[i].z});
+  m_boundingSphereDirty = true;
+
+  m_indices.reserve(m_indices.size() + indexCount);
+  for (unsigned long i = 0; i < indexCount; i++)
+    m_indices.push_back(indices[i] + offset);
+
+  m_dirty = true;
+  return Engine::SUCCESS;
+}
+
+void Engine::Graphics::Mesh::ClearGeometry() {
+  m_vertices.clear();
+  m_indices.clear();
+  m_boundingBox = BoundingBox::Empty();
+  m_boundingSphere.radius = -1.0f;
+  m_boundingSphereDirty = false;
+  m_dirty = true;
+}
+
+void Engine::Graphics::Mesh::UpdateBoundingSphere() {
+  m_boundingSphere = {m_boundingBox.Center(), -1.0f};
+
+  float radiusSquared = -1.0f;
+  for (const Vertex& vertex : m_vertices) {
+    Vec3f offset = Vec3f{vertex.x, vertex.y, vertex.z}
+      - m_boundingSphere.center;
+    radiusSquared = std::max(radiusSquared, offset.lengthSquared());
+  }
+
+  if (radiusSquared >= 0.0f)
+    m_boundingSphere.radius = sqrtf(radiusSquared);
+  m_boundingSphereDirty = false;
+}
+
+void Engine::Graphics::Mesh::Upload() {
+  Backend& backend = GetBackend();
+  bool firstUpload = m_vao == 0;
+
+  if (firstUpload) {
+    m_vao = backend.CreateVertexArray();
+    m_vbo = backend.CreateBuffer();
+    m_ebo = backend.CreateBuffer();
+  }
+
+  GetStateCache().BindVertexArray(m_vao);
+  GetStateCache().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  GetStateCache().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+
+  // Meshes that get uploaded more than once are treated as dynamic meshes
+  if (!firstUpload && m_vertices.size() == m_uploadedVertexCount
+    && m_indices.size() == m_uploadedIndexCount) {
+    backend.BufferSubData(GL_ARRAY_BUFFER, 0,
+      m_vertices.size() * sizeof(Vertex), m_vertices.data());
+    backend.BufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0,
+      m_indices.size() * sizeof(unsigned short), m_indices.data());
+  } else {
+    unsigned usage = firstUpload ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW;
+    backend.BufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex),
+      m_vertices.data(), usage);
+    backend.BufferData(GL_ELEMENT_ARRAY_BUFFER,
+      m_indices.size() * sizeof(unsigned short), m_indices.data(), usage);
+  }
+
+  if (firstUpload) {
+    backend.EnableVertexAttribArray(0);
+    backend.EnableVertexAttribArray(1);
+    backend.EnableVertexAttribArray(2);
+
+    backend.VertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(Vertex),
+      0); // position
+    backend.VertexAttribPointer(1, 2, GL_FLOAT, false, sizeof(Vertex),
+      sizeof(float) * 3); // texture coordinates
+    backend.VertexAttribPointer(2, 3, GL_FLOAT, false, sizeof(Vertex),
+      sizeof(float) * 5); // normal
+  }
+
+  m_uploadedVertexCount = m_vertices.size();
+  m_uploadedIndexCount = m_indices.size();
+  m_dirty = false;
+
+  if (!m_retainCPUData) {
+    // The sphere can not be fitted without the vertices
+    if (m_boundingSphereDirty)
+      UpdateBoundingSphere();
+
+    m_vertices = std::vector<Vertex>();
+    m_indices = std::vector<unsigned short>();
+  }
+}
+
+unsigned int Engine::Graphics::Mesh::GetVertexArray() {
+  if (m_dirty)
+    Upload();
+
+  return m_vao;
+}
+
+void Engine::Graphics::Mesh::MarkDirty() {
+  m_dirty = true;
+
+  // Only meshes that still hold their vertices can be measured again
+  if (m_vertices.empty())
+    return;
+
+  m_boundingBox = BoundingBox::Empty();
+  for (const Vertex& vertex : m_vertices)
+    m_boundingBox.Expand({vertex.x, vertex.y, vertex.z});
+  m_boundingSphereDirty = true;
+}
+
+bool Engine::Graphics::Mesh::IsDirty() {
+  return m_dirty;
+}
+
+void Engine::Graphics::Mesh::SetRetainCPUData(bool retain) {
+  m_retainCPUData = retain;
+}
+
+bool Engine::Graphics::Mesh::HasCPUData() {
+  return !m_vertices.empty() || m_dirty;
+}
+
 float* Engine::Graphics::Mesh::GetVertices() {
   return (float*)(m_vertices.data());
 }
 
 unsigned long Engine::Graphics::Mesh::GetVertexCount() {
+  if (m_vertices.empty() && !m_dirty)
+    return m_uploadedVertexCount;
+
   return m_vertices.size();
 }
 
@@ -102,5 +278,19 @@ unsigned short* Engine::Graphics::Mesh::GetIndices() {
 }
 
 unsigned long Engine::Graphics::Mesh::GetIndexCount() { 
+  if (m_indices.empty() && !m_dirty)
+    return m_uploadedIndexCount;
+
   return m_indices.size(); 
-}
\ No newline at end of file
+}
+
+const Engine::BoundingBox& Engine::Graphics::Mesh::GetBoundingBox() {
+  return m_boundingBox;
+}
+
+const Engine::BoundingSphere& Engine::Graphics::Mesh::GetBoundingSphere() {
+  if (m_boundingSphereDirty)
+    UpdateBoundingSphere();
+
+  return m_boundingSphere;
+}
@@ -81,6 +81,38 @@ namespace Engine::Graphics {
       std::vector<Vertex> m_vertices;
       std::vector<unsigned short> m_indices;
 
+      // GPU resident copy of the mesh
+      unsigned int m_vao = 0;
+      unsigned int m_vbo = 0;
+      unsigned int m_ebo = 0;
+
+      unsigned long m_uploadedVertexCount = 0;
+      unsigned long m_uploadedIndexCount = 0;
+
+      bool m_dirty = true;
+      bool m_retainCPUData = true;
+
+      // Bounds in the space of the mesh, kept after the CPU data is dropped
+      BoundingBox m_boundingBox = BoundingBox::Empty();
+      BoundingSphere m_boundingSphere = {{0.0f, 0.0f, 0.0f}, -1.0f};
+      bool m_boundingSphereDirty = false;
+
+      /**
+       * @brief Fits the bounding sphere around the vertices
+       *
+       * The sphere is centered on the bounding box, with the radius of the
+       * farthest vertex.
+       */
+      void UpdateBoundingSphere();
+
+      /**
+       * @brief Uploads the vertex and index data to the mesh buffers
+       *
+       * Creates the buffers on the first upload. Re-uploads reuse the
+       * existing buffers and only reallocate them if the size changed.
+       */
+      void Upload();
+
     protected:
 
       /**
@@ -106,8 +138,89 @@ namespace Engine::Graphics {
        */
       Success AddQuad(Vertex v1, Vertex v2, Vertex v3, Vertex v4);
 
+      /**
+       * @brief Appends already indexed geometry to the mesh
+       *
+       * The indices are relative to the vertices being added, so they are
+       * offset by the amount of vertices already in the mesh.
+       *
+       * @param vertices The vertices to add
+       * @param vertexCount The amount of vertices
+       * @param indices The indices of the new triangles
+       * @param indexCount The amount of indices
+       * @return FAILURE if the mesh would go over 65536 vertices
+       */
+      Success AddGeometry(const Vertex* vertices, unsigned long vertexCount,
+        const unsigned short* indices, unsigned long indexCount);
+
+      /**
+       * @brief Removes every vertex and index from the mesh
+       */
+      void ClearGeometry();
+
     public:
 
+      Mesh() = default;
+
+      /**
+       * @brief Copies the geometry of another mesh
+       *
+       * The GPU buffers are not shared, the copy uploads its own buffers the
+       * first time it is drawn.
+       */
+      Mesh(const Mesh& other);
+
+      Mesh& operator=(const Mesh& other);
+
+      /**
+       * @brief Frees the GPU buffers owned by the mesh
+       */
+      virtual ~Mesh();
+
+      /**
+       * @brief Returns the vertex array object of the mesh
+       *
+       * The mesh is uploaded to the GPU the first time this is called, and
+       * only uploaded again when the mesh has been marked dirty. This is
+       * called by the renderer so you should not need to call it manually.
+       *
+       * @return The vertex array object ready to be bound
+       */
+      unsigned int GetVertexArray();
+
+      /**
+       * @brief Flags the mesh to be uploaded again before the next draw
+       *
+       * Adding triangles already marks the mesh as dirty. The bounds are
+       * also recomputed, in case the vertices were edited in place.
+       */
+      void MarkDirty();
+
+      /**
+       * @brief Returns true if the GPU copy of the mesh is out of date
+       */
+      bool IsDirty();
+
+      /**
+       * @brief Sets if the mesh keeps its vertices and indices in memory after
+       * they are uploaded to the GPU.
+       *
+       * Most static meshes never need their data again after the upload, so
+       * dropping it saves memory. By default the data is retained.
+       *
+       * @warning Once the data is dropped, `GetVertices()` and `GetIndices()`
+       * return empty buffers, and adding triangles starts a new mesh from
+       * scratch.
+       *
+       * @param retain false to free the CPU data after the next upload
+       */
+      void SetRetainCPUData(bool retain);
+
+      /**
+       * @brief Returns true if the vertices and indices are still in memory
+       */
+      bool HasCPUData();
+
       /**
        * @brief Returns a pointer to a float array of vertices.
        * This output is designed to be ready for OpenGL use.
@@ -131,6 +244,22 @@ namespace Engine::Graphics {
        */
       unsigned short* GetIndices();
 
+      /**
+       * @brief Returns the box around every vertex of the mesh
+       *
+       * The box grows as triangles are added, and stays available after the
+       * CPU data is dropped.
+       */
+      const BoundingBox& GetBoundingBox();
+
+      /**
+       * @brief Returns the sphere around every vertex of the mesh
+       *
+       * The renderer culls the draws whose sphere is outside of the view.
+       * The radius is negative if the mesh is empty.
+       */
+      const BoundingSphere& GetBoundingSphere();
+
       /**
        * @brief Returns the number of indeces in the index buffer
        * 
@@ -0,0 +1,415 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "MeshSimplifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+// How much more the planes along open borders weigh than the triangles
+static constexpr double BORDER_WEIGHT = 10.0;
+
+// Collapses may not turn a triangle by more than about 80 degrees
+static constexpr float MIN_NORMAL_COSINE = 0.2f;
+
+namespace {
+
+  /**
+   * A mesh built from the geometry left by the simplifier
+   */
+  class SimplifiedMesh : public Engine::Graphics::Mesh {
+    public:
+    SimplifiedMesh(const std::vector<Engine::Graphics::Vertex>& vertices,
+      const std::vector<unsigned short>& indices) {
+      AddGeometry(vertices.data(), vertices.size(), indices.data(),
+        indices.size());
+    }
+  };
+}
+
+static bool PositionLess(const Engine::Vec3f& a, const Engine::Vec3f& b) {
+  if (a.x != b.x)
+    return a.x < b.x;
+  if (a.y != b.y)
+    return a.y < b.y;
+  return a.z < b.z;
+}
+
+void Engine::Graphics::MeshSimplifier::Quadric::AddPlane(double x, double y,
+  double z, double d, double planeWeight) {
+  double* q = a;
+  q[0] += planeWeight * x * x;
+  q[1] += planeWeight * x * y;
+  q[2] += planeWeight * x * z;
+  q[3] += planeWeight * x * d;
+  q[4] += planeWeight * y * y;
+  q[5] += planeWeight * y * z;
+  q[6] += planeWeight * y * d;
+  q[7] += planeWeight * z * z;
+  q[8] += planeWeight * z * d;
+  q[9] += planeWeight * d * d;
+  weight += planeWeight;
+}
+
+void Engine::Graphics::MeshSimplifier::Quadric::Add(const Quadric& other) {
+  for (int i = 0; i < 10; i++)
+    a[i] += other.a[i];
+  weight += other.weight;
+}
+
+double Engine::Graphics::MeshSimplifier::Quadric::Evaluate(Vec3f p) const {
+  double x = p.x, y = p.y, z = p.z;
+  return a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x
+    + a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y + a[7] * z * z
+    + 2 * a[8] * z + a[9];
+}
+
+Engine::Graphics::MeshSimplifier::MeshSimplifier(Mesh& mesh) {
+  if (!mesh.HasCPUData()) {
+    std::cerr << "ERROR: A mesh can not be simplified once its data was "
+      << "released" << std::endl;
+    return;
+  }
+
+  const Vertex* vertices = (const Vertex*)mesh.GetVertices();
+  const unsigned short* indices = mesh.GetIndices();
+  size_t vertexCount = mesh.GetVertexCount();
+  size_t indexCount = mesh.GetIndexCount() / 3 * 3;
+
+  // Vertices are welded by sorting them by position
+  std::vector<uint32_t> order(vertexCount);
+  std::iota(order.begin(), order.end(), 0);
+  auto position = [&](uint32_t i) {
+    return Vec3f{vertices[i].x, vertices[i].y, vertices[i].z};
+  };
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return PositionLess(position(a), position(b));
+  });
+
+  std::vector<uint32_t> pointOf(vertexCount);
+  for (size_t i = 0; i < vertexCount; i++) {
+    if (i == 0 || !(position(order[i - 1]) == position(order[i])))
+      m_points.push_back(position(order[i]));
+    pointOf[order[i]] = m_points.size() - 1;
+  }
+
+  m_quadrics.resize(m_points.size());
+  m_versions.resize(m_points.size(), 0);
+  m_pointTriangles.resize(m_points.size());
+
+  std::unordered_map<uint64_t, uint32_t> edgeUses;
+  auto edgeKey = [](uint32_t a, uint32_t b) {
+    return (uint64_t)std::min(a, b) << 32 | std::max(a, b);
+  };
+
+  for (size_t i = 0; i < indexCount; i += 3) {
+    uint32_t p[3] = {pointOf[indices[i]], pointOf[indices[i + 1]],
+      pointOf[indices[i + 2]]};
+    if (p[0] == p[1] || p[1] == p[2] || p[2] == p[0])
+      continue;
+
+    uint32_t triangle = m_triangles.size() / 3;
+    for (int k = 0; k < 3; k++) {
+      const Vertex& corner = vertices[indices[i + k]];
+      m_triangles.push_back(p[k]);
+      m_corners.push_back(corner);
+      m_pointTriangles[p[k]].push_back(triangle);
+      edgeUses[edgeKey(p[k], p[(k + 1) % 3])]++;
+    }
+
+    // Each triangle adds its plane to its points, weighted by its area
+    Vec3f normal = Cross(m_points[p[1]] - m_points[p[0]],
+      m_points[p[2]] - m_points[p[0]]);
+    float area = normal.length();
+    if (area > 0.0f) {
+      normal = normal / area;
+      double d = -Dot(normal, m_points[p[0]]);
+      for (int k = 0; k < 3; k++)
+        m_quadrics[p[k]].AddPlane(normal.x, normal.y, normal.z, d, area);
+    }
+
+    const Vertex* c = &m_corners[m_corners.size() - 3];
+    m_flatNormals = m_flatNormals && c[0].nx == c[1].nx && c[0].ny == c[1].ny
+      && c[0].nz == c[1].nz && c[0].nx == c[2].nx && c[0].ny == c[2].ny
+      && c[0].nz == c[2].nz;
+  }
+
+  m_triangleCount = m_triangles.size() / 3;
+  m_removed.resize(m_triangleCount, false);
+
+  // Open borders are held by planes standing on their edges
+  for (size_t t = 0; t < m_triangleCount; t++) {
+    const uint32_t* p = &m_triangles[t * 3];
+    Vec3f normal = Normalize(Cross(m_points[p[1]] - m_points[p[0]],
+      m_points[p[2]] - m_points[p[0]]));
+    for (int k = 0; k < 3; k++) {
+      uint32_t a = p[k], b = p[(k + 1) % 3];
+      if (edgeUses[edgeKey(a, b)] != 1)
+        continue;
+
+      Vec3f edge = m_points[b] - m_points[a];
+      Vec3f side = Normalize(Cross(edge, normal));
+      double d = -Dot(side, m_points[a]);
+      double weight = BORDER_WEIGHT * edge.lengthSquared();
+      m_quadrics[a].AddPlane(side.x, side.y, side.z, d, weight);
+      m_quadrics[b].AddPlane(side.x, side.y, side.z, d, weight);
+    }
+  }
+
+  for (size_t t = 0; t < m_triangleCount; t++)
+    for (int k = 0; k < 3; k++)
+      PushCollapse(m_triangles[t * 3 + k], m_triangles[t * 3 + (k + 1) % 3]);
+}
+
+double Engine::Graphics::MeshSimplifier::CollapseCost(uint32_t from,
+  uint32_t to) const {
+  Quadric quadric = m_quadrics[from];
+  quadric.Add(m_quadrics[to]);
+  if (quadric.weight <= 0.0)
+    return 0.0;
+
+  return std::max(quadric.Evaluate(m_points[to]) / quadric.weight, 0.0);
+}
+
+void Engine::Graphics::MeshSimplifier::PushCollapse(uint32_t from,
+  uint32_t to) {
+  for (auto [a, b] : {std::pair{from, to}, std::pair{to, from}}) {
+    m_heap.push_back({CollapseCost(a, b), a, b, m_versions[a], m_versions[b]});
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Collapse>());
+  }
+}
+
+int64_t Engine::Graphics::MeshSimplifier::FindWedge(uint32_t corner,
+  uint32_t from, uint32_t to) const {
+  const Vertex& moved = m_corners[corner];
+  for (uint32_t t : m_pointTriangles[from]) {
+    const uint32_t* p = &m_triangles[t * 3];
+    int fromCorner = -1, toCorner = -1;
+    for (int k = 0; k < 3; k++) {
+      if (p[k] == from)
+        fromCorner = k;
+      else if (p[k] == to)
+        toCorner = k;
+    }
+
+    if (toCorner < 0)
+      continue;
+
+    // The corner belongs to the same side of a seam as this triangle
+    const Vertex& shared = m_corners[t * 3 + fromCorner];
+    bool sameWedge = shared.u == moved.u && shared.v == moved.v
+      && (m_flatNormals || (shared.nx == moved.nx && shared.ny == moved.ny
+      && shared.nz == moved.nz));
+    if (sameWedge)
+      return t * 3 + toCorner;
+  }
+
+  return -1;
+}
+
+bool Engine::Graphics::MeshSimplifier::IsValid(uint32_t from,
+  uint32_t to) const {
+  // The points around both ends may only meet on the collapsed triangles
+  std::vector<uint32_t> fromNeighbours, toNeighbours;
+  size_t sharedTriangles = 0;
+  for (uint32_t t : m_pointTriangles[from]) {
+    const uint32_t* p = &m_triangles[t * 3];
+    bool shared = p[0] == to || p[1] == to || p[2] == to;
+    sharedTriangles += shared;
+    for (int k = 0; k < 3; k++)
+      if (p[k] != from && p[k] != to)
+        fromNeighbours.push_back(p[k]);
+
+    if (shared)
+      continue;
+
+    // The triangles that stay may not flip or become too thin
+    Vec3f before[3], after[3];
+    for (int k = 0; k < 3; k++) {
+      before[k] = m_points[p[k]];
+      after[k] = p[k] == from ? m_points[to] : before[k];
+    }
+    Vec3f oldNormal = Cross(before[1] - before[0], before[2] - before[0]);
+    Vec3f newNormal = Cross(after[1] - after[0], after[2] - after[0]);
+    if (oldNormal.lengthSquared() > 0.0f && Dot(oldNormal, newNormal)
+      <= MIN_NORMAL_COSINE * oldNormal.length() * newNormal.length())
+      return false;
+
+    for (int k = 0; k < 3; k++)
+      if (p[k] == from && FindWedge(t * 3 + k, from, to) < 0)
+        return false;
+  }
+
+  for (uint32_t t : m_pointTriangles[to])
+    for (int k = 0; k < 3; k++) {
+      uint32_t p = m_triangles[t * 3 + k];
+      if (p != from && p != to)
+        toNeighbours.push_back(p);
+    }
+
+  std::sort(fromNeighbours.begin(), fromNeighbours.end());
+  fromNeighbours.erase(std::unique(fromNeighbours.begin(),
+    fromNeighbours.end()), fromNeighbours.end());
+  std::sort(toNeighbours.begin(), toNeighbours.end());
+  toNeighbours.erase(std::unique(toNeighbours.begin(), toNeighbours.end()),
+    toNeighbours.end());
+
+  std::vector<uint32_t> common;
+  std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(),
+    toNeighbours.begin(), toNeighbours.end(), std::back_inserter(common));
+  return sharedTriangles > 0 && common.size() <= sharedTriangles;
+}
+
+void Engine::Graphics::MeshSimplifier::ApplyCollapse(uint32_t from,
+  uint32_t to) {
+  // The corners moved take the UV and normal found before anything changes
+  std::vector<std::pair<uint32_t, Vertex>> wedges;
+  for (uint32_t t : m_pointTriangles[from])
+    for (int k = 0; k < 3; k++)
+      if (m_triangles[t * 3 + k] == from) {
+        int64_t wedge = FindWedge(t * 3 + k, from, to);
+        if (wedge >= 0)
+          wedges.push_back({t * 3 + k, m_corners[wedge]});
+      }
+
+  for (uint32_t t : m_pointTriangles[from]) {
+    uint32_t* p = &m_triangles[t * 3];
+    if (p[0] != to && p[1] != to && p[2] != to) {
+      m_pointTriangles[to].push_back(t);
+      continue;
+    }
+
+    // The triangles along the edge disappear
+    m_removed[t] = true;
+    m_triangleCount--;
+    for (int k = 0; k < 3; k++) {
+      if (p[k] == from)
+        continue;
+
+      std::vector<uint32_t>& list = m_pointTriangles[p[k]];
+      list.erase(std::find(list.begin(), list.end(), t));
+    }
+  }
+
+  for (auto& [corner, wedge] : wedges) {
+    if (m_removed[corner / 3])
+      continue;
+
+    m_triangles[corner] = to;
+    m_corners[corner] = wedge;
+  }
+
+  m_pointTriangles[from].clear();
+  m_quadrics[to].Add(m_quadrics[from]);
+  m_versions[from]++;
+  m_versions[to]++;
+
+  for (uint32_t t : m_pointTriangles[to])
+    for (int k = 0; k < 3; k++)
+      if (m_triangles[t * 3 + k] != to)
+        PushCollapse(to, m_triangles[t * 3 + k]);
+}
+
+size_t Engine::Graphics::MeshSimplifier::Simplify(size_t targetTriangles,
+  float maxError) {
+  double maxCost = (double)maxError * maxError;
+
+  while (m_triangleCount > targetTriangles && !m_heap.empty()) {
+    const Collapse& top = m_heap.front();
+    if (top.cost > maxCost)
+      break;
+
+    Collapse collapse = top;
+    std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Collapse>());
+    m_heap.pop_back();
+
+    // Collapses queued before either end changed are outdated
+    if (collapse.fromVersion != m_versions[collapse.from]
+      || collapse.toVersion != m_versions[collapse.to])
+      continue;
+
+    if (!IsValid(collapse.from, collapse.to))
+      continue;
+
+    m_error = std::max(m_error, collapse.cost);
+    ApplyCollapse(collapse.from, collapse.to);
+  }
+
+  return m_triangleCount;
+}
+
+size_t Engine::Graphics::MeshSimplifier::GetTriangleCount() const {
+  return m_triangleCount;
+}
+
+float Engine::Graphics::MeshSimplifier::GetError() const {
+  return sqrt(m_error);
+}
+
+std::unique_ptr<Engine::Graphics::Mesh>
+  Engine::Graphics::MeshSimplifier::CreateMesh() const {
+  std::vector<Vertex> corners;
+  for (size_t t = 0; t < m_removed.size(); t++) {
+    if (m_removed[t])
+      continue;
+
+    Vertex v[3];
+    for (int k = 0; k < 3; k++) {
+      const Vec3f& point = m_points[m_triangles[t * 3 + k]];
+      v[k] = m_corners[t * 3 + k];
+      v[k].x = point.x;
+      v[k].y = point.y;
+      v[k].z = point.z;
+    }
+
+    if (m_flatNormals)
+      v[0].CalculateNormals(v[1], v[2]);
+    corners.insert(corners.end(), v, v + 3);
+  }
+
+  // Identical corners share a vertex
+  auto less = [](const Vertex& a, const Vertex& b) {
+    return std::lexicographical_compare(&a.x, &a.x + 8, &b.x, &b.x + 8);
+  };
+  std::vector<uint32_t> order(corners.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return less(corners[a], corners[b]);
+  });
+
+  std::vector<Vertex> vertices;
+  std::vector<unsigned short> indices(corners.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    if (i == 0 || less(corners[order[i - 1]], corners[order[i]]))
+      vertices.push_back(corners[order[i]]);
+    indices[order[i]] = vertices.size() - 1;
+  }
+
+  return std::make_unique<SimplifiedMesh>(vertices, indices);
+}
+
+std::vector<std::unique_ptr<Engine::Graphics::Mesh>>
+  Engine::Graphics::MeshSimplifier::GenerateLODs(Mesh& mesh, unsigned levels,
+  float ratio, float maxError) {
+  std::vector<std::unique_ptr<Mesh>> chain;
+  MeshSimplifier simplifier(mesh);
+
+  size_t triangles = simplifier.GetTriangleCount();
+  for (unsigned level = 0; level < levels; level++) {
+    size_t target = (size_t)(triangles * ratio);
+    size_t left = simplifier.Simplify(target, maxError);
+    if (left == triangles)
+      break;
+
+    chain.push_back(simplifier.CreateMesh());
+    triangles = left;
+  }
+
+  return chain;
+}
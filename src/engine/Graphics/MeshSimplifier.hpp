@@ -0,0 +1,164 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_MESHSIMPLIFIER
+#define ENGINE_MESHSIMPLIFIER
+
+#include "Mesh.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief Reduces the triangle count of a mesh by collapsing edges
+   *
+   * Every point accumulates the planes of the triangles around it in a
+   * quadric, which measures the squared distance from any point to those
+   * planes. Edges are collapsed onto one of their points, cheapest first,
+   * so the mesh loses the triangles that change its shape the least.
+   *
+   * Vertices at the same position are welded, since `AddTriangle` gives
+   * every triangle its own vertices. A point is only ever moved onto another
+   * point, and the corners moved take the UV and normal of the point they
+   * land on, so UV seams stay in place. The edges of open borders are held by
+   * extra planes, and collapses that would flip a triangle are skipped.
+   * Meshes with flat normals get their normals computed again.
+   *
+   * Simplifying is progressive: `Simplify` can be called again with a lower
+   * target, and `CreateMesh` copies the current state, which is how
+   * `GenerateLODs` builds a whole chain. This is fast enough to run when a
+   * level loads, or ahead of time for large meshes.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::MeshSimplifier simplifier(statue);
+   * simplifier.Simplify(statue.GetIndexCount() / 3 / 4);
+   * std::unique_ptr<Engine::Graphics::Mesh> low = simplifier.CreateMesh();
+   * ```
+   */
+  class MeshSimplifier {
+    private:
+
+    /**
+     * @brief A symmetric 4x4 matrix, the sum of plane equations p * p^T
+     */
+    struct Quadric {
+      double a[10] = {0};
+
+      // The sum of the weights of the planes, to average the error
+      double weight = 0;
+
+      void AddPlane(double x, double y, double z, double d, double weight);
+      void Add(const Quadric& other);
+
+      /**
+       * @brief Returns the weighted sum of squared distances to the planes
+       */
+      double Evaluate(Vec3f p) const;
+    };
+
+    struct Collapse {
+      double cost;
+      uint32_t from;
+      uint32_t to;
+      uint32_t fromVersion;
+      uint32_t toVersion;
+
+      bool operator>(const Collapse& other) const {
+        return cost > other.cost;
+      }
+    };
+
+    // Vertices at the same position are welded into a single point
+    std::vector<Vec3f> m_points;
+    std::vector<Quadric> m_quadrics;
+    std::vector<uint32_t> m_versions;
+    std::vector<std::vector<uint32_t>> m_pointTriangles;
+
+    // The points of each triangle, and the UV and normal of each corner
+    std::vector<uint32_t> m_triangles;
+    std::vector<Vertex> m_corners;
+    std::vector<bool> m_removed;
+
+    std::vector<Collapse> m_heap;
+    size_t m_triangleCount = 0;
+    double m_error = 0;
+    bool m_flatNormals = true;
+
+    /**
+     * @brief Returns the average squared distance moved by a collapse
+     */
+    double CollapseCost(uint32_t from, uint32_t to) const;
+
+    void PushCollapse(uint32_t from, uint32_t to);
+
+    /**
+     * @brief Returns the corner of a removed triangle that a corner at the
+     * collapsed point takes its UV and normal from, or -1 if it is on a seam
+     */
+    int64_t FindWedge(uint32_t corner, uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Returns false if the collapse would flip, pinch or tear the mesh
+     */
+    bool IsValid(uint32_t from, uint32_t to) const;
+
+    void ApplyCollapse(uint32_t from, uint32_t to);
+
+    public:
+
+    /**
+     * @brief Copies the geometry of a mesh to simplify it
+     *
+     * @param mesh a mesh that still has its CPU data
+     */
+    MeshSimplifier(Mesh& mesh);
+
+    /**
+     * @brief Collapses edges until the mesh has few enough triangles
+     *
+     * @param targetTriangles the amount of triangles to stop at
+     * @param maxError the distance the surface may move, in the units of the
+     * mesh
+     * @return The amount of triangles left
+     */
+    size_t Simplify(size_t targetTriangles, float maxError = INFINITY);
+
+    /**
+     * @brief Returns the amount of triangles left
+     */
+    size_t GetTriangleCount() const;
+
+    /**
+     * @brief Returns the largest distance moved by a collapse so far
+     */
+    float GetError() const;
+
+    /**
+     * @brief Creates a mesh with the triangles left
+     */
+    std::unique_ptr<Mesh> CreateMesh() const;
+
+    /**
+     * @brief Builds a chain of simplified meshes
+     *
+     * Each level has `ratio` times the triangles of the previous one. The
+     * chain stops early when the mesh can not be simplified any further.
+     *
+     * @param mesh the full detail mesh, which is not part of the chain
+     * @param levels the amount of simplified meshes to build
+     * @param ratio the fraction of triangles kept from one level to the next
+     * @param maxError the distance the surface may move in any level
+     */
+    static std::vector<std::unique_ptr<Mesh>> GenerateLODs(Mesh& mesh,
+      unsigned levels, float ratio = 0.5f, float maxError = INFINITY);
+  };
+}
+
+#endif
@@ -0,0 +1,304 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "OcclusionBuffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Vertices closer to the eye than this are behind the near plane
+static constexpr float MIN_W = 1e-5f;
+
+// Boxes must be this far behind the occluders, to absorb the rounding of
+// the interpolated depth
+static constexpr float DEPTH_EPSILON = 1e-5f;
+
+Engine::Graphics::OcclusionBuffer::OcclusionBuffer(int width, int height) {
+  m_width = (std::max(width, 1) + OCCLUSION_TILE_SIZE - 1)
+    / OCCLUSION_TILE_SIZE * OCCLUSION_TILE_SIZE;
+  m_height = std::max(height, 1);
+  memcpy(m_viewProjection, Mat4f::Identity().m, sizeof(m_viewProjection));
+
+  // Every level is half the size of the one below, down to a single pixel
+  int levelWidth = m_width, levelHeight = m_height;
+  while (true) {
+    m_levelWidths.push_back(levelWidth);
+    m_levelHeights.push_back(levelHeight);
+    m_levels.emplace_back((size_t)levelWidth * levelHeight, 1.0f);
+    if (levelWidth == 1 && levelHeight == 1)
+      break;
+
+    levelWidth = (levelWidth + 1) / 2;
+    levelHeight = (levelHeight + 1) / 2;
+  }
+}
+
+void Engine::Graphics::OcclusionBuffer::Begin(const float* viewProjection) {
+  memcpy(m_viewProjection, viewProjection, sizeof(m_viewProjection));
+  for (std::vector<float>& level : m_levels)
+    std::fill(level.begin(), level.end(), 1.0f);
+  m_triangleCount = 0;
+}
+
+void Engine::Graphics::OcclusionBuffer::AddOccluder(Mesh& mesh,
+  const float* transform) {
+  if (!mesh.HasCPUData())
+    return;
+
+  float m[16];
+  MultiplyMatrices(m_viewProjection, transform, m);
+
+  // Vertices behind the near plane get a negative w to be skipped below
+  const float* vertices = mesh.GetVertices();
+  size_t stride = sizeof(Vertex) / sizeof(float);
+  std::vector<ScreenVertex> screen(mesh.GetVertexCount());
+  std::vector<bool> visible(screen.size());
+  for (size_t i = 0; i < screen.size(); i++) {
+    const float* v = vertices + i * stride;
+    float x = m[0] * v[0] + m[4] * v[1] + m[8] * v[2] + m[12];
+    float y = m[1] * v[0] + m[5] * v[1] + m[9] * v[2] + m[13];
+    float z = m[2] * v[0] + m[6] * v[1] + m[10] * v[2] + m[14];
+    float w = m[3] * v[0] + m[7] * v[1] + m[11] * v[2] + m[15];
+    visible[i] = w > MIN_W;
+    if (!visible[i])
+      continue;
+
+    screen[i] = {(x / w * 0.5f + 0.5f) * m_width,
+      (y / w * 0.5f + 0.5f) * m_height, z / w * 0.5f + 0.5f};
+  }
+
+  const unsigned short* indices = mesh.GetIndices();
+  size_t indexCount = mesh.GetIndexCount();
+  for (size_t i = 0; i + 2 < indexCount; i += 3) {
+    unsigned short a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    if (visible[a] && visible[b] && visible[c])
+      RasterizeTriangle(screen[a], screen[b], screen[c]);
+  }
+}
+
+void Engine::Graphics::OcclusionBuffer::RasterizeTriangle(ScreenVertex a,
+  ScreenVertex b, ScreenVertex c) {
+  // Twice the signed area, occluders are drawn from both sides
+  float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+  if (area == 0.0f || !std::isfinite(area))
+    return;
+
+  if (area < 0.0f) {
+    std::swap(b, c);
+    area = -area;
+  }
+
+  int minX = std::max((int)floorf(std::min({a.x, b.x, c.x})), 0);
+  int maxX = std::min((int)floorf(std::max({a.x, b.x, c.x})), m_width - 1);
+  int minY = std::max((int)floorf(std::min({a.y, b.y, c.y})), 0);
+  int maxY = std::min((int)floorf(std::max({a.y, b.y, c.y})), m_height - 1);
+  if (minX > maxX || minY > maxY)
+    return;
+
+  m_triangleCount++;
+
+  // Each edge is opposite to the vertex it weights, positive inside
+  const ScreenVertex* starts[3] = {&b, &c, &a};
+  const ScreenVertex* ends[3] = {&c, &a, &b};
+  float stepX[3], stepY[3], origin[3];
+  for (int k = 0; k < 3; k++) {
+    float dx = ends[k]->x - starts[k]->x, dy = ends[k]->y - starts[k]->y;
+    stepX[k] = -dy;
+    stepY[k] = dx;
+    origin[k] = dy * starts[k]->x - dx * starts[k]->y;
+  }
+
+  // The depth is a plane over the screen
+  float depthX = (stepX[0] * a.depth + stepX[1] * b.depth
+    + stepX[2] * c.depth) / area;
+  float depthY = (stepY[0] * a.depth + stepY[1] * b.depth
+    + stepY[2] * c.depth) / area;
+  float depthOrigin = (origin[0] * a.depth + origin[1] * b.depth
+    + origin[2] * c.depth) / area;
+
+  // The furthest depth over a pixel is written, so nothing is hidden by the
+  // part of the pixel the triangle does not reach
+  float farthest = std::max({a.depth, b.depth, c.depth});
+  depthOrigin += 0.5f * (fabsf(depthX) + fabsf(depthY));
+
+  std::vector<float>& depth = m_levels[0];
+  const int tile = OCCLUSION_TILE_SIZE;
+  for (int tileY = minY / tile; tileY <= maxY / tile; tileY++)
+    for (int tileX = minX / tile; tileX <= maxX / tile; tileX++) {
+      // Tiles fully outside of an edge are skipped
+      float centerX = tileX * tile + tile * 0.5f;
+      float centerY = tileY * tile + tile * 0.5f;
+      bool outside = false;
+      for (int k = 0; k < 3; k++)
+        outside = outside || origin[k] + stepX[k] * centerX
+          + stepY[k] * centerY + 0.5f * tile * (fabsf(stepX[k])
+          + fabsf(stepY[k])) < 0.0f;
+      if (outside)
+        continue;
+
+      int startX = tileX * tile;
+      int endY = std::min(tileY * tile + tile, m_height);
+      for (int y = tileY * tile; y < endY; y++) {
+        float pixelY = y + 0.5f;
+        float* row = &depth[(size_t)y * m_width];
+        int x = startX;
+
+        #ifdef ENGINE_SIMD
+        // 4 pixels at a time, the width is a multiple of the tile size
+        const v128_t lanes = wasm_f32x4_make(0.5f, 1.5f, 2.5f, 3.5f);
+        const v128_t zero = wasm_f32x4_splat(0.0f);
+        for (; x < startX + tile; x += 4) {
+          v128_t pixelX = wasm_f32x4_add(wasm_f32x4_splat((float)x), lanes);
+          v128_t inside = wasm_f32x4_ge(wasm_f32x4_add(wasm_f32x4_mul(
+            pixelX, wasm_f32x4_splat(stepX[0])), wasm_f32x4_splat(
+            origin[0] + stepY[0] * pixelY)), zero);
+          for (int k = 1; k < 3; k++)
+            inside = wasm_v128_and(inside, wasm_f32x4_ge(wasm_f32x4_add(
+              wasm_f32x4_mul(pixelX, wasm_f32x4_splat(stepX[k])),
+              wasm_f32x4_splat(origin[k] + stepY[k] * pixelY)), zero));
+
+          v128_t z = wasm_f32x4_add(wasm_f32x4_mul(pixelX,
+            wasm_f32x4_splat(depthX)), wasm_f32x4_splat(depthOrigin
+            + depthY * pixelY));
+
+          // Fragments in front of the near plane are clipped
+          inside = wasm_v128_and(inside, wasm_f32x4_ge(z, zero));
+          if (!wasm_v128_any_true(inside))
+            continue;
+
+          z = wasm_f32x4_min(z, wasm_f32x4_splat(farthest));
+          v128_t current = wasm_v128_load(&row[x]);
+          wasm_v128_store(&row[x], wasm_v128_bitselect(
+            wasm_f32x4_min(current, z), current, inside));
+        }
+        #endif
+
+        for (; x < startX + tile; x++) {
+          float pixelX = x + 0.5f;
+          bool inside = true;
+          for (int k = 0; k < 3; k++)
+            inside = inside
+              && origin[k] + stepX[k] * pixelX + stepY[k] * pixelY >= 0.0f;
+
+          float z = depthOrigin + depthX * pixelX + depthY * pixelY;
+          if (inside && z >= 0.0f)
+            row[x] = std::min(row[x], std::min(z, farthest));
+        }
+      }
+    }
+}
+
+void Engine::Graphics::OcclusionBuffer::BuildPyramid() {
+  for (size_t level = 1; level < m_levels.size(); level++) {
+    const std::vector<float>& source = m_levels[level - 1];
+    std::vector<float>& target = m_levels[level];
+    int sourceWidth = m_levelWidths[level - 1];
+    int sourceHeight = m_levelHeights[level - 1];
+    int width = m_levelWidths[level];
+    int height = m_levelHeights[level];
+
+    for (int y = 0; y < height; y++) {
+      // Odd sizes repeat the last row and column
+      const float* row0 = &source[(size_t)(2 * y) * sourceWidth];
+      const float* row1 = &source[(size_t)std::min(2 * y + 1,
+        sourceHeight - 1) * sourceWidth];
+      float* out = &target[(size_t)y * width];
+      int x = 0;
+
+      #ifdef ENGINE_SIMD
+      // 8 pixels of 2 rows make 4 pixels of the next level
+      for (; 2 * x + 8 <= sourceWidth; x += 4) {
+        v128_t top = wasm_f32x4_max(wasm_v128_load(&row0[2 * x]),
+          wasm_v128_load(&row1[2 * x]));
+        v128_t bottom = wasm_f32x4_max(wasm_v128_load(&row0[2 * x + 4]),
+          wasm_v128_load(&row1[2 * x + 4]));
+        wasm_v128_store(&out[x], wasm_f32x4_max(
+          wasm_i32x4_shuffle(top, bottom, 0, 2, 4, 6),
+          wasm_i32x4_shuffle(top, bottom, 1, 3, 5, 7)));
+      }
+      #endif
+
+      for (; x < width; x++) {
+        int x0 = 2 * x, x1 = std::min(2 * x + 1, sourceWidth - 1);
+        out[x] = std::max(std::max(row0[x0], row0[x1]),
+          std::max(row1[x0], row1[x1]));
+      }
+    }
+  }
+}
+
+bool Engine::Graphics::OcclusionBuffer::IsOccluded(
+  const BoundingBox& box) const {
+  if (box.IsEmpty())
+    return false;
+
+  const float* m = m_viewProjection;
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+  float minDepth = INFINITY;
+  for (int corner = 0; corner < 8; corner++) {
+    Vec3f p = {corner & 1 ? box.max.x : box.min.x,
+      corner & 2 ? box.max.y : box.min.y, corner & 4 ? box.max.z : box.min.z};
+    float w = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
+    if (w <= MIN_W)
+      return false;
+
+    float x = ((m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12]) / w * 0.5f
+      + 0.5f) * m_width;
+    float y = ((m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13]) / w * 0.5f
+      + 0.5f) * m_height;
+    float depth = (m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]) / w * 0.5f
+      + 0.5f;
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
+    minDepth = std::min(minDepth, depth);
+  }
+
+  if (minDepth < 0.0f || maxX < 0.0f || maxY < 0.0f || minX > m_width
+    || minY > m_height)
+    return false;
+
+  // One more pixel on each side, for the pixels an occluder edge only
+  // partially covers
+  int x0 = std::max((int)floorf(minX) - 1, 0);
+  int y0 = std::max((int)floorf(minY) - 1, 0);
+  int x1 = std::min((int)floorf(maxX) + 1, m_width - 1);
+  int y1 = std::min((int)floorf(maxY) + 1, m_height - 1);
+
+  // The finest level where the box spans 8 pixels or less on each side,
+  // since the box rarely lines up with the pixels of the coarser levels
+  size_t level = 0;
+  while (((x1 >> level) - (x0 >> level) > 7 || (y1 >> level) - (y0 >> level)
+    > 7) && level + 1 < m_levels.size())
+    level++;
+
+  const std::vector<float>& depth = m_levels[level];
+  int width = m_levelWidths[level];
+  float farthest = 0.0f;
+  for (int y = y0 >> level; y <= y1 >> level; y++)
+    for (int x = x0 >> level; x <= x1 >> level; x++)
+      farthest = std::max(farthest, depth[(size_t)y * width + x]);
+
+  return minDepth > farthest + DEPTH_EPSILON;
+}
+
+const std::vector<float>&
+  Engine::Graphics::OcclusionBuffer::GetDepthBuffer() const {
+  return m_levels[0];
+}
+
+int Engine::Graphics::OcclusionBuffer::GetWidth() const {
+  return m_width;
+}
+
+int Engine::Graphics::OcclusionBuffer::GetHeight() const {
+  return m_height;
+}
+
+size_t Engine::Graphics::OcclusionBuffer::GetTriangleCount() const {
+  return m_triangleCount;
+}
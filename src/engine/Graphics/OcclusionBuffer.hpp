@@ -0,0 +1,133 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_OCCLUSIONBUFFER
+#define ENGINE_OCCLUSIONBUFFER
+
+#include "Mesh.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The amount of pixels on each side of an occlusion buffer tile
+   */
+  constexpr int OCCLUSION_TILE_SIZE = 8;
+
+  /**
+   * @brief A low resolution depth buffer drawn on the CPU to hide objects
+   *
+   * A few large meshes (walls, buildings, terrain) are rasterized as
+   * occluders into a small depth buffer, and a hierarchical depth pyramid is
+   * built from it, where each pixel keeps the furthest depth of the 4 pixels
+   * below it. A box is hidden when its closest point is behind the furthest
+   * occluder over the whole area it covers, which is answered with a handful
+   * of reads (64 at most) from the level of the pyramid that matches its size.
+   *
+   * Occluders are rasterized tile by tile, 4 pixels at a time with wasm SIMD
+   * when the engine is compiled with `-msimd128`. Triangles that cross the
+   * near plane are skipped, so the buffer never hides more than it should.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::OcclusionBuffer occlusion;
+   * occlusion.Begin(frameConstants.GetData().ViewProjection);
+   * occlusion.AddOccluder(wallMesh, wall.GetWorldMatrix());
+   * occlusion.BuildPyramid();
+   * if (!occlusion.IsOccluded(mesh.GetBoundingBox().Transformed(world)))
+   *   renderer.DrawMesh(&mesh, world);
+   * ```
+   */
+  class OcclusionBuffer {
+    private:
+    int m_width;
+    int m_height;
+    float m_viewProjection[16];
+
+    // Level 0 is the depth buffer, every next level is half the size
+    std::vector<std::vector<float>> m_levels;
+    std::vector<int> m_levelWidths;
+    std::vector<int> m_levelHeights;
+
+    size_t m_triangleCount = 0;
+
+    /**
+     * @brief A vertex in window space, with its depth from 0 to 1
+     */
+    struct ScreenVertex {
+      float x, y, depth;
+    };
+
+    /**
+     * @brief Writes the closest depth of a triangle in the pixels it covers
+     */
+    void RasterizeTriangle(ScreenVertex a, ScreenVertex b, ScreenVertex c);
+
+    public:
+
+    /**
+     * @brief Creates a buffer
+     *
+     * The width is rounded up to a multiple of `OCCLUSION_TILE_SIZE`.
+     *
+     * @param width the width in pixels
+     * @param height the height in pixels
+     */
+    OcclusionBuffer(int width = 256, int height = 128);
+
+    /**
+     * @brief Clears the buffer for a new frame
+     *
+     * @param viewProjection the column-major view projection of the camera
+     */
+    void Begin(const float* viewProjection);
+
+    /**
+     * @brief Rasterizes a mesh into the depth buffer
+     *
+     * The mesh must still have its CPU data (see `Mesh::SetRetainCPUData`),
+     * otherwise it is ignored.
+     *
+     * @param mesh the mesh hiding what is behind it
+     * @param transform the column-major model matrix of the mesh
+     */
+    void AddOccluder(Mesh& mesh, const float* transform);
+
+    /**
+     * @brief Builds the depth pyramid from the occluders added
+     *
+     * This must be called after the last occluder and before the first
+     * `IsOccluded` of the frame.
+     */
+    void BuildPyramid();
+
+    /**
+     * @brief Returns true if the box is hidden behind the occluders
+     *
+     * Boxes that cross the near plane or leave the screen are never hidden.
+     *
+     * @param box the box in world space
+     */
+    bool IsOccluded(const BoundingBox& box) const;
+
+    /**
+     * @brief Returns the depth buffer, its rows go from the bottom to the top
+     */
+    const std::vector<float>& GetDepthBuffer() const;
+
+    int GetWidth() const;
+    int GetHeight() const;
+
+    /**
+     * @brief Returns the amount of triangles rasterized since `Begin`
+     */
+    size_t GetTriangleCount() const;
+  };
+}
+
+#endif
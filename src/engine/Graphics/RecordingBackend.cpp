@@ -0,0 +1,338 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "RecordingBackend.hpp"
+#include <GLES3/gl3.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+  struct ReportedUniform {
+    const char* name;
+    unsigned type;
+  };
+
+  // The uniforms the engine sets on every program, each at the location of
+  // its EngineUniform
+  const ReportedUniform s_reportedUniforms[] = {
+    {"u_Window", GL_FLOAT_VEC2},
+    {"u_Transform", GL_FLOAT_MAT4},
+    {"u_Camera", GL_FLOAT_MAT4}
+  };
+
+  constexpr int REPORTED_UNIFORM_COUNT = sizeof(s_reportedUniforms)
+    / sizeof(ReportedUniform);
+}
+
+void Engine::Graphics::RecordingBackend::Record(const char* name,
+  size_t payloadSize) {
+  m_commands.push_back({name, payloadSize});
+  m_payloadSize += payloadSize;
+}
+
+const std::vector<Engine::Graphics::RecordedCommand>&
+  Engine::Graphics::RecordingBackend::GetCommands() {
+  return m_commands;
+}
+
+size_t Engine::Graphics::RecordingBackend::GetCommandCount() {
+  return m_commands.size();
+}
+
+size_t Engine::Graphics::RecordingBackend::CountCommands(const char* name) {
+  size_t count = 0;
+  for (const RecordedCommand& command : m_commands)
+    if (strcmp(command.name, name) == 0)
+      count++;
+
+  return count;
+}
+
+size_t Engine::Graphics::RecordingBackend::GetPayloadSize() {
+  return m_payloadSize;
+}
+
+void Engine::Graphics::RecordingBackend::ClearCommands() {
+  m_commands.clear();
+  m_payloadSize = 0;
+}
+
+void Engine::Graphics::RecordingBackend::SetCanvasSize(int width,
+  int height) {
+  m_canvasSize[0] = width;
+  m_canvasSize[1] = height;
+}
+
+bool Engine::Graphics::RecordingBackend::CreateContext(const char* canvas) {
+  Record("CreateContext");
+  return true;
+}
+
+void Engine::Graphics::RecordingBackend::GetCanvasSize(const char* canvas,
+  int& width, int& height) {
+  width = m_canvasSize[0];
+  height = m_canvasSize[1];
+}
+
+bool Engine::Graphics::RecordingBackend::ReadFile(const char* path,
+  std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    contents.clear();
+    return true;
+  }
+
+  std::stringstream stream;
+  stream << file.rdbuf();
+  contents = stream.str();
+  return true;
+}
+
+void Engine::Graphics::RecordingBackend::FetchFile(const char* path,
+  AssetRequest& request) {
+  std::string contents;
+  ReadFile(path, contents);
+
+  request.data = new unsigned char[contents.size()];
+  memcpy(request.data, contents.data(), contents.size());
+  request.size = contents.size();
+  request.req_state = 2;
+}
+
+void Engine::Graphics::RecordingBackend::Enable(unsigned capability) {
+  Record("Enable");
+}
+
+void Engine::Graphics::RecordingBackend::Disable(unsigned capability) {
+  Record("Disable");
+}
+
+void Engine::Graphics::RecordingBackend::BlendFunc(unsigned source,
+  unsigned destination) {
+  Record("BlendFunc");
+}
+
+void Engine::Graphics::RecordingBackend::DepthMask(bool enabled) {
+  Record("DepthMask");
+}
+
+void Engine::Graphics::RecordingBackend::FrontFace(unsigned mode) {
+  Record("FrontFace");
+}
+
+void Engine::Graphics::RecordingBackend::Viewport(int x, int y, int width,
+  int height) {
+  Record("Viewport");
+}
+
+void Engine::Graphics::RecordingBackend::ClearColor(float r, float g, float b,
+  float a) {
+  Record("ClearColor");
+}
+
+void Engine::Graphics::RecordingBackend::Clear(unsigned mask) {
+  Record("Clear");
+}
+
+unsigned Engine::Graphics::RecordingBackend::CreateBuffer() {
+  Record("CreateBuffer");
+  return m_nextName++;
+}
+
+void Engine::Graphics::RecordingBackend::DeleteBuffers(int count,
+  const unsigned* buffers) {
+  Record("DeleteBuffers");
+}
+
+void Engine::Graphics::RecordingBackend::BindBuffer(unsigned target,
+  unsigned buffer) {
+  Record("BindBuffer");
+}
+
+void Engine::Graphics::RecordingBackend::BindBufferBase(unsigned target,
+  unsigned index, unsigned buffer) {
+  Record("BindBufferBase");
+}
+
+void Engine::Graphics::RecordingBackend::BufferData(unsigned target,
+  size_t size, const void* data, unsigned usage) {
+  Record("BufferData", data != nullptr ? size : 0);
+}
+
+void Engine::Graphics::RecordingBackend::BufferSubData(unsigned target,
+  size_t offset, size_t size, const void* data) {
+  Record("BufferSubData", size);
+}
+
+unsigned Engine::Graphics::RecordingBackend::CreateVertexArray() {
+  Record("CreateVertexArray");
+  return m_nextName++;
+}
+
+void Engine::Graphics::RecordingBackend::DeleteVertexArrays(int count,
+  const unsigned* vertexArrays) {
+  Record("DeleteVertexArrays");
+}
+
+void Engine::Graphics::RecordingBackend::BindVertexArray(
+  unsigned vertexArray) {
+  Record("BindVertexArray");
+}
+
+void Engine::Graphics::RecordingBackend::EnableVertexAttribArray(
+  unsigned index) {
+  Record("EnableVertexAttribArray");
+}
+
+void Engine::Graphics::RecordingBackend::VertexAttribPointer(unsigned index,
+  int size, unsigned type, bool normalized, int stride, size_t offset) {
+  Record("VertexAttribPointer");
+}
+
+void Engine::Graphics::RecordingBackend::VertexAttribDivisor(unsigned index,
+  unsigned divisor) {
+  Record("VertexAttribDivisor");
+}
+
+unsigned Engine::Graphics::RecordingBackend::CreateTexture() {
+  Record("CreateTexture");
+  return m_nextName++;
+}
+
+void Engine::Graphics::RecordingBackend::DeleteTextures(int count,
+  const unsigned* textures) {
+  Record("DeleteTextures");
+}
+
+void Engine::Graphics::RecordingBackend::ActiveTexture(unsigned unit) {
+  Record("ActiveTexture");
+}
+
+void Engine::Graphics::RecordingBackend::BindTexture(unsigned target,
+  unsigned texture) {
+  Record("BindTexture");
+}
+
+void Engine::Graphics::RecordingBackend::TexParameter(unsigned target,
+  unsigned name, int value) {
+  Record("TexParameter");
+}
+
+void Engine::Graphics::RecordingBackend::TexImage2D(unsigned target,
+  int level, int internalFormat, int width, int height, unsigned format,
+  unsigned type, const void* pixels) {
+  Record("TexImage2D", pixels != nullptr ? (size_t)width * height * 4 : 0);
+}
+
+void Engine::Graphics::RecordingBackend::TexStorage3D(unsigned target,
+  int levels, unsigned internalFormat, int width, int height, int depth) {
+  Record("TexStorage3D");
+}
+
+void Engine::Graphics::RecordingBackend::TexSubImage3D(unsigned target,
+  int level, int x, int y, int z, int width, int height, int depth,
+  unsigned format, unsigned type, const void* pixels) {
+  Record("TexSubImage3D", (size_t)width * height * depth * 4);
+}
+
+void Engine::Graphics::RecordingBackend::GenerateMipmap(unsigned target) {
+  Record("GenerateMipmap");
+}
+
+unsigned Engine::Graphics::RecordingBackend::CompileShader(unsigned type,
+  const char* source, int length, std::string& log) {
+  Record("CompileShader", length);
+  return m_nextName++;
+}
+
+void Engine::Graphics::RecordingBackend::DeleteShader(unsigned shader) {
+  Record("DeleteShader");
+}
+
+unsigned Engine::Graphics::RecordingBackend::CreateProgram() {
+  Record("CreateProgram");
+  return m_nextName++;
+}
+
+void Engine::Graphics::RecordingBackend::DeleteProgram(unsigned program) {
+  Record("DeleteProgram");
+}
+
+void Engine::Graphics::RecordingBackend::AttachShader(unsigned program,
+  unsigned shader) {
+  Record("AttachShader");
+}
+
+void Engine::Graphics::RecordingBackend::BindAttribLocation(unsigned program,
+  unsigned index, const char* name) {
+  Record("BindAttribLocation");
+}
+
+bool Engine::Graphics::RecordingBackend::LinkProgram(unsigned program,
+  std::string& log) {
+  Record("LinkProgram");
+  return true;
+}
+
+void Engine::Graphics::RecordingBackend::UseProgram(unsigned program) {
+  Record("UseProgram");
+}
+
+int Engine::Graphics::RecordingBackend::GetActiveUniformCount(
+  unsigned program) {
+  Record("GetActiveUniformCount");
+  return REPORTED_UNIFORM_COUNT;
+}
+
+void Engine::Graphics::RecordingBackend::GetActiveUniform(unsigned program,
+  unsigned index, std::string& name, unsigned& type, int& size) {
+  Record("GetActiveUniform");
+  name = s_reportedUniforms[index].name;
+  type = s_reportedUniforms[index].type;
+  size = 1;
+}
+
+int Engine::Graphics::RecordingBackend::GetUniformLocation(unsigned program,
+  const char* name) {
+  Record("GetUniformLocation");
+  for (int i = 0; i < REPORTED_UNIFORM_COUNT; i++)
+    if (strcmp(s_reportedUniforms[i].name, name) == 0)
+      return i;
+
+  return -1;
+}
+
+unsigned Engine::Graphics::RecordingBackend::GetUniformBlockIndex(
+  unsigned program, const char* name) {
+  Record("GetUniformBlockIndex");
+  return strcmp(name, "FrameConstants") == 0 ? 0 : GL_INVALID_INDEX;
+}
+
+void Engine::Graphics::RecordingBackend::UniformBlockBinding(
+  unsigned program, unsigned block, unsigned binding) {
+  Record("UniformBlockBinding");
+}
+
+void Engine::Graphics::RecordingBackend::Uniform(unsigned type, int location,
+  int count, const float* values) {
+  Record("Uniform", UniformComponents(type) * count * sizeof(float));
+}
+
+void Engine::Graphics::RecordingBackend::Uniform(unsigned type, int location,
+  int count, const int* values) {
+  Record("Uniform", UniformComponents(type) * count * sizeof(int));
+}
+
+void Engine::Graphics::RecordingBackend::DrawElements(unsigned mode,
+  int count, unsigned type, size_t offset) {
+  Record("DrawElements");
+}
+
+void Engine::Graphics::RecordingBackend::DrawElementsInstanced(unsigned mode,
+  int count, unsigned type, size_t offset, int instanceCount) {
+  Record("DrawElementsInstanced");
+}
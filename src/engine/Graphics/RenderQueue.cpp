@@ -0,0 +1,150 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "RenderQueue.hpp"
+#include <cmath>
+
+/**
+ * Squashes a pointer into the amount of bits requested. Only identical
+ * pointers need to end up next to each other, so collisions are harmless.
+ */
+static uint64_t HashPointer(const void* pointer, unsigned bits) {
+  if (pointer == nullptr)
+    return 0;
+
+  uint64_t value = (uint64_t)(uintptr_t)pointer;
+  value = (value >> 4) * 0x9E3779B97F4A7C15ull;
+  return (value >> (64 - bits)) | 1;
+}
+
+uint64_t Engine::Graphics::RenderQueue::MakeKey(unsigned char layer,
+  bool transparent, Shader* shader, Material* material, Texture* texture,
+  float depth) {
+  if (depth < 0.0f) depth = 0.0f;
+  if (depth > 1.0f) depth = 1.0f;
+
+  uint64_t depthBits = (uint64_t)(depth * 0xFFFFFF);
+  uint64_t state = HashPointer(shader, 10) << 22
+    | HashPointer(material, 10) << 12
+    | HashPointer(texture, 12);
+
+  uint64_t key = (uint64_t)(layer & 0x7F) << 57;
+
+  if (transparent)
+    return key | 1ull << 56 | (0xFFFFFF - depthBits) << 32 | state;
+
+  return key | state << 24 | depthBits;
+}
+
+void Engine::Graphics::RenderQueue::Push(const DrawCommand& command) {
+  m_commands.push_back(command);
+}
+
+size_t Engine::Graphics::RenderQueue::Cull(const Frustum& frustum) {
+  size_t count = m_commands.size();
+  m_sphereX.resize(count);
+  m_sphereY.resize(count);
+  m_sphereZ.resize(count);
+  m_sphereRadius.resize(count);
+  m_visible.resize(count);
+
+  for (size_t i = 0; i < count; i++) {
+    const DrawCommand& command = m_commands[i];
+    BoundingSphere sphere = {{0.0f, 0.0f, 0.0f}, INFINITY};
+    if (command.mesh != nullptr && command.instanceCount == 0)
+      sphere = command.mesh->GetBoundingSphere().Transformed(
+        command.transform);
+
+    m_sphereX[i] = sphere.center.x;
+    m_sphereY[i] = sphere.center.y;
+    m_sphereZ[i] = sphere.center.z;
+    m_sphereRadius[i] = sphere.radius;
+  }
+
+  size_t visibleCount = frustum.CullSpheres(m_sphereX.data(),
+    m_sphereY.data(), m_sphereZ.data(), m_sphereRadius.data(), count,
+    m_visible.data());
+  if (visibleCount == count)
+    return 0;
+
+  // The kept commands are compacted in their recorded order
+  size_t kept = 0;
+  for (size_t i = 0; i < count; i++)
+    if (m_visible[i])
+      m_commands[kept++] = m_commands[i];
+  m_commands.resize(kept);
+
+  return count - kept;
+}
+
+size_t Engine::Graphics::RenderQueue::CullOccluded(
+  const OcclusionBuffer& occlusion) {
+  size_t count = m_commands.size();
+  size_t kept = 0;
+  for (size_t i = 0; i < count; i++) {
+    const DrawCommand& command = m_commands[i];
+    bool hidden = command.mesh != nullptr && command.instanceCount == 0
+      && occlusion.IsOccluded(command.mesh->GetBoundingBox().Transformed(
+        command.transform));
+    if (!hidden)
+      m_commands[kept++] = m_commands[i];
+  }
+  m_commands.resize(kept);
+
+  return count - kept;
+}
+
+const std::vector<uint32_t>& Engine::Graphics::RenderQueue::Sort() {
+  size_t count = m_commands.size();
+
+  m_keys.resize(count);
+  m_order.resize(count);
+  m_scratch.resize(count);
+
+  uint64_t differentBits = 0;
+  for (size_t i = 0; i < count; i++) {
+    m_keys[i] = m_commands[i].key;
+    m_order[i] = i;
+    differentBits |= m_keys[i] ^ m_keys[0];
+  }
+
+  // LSD radix sort in 8-bit digits, skipping digits that every key shares
+  for (unsigned shift = 0; shift < 64; shift += 8) {
+    if (((differentBits >> shift) & 0xFF) == 0)
+      continue;
+
+    uint32_t offsets[256] = {0};
+    for (size_t i = 0; i < count; i++)
+      offsets[(m_keys[m_order[i]] >> shift) & 0xFF]++;
+
+    uint32_t total = 0;
+    for (unsigned digit = 0; digit < 256; digit++) {
+      uint32_t amount = offsets[digit];
+      offsets[digit] = total;
+      total += amount;
+    }
+
+    for (size_t i = 0; i < count; i++)
+      m_scratch[offsets[(m_keys[m_order[i]] >> shift) & 0xFF]++] = m_order[i];
+
+    m_order.swap(m_scratch);
+  }
+
+  return m_order;
+}
+
+Engine::Graphics::DrawCommand& Engine::Graphics::RenderQueue::GetCommand(
+  uint32_t index) {
+  return m_commands[index];
+}
+
+size_t Engine::Graphics::RenderQueue::GetCommandCount() {
+  return m_commands.size();
+}
+
+void Engine::Graphics::RenderQueue::Clear() {
+  m_commands.clear();
+}
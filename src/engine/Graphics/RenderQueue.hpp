@@ -0,0 +1,168 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_RENDERQUEUE
+#define ENGINE_RENDERQUEUE
+
+#include "Mesh.hpp"
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "Material.hpp"
+#include "Frustum.hpp"
+#include "OcclusionBuffer.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The amount of texture slots tracked by a draw command
+   */
+  const unsigned int MAX_TEXTURE_SLOTS = 4;
+
+  /**
+   * @brief An object that issues its own draw calls when the queue is flushed
+   *
+   * This allows systems with their own vertex layout (such as sprites) to be
+   * sorted along with every other draw. When the command is reached, the
+   * renderer has already bound the shader of the command and uploaded the
+   * engine uniforms, and the drawable binds everything else it needs.
+   */
+  class QueueDrawable {
+    public:
+
+    /**
+     * @brief Issues the draw calls of the batch
+     *
+     * @param batch the batch number given when the draw was submitted
+     */
+    virtual void ExecuteDraw(unsigned int batch) = 0;
+  };
+
+  /**
+   * @brief A single draw recorded by the renderer
+   *
+   * Stores everything needed to issue the draw later on: the mesh, the
+   * state it was recorded with, and the object transformation matrix.
+   * Instanced draws point to their transformations in the instance buffer of
+   * the renderer, and keep the first one as their transformation matrix.
+   * Commands with a drawable have no mesh. Commands with a material point to
+   * a snapshot of its parameter values, taken when the draw was recorded.
+   */
+  struct DrawCommand {
+    uint64_t key;
+    Mesh* mesh;
+    QueueDrawable* drawable;
+    unsigned int drawableBatch;
+    unsigned int instanceOffset;
+    unsigned int instanceCount;
+    Shader* shader;
+    Material* material;
+    unsigned int parameterOffset;
+    unsigned int parameterSize;
+    Texture* textures[MAX_TEXTURE_SLOTS];
+    float transform[16];
+  };
+
+  /**
+   * @brief A queue of draw commands sorted before they are executed
+   *
+   * Each command gets a 64-bit sort key so that sorting the queue groups
+   * draws by state and orders them by depth. The layout of the key is the
+   * following (most significant bits first):
+   *
+   * - Opaque: layer (7) | 0 (1) | shader (10) | material (10) | texture (12) | depth (24)
+   *
+   * - Transparent: layer (7) | 1 (1) | inverted depth (24) | shader (10) | material (10) | texture (12)
+   *
+   * This way layers are always drawn in order, opaque draws are drawn before
+   * transparent ones with as little state changes as possible (front to back
+   * within the same state), and transparent draws are drawn back to front.
+   *
+   * @authors
+   * - Roberto Selles/Henderythmix
+   */
+  class RenderQueue {
+    private:
+    std::vector<DrawCommand> m_commands;
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_scratch;
+
+    // World bounding spheres of the commands being culled
+    std::vector<float> m_sphereX, m_sphereY, m_sphereZ, m_sphereRadius;
+    std::vector<uint8_t> m_visible;
+
+    public:
+
+    /**
+     * @brief Creates the sort key of a draw
+     *
+     * @param layer the layer of the draw (0 to 127), lower layers draw first
+     * @param transparent if the draw is blended
+     * @param shader the shader used by the draw
+     * @param material the material used by the draw (can be null)
+     * @param texture the texture in the first slot (can be null)
+     * @param depth the distance of the draw from the camera, from 0 to 1
+     * @return the 64-bit sort key
+     */
+    static uint64_t MakeKey(unsigned char layer, bool transparent,
+      Shader* shader, Material* material, Texture* texture, float depth);
+
+    /**
+     * @brief Adds a command to the queue
+     */
+    void Push(const DrawCommand& command);
+
+    /**
+     * @brief Removes the mesh draws that are outside of the frustum
+     *
+     * The bounding sphere of each mesh is moved by the transform of its draw,
+     * and every sphere is tested at once. Instanced draws and drawables are
+     * always kept, since they have no single transform.
+     *
+     * @return the amount of commands removed
+     */
+    size_t Cull(const Frustum& frustum);
+
+    /**
+     * @brief Removes the mesh draws hidden behind the occluders
+     *
+     * The bounding box of each mesh is moved by the transform of its draw
+     * and tested against the depth pyramid. Instanced draws and drawables are
+     * always kept.
+     *
+     * @return the amount of commands removed
+     */
+    size_t CullOccluded(const OcclusionBuffer& occlusion);
+
+    /**
+     * @brief Radix sorts the commands by their keys
+     *
+     * @return the order in which the commands should be executed
+     */
+    const std::vector<uint32_t>& Sort();
+
+    /**
+     * @brief Returns the command at the index
+     */
+    DrawCommand& GetCommand(uint32_t index);
+
+    /**
+     * @brief Returns the amount of commands recorded
+     */
+    size_t GetCommandCount();
+
+    /**
+     * @brief Removes all the commands from the queue
+     *
+     * The memory of the queue is kept so the next frame does not reallocate.
+     */
+    void Clear();
+  };
+}
+
+#endif
@@ -5,156 +5,301 @@
  */
 
 #include "Renderer.hpp"
-#include <emscripten/html5.h>
+#include "StateCache.hpp"
+#include "Backend.hpp"
 #include <iostream>
-
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 
 Engine::Camera DefaultCamera("DefaultCamera", 1.0f);
 
+// The buffer the current thread records into, if not the main one
+static thread_local Engine::Graphics::CommandBuffer* s_recording = nullptr;
+
 // This is moved here to be initialized at renderer construction
 
 Engine::Graphics::Renderer::Renderer(const char* id) : m_camera(&DefaultCamera) {
-  EmscriptenWebGLContextAttributes attrs;
-  emscripten_webgl_init_context_attributes(&attrs);
-  attrs.alpha = EM_TRUE;
-  attrs.depth = EM_TRUE;
-  attrs.stencil = EM_FALSE;
-  attrs.antialias = EM_TRUE;
-  attrs.majorVersion = 2;
-
-  // Generate the WebGL Context
-  m_context = emscripten_webgl_create_context(id, &attrs);
-  emscripten_webgl_make_context_current(m_context);
   m_id = id;
+  GetBackend().CreateContext(id);
 
-  EM_ASM({
-    let name = UTF8ToString($0);
-    game.canvases[UTF8ToString($0)] = document.getElementById(UTF8ToString($0));
-    game.gl[UTF8ToString($0)] = game.canvases[UTF8ToString($0)]
-      .getContext("webgl2");
-  }, id);
+  // The new context starts from the default GL state
+  StateCache& cache = GetStateCache();
+  cache.Reset();
 
   // Setup Clear Color and default render settings
   // Color is apprximately #181818ff
-  glClearColor(0.094f, 0.094f, 0.094f, 1.0f);
-  glEnable(GL_DEPTH_TEST);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_CULL_FACE);
-  glFrontFace(GL_CCW);
-
-  // Generate and configure buffers
-  glGenBuffers(1, &m_vbo);
-  glGenVertexArrays(1, &m_vao);
-  glGenBuffers(1, &m_ebo);
-
-  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-  glBindVertexArray(m_vao);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-  glEnableVertexAttribArray(0);
-  glEnableVertexAttribArray(1);
-  glEnableVertexAttribArray(2);
+  cache.ClearColor(0.094f, 0.094f, 0.094f, 1.0f);
+  cache.SetDepthTest(true);
+  cache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  cache.SetCullFace(true);
+  GetBackend().FrontFace(GL_CCW);
+
+  m_instanceBuffer = GetBackend().CreateBuffer();
 
   std::cout << "DEBUG: Canvas Initialized with tag " << id << std::endl;
-  UseShader(DefaultShader());
 }
 
 void Engine::Graphics::Renderer::ClearBuffer() {
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  GetBackend().Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void Engine::Graphics::Renderer::DrawMesh(Engine::Graphics::Mesh* mesh,
-  Engine::Vec3f position, Engine::Vec3f scale, Engine::Vec3f rotation) {
-  // Generate Data
-  float* vertexBuffer = mesh->GetVertices();
-  unsigned long vertexCount = mesh->GetVertexCount();
-  unsigned short* indexBuffer = mesh->GetIndices();
-  unsigned long indexCount = mesh->GetIndexCount();
-
-  // Prepare Transformation uniforms
-
+void Engine::Graphics::Renderer::BeginFrame() {
   // Window Dimensions
   int WindowDimensions[2] {0, 0}; // Width, Height
-  emscripten_get_canvas_element_size(m_id, &WindowDimensions[0], &WindowDimensions[1]);
-  int windowDimensionsSize = glGetUniformLocation(m_currentShaderProgram, "u_Window");
-  glUniform2f(windowDimensionsSize, WindowDimensions[0], WindowDimensions[1]);
+  GetBackend().GetCanvasSize(m_id, WindowDimensions[0], WindowDimensions[1]);
+  GetStateCache().Viewport(0, 0, WindowDimensions[0], WindowDimensions[1]);
 
-  float FOV = m_camera->getFOV();
+  m_frameConstants.Update(*m_camera, WindowDimensions[0], WindowDimensions[1]);
+  m_frameConstants.Upload();
 
-  // Object Transformation Matrix
-  glm::mat4 transformationMatrix = glm::mat4(1.0f);
+  // Programs without the FrameConstants block still use the old uniforms
+  const FrameConstantsData& frame = m_frameConstants.GetData();
+  memcpy(m_cameraMatrix, frame.View, sizeof(m_cameraMatrix));
+  m_windowSize[0] = frame.Window[0];
+  m_windowSize[1] = frame.Window[1];
+  m_frustum = Frustum(frame.ViewProjection);
+  memcpy(m_viewProjection, frame.ViewProjection, sizeof(m_viewProjection));
 
-  transformationMatrix = glm::translate(transformationMatrix,
-    glm::vec3(position.x, position.y, position.z)); // position
+  m_mainBuffer.Begin(m_cameraMatrix);
+}
 
-  transformationMatrix = glm::rotate(transformationMatrix, glm::radians(rotation.x),
-    glm::vec3(1.0f, 0.0f, 0.0f)); // rotation
-  transformationMatrix = glm::rotate(transformationMatrix, glm::radians(rotation.y),
-    glm::vec3(0.0f, 1.0f, 0.0f)); // rotation
-  transformationMatrix = glm::rotate(transformationMatrix, glm::radians(rotation.z),
-    glm::vec3(0.0f, 0.0f, 1.0f)); // rotation
+Engine::Graphics::CommandBuffer&
+  Engine::Graphics::Renderer::GetCommandBuffer() {
+  return s_recording != nullptr ? *s_recording : m_mainBuffer;
+}
 
-  transformationMatrix = glm::scale(transformationMatrix,
-    glm::vec3(scale.x, scale.y, scale.z)); // scale
+void Engine::Graphics::Renderer::BeginRecording(CommandBuffer& buffer) {
+  // The draws start with the state of the buffer they would have gone into
+  buffer.CopyState(GetCommandBuffer());
+  buffer.Begin(m_cameraMatrix);
+  s_recording = &buffer;
+}
 
-  int transformUniform = glGetUniformLocation(m_currentShaderProgram, "u_Transform");
-  glUniformMatrix4fv(transformUniform, 1, GL_FALSE, &transformationMatrix[0][0]);
+void Engine::Graphics::Renderer::EndRecording() {
+  s_recording = nullptr;
+}
 
-  // Camera Position Matrix
-  Vec3f camPos = m_camera->GetGlobalPosition();
-  Vec3f camRot = m_camera->GetGlobalRotation();
+bool Engine::Graphics::Renderer::IsRecording() {
+  return s_recording != nullptr;
+}
 
-  glm::mat4 cameraMatrix = glm::mat4(1.0f);
-  cameraMatrix = glm::rotate(cameraMatrix, glm::radians(camRot.x),
-    glm::vec3(1.0f, 0.0f, 0.0f)); // rotation
-  cameraMatrix = glm::rotate(cameraMatrix, glm::radians(camRot.y),
-    glm::vec3(0.0f, 1.0f, 0.0f)); // rotation
-  cameraMatrix = glm::rotate(cameraMatrix, glm::radians(camRot.z),
-    glm::vec3(0.0f, 0.0f, 1.0f)); // rotation
-  cameraMatrix = glm::scale(cameraMatrix, glm::vec3(1.0f / FOV,
-    1.0f / FOV, 1.0f / FOV)); // scale
+void Engine::Graphics::Renderer::Submit(CommandBuffer& buffer) {
+  #ifdef ENGINE_THREADING
+  std::lock_guard<std::mutex> lock(m_submitMutex);
+  #endif
+  m_submitted.push_back(&buffer);
+}
 
+void Engine::Graphics::Renderer::Merge(CommandBuffer& buffer) {
+  // Instance and parameter offsets are relative to the data of the buffer
+  uint32_t instanceOffset = m_instanceData.size() / 16;
+  uint32_t parameterOffset = m_parameterData.size();
+
+  for (const DrawCommand& recorded : buffer.GetCommands()) {
+    DrawCommand command = recorded;
+    if (command.instanceCount != 0)
+      command.instanceOffset += instanceOffset;
+    command.parameterOffset += parameterOffset;
+    m_queue.Push(command);
+  }
+
+  const std::vector<float>& instances = buffer.GetInstanceData();
+  m_instanceData.insert(m_instanceData.end(), instances.begin(),
+    instances.end());
+
+  const std::vector<unsigned char>& parameters = buffer.GetParameterData();
+  m_parameterData.insert(m_parameterData.end(), parameters.begin(),
+    parameters.end());
+}
 
-  cameraMatrix = glm::translate(cameraMatrix, glm::vec3(camPos.x / FOV,
-    camPos.y / FOV, camPos.z / FOV)); // position
+void Engine::Graphics::Renderer::DrawMesh(Engine::Graphics::Mesh* mesh,
+  Engine::Vec3f position, Engine::Vec3f scale, Engine::Vec3f rotation) {
+  GetCommandBuffer().DrawMesh(mesh, position, scale, rotation);
+}
 
+void Engine::Graphics::Renderer::DrawMesh(Mesh* mesh, Vec3f position,
+  Vec3f scale, Quatf rotation) {
+  GetCommandBuffer().DrawMesh(mesh, position, scale, rotation);
+}
 
-  int cameraUniform = glGetUniformLocation(m_currentShaderProgram, "u_Camera");
-  glUniformMatrix4fv(cameraUniform, 1, GL_FALSE, &cameraMatrix[0][0]);
+void Engine::Graphics::Renderer::DrawMesh(Mesh* mesh, const float* transform) {
+  GetCommandBuffer().DrawMesh(mesh, transform);
+}
 
-  // Bind data
-  glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Engine::Graphics::Vertex),
-    vertexBuffer, GL_DYNAMIC_DRAW);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned short),
-    indexBuffer, GL_DYNAMIC_DRAW);
+void Engine::Graphics::Renderer::DrawMeshInstanced(Mesh* mesh,
+  std::span<const Transform> instances) {
+  GetCommandBuffer().DrawMeshInstanced(mesh, instances);
+}
+
+void Engine::Graphics::Renderer::SubmitDrawable(QueueDrawable* drawable,
+  unsigned int batch, Shader& shader, Vec3f position, bool transparent) {
+  GetCommandBuffer().SubmitDrawable(drawable, batch, shader, position,
+    transparent);
+}
+
+void Engine::Graphics::Renderer::Flush() {
+  // Buffers recorded on other threads are merged in the order of submission
+  Merge(m_mainBuffer);
+  {
+    #ifdef ENGINE_THREADING
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    #endif
+    for (CommandBuffer* buffer : m_submitted)
+      Merge(*buffer);
+    m_submitted.clear();
+  }
+
+  m_culledCount = m_frustumCulling ? m_queue.Cull(m_frustum) : 0;
+
+  // The hidden draws are removed once the visible ones are known
+  m_occludedCount = 0;
+  if (m_occlusionCulling && !m_occluders.empty()) {
+    m_occlusion.Begin(m_viewProjection);
+    for (Occluder& occluder : m_occluders)
+      m_occlusion.AddOccluder(*occluder.mesh, occluder.transform);
+    m_occlusion.BuildPyramid();
+    m_occludedCount = m_queue.CullOccluded(m_occlusion);
+  }
+  m_occluders.clear();
+
+  const std::vector<uint32_t>& order = m_queue.Sort();
+
+  StateCache& cache = GetStateCache();
+  Backend& backend = GetBackend();
+
+  // Every instance of the frame is uploaded at once
+  if (!m_instanceData.empty()) {
+    cache.BindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    backend.BufferData(GL_ARRAY_BUFFER,
+      m_instanceData.size() * sizeof(float), m_instanceData.data(),
+      GL_STREAM_DRAW);
+  }
+
+  Shader* shader = nullptr;
+  Material* material = nullptr;
+  unsigned int parameterOffset = 0;
+
+  for (uint32_t index : order) {
+    DrawCommand& command = m_queue.GetCommand(index);
+
+    // Blended draws are sorted last, so this only toggles once per layer
+    bool transparent = (command.key >> 56) & 1;
+    cache.SetBlend(transparent);
+    cache.SetDepthMask(!transparent);
+
+    if (command.shader != shader) {
+      shader = command.shader;
+      material = nullptr;
+      cache.UseProgram(shader->GetShaderProgram());
+
+      // The per frame uniforms only change with the program
+      shader->SetUniform(shader->GetEngineUniform(U_WINDOW), m_windowSize);
+      shader->SetUniform(shader->GetEngineUniform(U_CAMERA), m_cameraMatrix);
+    }
+
+    if (command.drawable != nullptr) {
+      command.drawable->ExecuteDraw(command.drawableBatch);
+      continue;
+    }
+
+    // Draws sharing a material can still have recorded different values
+    if (command.material != material
+      || command.parameterOffset != parameterOffset) {
+      material = command.material;
+      parameterOffset = command.parameterOffset;
+      if (material != nullptr)
+        material->ApplyMaterialParams(
+          m_parameterData.data() + parameterOffset, command.parameterSize);
+    }
+
+    for (unsigned slot = 0; slot < MAX_TEXTURE_SLOTS; slot++) {
+      Texture* texture = command.textures[slot];
+      cache.BindTexture(slot, GL_TEXTURE_2D,
+        texture != nullptr ? texture->GetTexture() : 0);
+    }
+
+    // Bind the GPU resident mesh (uploads only if the mesh is dirty)
+    cache.BindVertexArray(command.mesh->GetVertexArray());
+
+    if (command.instanceCount == 0) {
+      shader->SetUniform(shader->GetEngineUniform(U_TRANSFORM),
+        command.transform);
+      backend.DrawElements(GL_TRIANGLES, command.mesh->GetIndexCount(),
+        GL_UNSIGNED_SHORT, 0);
+      continue;
+    }
+
+    // a_Model is a mat4, so it takes the locations 3 to 6
+    cache.BindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    for (unsigned column = 0; column < 4; column++) {
+      backend.EnableVertexAttribArray(3 + column);
+      backend.VertexAttribPointer(3 + column, 4, GL_FLOAT, false,
+        sizeof(float) * 16, sizeof(float)
+          * (command.instanceOffset * 16 + column * 4));
+      backend.VertexAttribDivisor(3 + column, 1);
+    }
+
+    backend.DrawElementsInstanced(GL_TRIANGLES, command.mesh->GetIndexCount(),
+      GL_UNSIGNED_SHORT, 0, command.instanceCount);
+  }
+
+  // The depth buffer can only be cleared with depth writes enabled
+  cache.SetBlend(false);
+  cache.SetDepthMask(true);
+
+  m_queue.Clear();
+  m_instanceData.clear();
+  m_parameterData.clear();
+}
+
+void Engine::Graphics::Renderer::SetFrustumCulling(bool enabled) {
+  m_frustumCulling = enabled;
+}
+
+size_t Engine::Graphics::Renderer::GetCulledCount() {
+  return m_culledCount;
+}
 
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Engine::Graphics::Vertex),
-    (void*)0); // position
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Engine::Graphics::Vertex),
-    (void*)(sizeof(float) * 3)); // texture coordinates
-  glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Engine::Graphics::Vertex),
-    (void*)(sizeof(float) * 5)); // normal
+void Engine::Graphics::Renderer::AddOccluder(Mesh* mesh,
+  const float* transform) {
+  #ifdef ENGINE_THREADING
+  std::lock_guard<std::mutex> lock(m_submitMutex);
+  #endif
+  m_occluders.push_back({mesh, {}});
+  memcpy(m_occluders.back().transform, transform, sizeof(float) * 16);
+}
+
+void Engine::Graphics::Renderer::SetOcclusionCulling(bool enabled) {
+  m_occlusionCulling = enabled;
+}
+
+size_t Engine::Graphics::Renderer::GetOccludedCount() {
+  return m_occludedCount;
+}
 
-  glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, 0);
+Engine::Graphics::OcclusionBuffer&
+  Engine::Graphics::Renderer::GetOcclusionBuffer() {
+  return m_occlusion;
+}
+
+const float* Engine::Graphics::Renderer::GetViewProjection() {
+  return m_viewProjection;
 }
 
 void Engine::Graphics::Renderer::UseShader(Shader& shader) {
-  m_currentShaderProgram = shader.GetShaderProgram();
-  glUseProgram(m_currentShaderProgram);
+  GetCommandBuffer().UseShader(shader);
 }
 
 void Engine::Graphics::Renderer::UseTexture(Engine::Graphics::Texture& texture,
   unsigned int textureSlot) {
-  glActiveTexture(textureSlot);
-  glBindTexture(GL_TEXTURE_2D, texture.GetTexture());
+  GetCommandBuffer().UseTexture(texture, textureSlot);
 }
 
 void Engine::Graphics::Renderer::UseMaterial(Engine::Graphics::Material* material) {
-  UseShader(*material->GetShader());
-  material->ApplyMaterialParams();
+  GetCommandBuffer().UseMaterial(material);
+}
+
+void Engine::Graphics::Renderer::SetLayer(unsigned char layer) {
+  GetCommandBuffer().SetLayer(layer);
 }
 
 void Engine::Graphics::Renderer::SetCameraReference(Engine::Camera& camera) {
@@ -162,5 +307,5 @@ void Engine::Graphics::Renderer::SetCameraReference(Engine::Camera& camera) {
 }
 
 void Engine::Graphics::Renderer::SetBackgroundColor(Vec3f color) {
-  glClearColor(color.x, color.y, color.z, 1.0f);
+  GetStateCache().ClearColor(color.x, color.y, color.z, 1.0f);
 }
@@ -11,11 +11,20 @@
 #include "Shader.hpp"
 #include "Texture.hpp"
 #include "Material.hpp"
+#include "RenderQueue.hpp"
+#include "FrameConstants.hpp"
+#include "CommandBuffer.hpp"
 #include "../GameObject.hpp"
 #include "../GameObjects/Camera.hpp"
 #include <memory>
+#include <span>
+#include <vector>
 #include <GLES3/gl3.h>
 
+#ifdef ENGINE_THREADING
+#include <mutex>
+#endif
+
 namespace Engine::Graphics {
 
   /**
@@ -27,21 +36,62 @@ namespace Engine::Graphics {
    * canvas, you can access it using `Engine::Game::GetInstance().GetRenderer()`,
    * and that will return the main renderer.
    *
+   * Draws are not executed right away. They are recorded into a render queue
+   * along with the state they were recorded with, and the queue is sorted to
+   * reduce state changes (and to draw transparent materials back to front)
+   * before it is flushed at the end of the frame.
+   *
+   * Mesh draws whose bounding sphere is outside of the camera frustum are
+   * removed from the queue before it is sorted, so they never reach the GPU.
+   * Meshes registered with `AddOccluder` are rasterized into a small CPU
+   * depth buffer, and the draws hidden behind them are removed as well.
+   *
+   * The renderer talks to the GPU through the backend returned by
+   * `GetBackend()`, so it can run headless with a `RecordingBackend`.
+   *
    * @authors
    * - Roberto Selles/Henderythmix
    */
   class Renderer {
     private:
-    unsigned long m_context;
     const char* m_id;
 
-    unsigned int m_vbo;
-    unsigned int m_vao;
-    unsigned int m_ebo;
+    CommandBuffer m_mainBuffer;
+    std::vector<CommandBuffer*> m_submitted;
+    #ifdef ENGINE_THREADING
+    std::mutex m_submitMutex;
+    #endif
+
+    RenderQueue m_queue;
 
-    unsigned int m_currentShaderProgram;
+    unsigned int m_instanceBuffer;
+    std::vector<float> m_instanceData;
+    std::vector<unsigned char> m_parameterData;
 
     Camera* m_camera;
+    FrameConstants m_frameConstants;
+    float m_cameraMatrix[16];
+    float m_windowSize[2];
+
+    Frustum m_frustum;
+    bool m_frustumCulling = true;
+    size_t m_culledCount = 0;
+
+    struct Occluder {
+      Mesh* mesh;
+      float transform[16];
+    };
+
+    OcclusionBuffer m_occlusion;
+    std::vector<Occluder> m_occluders;
+    float m_viewProjection[16] = {0};
+    bool m_occlusionCulling = true;
+    size_t m_occludedCount = 0;
+
+    /**
+     * @brief Adds the commands and instances of a buffer to the render queue
+     */
+    void Merge(CommandBuffer& buffer);
 
     public:
 
@@ -57,10 +107,142 @@ namespace Engine::Graphics {
      */
     void ClearBuffer();
 
+    /**
+     * @brief Prepares the per frame data (camera and window) used to record
+     * the draws of the frame
+     *
+     * The view, projection and window size are computed here once, and
+     * uploaded to the `FrameConstants` uniform block shared by every shader.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Sorts and executes every draw recorded this frame
+     *
+     * The draws recorded by the renderer and the command buffers submitted
+     * this frame are merged into one queue before they are sorted.
+     */
+    void Flush();
+
+    /**
+     * @brief Sets if the draws outside of the camera frustum are skipped
+     *
+     * Culling is enabled by default. Disable it when a custom shader places
+     * meshes without the camera of the frame, such as screen space overlays.
+     *
+     * @param enabled false to draw every mesh
+     */
+    void SetFrustumCulling(bool enabled);
+
+    /**
+     * @brief Returns the amount of draws culled by the last flush
+     */
+    size_t GetCulledCount();
+
+    /**
+     * @brief Hides the draws behind a mesh this frame
+     *
+     * The occluder is only rasterized into the occlusion buffer, it must
+     * still be drawn like any other mesh. Good occluders are large meshes
+     * with few triangles, such as walls and buildings, that keep their CPU
+     * data. This can be called from any thread when the engine is built with
+     * `ENGINE_THREADING`.
+     *
+     * @param mesh the mesh hiding what is behind it
+     * @param transform a column-major matrix of 16 floats
+     */
+    void AddOccluder(Mesh* mesh, const float* transform);
+
+    /**
+     * @brief Sets if the draws hidden behind the occluders are skipped
+     *
+     * Occlusion culling is enabled by default, and does nothing on the frames
+     * without occluders.
+     *
+     * @param enabled false to draw the hidden meshes
+     */
+    void SetOcclusionCulling(bool enabled);
+
+    /**
+     * @brief Returns the amount of draws hidden by the occluders in the last
+     * flush
+     */
+    size_t GetOccludedCount();
+
+    /**
+     * @brief Returns the depth buffer the occluders were rasterized into
+     */
+    OcclusionBuffer& GetOcclusionBuffer();
+
+    /**
+     * @brief Returns the column-major view projection of the current frame
+     */
+    const float* GetViewProjection();
+
+    /**
+     * @brief Returns the command buffer the calling thread records into
+     *
+     * This is the buffer given to `BeginRecording` on this thread, or the
+     * buffer of the renderer if the thread is not recording one.
+     */
+    CommandBuffer& GetCommandBuffer();
+
+    /**
+     * @brief Makes the calling thread record its draws into a buffer
+     *
+     * Until `EndRecording` is called, every draw made through the renderer on
+     * this thread (`DrawMesh`, `UseTexture`, ...) goes into the buffer
+     * instead. The buffer is cleared first, and takes the current shader,
+     * material, textures and layer of the buffer the thread was recording
+     * into (the buffer of the renderer on a new thread). Recording does no GL
+     * work, so this can be used on worker threads once `BeginFrame` has been
+     * called.
+     *
+     * ## Example
+     * ```cpp
+     * Engine::Graphics::CommandBuffer buffer;
+     *
+     * std::thread worker([&]() {
+     *   renderer.BeginRecording(buffer);
+     *   heavyNode->Draw();
+     *   renderer.EndRecording();
+     * });
+     * worker.join();
+     * renderer.Submit(buffer);
+     * ```
+     *
+     * @param buffer the buffer to record into
+     */
+    void BeginRecording(CommandBuffer& buffer);
+
+    /**
+     * @brief Stops recording into the buffer of the calling thread
+     */
+    void EndRecording();
+
+    /**
+     * @brief Returns if the calling thread is recording into its own buffer
+     */
+    bool IsRecording();
+
+    /**
+     * @brief Adds a recorded buffer to the draws of this frame
+     *
+     * The buffer is merged when the renderer is flushed, so it must stay
+     * alive and not be recorded again until then. This can be called from
+     * any thread when the engine is built with `ENGINE_THREADING`.
+     *
+     * @param buffer the buffer to submit
+     */
+    void Submit(CommandBuffer& buffer);
+
     /**
      * @brief Draws a mesh to the canvas
      *
-     * Draws a mesh to the canvas with the currently loaded data.
+     * Records a draw of the mesh with the currently loaded data. The draw is
+     * executed when the renderer is flushed at the end of the frame, so the
+     * mesh must stay alive until then. The mesh is only uploaded to the GPU
+     * the first time it is drawn, or after it has been marked dirty.
      * The data loaded (but not required) includes:
      *
      * - Shaders
@@ -77,6 +259,63 @@ namespace Engine::Graphics {
     void DrawMesh(Mesh* mesh, Vec3f position = {0, 0, 0},
       Vec3f scale = {1, 1, 1}, Vec3f rotation = {0, 0, 0});
 
+    /**
+     * @brief Draws a mesh rotated by a quaternion
+     *
+     * @param mesh the mesh to draw
+     * @param position the position of the mesh
+     * @param scale the scaling of the mesh
+     * @param rotation the rotation of the mesh
+     */
+    void DrawMesh(Mesh* mesh, Vec3f position, Vec3f scale, Quatf rotation);
+
+    /**
+     * @brief Draws a mesh with a transformation matrix
+     *
+     * This skips composing the matrix, such as for the cached world matrix
+     * of a game object (`GameObject::GetWorldMatrix()`).
+     *
+     * @param mesh the mesh to draw
+     * @param transform a column-major matrix of 16 floats
+     */
+    void DrawMesh(Mesh* mesh, const float* transform);
+
+    /**
+     * @brief Draws many copies of a mesh in a single draw call
+     *
+     * Every transformation is packed into an instance buffer, and the mesh is
+     * drawn once for all of them. The instance transformations are read in
+     * the vertex shader through `attribute mat4 a_Model`. If the default
+     * shader is loaded, the renderer uses `InstancedShader()` instead. Custom
+     * shaders need a vertex shader that reads `a_Model` such as
+     * `js/instanced.vert`.
+     *
+     * ## Example
+     * ```cpp
+     * std::vector<Engine::Transform> bullets(1000);
+     * renderer.DrawMeshInstanced(&mesh, bullets);
+     * ```
+     *
+     * @param mesh the mesh to draw
+     * @param instances the transformation of each copy
+     */
+    void DrawMeshInstanced(Mesh* mesh, std::span<const Transform> instances);
+
+    /**
+     * @brief Records a draw executed by the drawable itself
+     *
+     * The command is sorted like any other draw using the shader, the
+     * current layer, and the distance from the camera to the position.
+     *
+     * @param drawable the object that issues the draw calls
+     * @param batch a number passed back to the drawable
+     * @param shader the shader used by the drawable
+     * @param position the position used to sort the draw
+     * @param transparent if the draw is blended
+     */
+    void SubmitDrawable(QueueDrawable* drawable, unsigned int batch,
+      Shader& shader, Vec3f position, bool transparent);
+
     /**
      * @brief Sets the currently loaded shader.
      *
@@ -126,6 +365,16 @@ namespace Engine::Graphics {
      */
     void UseMaterial(Material* material);
 
+    /**
+     * @brief Sets the layer of the next draws
+     *
+     * Lower layers are drawn first no matter the depth or state of the draws.
+     * This is useful to draw backgrounds or overlays.
+     *
+     * @param layer the layer from 0 to 127
+     */
+    void SetLayer(unsigned char layer);
+
     /**
      * @brief Sets the camera reference.
      *
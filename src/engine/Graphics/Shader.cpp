@@ -5,10 +5,31 @@
  */
 
 #include "Shader.hpp"
+#include "Backend.hpp"
+#include "FrameConstants.hpp"
+#include "StateCache.hpp"
 #include <GLES3/gl3.h>
-#include <emscripten/html5.h>
 #include <iostream>
-#include "../Game.hpp"
+#include <cstring>
+
+static const char* s_engineUniformNames[Engine::Graphics::ENGINE_UNIFORM_COUNT] = {
+  "u_Window",
+  "u_Transform",
+  "u_Camera"
+};
+
+/**
+ * Returns true if the uniform type is made out of floats
+ */
+static bool IsFloatUniform(unsigned type) {
+  switch (type) {
+    case GL_FLOAT: case GL_FLOAT_VEC2: case GL_FLOAT_VEC3: case GL_FLOAT_VEC4:
+    case GL_FLOAT_MAT2: case GL_FLOAT_MAT3: case GL_FLOAT_MAT4:
+      return true;
+    default:
+      return false;
+  }
+}
 
 Engine::Graphics::Shader::Shader() : Engine::Graphics::Shader("js/default.frag", "js/default.vert") {}
 
@@ -19,73 +40,73 @@ Engine::Graphics::Shader::Shader(const char* frag, const char* vert) {
   m_shaderProgram = 0;
   m_frag = frag;
   m_vert = vert;
-}
-
-void Engine::Graphics::Shader::CompileShader() {
-  // Load shader scripts
-  char *vScript = nullptr, *fScript = nullptr;
-  int vertexShaderSize, fragmentShaderSize;
 
-  int vScriptError, fScriptError;
+  for (int i = 0; i < ENGINE_UNIFORM_COUNT; i++)
+    m_engineUniforms[i] = -1;
+}
 
-  //std::cout << "fetching data from vertex shader " << std::string(m_vert) << " and fragment shader " << std::string(m_frag) << std::endl;
-  emscripten_wget_data(m_frag, (void**)&fScript, &fragmentShaderSize, &fScriptError);
-  emscripten_wget_data(m_vert, (void**)&vScript, &vertexShaderSize, &vScriptError);
+Engine::Graphics::Shader::~Shader() {
+  if (m_shaderProgram != 0)
+    GetStateCache().DeleteProgram(m_shaderProgram);
+}
 
-  while (fScript == 0) emscripten_sleep(0);
-  while (vScript == 0) emscripten_sleep(0);
+void Engine::Graphics::Shader::CompileShader() {
+  Backend& backend = GetBackend();
 
-  if (vScriptError != 0)
-    std::cerr << "ERROR: Failed to load vertex shader " << m_vert << std::endl;
+  // Load shader scripts
+  std::string fScript, vScript;
 
-  if (fScriptError != 0)
+  if (!backend.ReadFile(m_frag, fScript))
     std::cerr << "ERROR: Failed to load fragment shader " << m_frag << std::endl;
 
-  // Compile and check vertex shader
-  unsigned vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vertexShader, 1, &vScript, &vertexShaderSize);
-  glCompileShader(vertexShader);
+  // The default vertex shader is GLSL ES 3.00, and both stages must use the
+  // same version, so older fragment shaders are paired with the legacy one
+  const char* vert = m_vert;
+  if (strcmp(vert, "js/default.vert") == 0
+    && fScript.find("#version 300 es") == std::string::npos)
+    vert = "js/legacy.vert";
 
-  int success;
-  char infoLog[512];
-  glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+  if (!backend.ReadFile(vert, vScript))
+    std::cerr << "ERROR: Failed to load vertex shader " << vert << std::endl;
 
-  if (!success) {
-    glGetShaderInfoLog(vertexShader, 512, 0, infoLog);
+  // Compile and check both stages
+  std::string infoLog;
+  unsigned vertexShader = backend.CompileShader(GL_VERTEX_SHADER,
+    vScript.data(), vScript.size(), infoLog);
+
+  if (!infoLog.empty()) {
     std::cerr << "ERROR: Vertex Shader Failed to compile\n"
       << infoLog << std::endl;
+    infoLog.clear();
   }
 
-  // Compile and check fragment shader
-  unsigned fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragmentShader, 1, &fScript, &fragmentShaderSize);
-  glCompileShader(fragmentShader);
-
-  glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+  unsigned fragmentShader = backend.CompileShader(GL_FRAGMENT_SHADER,
+    fScript.data(), fScript.size(), infoLog);
 
-  if (!success) {
-    glGetShaderInfoLog(fragmentShader, 512, 0, infoLog);
+  if (!infoLog.empty()) {
     std::cerr << "ERROR: Fragment Shader Failed to compile\n"
       << infoLog << std::endl;
+    infoLog.clear();
   }
 
   // Setup shader program
-  m_shaderProgram = glCreateProgram();
-  glAttachShader(m_shaderProgram, vertexShader);
-  glAttachShader(m_shaderProgram, fragmentShader);
+  m_shaderProgram = backend.CreateProgram();
+  backend.AttachShader(m_shaderProgram, vertexShader);
+  backend.AttachShader(m_shaderProgram, fragmentShader);
 
-  glLinkProgram(m_shaderProgram);
+  // Attribute locations only take effect when the program is linked
+  backend.BindAttribLocation(m_shaderProgram, 0, "a_Position");
+  backend.BindAttribLocation(m_shaderProgram, 1, "a_UV");
+  backend.BindAttribLocation(m_shaderProgram, 2, "a_Normal");
+  backend.BindAttribLocation(m_shaderProgram, 3, "a_Model");
 
-  glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, &success);
+  bool success = backend.LinkProgram(m_shaderProgram, infoLog);
 
   // Clean up unneeded data
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
-  delete[] vScript;
-  delete[] fScript;
+  backend.DeleteShader(vertexShader);
+  backend.DeleteShader(fragmentShader);
 
   if (!success) {
-    glGetProgramInfoLog(m_shaderProgram, 512, 0, infoLog);
     std::cerr << "ERROR: Shader Program Failed to link successfully\n"
       << infoLog << std::endl;
 
@@ -96,9 +117,118 @@ void Engine::Graphics::Shader::CompileShader() {
       << m_shaderProgram << std::endl;
   }
 
-  glBindAttribLocation(m_shaderProgram, 0, "a_Position");
-  glBindAttribLocation(m_shaderProgram, 1, "a_UV");
-  glBindAttribLocation(m_shaderProgram, 2, "a_Normal");
+  // Programs declaring the per frame block read it from the shared buffer
+  unsigned frameBlock = backend.GetUniformBlockIndex(m_shaderProgram,
+    "FrameConstants");
+  if (frameBlock != GL_INVALID_INDEX)
+    backend.UniformBlockBinding(m_shaderProgram, frameBlock,
+      FRAME_CONSTANTS_BINDING);
+
+  ReflectUniforms();
+}
+
+void Engine::Graphics::Shader::ReflectUniforms() {
+  Backend& backend = GetBackend();
+  int uniformCount = backend.GetActiveUniformCount(m_shaderProgram);
+
+  m_uniforms.clear();
+  m_uniforms.reserve(uniformCount);
+
+  std::string name;
+  for (int i = 0; i < uniformCount; i++) {
+    int size = 0;
+    unsigned type = 0;
+    backend.GetActiveUniform(m_shaderProgram, i, name, type, size);
+
+    // Arrays are reported as "name[0]"
+    size_t bracket = name.find('[');
+    if (bracket != std::string::npos)
+      name.resize(bracket);
+
+    int location = backend.GetUniformLocation(m_shaderProgram, name.c_str());
+    if (location < 0) // uniforms inside of blocks have no location
+      continue;
+
+    m_uniforms.push_back({name, location, type, size, false,
+      std::vector<unsigned char>(UniformComponents(type) * size * 4)});
+  }
+
+  for (int i = 0; i < ENGINE_UNIFORM_COUNT; i++)
+    m_engineUniforms[i] = GetUniformHandle(s_engineUniformNames[i]);
+}
+
+bool Engine::Graphics::Shader::UpdateShadow(Uniform& uniform,
+  const void* value) {
+  if (uniform.uploaded
+    && memcmp(uniform.shadow.data(), value, uniform.shadow.size()) == 0)
+    return false;
+
+  memcpy(uniform.shadow.data(), value, uniform.shadow.size());
+  uniform.uploaded = true;
+  return true;
+}
+
+int Engine::Graphics::Shader::GetUniformHandle(const char* name) {
+  GetShaderProgram();
+
+  for (size_t i = 0; i < m_uniforms.size(); i++)
+    if (m_uniforms[i].name == name)
+      return i;
+
+  return -1;
+}
+
+int Engine::Graphics::Shader::GetEngineUniform(EngineUniform uniform) {
+  GetShaderProgram();
+  return m_engineUniforms[uniform];
+}
+
+unsigned Engine::Graphics::Shader::GetUniformType(int handle) {
+  if (handle < 0 || handle >= (int)m_uniforms.size())
+    return 0;
+
+  return m_uniforms[handle].type;
+}
+
+int Engine::Graphics::Shader::GetUniformSize(int handle) {
+  if (handle < 0 || handle >= (int)m_uniforms.size())
+    return 0;
+
+  return m_uniforms[handle].size;
+}
+
+void Engine::Graphics::Shader::SetUniform(int handle, const float* values) {
+  if (handle < 0 || handle >= (int)m_uniforms.size())
+    return;
+
+  Uniform& uniform = m_uniforms[handle];
+  if (!IsFloatUniform(uniform.type)) {
+    std::cerr << "ERROR: Uniform " << uniform.name
+      << " does not take float values" << std::endl;
+    return;
+  }
+
+  if (!UpdateShadow(uniform, values))
+    return;
+
+  GetBackend().Uniform(uniform.type, uniform.location, uniform.size, values);
+}
+
+void Engine::Graphics::Shader::SetUniform(int handle, const int* values) {
+  if (handle < 0 || handle >= (int)m_uniforms.size())
+    return;
+
+  Uniform& uniform = m_uniforms[handle];
+  if (IsFloatUniform(uniform.type)) {
+    std::cerr << "ERROR: Uniform " << uniform.name
+      << " does not take integer values" << std::endl;
+    return;
+  }
+
+  if (!UpdateShadow(uniform, values))
+    return;
+
+  GetBackend().Uniform(uniform.type, uniform.location, uniform.size, values);
 }
 
 unsigned int Engine::Graphics::Shader::GetShaderProgram() {
@@ -113,3 +243,9 @@ Engine::Graphics::Shader& Engine::Graphics::DefaultShader() {
   static Engine::Graphics::Shader defaultShader("js/default.frag", "js/default.vert");
   return defaultShader;
 }
+
+Engine::Graphics::Shader& Engine::Graphics::InstancedShader() {
+  static Engine::Graphics::Shader instancedShader("js/default.frag",
+    "js/instanced.vert");
+  return instancedShader;
+}
@@ -7,8 +7,28 @@
 #ifndef ENGINE_SHADER
 #define ENGINE_SHADER
 
+#include <string>
+#include <vector>
+
 namespace Engine::Graphics {
 
+  /**
+   * @brief The uniforms that the engine provides to every shader
+   *
+   * These are resolved once when the shader is linked, so the renderer can
+   * upload them without looking them up by name.
+   *
+   * - U_WINDOW: `uniform vec2 u_Window`
+   * - U_TRANSFORM: `uniform mat4 u_Transform`
+   * - U_CAMERA: `uniform mat4 u_Camera`
+   */
+  enum EngineUniform {
+    U_WINDOW,
+    U_TRANSFORM,
+    U_CAMERA,
+    ENGINE_UNIFORM_COUNT
+  };
+
   /**
    * @brief A class used to load and use shaders
    * 
@@ -37,13 +57,42 @@ namespace Engine::Graphics {
   class Shader {
     private:
 
+    /**
+     * @brief An active uniform of the linked program
+     *
+     * Keeps a shadow copy of the last uploaded value so uploading the same
+     * value twice does not reach the GPU.
+     */
+    struct Uniform {
+      std::string name;
+      int location;
+      unsigned int type;
+      int size;
+      bool uploaded;
+      std::vector<unsigned char> shadow;
+    };
+
     unsigned int m_shaderProgram;
 
     const char* m_frag;
     const char* m_vert;
 
+    std::vector<Uniform> m_uniforms;
+    int m_engineUniforms[ENGINE_UNIFORM_COUNT];
+
     void CompileShader();
 
+    /**
+     * @brief Fills the uniform table with the active uniforms of the program
+     */
+    void ReflectUniforms();
+
+    /**
+     * @brief Returns true if the value differs from the shadow copy, and
+     * updates the shadow copy if it does.
+     */
+    bool UpdateShadow(Uniform& uniform, const void* value);
+
     public:
 
     /**
@@ -73,6 +122,14 @@ namespace Engine::Graphics {
      */
     Shader(const char* frag, const char* vert);
 
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
+    /**
+     * @brief Deletes the program, if it was compiled
+     */
+    ~Shader();
+
     /**
      * @brief Gets the shader program
      * 
@@ -83,6 +140,66 @@ namespace Engine::Graphics {
      * @return the shader program
      */
     unsigned int GetShaderProgram();
+
+    /**
+     * @brief Returns the handle of an active uniform in the shader
+     *
+     * The lookup is done by name, so call this once and keep the handle
+     * instead of calling it every frame.
+     *
+     * @param name the name of the uniform in the shader code
+     * @return the handle of the uniform, or -1 if the uniform is not active
+     */
+    int GetUniformHandle(const char* name);
+
+    /**
+     * @brief Returns the handle of one of the engine provided uniforms
+     *
+     * @param uniform the engine uniform to look for
+     * @return the handle of the uniform, or -1 if the shader does not use it
+     */
+    int GetEngineUniform(EngineUniform uniform);
+
+    /**
+     * @brief Returns the GL type of a uniform (`GL_FLOAT_VEC3`, `GL_INT`...)
+     *
+     * @param handle the handle returned by `GetUniformHandle`
+     * @return the type of the uniform, or 0 if the handle is not valid
+     */
+    unsigned GetUniformType(int handle);
+
+    /**
+     * @brief Returns the amount of elements of a uniform, 1 unless it is an
+     * array
+     *
+     * @param handle the handle returned by `GetUniformHandle`
+     * @return the size of the uniform, or 0 if the handle is not valid
+     */
+    int GetUniformSize(int handle);
+
+    /**
+     * @brief Uploads float data to a uniform
+     *
+     * The amount of floats read depends on the type of the uniform in the
+     * shader (e.g. 2 for `vec2`, 16 for `mat4`). If the value is identical to
+     * the last value uploaded, the upload is skipped.
+     *
+     * @warning The shader must be in use by the renderer
+     *
+     * @param handle the handle returned by `GetUniformHandle`
+     * @param values the values to upload
+     */
+    void SetUniform(int handle, const float* values);
+
+    /**
+     * @brief Uploads integer data to a uniform (ints, bools and samplers)
+     *
+     * @warning The shader must be in use by the renderer
+     *
+     * @param handle the handle returned by `GetUniformHandle`
+     * @param values the values to upload
+     */
+    void SetUniform(int handle, const int* values);
   };
 
   /**
@@ -91,6 +208,14 @@ namespace Engine::Graphics {
    * 
    */
   extern Shader& DefaultShader();
+
+  /**
+   * @brief The default shader used by the renderer for instanced draws.
+   *
+   * Uses `js/instanced.vert`, which reads the transformation of each
+   * instance from the `a_Model` attribute instead of `u_Transform`.
+   */
+  extern Shader& InstancedShader();
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,803 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SoftwareBackend.hpp"
+#include "Shader.hpp"
+#include "../Math.hpp"
+#include <GLES3/gl3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Window coordinates are kept in fixed point with 4 bits of sub-pixel
+// precision, which keeps the edge functions exact in 64 bit integers
+static constexpr int SUBPIXEL_BITS = 4;
+static constexpr long long SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+static constexpr float GUARD_BAND = 1 << 22;
+
+// Triangles are clipped against the near plane and the four sides of the
+// guard band, and each plane adds at most one vertex to the polygon
+static constexpr int CLIP_PLANES = 5;
+static constexpr int MAX_CLIPPED_VERTICES = 3 + CLIP_PLANES;
+
+// The pixels of a row are tested in groups of this size
+static constexpr int LANES = 4;
+
+/**
+ * Returns how far a vertex is inside of a clipping plane, negative if it is
+ * outside
+ */
+template <typename Vertex>
+static float ClipDistance(const Vertex& vertex, int plane) {
+  switch (plane) {
+    case 0: return vertex.depth;
+    case 1: return vertex.x + GUARD_BAND;
+    case 2: return GUARD_BAND - vertex.x;
+    case 3: return vertex.y + GUARD_BAND;
+    default: return GUARD_BAND - vertex.y;
+  }
+}
+
+/**
+ * Clips a convex polygon against a plane
+ *
+ * Window space is an affine transform of the vertex positions, so the
+ * attributes of the new vertices are interpolated linearly.
+ *
+ * @returns The amount of vertices written to `output`
+ */
+template <typename Vertex>
+static int ClipPolygon(const Vertex* input, int count, Vertex* output,
+  int plane) {
+  int clipped = 0;
+  for (int i = 0; i < count; i++) {
+    const Vertex& current = input[i];
+    const Vertex& next = input[(i + 1) % count];
+    float currentDistance = ClipDistance(current, plane);
+    float nextDistance = ClipDistance(next, plane);
+
+    if (currentDistance >= 0.0f)
+      output[clipped++] = current;
+
+    if ((currentDistance >= 0.0f) == (nextDistance >= 0.0f))
+      continue;
+
+    // The edge crosses the plane
+    float t = currentDistance / (currentDistance - nextDistance);
+    Vertex& vertex = output[clipped++];
+    vertex.x = current.x + (next.x - current.x) * t;
+    vertex.y = current.y + (next.y - current.y) * t;
+    vertex.depth = current.depth + (next.depth - current.depth) * t;
+    for (int k = 0; k < 2; k++)
+      vertex.uv[k] = current.uv[k] + (next.uv[k] - current.uv[k]) * t;
+    for (int k = 0; k < 3; k++)
+      vertex.normal[k] = current.normal[k]
+        + (next.normal[k] - current.normal[k]) * t;
+  }
+
+  return clipped;
+}
+
+/**
+ * Returns the factor of a blend function
+ */
+static float BlendFactor(unsigned factor, float sourceAlpha,
+  float destinationAlpha) {
+  switch (factor) {
+    case GL_ZERO: return 0.0f;
+    case GL_SRC_ALPHA: return sourceAlpha;
+    case GL_ONE_MINUS_SRC_ALPHA: return 1.0f - sourceAlpha;
+    case GL_DST_ALPHA: return destinationAlpha;
+    case GL_ONE_MINUS_DST_ALPHA: return 1.0f - destinationAlpha;
+    default: return 1.0f;
+  }
+}
+
+Engine::Graphics::SoftwareBackend::SoftwareBackend() {
+  m_blendFunc[0] = GL_ONE;
+  m_blendFunc[1] = GL_ZERO;
+}
+
+const std::vector<unsigned char>&
+  Engine::Graphics::SoftwareBackend::GetColorBuffer() {
+  ResizeBuffers();
+  return m_color;
+}
+
+const std::vector<float>& Engine::Graphics::SoftwareBackend::GetDepthBuffer() {
+  ResizeBuffers();
+  return m_depth;
+}
+
+const std::vector<unsigned>&
+  Engine::Graphics::SoftwareBackend::GetOverdrawBuffer() {
+  ResizeBuffers();
+  return m_overdraw;
+}
+
+int Engine::Graphics::SoftwareBackend::GetWidth() {
+  ResizeBuffers();
+  return m_width;
+}
+
+int Engine::Graphics::SoftwareBackend::GetHeight() {
+  ResizeBuffers();
+  return m_height;
+}
+
+const Engine::Graphics::RasterStats&
+  Engine::Graphics::SoftwareBackend::GetStats() {
+  return m_stats;
+}
+
+void Engine::Graphics::SoftwareBackend::ResizeBuffers() {
+  int width, height;
+  GetCanvasSize(nullptr, width, height);
+  if (width == m_width && height == m_height)
+    return;
+
+  m_width = width;
+  m_height = height;
+  m_color.assign((size_t)width * height * 4, 0);
+  m_depth.assign((size_t)width * height, 1.0f);
+  m_overdraw.assign((size_t)width * height, 0);
+}
+
+unsigned* Engine::Graphics::SoftwareBackend::BoundBuffer(unsigned target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      return &m_arrayBuffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return &m_vertexArrays[m_vertexArray].elementBuffer;
+    default:
+      return nullptr;
+  }
+}
+
+void Engine::Graphics::SoftwareBackend::Enable(unsigned capability) {
+  RecordingBackend::Enable(capability);
+  if (capability == GL_BLEND) m_blend = true;
+  if (capability == GL_DEPTH_TEST) m_depthTest = true;
+  if (capability == GL_CULL_FACE) m_cullFace = true;
+}
+
+void Engine::Graphics::SoftwareBackend::Disable(unsigned capability) {
+  RecordingBackend::Disable(capability);
+  if (capability == GL_BLEND) m_blend = false;
+  if (capability == GL_DEPTH_TEST) m_depthTest = false;
+  if (capability == GL_CULL_FACE) m_cullFace = false;
+}
+
+void Engine::Graphics::SoftwareBackend::BlendFunc(unsigned source,
+  unsigned destination) {
+  RecordingBackend::BlendFunc(source, destination);
+  m_blendFunc[0] = source;
+  m_blendFunc[1] = destination;
+}
+
+void Engine::Graphics::SoftwareBackend::DepthMask(bool enabled) {
+  RecordingBackend::DepthMask(enabled);
+  m_depthMask = enabled;
+}
+
+void Engine::Graphics::SoftwareBackend::FrontFace(unsigned mode) {
+  RecordingBackend::FrontFace(mode);
+  m_frontFaceCCW = mode == GL_CCW;
+}
+
+void Engine::Graphics::SoftwareBackend::Viewport(int x, int y, int width,
+  int height) {
+  RecordingBackend::Viewport(x, y, width, height);
+  m_viewport[0] = x;
+  m_viewport[1] = y;
+  m_viewport[2] = width;
+  m_viewport[3] = height;
+}
+
+void Engine::Graphics::SoftwareBackend::ClearColor(float r, float g, float b,
+  float a) {
+  RecordingBackend::ClearColor(r, g, b, a);
+  m_clearColor[0] = r;
+  m_clearColor[1] = g;
+  m_clearColor[2] = b;
+  m_clearColor[3] = a;
+}
+
+void Engine::Graphics::SoftwareBackend::Clear(unsigned mask) {
+  RecordingBackend::Clear(mask);
+  ResizeBuffers();
+
+  if (mask & GL_COLOR_BUFFER_BIT) {
+    unsigned char color[4];
+    for (int i = 0; i < 4; i++)
+      color[i] = std::clamp(m_clearColor[i], 0.0f, 1.0f) * 255.0f + 0.5f;
+
+    for (size_t i = 0; i < m_color.size(); i += 4)
+      memcpy(&m_color[i], color, 4);
+
+    // A new frame starts with the color buffer
+    std::fill(m_overdraw.begin(), m_overdraw.end(), 0);
+    m_stats = RasterStats();
+  }
+
+  // Like GL, the depth buffer is only cleared if it can be written to
+  if ((mask & GL_DEPTH_BUFFER_BIT) && m_depthMask)
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+}
+
+void Engine::Graphics::SoftwareBackend::DeleteBuffers(int count,
+  const unsigned* buffers) {
+  RecordingBackend::DeleteBuffers(count, buffers);
+  for (int i = 0; i < count; i++)
+    m_buffers.erase(buffers[i]);
+}
+
+void Engine::Graphics::SoftwareBackend::BindBuffer(unsigned target,
+  unsigned buffer) {
+  RecordingBackend::BindBuffer(target, buffer);
+  unsigned* bound = BoundBuffer(target);
+  if (bound != nullptr)
+    *bound = buffer;
+}
+
+void Engine::Graphics::SoftwareBackend::BufferData(unsigned target,
+  size_t size, const void* data, unsigned usage) {
+  RecordingBackend::BufferData(target, size, data, usage);
+  unsigned* bound = BoundBuffer(target);
+  if (bound == nullptr)
+    return;
+
+  std::vector<unsigned char>& buffer = m_buffers[*bound];
+  buffer.assign(size, 0);
+  if (data != nullptr)
+    memcpy(buffer.data(), data, size);
+}
+
+void Engine::Graphics::SoftwareBackend::BufferSubData(unsigned target,
+  size_t offset, size_t size, const void* data) {
+  RecordingBackend::BufferSubData(target, offset, size, data);
+  unsigned* bound = BoundBuffer(target);
+  if (bound == nullptr)
+    return;
+
+  std::vector<unsigned char>& buffer = m_buffers[*bound];
+  if (offset + size <= buffer.size())
+    memcpy(buffer.data() + offset, data, size);
+}
+
+void Engine::Graphics::SoftwareBackend::DeleteVertexArrays(int count,
+  const unsigned* vertexArrays) {
+  RecordingBackend::DeleteVertexArrays(count, vertexArrays);
+  for (int i = 0; i < count; i++) {
+    m_vertexArrays.erase(vertexArrays[i]);
+    if (m_vertexArray == vertexArrays[i])
+      m_vertexArray = 0;
+  }
+}
+
+void Engine::Graphics::SoftwareBackend::BindVertexArray(unsigned vertexArray) {
+  RecordingBackend::BindVertexArray(vertexArray);
+  m_vertexArray = vertexArray;
+}
+
+void Engine::Graphics::SoftwareBackend::EnableVertexAttribArray(
+  unsigned index) {
+  RecordingBackend::EnableVertexAttribArray(index);
+  if (index < 7)
+    m_vertexArrays[m_vertexArray].attributes[index].enabled = true;
+}
+
+void Engine::Graphics::SoftwareBackend::VertexAttribPointer(unsigned index,
+  int size, unsigned type, bool normalized, int stride, size_t offset) {
+  RecordingBackend::VertexAttribPointer(index, size, type, normalized, stride,
+    offset);
+  if (index >= 7)
+    return;
+
+  VertexAttribute& attribute = m_vertexArrays[m_vertexArray].attributes[index];
+  attribute.buffer = m_arrayBuffer;
+  attribute.size = size;
+  attribute.type = type;
+  attribute.stride = stride;
+  attribute.offset = offset;
+}
+
+void Engine::Graphics::SoftwareBackend::VertexAttribDivisor(unsigned index,
+  unsigned divisor) {
+  RecordingBackend::VertexAttribDivisor(index, divisor);
+  if (index < 7)
+    m_vertexArrays[m_vertexArray].attributes[index].divisor = divisor;
+}
+
+void Engine::Graphics::SoftwareBackend::DeleteTextures(int count,
+  const unsigned* textures) {
+  RecordingBackend::DeleteTextures(count, textures);
+  for (int i = 0; i < count; i++)
+    m_textures.erase(textures[i]);
+}
+
+void Engine::Graphics::SoftwareBackend::ActiveTexture(unsigned unit) {
+  RecordingBackend::ActiveTexture(unit);
+  m_activeUnit = std::min<unsigned>(unit - GL_TEXTURE0, 15);
+}
+
+void Engine::Graphics::SoftwareBackend::BindTexture(unsigned target,
+  unsigned texture) {
+  RecordingBackend::BindTexture(target, texture);
+  if (target == GL_TEXTURE_2D)
+    m_boundTextures[m_activeUnit] = texture;
+}
+
+void Engine::Graphics::SoftwareBackend::TexImage2D(unsigned target,
+  int level, int internalFormat, int width, int height, unsigned format,
+  unsigned type, const void* pixels) {
+  RecordingBackend::TexImage2D(target, level, internalFormat, width, height,
+    format, type, pixels);
+
+  // Only the base level of RGBA textures is sampled
+  if (target != GL_TEXTURE_2D || level != 0 || format != GL_RGBA
+    || type != GL_UNSIGNED_BYTE)
+    return;
+
+  TextureImage& image = m_textures[m_boundTextures[m_activeUnit]];
+  image.width = width;
+  image.height = height;
+  image.pixels.assign((size_t)width * height * 4, 0);
+  if (pixels != nullptr)
+    memcpy(image.pixels.data(), pixels, image.pixels.size());
+}
+
+void Engine::Graphics::SoftwareBackend::DeleteProgram(unsigned program) {
+  RecordingBackend::DeleteProgram(program);
+  m_programs.erase(program);
+}
+
+void Engine::Graphics::SoftwareBackend::UseProgram(unsigned program) {
+  RecordingBackend::UseProgram(program);
+  m_program = program;
+}
+
+void Engine::Graphics::SoftwareBackend::Uniform(unsigned type, int location,
+  int count, const float* values) {
+  RecordingBackend::Uniform(type, location, count, values);
+
+  ProgramState& program = m_programs[m_program];
+  switch (location) {
+    case U_WINDOW:
+      memcpy(program.window, values, sizeof(program.window));
+      break;
+    case U_TRANSFORM:
+      memcpy(program.transform, values, sizeof(program.transform));
+      break;
+    case U_CAMERA:
+      memcpy(program.camera, values, sizeof(program.camera));
+      break;
+  }
+}
+
+void Engine::Graphics::SoftwareBackend::DrawElements(unsigned mode, int count,
+  unsigned type, size_t offset) {
+  RecordingBackend::DrawElements(mode, count, type, offset);
+  if (mode == GL_TRIANGLES)
+    Draw(count, type, offset, 0);
+}
+
+void Engine::Graphics::SoftwareBackend::DrawElementsInstanced(unsigned mode,
+  int count, unsigned type, size_t offset, int instanceCount) {
+  RecordingBackend::DrawElementsInstanced(mode, count, type, offset,
+    instanceCount);
+  if (mode == GL_TRIANGLES)
+    Draw(count, type, offset, instanceCount);
+}
+
+void Engine::Graphics::SoftwareBackend::ReadAttribute(
+  const VertexAttribute& attribute, size_t index, float* values, int count) {
+  static const float defaults[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  memcpy(values, defaults, sizeof(float) * count);
+
+  auto buffer = m_buffers.find(attribute.buffer);
+  if (!attribute.enabled || buffer == m_buffers.end())
+    return;
+
+  size_t componentSize = attribute.type == GL_FLOAT ? sizeof(float) : 1;
+  size_t stride = attribute.stride != 0 ? attribute.stride
+    : attribute.size * componentSize;
+  size_t start = attribute.offset + index * stride;
+  int components = std::min(attribute.size, count);
+  if (start + components * componentSize > buffer->second.size())
+    return;
+
+  const unsigned char* data = buffer->second.data() + start;
+  for (int i = 0; i < components; i++) {
+    if (attribute.type == GL_FLOAT)
+      memcpy(&values[i], data + i * sizeof(float), sizeof(float));
+    else if (attribute.type == GL_UNSIGNED_BYTE)
+      values[i] = data[i] / 255.0f;
+  }
+}
+
+Engine::Graphics::SoftwareBackend::ShadedVertex
+  Engine::Graphics::SoftwareBackend::ShadeVertex(const float* model,
+  const ProgramState& program, size_t index) {
+  const VertexArrayState& vertexArray = m_vertexArrays[m_vertexArray];
+
+  float position[4], uv[2], normal[3];
+  ReadAttribute(vertexArray.attributes[0], index, position, 4);
+  ReadAttribute(vertexArray.attributes[1], index, uv, 2);
+  ReadAttribute(vertexArray.attributes[2], index, normal, 3);
+  position[3] = 1.0f;
+
+  // newPos = u_Camera * u_Transform * vec4(a_Position, 1.0)
+  float world[4], view[4];
+  for (int row = 0; row < 4; row++) {
+    world[row] = 0.0f;
+    for (int column = 0; column < 4; column++)
+      world[row] += model[column * 4 + row] * position[column];
+  }
+
+  for (int row = 0; row < 4; row++) {
+    view[row] = 0.0f;
+    for (int column = 0; column < 4; column++)
+      view[row] += program.camera[column * 4 + row] * world[column];
+  }
+
+  // The shorter side of the window spans -1 to 1
+  const float* window = program.window;
+  if (window[1] < window[0])
+    view[0] *= window[1] / window[0];
+  else
+    view[1] *= window[0] / window[1];
+
+  ShadedVertex vertex;
+  vertex.x = m_viewport[0] + (view[0] + 1.0f) * 0.5f * m_viewport[2];
+  vertex.y = m_viewport[1] + (view[1] + 1.0f) * 0.5f * m_viewport[3];
+  vertex.depth = ((view[2] - 100.0f) / 100.0f + 1.0f) * 0.5f;
+
+  vertex.uv[0] = uv[0];
+  vertex.uv[1] = uv[1];
+
+  float length = 0.0f;
+  for (int row = 0; row < 3; row++) {
+    vertex.normal[row] = 0.0f;
+    for (int column = 0; column < 3; column++)
+      vertex.normal[row] += model[column * 4 + row] * normal[column];
+    length += vertex.normal[row] * vertex.normal[row];
+  }
+
+  if (length > 0.0f) {
+    length = sqrtf(length);
+    for (int i = 0; i < 3; i++)
+      vertex.normal[i] /= length;
+  }
+
+  return vertex;
+}
+
+void Engine::Graphics::SoftwareBackend::Draw(int count, unsigned type,
+  size_t offset, int instanceCount) {
+  ResizeBuffers();
+  if (m_viewport[2] == 0 || m_viewport[3] == 0) {
+    m_viewport[2] = m_width;
+    m_viewport[3] = m_height;
+  }
+
+  const VertexArrayState& vertexArray = m_vertexArrays[m_vertexArray];
+  auto elements = m_buffers.find(vertexArray.elementBuffer);
+  if (elements == m_buffers.end())
+    return;
+
+  size_t indexSize = type == GL_UNSIGNED_INT ? 4
+    : type == GL_UNSIGNED_SHORT ? 2 : 1;
+  if (offset + count * indexSize > elements->second.size())
+    return;
+
+  const unsigned char* indexData = elements->second.data() + offset;
+  auto readIndex = [indexData, indexSize](int i) -> size_t {
+    if (indexSize == 4) {
+      unsigned index;
+      memcpy(&index, indexData + i * 4, 4);
+      return index;
+    }
+    if (indexSize == 2) {
+      unsigned short index;
+      memcpy(&index, indexData + i * 2, 2);
+      return index;
+    }
+    return indexData[i];
+  };
+
+  const ProgramState& program = m_programs[m_program];
+
+  for (int instance = 0; instance < std::max(instanceCount, 1); instance++) {
+    // Instanced draws take their model matrix from a_Model
+    float model[16];
+    if (instanceCount == 0)
+      memcpy(model, program.transform, sizeof(model));
+    else
+      for (int column = 0; column < 4; column++) {
+        const VertexAttribute& attribute = vertexArray.attributes[3 + column];
+        size_t index = attribute.divisor != 0 ? instance / attribute.divisor
+          : instance;
+        ReadAttribute(attribute, index, &model[column * 4], 4);
+      }
+
+    for (int i = 0; i + 2 < count; i += 3)
+      DrawTriangle(ShadeVertex(model, program, readIndex(i)),
+        ShadeVertex(model, program, readIndex(i + 1)),
+        ShadeVertex(model, program, readIndex(i + 2)));
+  }
+}
+
+void Engine::Graphics::SoftwareBackend::DrawTriangle(ShadedVertex a,
+  ShadedVertex b, ShadedVertex c) {
+  // Twice the signed area, positive when counter clockwise. Vertices are
+  // not clipped yet, so the area is taken in double precision
+  double area = ((double)b.x - a.x) * ((double)c.y - a.y)
+    - ((double)b.y - a.y) * ((double)c.x - a.x);
+  if (area == 0.0 || std::isnan(area))
+    return;
+
+  bool front = m_frontFaceCCW ? area > 0.0 : area < 0.0;
+  if (m_cullFace && !front) {
+    m_stats.culledTriangles++;
+    return;
+  }
+
+  // Most triangles are inside of every plane, and are not clipped
+  ShadedVertex polygons[2][MAX_CLIPPED_VERTICES] = {{a, b, c}};
+  int count = 3;
+  int current = 0;
+  for (int plane = 0; plane < CLIP_PLANES && count >= 3; plane++) {
+    bool inside = true;
+    for (int i = 0; i < count && inside; i++)
+      inside = ClipDistance(polygons[current][i], plane) >= 0.0f;
+
+    if (inside)
+      continue;
+
+    count = ClipPolygon(polygons[current], count, polygons[1 - current],
+      plane);
+    current = 1 - current;
+  }
+
+  if (count < 3)
+    return;
+
+  m_stats.triangles++;
+
+  // Clipping keeps the winding, so the polygon is split into a fan
+  const ShadedVertex* polygon = polygons[current];
+  for (int i = 1; i + 1 < count; i++)
+    RasterizeTriangle(polygon[0], polygon[i], polygon[i + 1], area > 0.0);
+}
+
+void Engine::Graphics::SoftwareBackend::RasterizeTriangle(ShadedVertex a,
+  ShadedVertex b, ShadedVertex c, bool counterClockwise) {
+  long long x[3] = {std::llround(a.x * SUBPIXEL_ONE),
+    std::llround(b.x * SUBPIXEL_ONE), std::llround(c.x * SUBPIXEL_ONE)};
+  long long y[3] = {std::llround(a.y * SUBPIXEL_ONE),
+    std::llround(b.y * SUBPIXEL_ONE), std::llround(c.y * SUBPIXEL_ONE)};
+
+  long long area = (x[1] - x[0]) * (y[2] - y[0])
+    - (y[1] - y[0]) * (x[2] - x[0]);
+  if (area == 0 || (area > 0) != counterClockwise)
+    return;
+
+  // The edge functions expect counter clockwise vertices
+  if (area < 0) {
+    std::swap(b, c);
+    std::swap(x[1], x[2]);
+    std::swap(y[1], y[2]);
+    area = -area;
+  }
+
+  TriangleSetup setup;
+  setup.vertices[0] = a;
+  setup.vertices[1] = b;
+  setup.vertices[2] = c;
+  setup.area = area;
+
+  // Pixels whose center may be inside, clipped to the viewport
+  long long minX = std::min({x[0], x[1], x[2]});
+  long long maxX = std::max({x[0], x[1], x[2]});
+  long long minY = std::min({y[0], y[1], y[2]});
+  long long maxY = std::max({y[0], y[1], y[2]});
+  setup.bounds[0] = std::max<long long>({minX >> SUBPIXEL_BITS, m_viewport[0],
+    0});
+  setup.bounds[1] = std::max<long long>({minY >> SUBPIXEL_BITS, m_viewport[1],
+    0});
+  setup.bounds[2] = std::min<long long>({maxX >> SUBPIXEL_BITS,
+    m_viewport[0] + m_viewport[2] - 1, m_width - 1});
+  setup.bounds[3] = std::min<long long>({maxY >> SUBPIXEL_BITS,
+    m_viewport[1] + m_viewport[3] - 1, m_height - 1});
+
+  if (setup.bounds[0] > setup.bounds[2] || setup.bounds[1] > setup.bounds[3])
+    return;
+
+  // Each edge is opposite to the vertex it weights, and is evaluated at the
+  // center of the pixel (0, 0)
+  const long long xs[3] = {x[1], x[2], x[0]}, ys[3] = {y[1], y[2], y[0]};
+  const long long xe[3] = {x[2], x[0], x[1]}, ye[3] = {y[2], y[0], y[1]};
+  const long long center = SUBPIXEL_ONE / 2;
+  for (int k = 0; k < 3; k++) {
+    long long dx = xe[k] - xs[k], dy = ye[k] - ys[k];
+    setup.edges[k] = dx * (center - ys[k]) - dy * (center - xs[k]);
+    setup.stepX[k] = -dy * SUBPIXEL_ONE;
+    setup.stepY[k] = dx * SUBPIXEL_ONE;
+
+    // Top left rule: pixels on the bottom or right edges belong to the
+    // triangle next to them
+    bool topLeft = dy < 0 || (dy == 0 && dx < 0);
+    setup.biases[k] = topLeft ? 0 : -1;
+  }
+
+  const int tile = SOFTWARE_TILE_SIZE;
+  for (int tileY = setup.bounds[1] / tile; tileY <= setup.bounds[3] / tile;
+    tileY++)
+    for (int tileX = setup.bounds[0] / tile; tileX <= setup.bounds[2] / tile;
+      tileX++) {
+      // The edge functions are linear, so the corners of a tile bound them
+      bool outside = false, covered = true;
+      for (int k = 0; k < 3 && !outside; k++) {
+        long long corner = setup.edges[k] + setup.biases[k]
+          + setup.stepX[k] * tileX * tile + setup.stepY[k] * tileY * tile;
+        long long across = setup.stepX[k] * (tile - 1);
+        long long up = setup.stepY[k] * (tile - 1);
+
+        long long low = corner + std::min<long long>(across, 0)
+          + std::min<long long>(up, 0);
+        long long high = corner + std::max<long long>(across, 0)
+          + std::max<long long>(up, 0);
+
+        outside = high < 0;
+        covered = covered && low >= 0;
+      }
+
+      if (!outside)
+        RasterizeTile(setup, tileX, tileY, covered);
+    }
+}
+
+void Engine::Graphics::SoftwareBackend::RasterizeTile(
+  const TriangleSetup& setup, int tileX, int tileY, bool covered) {
+  const int tile = SOFTWARE_TILE_SIZE;
+  int startX = std::max(tileX * tile, setup.bounds[0]);
+  int endX = std::min(tileX * tile + tile - 1, setup.bounds[2]);
+  int startY = std::max(tileY * tile, setup.bounds[1]);
+  int endY = std::min(tileY * tile + tile - 1, setup.bounds[3]);
+
+  float inverseArea = 1.0f / setup.area;
+
+  for (int y = startY; y <= endY; y++) {
+    long long row[3];
+    for (int k = 0; k < 3; k++)
+      row[k] = setup.edges[k] + setup.stepX[k] * startX + setup.stepY[k] * y;
+
+    #ifdef ENGINE_SIMD
+    // The edge functions need 64 bits, so the 4 lanes of a group take two
+    // registers per edge, which are stepped along the row
+    v128_t low[3], high[3], step[3], bias[3];
+    for (int k = 0; k < 3; k++) {
+      long long stepX = setup.stepX[k];
+      low[k] = wasm_i64x2_make(row[k], row[k] + stepX);
+      high[k] = wasm_i64x2_make(row[k] + stepX * 2, row[k] + stepX * 3);
+      step[k] = wasm_i64x2_splat(stepX * LANES);
+      bias[k] = wasm_i64x2_splat(setup.biases[k]);
+    }
+    const v128_t zero = wasm_i64x2_splat(0);
+    #endif
+
+    for (int x = startX; x <= endX; x += LANES) {
+      // Test a group of pixels against the three edges at once, keeping a
+      // bit per pixel inside
+      long long lanes[3][LANES];
+      int inside = (1 << std::min(LANES, endX - x + 1)) - 1;
+
+      #ifdef ENGINE_SIMD
+      for (int k = 0; k < 3; k++) {
+        if (!covered)
+          inside &= wasm_i64x2_bitmask(wasm_i64x2_ge(wasm_i64x2_add(low[k],
+            bias[k]), zero)) | wasm_i64x2_bitmask(wasm_i64x2_ge(
+            wasm_i64x2_add(high[k], bias[k]), zero)) << 2;
+
+        wasm_v128_store(&lanes[k][0], low[k]);
+        wasm_v128_store(&lanes[k][2], high[k]);
+        low[k] = wasm_i64x2_add(low[k], step[k]);
+        high[k] = wasm_i64x2_add(high[k], step[k]);
+      }
+      #else
+      for (int k = 0; k < 3; k++)
+        for (int l = 0; l < LANES; l++) {
+          lanes[k][l] = row[k] + setup.stepX[k] * (x - startX + l);
+          if (!covered && lanes[k][l] + setup.biases[k] < 0)
+            inside &= ~(1 << l);
+        }
+      #endif
+
+      for (int l = 0; l < LANES; l++) {
+        if (!(inside & (1 << l)))
+          continue;
+
+        float weights[3] = {lanes[0][l] * inverseArea,
+          lanes[1][l] * inverseArea, lanes[2][l] * inverseArea};
+        ShadeFragment(x + l, y, weights, setup.vertices);
+      }
+    }
+  }
+}
+
+void Engine::Graphics::SoftwareBackend::ShadeFragment(int x, int y,
+  const float* weights, const ShadedVertex* vertices) {
+  float depth = weights[0] * vertices[0].depth
+    + weights[1] * vertices[1].depth + weights[2] * vertices[2].depth;
+
+  // Fragments outside of the depth range are clipped
+  if (depth < 0.0f || depth > 1.0f)
+    return;
+
+  m_stats.fragments++;
+
+  size_t pixel = (size_t)y * m_width + x;
+  if (m_depthTest && !(depth < m_depth[pixel]))
+    return;
+
+  m_stats.shadedFragments++;
+  m_overdraw[pixel]++;
+
+  float uv[2], normal[3];
+  for (int i = 0; i < 2; i++)
+    uv[i] = weights[0] * vertices[0].uv[i] + weights[1] * vertices[1].uv[i]
+      + weights[2] * vertices[2].uv[i];
+  for (int i = 0; i < 3; i++)
+    normal[i] = weights[0] * vertices[0].normal[i]
+      + weights[1] * vertices[1].normal[i]
+      + weights[2] * vertices[2].normal[i];
+
+  // texture(u_Color, v_UV), nearest and repeating like the engine textures.
+  // Textures that are not loaded read as opaque black, like in WebGL
+  float image[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  auto texture = m_textures.find(m_boundTextures[0]);
+  if (texture != m_textures.end() && !texture->second.pixels.empty()) {
+    const TextureImage& source = texture->second;
+    int u = (int)floorf((uv[0] - floorf(uv[0])) * source.width);
+    int v = (int)floorf((uv[1] - floorf(uv[1])) * source.height);
+    u = std::clamp(u, 0, source.width - 1);
+    v = std::clamp(v, 0, source.height - 1);
+
+    const unsigned char* texel = &source.pixels[((size_t)v * source.width + u)
+      * 4];
+    for (int i = 0; i < 4; i++)
+      image[i] = texel[i] / 255.0f;
+  }
+
+  if (image[3] < 0.1f)
+    return;
+
+  float lighting = (normal[0] * -0.1f + normal[1] * -0.5f + normal[2])
+    / sqrtf(2.26f);
+
+  float color[4] = {image[0] * lighting, image[1] * lighting,
+    image[2] * lighting, image[3]};
+
+  unsigned char* target = &m_color[pixel * 4];
+  if (m_blend) {
+    float destination[4];
+    for (int i = 0; i < 4; i++)
+      destination[i] = target[i] / 255.0f;
+
+    float sourceFactor = BlendFactor(m_blendFunc[0], color[3], destination[3]);
+    float destinationFactor = BlendFactor(m_blendFunc[1], color[3],
+      destination[3]);
+    for (int i = 0; i < 4; i++)
+      color[i] = color[i] * sourceFactor + destination[i] * destinationFactor;
+  }
+
+  for (int i = 0; i < 4; i++)
+    target[i] = std::clamp(color[i], 0.0f, 1.0f) * 255.0f + 0.5f;
+
+  if (m_depthTest && m_depthMask)
+    m_depth[pixel] = depth;
+}
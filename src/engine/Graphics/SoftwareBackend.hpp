@@ -0,0 +1,291 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_SOFTWAREBACKEND
+#define ENGINE_SOFTWAREBACKEND
+
+#include "RecordingBackend.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The amount of pixels on each side of a rasterizer tile
+   */
+  constexpr int SOFTWARE_TILE_SIZE = 16;
+
+  /**
+   * @brief The work done by the software rasterizer since the last clear
+   *
+   * - triangles: the triangles that reached the rasterizer
+   * - culledTriangles: the triangles dropped for facing away
+   * - fragments: the pixels covered by the triangles
+   * - shadedFragments: the covered pixels that passed the depth test and
+   *   ran the fragment stage
+   */
+  struct RasterStats {
+    size_t triangles = 0;
+    size_t culledTriangles = 0;
+    size_t fragments = 0;
+    size_t shadedFragments = 0;
+  };
+
+  /**
+   * @brief A backend that draws on the CPU
+   *
+   * This is a reference rasterizer for the default pipeline of the engine.
+   * Every draw is executed as `js/legacy.vert` (`u_Transform`, `u_Camera`
+   * and `u_Window`, or the `a_Model` of instanced draws) followed by
+   * `js/default.frag`, whatever the program, so only meshes using the
+   * default layout (position, UV and normal as floats) draw correctly.
+   *
+   * Triangles are rasterized tile by tile, with fixed point edge functions
+   * and the top left fill rule, so results are exact from one machine to
+   * the next. Depth testing (`GL_LESS`), depth writes, back face culling and
+   * alpha blending follow the state set by the engine.
+   *
+   * The color, depth and overdraw buffers are the size of the canvas, and
+   * their rows go from the bottom to the top like `glReadPixels`. The
+   * overdraw buffer counts how many fragments were shaded for each pixel, so
+   * it measures the fill cost of a scene. Every call is also recorded, as in
+   * `RecordingBackend`.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::SoftwareBackend backend;
+   * backend.SetCanvasSize(320, 240);
+   * Engine::Graphics::SetBackend(backend);
+   *
+   * renderer.ClearBuffer();
+   * renderer.BeginFrame();
+   * scene.Draw();
+   * renderer.Flush();
+   *
+   * float overdraw = (float)backend.GetStats().shadedFragments
+   *   / (320 * 240);
+   * ```
+   */
+  class SoftwareBackend : public RecordingBackend {
+    private:
+    struct VertexAttribute {
+      bool enabled = false;
+      unsigned buffer = 0;
+      int size = 4;
+      unsigned type = 0;
+      int stride = 0;
+      size_t offset = 0;
+      unsigned divisor = 0;
+    };
+
+    struct VertexArrayState {
+      unsigned elementBuffer = 0;
+      VertexAttribute attributes[7];
+    };
+
+    struct ProgramState {
+      float transform[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+      float camera[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+      float window[2] = {1, 1};
+    };
+
+    struct TextureImage {
+      int width = 0;
+      int height = 0;
+      std::vector<unsigned char> pixels;
+    };
+
+    /**
+     * @brief A vertex after the vertex stage, in window space
+     */
+    struct ShadedVertex {
+      float x, y;
+      float depth;
+      float uv[2];
+      float normal[3];
+    };
+
+    std::unordered_map<unsigned, std::vector<unsigned char>> m_buffers;
+    std::unordered_map<unsigned, VertexArrayState> m_vertexArrays;
+    std::unordered_map<unsigned, ProgramState> m_programs;
+    std::unordered_map<unsigned, TextureImage> m_textures;
+
+    unsigned m_arrayBuffer = 0;
+    unsigned m_vertexArray = 0;
+    unsigned m_program = 0;
+    unsigned m_activeUnit = 0;
+    unsigned m_boundTextures[16] = {0};
+
+    bool m_blend = false;
+    bool m_depthTest = false;
+    bool m_cullFace = false;
+    bool m_depthMask = true;
+    bool m_frontFaceCCW = true;
+    unsigned m_blendFunc[2];
+    float m_clearColor[4] = {0, 0, 0, 0};
+    int m_viewport[4] = {0, 0, 0, 0};
+
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<unsigned char> m_color;
+    std::vector<float> m_depth;
+    std::vector<unsigned> m_overdraw;
+    RasterStats m_stats;
+
+    /**
+     * @brief Resizes the buffers to the canvas if it changed size
+     */
+    void ResizeBuffers();
+
+    /**
+     * @brief Returns the buffer bound to a target, or null if not tracked
+     */
+    unsigned* BoundBuffer(unsigned target);
+
+    /**
+     * @brief Reads an attribute of a vertex as floats
+     */
+    void ReadAttribute(const VertexAttribute& attribute, size_t index,
+      float* values, int count);
+
+    /**
+     * @brief Runs the vertex stage on a vertex
+     */
+    ShadedVertex ShadeVertex(const float* model, const ProgramState& program,
+      size_t index);
+
+    /**
+     * @brief A triangle ready to be rasterized
+     *
+     * The edge functions are given at the center of the pixel (0, 0), and
+     * change by `stepX` and `stepY` from one pixel to the next. A pixel is
+     * inside when every edge plus its bias is positive or zero.
+     */
+    struct TriangleSetup {
+      ShadedVertex vertices[3];
+      long long edges[3];
+      long long biases[3];
+      long long stepX[3];
+      long long stepY[3];
+      long long area;
+      int bounds[4];
+    };
+
+    /**
+     * @brief Culls and clips a triangle, and rasterizes what is left of it
+     *
+     * Triangles are clipped against the near plane and the guard band, so
+     * the polygon left is split back into triangles.
+     */
+    void DrawTriangle(ShadedVertex a, ShadedVertex b, ShadedVertex c);
+
+    /**
+     * @brief Sets up and rasterizes a triangle inside of the guard band
+     *
+     * @param counterClockwise the winding of the triangle before it was
+     * clipped. Triangles that snapping to the sub-pixel grid flipped are
+     * dropped.
+     */
+    void RasterizeTriangle(ShadedVertex a, ShadedVertex b, ShadedVertex c,
+      bool counterClockwise);
+
+    /**
+     * @brief Rasterizes the pixels of a tile covered by a triangle
+     *
+     * @param covered if the whole tile is inside the triangle, in which case
+     * the edges are not tested
+     */
+    void RasterizeTile(const TriangleSetup& setup, int tileX, int tileY,
+      bool covered);
+
+    /**
+     * @brief Runs the fragment stage on a pixel
+     */
+    void ShadeFragment(int x, int y, const float* weights,
+      const ShadedVertex* vertices);
+
+    /**
+     * @brief Executes the draws of the current vertex array
+     */
+    void Draw(int count, unsigned type, size_t offset, int instanceCount);
+
+    public:
+
+    SoftwareBackend();
+
+    /**
+     * @brief Returns the color buffer, 4 bytes (RGBA) per pixel
+     */
+    const std::vector<unsigned char>& GetColorBuffer();
+
+    /**
+     * @brief Returns the depth buffer, from 0 (near) to 1 (far)
+     */
+    const std::vector<float>& GetDepthBuffer();
+
+    /**
+     * @brief Returns how many fragments were shaded for each pixel
+     */
+    const std::vector<unsigned>& GetOverdrawBuffer();
+
+    /**
+     * @brief Returns the width of the buffers
+     */
+    int GetWidth();
+
+    /**
+     * @brief Returns the height of the buffers
+     */
+    int GetHeight();
+
+    /**
+     * @brief Returns the work done since the color buffer was cleared
+     */
+    const RasterStats& GetStats();
+
+    void Enable(unsigned capability) override;
+    void Disable(unsigned capability) override;
+    void BlendFunc(unsigned source, unsigned destination) override;
+    void DepthMask(bool enabled) override;
+    void FrontFace(unsigned mode) override;
+    void Viewport(int x, int y, int width, int height) override;
+    void ClearColor(float r, float g, float b, float a) override;
+    void Clear(unsigned mask) override;
+
+    void DeleteBuffers(int count, const unsigned* buffers) override;
+    void BindBuffer(unsigned target, unsigned buffer) override;
+    void BufferData(unsigned target, size_t size, const void* data,
+      unsigned usage) override;
+    void BufferSubData(unsigned target, size_t offset, size_t size,
+      const void* data) override;
+
+    void DeleteVertexArrays(int count, const unsigned* vertexArrays) override;
+    void BindVertexArray(unsigned vertexArray) override;
+    void EnableVertexAttribArray(unsigned index) override;
+    void VertexAttribPointer(unsigned index, int size, unsigned type,
+      bool normalized, int stride, size_t offset) override;
+    void VertexAttribDivisor(unsigned index, unsigned divisor) override;
+
+    void DeleteTextures(int count, const unsigned* textures) override;
+    void ActiveTexture(unsigned unit) override;
+    void BindTexture(unsigned target, unsigned texture) override;
+    void TexImage2D(unsigned target, int level, int internalFormat, int width,
+      int height, unsigned format, unsigned type, const void* pixels) override;
+
+    void DeleteProgram(unsigned program) override;
+    void UseProgram(unsigned program) override;
+    void Uniform(unsigned type, int location, int count,
+      const float* values) override;
+
+    void DrawElements(unsigned mode, int count, unsigned type,
+      size_t offset) override;
+    void DrawElementsInstanced(unsigned mode, int count, unsigned type,
+      size_t offset, int instanceCount) override;
+  };
+}
+
+#endif
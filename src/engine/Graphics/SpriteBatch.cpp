@@ -0,0 +1,287 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SpriteBatch.hpp"
+#include "Backend.hpp"
+#include "StateCache.hpp"
+#include <GLES3/gl3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include "../Game.hpp"
+
+/**
+ * Maps a float to an unsigned integer with the same ordering
+ */
+static uint32_t SortableFloat(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+Engine::Graphics::SpriteBatch::~SpriteBatch() {
+  if (m_vao != 0) {
+    GetStateCache().DeleteVertexArrays(1, &m_vao);
+    GetStateCache().DeleteBuffers(1, &m_vbo);
+    GetStateCache().DeleteBuffers(1, &m_ebo);
+  }
+}
+
+void Engine::Graphics::SpriteBatch::CreateBuffers() {
+  Backend& backend = GetBackend();
+  m_vao = backend.CreateVertexArray();
+  m_vbo = backend.CreateBuffer();
+  m_ebo = backend.CreateBuffer();
+
+  GetStateCache().BindVertexArray(m_vao);
+
+  // Every draw uses the same quad indices, so they are only uploaded once
+  std::vector<unsigned short> indices(MAX_SPRITES_PER_DRAW * 6);
+  for (size_t i = 0; i < MAX_SPRITES_PER_DRAW; i++) {
+    unsigned short first = i * 4;
+    unsigned short* quad = &indices[i * 6];
+    quad[0] = first;
+    quad[1] = first + 1;
+    quad[2] = first + 2;
+    quad[3] = first;
+    quad[4] = first + 2;
+    quad[5] = first + 3;
+  }
+
+  GetStateCache().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+  backend.BufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()
+    * sizeof(unsigned short), indices.data(), GL_STATIC_DRAW);
+
+  GetStateCache().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  for (unsigned attribute = 0; attribute < 4; attribute++)
+    backend.EnableVertexAttribArray(attribute);
+
+  GetStateCache().BindVertexArray(0);
+}
+
+void Engine::Graphics::SpriteBatch::Upload() {
+  if (m_vao == 0)
+    CreateBuffers();
+
+  GetStateCache().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+  // Orphan the previous storage so the upload does not wait on the GPU
+  size_t size = m_vertices.size() * sizeof(SpriteVertex);
+  if (size > m_bufferCapacity) {
+    m_bufferCapacity = size;
+    GetBackend().BufferData(GL_ARRAY_BUFFER, size, m_vertices.data(),
+      GL_STREAM_DRAW);
+  } else {
+    GetBackend().BufferData(GL_ARRAY_BUFFER, m_bufferCapacity, nullptr,
+      GL_STREAM_DRAW);
+    GetBackend().BufferSubData(GL_ARRAY_BUFFER, 0, size, m_vertices.data());
+  }
+
+  m_uploaded = true;
+}
+
+void Engine::Graphics::SpriteBatch::WriteQuad(const Entry& entry) {
+  const Sprite& sprite = entry.sprite;
+
+  float angle = sprite.Rotation * DEGREES_TO_RADIANS;
+  float c = cosf(angle);
+  float s = sinf(angle);
+
+  float halfWidth = sprite.Size.x * 0.5f;
+  float halfHeight = sprite.Size.y * 0.5f;
+
+  // Bottom left, bottom right, top right, top left
+  const float corners[4][2] = {
+    {-halfWidth, -halfHeight}, {halfWidth, -halfHeight},
+    {halfWidth, halfHeight}, {-halfWidth, halfHeight}
+  };
+  const float uvs[4][2] = {
+    {sprite.UV[0], sprite.UV[3]}, {sprite.UV[2], sprite.UV[3]},
+    {sprite.UV[2], sprite.UV[1]}, {sprite.UV[0], sprite.UV[1]}
+  };
+
+  for (int i = 0; i < 4; i++) {
+    SpriteVertex vertex;
+    vertex.x = sprite.Position.x + corners[i][0] * c - corners[i][1] * s;
+    vertex.y = sprite.Position.y + corners[i][0] * s + corners[i][1] * c;
+    vertex.z = sprite.Depth;
+    vertex.u = uvs[i][0];
+    vertex.v = uvs[i][1];
+    vertex.r = sprite.Tint.r;
+    vertex.g = sprite.Tint.g;
+    vertex.b = sprite.Tint.b;
+    vertex.a = sprite.Tint.a;
+    vertex.layer = entry.layer;
+    m_vertices.push_back(vertex);
+  }
+}
+
+void Engine::Graphics::SpriteBatch::Begin() {
+  if (m_begun) {
+    std::cerr << "ERROR: SpriteBatch::Begin called before End" << std::endl;
+    return;
+  }
+
+  m_begun = true;
+  m_entries.clear();
+}
+
+void Engine::Graphics::SpriteBatch::Draw(Texture& texture,
+  const Sprite& sprite) {
+  if (!m_begun) {
+    std::cerr << "ERROR: SpriteBatch::Draw called before Begin" << std::endl;
+    return;
+  }
+
+  m_entries.push_back({sprite, &texture, nullptr, 0});
+}
+
+void Engine::Graphics::SpriteBatch::Draw(TextureArray& texture, unsigned layer,
+  const Sprite& sprite) {
+  if (!m_begun) {
+    std::cerr << "ERROR: SpriteBatch::Draw called before Begin" << std::endl;
+    return;
+  }
+
+  m_entries.push_back({sprite, nullptr, &texture, (float)layer});
+}
+
+void Engine::Graphics::SpriteBatch::Draw(TextureAtlas& atlas,
+  std::string_view name, const Sprite& sprite) {
+  const AtlasRegion* region = atlas.GetRegion(name);
+  if (region == nullptr)
+    return;
+
+  Sprite atlasSprite = sprite;
+  memcpy(atlasSprite.UV, region->UV, sizeof(atlasSprite.UV));
+  Draw(*atlas.GetPages(), region->Page, atlasSprite);
+}
+
+void Engine::Graphics::SpriteBatch::End() {
+  End(Game::getInstance().GetRenderer());
+}
+
+void Engine::Graphics::SpriteBatch::End(Renderer& renderer) {
+  if (!m_begun) {
+    std::cerr << "ERROR: SpriteBatch::End called before Begin" << std::endl;
+    return;
+  }
+
+  m_begun = false;
+  m_runs.clear();
+  m_vertices.clear();
+
+  if (m_entries.empty())
+    return;
+
+  // Sort back to front, then by texture so that sprites sharing a depth
+  // also share a draw
+  std::vector<const void*> textures;
+  m_order.resize(m_entries.size());
+  for (size_t i = 0; i < m_entries.size(); i++) {
+    const Entry& entry = m_entries[i];
+    const void* texture = entry.texture != nullptr ? (const void*)entry.texture
+      : (const void*)entry.array;
+
+    uint32_t textureIndex = std::find(textures.begin(), textures.end(),
+      texture) - textures.begin();
+    if (textureIndex == textures.size())
+      textures.push_back(texture);
+
+    uint32_t depth = ~SortableFloat(entry.sprite.Depth);
+    m_order[i] = {(uint64_t)depth << 32 | textureIndex, (uint32_t)i};
+  }
+
+  std::sort(m_order.begin(), m_order.end());
+
+  m_vertices.reserve(m_entries.size() * 4);
+  for (const std::pair<uint64_t, uint32_t>& sorted : m_order) {
+    const Entry& entry = m_entries[sorted.second];
+
+    bool newRun = m_runs.empty() || m_runs.back().texture != entry.texture
+      || m_runs.back().array != entry.array
+      || m_runs.back().count == MAX_SPRITES_PER_DRAW;
+
+    if (newRun)
+      m_runs.push_back({entry.texture, entry.array, m_vertices.size() / 4, 0});
+
+    m_runs.back().count++;
+    WriteQuad(entry);
+  }
+
+  m_uploaded = false;
+
+  for (size_t i = 0; i < m_runs.size(); i++) {
+    const Run& run = m_runs[i];
+    const Sprite& first = m_entries[m_order[run.first].second].sprite;
+
+    Shader& shader = run.array != nullptr ? SpriteArrayShader()
+      : SpriteShader();
+    renderer.SubmitDrawable(this, i, shader,
+      {first.Position.x, first.Position.y, first.Depth}, true);
+  }
+}
+
+size_t Engine::Graphics::SpriteBatch::GetDrawCount() {
+  return m_runs.size();
+}
+
+void Engine::Graphics::SpriteBatch::ExecuteDraw(unsigned int batch) {
+  if (batch >= m_runs.size())
+    return;
+
+  // The first run drawn in the frame uploads the vertices of every run
+  if (!m_uploaded)
+    Upload();
+
+  const Run& run = m_runs[batch];
+
+  StateCache& cache = GetStateCache();
+
+  // Sprites are skipped until their texture has loaded
+  if (run.array != nullptr) {
+    unsigned texture = run.array->GetTexture();
+    if (texture == 0)
+      return;
+    cache.BindTexture(0, GL_TEXTURE_2D_ARRAY, texture);
+  } else {
+    unsigned texture = run.texture->GetTexture();
+    if (texture == 0)
+      return;
+    cache.BindTexture(0, GL_TEXTURE_2D, texture);
+  }
+
+  // GLES3 has no base vertex, so the attributes point to the run instead
+  cache.BindVertexArray(m_vao);
+  cache.BindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+  size_t offset = run.first * 4 * sizeof(SpriteVertex);
+  Backend& backend = GetBackend();
+  backend.VertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(SpriteVertex),
+    offset + offsetof(SpriteVertex, x));
+  backend.VertexAttribPointer(1, 2, GL_FLOAT, false, sizeof(SpriteVertex),
+    offset + offsetof(SpriteVertex, u));
+  backend.VertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, true,
+    sizeof(SpriteVertex), offset + offsetof(SpriteVertex, r));
+  backend.VertexAttribPointer(3, 1, GL_FLOAT, false, sizeof(SpriteVertex),
+    offset + offsetof(SpriteVertex, layer));
+
+  backend.DrawElements(GL_TRIANGLES, run.count * 6, GL_UNSIGNED_SHORT, 0);
+}
+
+Engine::Graphics::Shader& Engine::Graphics::SpriteShader() {
+  static Engine::Graphics::Shader spriteShader("js/sprite.frag",
+    "js/sprite.vert");
+  return spriteShader;
+}
+
+Engine::Graphics::Shader& Engine::Graphics::SpriteArrayShader() {
+  static Engine::Graphics::Shader spriteArrayShader("js/sprite_array.frag",
+    "js/sprite.vert");
+  return spriteArrayShader;
+}
@@ -0,0 +1,223 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_SPRITEBATCH
+#define ENGINE_SPRITEBATCH
+
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "TextureArray.hpp"
+#include "TextureAtlas.hpp"
+#include "RenderQueue.hpp"
+#include "../Utils.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Graphics {
+  class Renderer;
+
+  /**
+   * @brief A textured quad drawn by a `SpriteBatch`
+   *
+   * The position is the center of the sprite, and the rotation is in degrees
+   * around that center. The UV rectangle is `{u0, v0, u1, v1}`, where
+   * `(u0, v0)` is the top left corner of the sprite in the texture. Sprites
+   * with a greater depth are further away from the camera.
+   */
+  struct Sprite {
+    Vec2f Position = {0, 0};
+    Vec2f Size = {1, 1};
+    float Rotation = 0;
+    float UV[4] = {0, 0, 1, 1};
+    Color Tint = {255, 255, 255, 255};
+    float Depth = 0;
+  };
+
+  /**
+   * @brief Draws a large amount of sprites with a few draw calls
+   *
+   * Sprites are collected between `Begin()` and `End()`. When the batch ends,
+   * the sprites are sorted back to front, and then by texture, and every run
+   * of sprites that share a texture becomes a single draw. The vertices of
+   * every sprite are written into one streaming vertex buffer that is uploaded
+   * once per frame.
+   *
+   * Sprites from a `TextureArray` are batched together whatever layer they
+   * use, so an atlas split into several pages only needs one draw as long as
+   * its pages are stored in the same texture array.
+   *
+   * The runs are recorded into the render queue of the renderer as blended
+   * draws, so they are sorted along with the rest of the scene.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class Particles : public Engine::GameObject {
+   *   public:
+   *   Engine::Graphics::Texture texture;
+   *   Engine::Graphics::SpriteBatch batch;
+   *   std::vector<Engine::Graphics::Sprite> sprites;
+   *
+   *   Particles() : GameObject("Particles"), texture("Assets/spark.png") {}
+   *
+   *   void Draw() override {
+   *     batch.Begin();
+   *     for (Engine::Graphics::Sprite& sprite : sprites)
+   *       batch.Draw(texture, sprite);
+   *     batch.End();
+   *   }
+   * };
+   * ```
+   */
+  class SpriteBatch : public QueueDrawable {
+    private:
+
+    /**
+     * @brief The vertex layout of the sprites
+     */
+    struct SpriteVertex {
+      float x, y, z;
+      float u, v;
+      unsigned char r, g, b, a;
+      float layer;
+    };
+
+    /**
+     * @brief A sprite waiting for the batch to end
+     */
+    struct Entry {
+      Sprite sprite;
+      Texture* texture;
+      TextureArray* array;
+      float layer;
+    };
+
+    /**
+     * @brief A range of sprites drawn with the same texture
+     */
+    struct Run {
+      Texture* texture;
+      TextureArray* array;
+      size_t first;
+      size_t count;
+    };
+
+    unsigned int m_vao = 0;
+    unsigned int m_vbo = 0;
+    unsigned int m_ebo = 0;
+    size_t m_bufferCapacity = 0;
+    bool m_uploaded = true;
+    bool m_begun = false;
+
+    std::vector<Entry> m_entries;
+    std::vector<std::pair<uint64_t, uint32_t>> m_order;
+    std::vector<SpriteVertex> m_vertices;
+    std::vector<Run> m_runs;
+
+    /**
+     * @brief Creates the buffers the first time the batch is drawn
+     */
+    void CreateBuffers();
+
+    /**
+     * @brief Uploads the vertices of the frame to the vertex buffer
+     */
+    void Upload();
+
+    /**
+     * @brief Writes the four vertices of a sprite
+     */
+    void WriteQuad(const Entry& entry);
+
+    public:
+
+    /**
+     * @brief The most sprites drawn by a single draw call
+     *
+     * Quads are indexed with 16 bit indices, so longer runs are split.
+     */
+    static constexpr size_t MAX_SPRITES_PER_DRAW = 16384;
+
+    SpriteBatch() = default;
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+    ~SpriteBatch();
+
+    /**
+     * @brief Starts collecting sprites
+     *
+     * @warning The sprites of the previous frame must have been flushed by
+     * the renderer first
+     */
+    void Begin();
+
+    /**
+     * @brief Adds a sprite using a texture
+     *
+     * @param texture the texture of the sprite
+     * @param sprite the sprite to draw
+     */
+    void Draw(Texture& texture, const Sprite& sprite);
+
+    /**
+     * @brief Adds a sprite using a layer of a texture array
+     *
+     * @param texture the texture array of the sprite
+     * @param layer the layer (or atlas page) the UV rectangle refers to
+     * @param sprite the sprite to draw
+     */
+    void Draw(TextureArray& texture, unsigned layer, const Sprite& sprite);
+
+    /**
+     * @brief Adds a sprite stored in an atlas
+     *
+     * The UV rectangle of the sprite is replaced by the one of the region.
+     * Nothing is drawn while the atlas is loading, or if the region is not in
+     * the atlas.
+     *
+     * @param atlas the atlas of the sprite
+     * @param name the name of the region
+     * @param sprite the sprite to draw
+     */
+    void Draw(TextureAtlas& atlas, std::string_view name,
+      const Sprite& sprite);
+
+    /**
+     * @brief Sorts the sprites, and records their draws into the renderer of
+     * the game
+     */
+    void End();
+
+    /**
+     * @brief Sorts the sprites, and records their draws into a renderer
+     */
+    void End(Renderer& renderer);
+
+    /**
+     * @brief Returns the amount of draw calls recorded by the last `End()`
+     */
+    size_t GetDrawCount();
+
+    /**
+     * @brief Draws a run of sprites
+     *
+     * @param batch the index of the run
+     */
+    void ExecuteDraw(unsigned int batch) override;
+  };
+
+  /**
+   * @brief The shader used by `SpriteBatch` for sprites using a texture
+   */
+  extern Shader& SpriteShader();
+
+  /**
+   * @brief The shader used by `SpriteBatch` for sprites using a texture array
+   */
+  extern Shader& SpriteArrayShader();
+}
+
+#endif
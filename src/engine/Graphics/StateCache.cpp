@@ -0,0 +1,281 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "StateCache.hpp"
+#include "Backend.hpp"
+#include <GLES3/gl3.h>
+
+Engine::Graphics::StateCache::StateCache() {
+  Reset();
+}
+
+bool Engine::Graphics::StateCache::Update(unsigned& current, unsigned value) {
+  if (current == value) {
+    m_skipped++;
+    return false;
+  }
+
+  current = value;
+  m_issued++;
+  return true;
+}
+
+void Engine::Graphics::StateCache::SetCapability(unsigned& current,
+  unsigned capability, bool enabled) {
+  if (!Update(current, enabled))
+    return;
+
+  if (enabled)
+    GetBackend().Enable(capability);
+  else
+    GetBackend().Disable(capability);
+}
+
+unsigned* Engine::Graphics::StateCache::TextureSlot(unsigned unit,
+  unsigned target) {
+  if (unit >= STATE_CACHE_TEXTURE_UNITS)
+    return nullptr;
+
+  switch (target) {
+    case GL_TEXTURE_2D:
+      return &m_textures2D[unit];
+    case GL_TEXTURE_2D_ARRAY:
+      return &m_textures2DArray[unit];
+    default:
+      return nullptr;
+  }
+}
+
+void Engine::Graphics::StateCache::Reset() {
+  m_program = UNKNOWN;
+  m_vertexArray = UNKNOWN;
+  m_arrayBuffer = UNKNOWN;
+  m_elementBuffer = UNKNOWN;
+  m_uniformBuffer = UNKNOWN;
+  for (unsigned i = 0; i < STATE_CACHE_UNIFORM_BINDINGS; i++)
+    m_uniformBindings[i] = UNKNOWN;
+
+  m_activeUnit = UNKNOWN;
+  for (unsigned i = 0; i < STATE_CACHE_TEXTURE_UNITS; i++) {
+    m_textures2D[i] = UNKNOWN;
+    m_textures2DArray[i] = UNKNOWN;
+  }
+
+  m_blend = UNKNOWN;
+  m_blendFunc[0] = UNKNOWN;
+  m_blendFunc[1] = UNKNOWN;
+  m_depthTest = UNKNOWN;
+  m_depthMask = UNKNOWN;
+  m_cullFace = UNKNOWN;
+
+  m_viewportKnown = false;
+  m_clearColorKnown = false;
+}
+
+void Engine::Graphics::StateCache::UseProgram(unsigned program) {
+  if (Update(m_program, program))
+    GetBackend().UseProgram(program);
+}
+
+void Engine::Graphics::StateCache::BindVertexArray(unsigned vertexArray) {
+  if (!Update(m_vertexArray, vertexArray))
+    return;
+
+  GetBackend().BindVertexArray(vertexArray);
+  m_elementBuffer = UNKNOWN;
+}
+
+void Engine::Graphics::StateCache::BindBuffer(unsigned target,
+  unsigned buffer) {
+  unsigned* current = nullptr;
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      current = &m_arrayBuffer;
+      break;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      current = &m_elementBuffer;
+      break;
+    case GL_UNIFORM_BUFFER:
+      current = &m_uniformBuffer;
+      break;
+  }
+
+  if (current == nullptr) {
+    m_issued++;
+    GetBackend().BindBuffer(target, buffer);
+    return;
+  }
+
+  if (Update(*current, buffer))
+    GetBackend().BindBuffer(target, buffer);
+}
+
+void Engine::Graphics::StateCache::BindUniformBuffer(unsigned index,
+  unsigned buffer) {
+  if (index >= STATE_CACHE_UNIFORM_BINDINGS) {
+    m_issued++;
+    GetBackend().BindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+    return;
+  }
+
+  if (!Update(m_uniformBindings[index], buffer))
+    return;
+
+  // Binding to an indexed point also binds the generic binding point
+  GetBackend().BindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+  m_uniformBuffer = buffer;
+}
+
+void Engine::Graphics::StateCache::ActiveTexture(unsigned unit) {
+  if (Update(m_activeUnit, unit))
+    GetBackend().ActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void Engine::Graphics::StateCache::BindTexture(unsigned unit, unsigned target,
+  unsigned texture) {
+  unsigned* current = TextureSlot(unit, target);
+
+  if (current == nullptr) {
+    ActiveTexture(unit);
+    m_issued++;
+    GetBackend().BindTexture(target, texture);
+    return;
+  }
+
+  if (*current == texture) {
+    m_skipped++;
+    return;
+  }
+
+  ActiveTexture(unit);
+  Update(*current, texture);
+  GetBackend().BindTexture(target, texture);
+}
+
+void Engine::Graphics::StateCache::SetBlend(bool enabled) {
+  SetCapability(m_blend, GL_BLEND, enabled);
+}
+
+void Engine::Graphics::StateCache::BlendFunc(unsigned source,
+  unsigned destination) {
+  if (m_blendFunc[0] == source && m_blendFunc[1] == destination) {
+    m_skipped++;
+    return;
+  }
+
+  m_blendFunc[0] = source;
+  m_blendFunc[1] = destination;
+  m_issued++;
+  GetBackend().BlendFunc(source, destination);
+}
+
+void Engine::Graphics::StateCache::SetDepthTest(bool enabled) {
+  SetCapability(m_depthTest, GL_DEPTH_TEST, enabled);
+}
+
+void Engine::Graphics::StateCache::SetDepthMask(bool enabled) {
+  if (Update(m_depthMask, enabled))
+    GetBackend().DepthMask(enabled);
+}
+
+void Engine::Graphics::StateCache::SetCullFace(bool enabled) {
+  SetCapability(m_cullFace, GL_CULL_FACE, enabled);
+}
+
+void Engine::Graphics::StateCache::Viewport(int x, int y, int width,
+  int height) {
+  if (m_viewportKnown && m_viewport[0] == x && m_viewport[1] == y
+    && m_viewport[2] == width && m_viewport[3] == height) {
+    m_skipped++;
+    return;
+  }
+
+  m_viewport[0] = x;
+  m_viewport[1] = y;
+  m_viewport[2] = width;
+  m_viewport[3] = height;
+  m_viewportKnown = true;
+  m_issued++;
+  GetBackend().Viewport(x, y, width, height);
+}
+
+void Engine::Graphics::StateCache::ClearColor(float r, float g, float b,
+  float a) {
+  if (m_clearColorKnown && m_clearColor[0] == r && m_clearColor[1] == g
+    && m_clearColor[2] == b && m_clearColor[3] == a) {
+    m_skipped++;
+    return;
+  }
+
+  m_clearColor[0] = r;
+  m_clearColor[1] = g;
+  m_clearColor[2] = b;
+  m_clearColor[3] = a;
+  m_clearColorKnown = true;
+  m_issued++;
+  GetBackend().ClearColor(r, g, b, a);
+}
+
+void Engine::Graphics::StateCache::DeleteProgram(unsigned program) {
+  if (m_program == program)
+    m_program = UNKNOWN;
+
+  GetBackend().DeleteProgram(program);
+}
+
+void Engine::Graphics::StateCache::DeleteBuffers(int count,
+  const unsigned* buffers) {
+  // GL unbinds deleted objects, so the cache has to forget them too
+  for (int i = 0; i < count; i++) {
+    if (m_arrayBuffer == buffers[i]) m_arrayBuffer = 0;
+    if (m_elementBuffer == buffers[i]) m_elementBuffer = UNKNOWN;
+    if (m_uniformBuffer == buffers[i]) m_uniformBuffer = 0;
+    for (unsigned j = 0; j < STATE_CACHE_UNIFORM_BINDINGS; j++)
+      if (m_uniformBindings[j] == buffers[i]) m_uniformBindings[j] = 0;
+  }
+
+  GetBackend().DeleteBuffers(count, buffers);
+}
+
+void Engine::Graphics::StateCache::DeleteVertexArrays(int count,
+  const unsigned* vertexArrays) {
+  for (int i = 0; i < count; i++)
+    if (m_vertexArray == vertexArrays[i]) {
+      m_vertexArray = 0;
+      m_elementBuffer = UNKNOWN;
+    }
+
+  GetBackend().DeleteVertexArrays(count, vertexArrays);
+}
+
+void Engine::Graphics::StateCache::DeleteTextures(int count,
+  const unsigned* textures) {
+  for (int i = 0; i < count; i++)
+    for (unsigned unit = 0; unit < STATE_CACHE_TEXTURE_UNITS; unit++) {
+      if (m_textures2D[unit] == textures[i]) m_textures2D[unit] = 0;
+      if (m_textures2DArray[unit] == textures[i]) m_textures2DArray[unit] = 0;
+    }
+
+  GetBackend().DeleteTextures(count, textures);
+}
+
+size_t Engine::Graphics::StateCache::GetIssuedCount() {
+  return m_issued;
+}
+
+size_t Engine::Graphics::StateCache::GetSkippedCount() {
+  return m_skipped;
+}
+
+void Engine::Graphics::StateCache::ResetCounters() {
+  m_issued = 0;
+  m_skipped = 0;
+}
+
+Engine::Graphics::StateCache& Engine::Graphics::GetStateCache() {
+  static Engine::Graphics::StateCache stateCache;
+  return stateCache;
+}
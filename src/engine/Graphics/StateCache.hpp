@@ -0,0 +1,228 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_STATECACHE
+#define ENGINE_STATECACHE
+
+#include <cstddef>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief The amount of texture units tracked by the state cache
+   */
+  constexpr unsigned STATE_CACHE_TEXTURE_UNITS = 16;
+
+  /**
+   * @brief The amount of uniform buffer binding points tracked by the cache
+   */
+  constexpr unsigned STATE_CACHE_UNIFORM_BINDINGS = 8;
+
+  /**
+   * @brief Remembers the GL state so that redundant calls are not issued
+   *
+   * Every WebGL call crosses from WebAssembly into JavaScript, so setting a
+   * state to the value it already has is not free. Engine code changes the
+   * bound program, vertex array, buffers, textures, blending, depth, culling,
+   * clear color and viewport through the cache, which only calls GL when the
+   * value changes. The cache counts the calls it issued and the calls it
+   * skipped.
+   *
+   * @warning GL calls made outside of the cache make it out of date. Call
+   * `Reset()` after changing any of the tracked state by hand.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::StateCache& cache = Engine::Graphics::GetStateCache();
+   * cache.UseProgram(shader.GetShaderProgram());
+   * cache.BindTexture(0, GL_TEXTURE_2D, texture.GetTexture());
+   * std::cout << cache.GetSkippedCount() << " calls skipped" << std::endl;
+   * ```
+   */
+  class StateCache {
+    private:
+    static constexpr unsigned UNKNOWN = 0xFFFFFFFF;
+
+    unsigned m_program;
+    unsigned m_vertexArray;
+    unsigned m_arrayBuffer;
+    unsigned m_elementBuffer;
+    unsigned m_uniformBuffer;
+    unsigned m_uniformBindings[STATE_CACHE_UNIFORM_BINDINGS];
+
+    unsigned m_activeUnit;
+    unsigned m_textures2D[STATE_CACHE_TEXTURE_UNITS];
+    unsigned m_textures2DArray[STATE_CACHE_TEXTURE_UNITS];
+
+    unsigned m_blend;
+    unsigned m_blendFunc[2];
+    unsigned m_depthTest;
+    unsigned m_depthMask;
+    unsigned m_cullFace;
+
+    int m_viewport[4];
+    bool m_viewportKnown;
+    float m_clearColor[4];
+    bool m_clearColorKnown;
+
+    size_t m_issued = 0;
+    size_t m_skipped = 0;
+
+    /**
+     * @brief Counts the call, and returns if the value has to be changed
+     */
+    bool Update(unsigned& current, unsigned value);
+
+    /**
+     * @brief Enables or disables a capability if it changed
+     */
+    void SetCapability(unsigned& current, unsigned capability, bool enabled);
+
+    /**
+     * @brief Returns the cached texture of the unit for the target
+     */
+    unsigned* TextureSlot(unsigned unit, unsigned target);
+
+    public:
+
+    StateCache();
+
+    /**
+     * @brief Forgets every cached value
+     *
+     * The next call to each method reaches GL whatever its value.
+     */
+    void Reset();
+
+    /**
+     * @brief Binds a shader program
+     */
+    void UseProgram(unsigned program);
+
+    /**
+     * @brief Binds a vertex array
+     *
+     * The element buffer is part of the vertex array, so the cached element
+     * buffer is forgotten when the vertex array changes.
+     */
+    void BindVertexArray(unsigned vertexArray);
+
+    /**
+     * @brief Binds a buffer
+     *
+     * Array, element and uniform buffers are cached, other targets are
+     * always bound.
+     */
+    void BindBuffer(unsigned target, unsigned buffer);
+
+    /**
+     * @brief Binds a uniform buffer to a binding point
+     */
+    void BindUniformBuffer(unsigned index, unsigned buffer);
+
+    /**
+     * @brief Selects the active texture unit
+     *
+     * @param unit the index of the unit (0 for `GL_TEXTURE0`)
+     */
+    void ActiveTexture(unsigned unit);
+
+    /**
+     * @brief Binds a texture to a texture unit
+     *
+     * Only changes the active texture unit if the texture has to be bound.
+     * `GL_TEXTURE_2D` and `GL_TEXTURE_2D_ARRAY` are cached, other targets are
+     * always bound.
+     *
+     * @param unit the index of the unit (0 for `GL_TEXTURE0`)
+     * @param target the texture target
+     * @param texture the texture to bind
+     */
+    void BindTexture(unsigned unit, unsigned target, unsigned texture);
+
+    /**
+     * @brief Enables or disables blending
+     */
+    void SetBlend(bool enabled);
+
+    /**
+     * @brief Sets the blending factors
+     */
+    void BlendFunc(unsigned source, unsigned destination);
+
+    /**
+     * @brief Enables or disables the depth test
+     */
+    void SetDepthTest(bool enabled);
+
+    /**
+     * @brief Enables or disables writing to the depth buffer
+     */
+    void SetDepthMask(bool enabled);
+
+    /**
+     * @brief Enables or disables face culling
+     */
+    void SetCullFace(bool enabled);
+
+    /**
+     * @brief Sets the viewport
+     */
+    void Viewport(int x, int y, int width, int height);
+
+    /**
+     * @brief Sets the color the canvas is cleared to
+     */
+    void ClearColor(float r, float g, float b, float a);
+
+    /**
+     * @brief Deletes a program and forgets it if it is bound
+     *
+     * GL keeps using a deleted program until another one is bound, and a new
+     * program can get the same name, so the next `UseProgram` always reaches
+     * GL.
+     */
+    void DeleteProgram(unsigned program);
+
+    /**
+     * @brief Deletes buffers and forgets them if they are bound
+     */
+    void DeleteBuffers(int count, const unsigned* buffers);
+
+    /**
+     * @brief Deletes vertex arrays and forgets them if they are bound
+     */
+    void DeleteVertexArrays(int count, const unsigned* vertexArrays);
+
+    /**
+     * @brief Deletes textures and forgets them if they are bound
+     */
+    void DeleteTextures(int count, const unsigned* textures);
+
+    /**
+     * @brief Returns the amount of calls that reached GL
+     */
+    size_t GetIssuedCount();
+
+    /**
+     * @brief Returns the amount of calls skipped because nothing changed
+     */
+    size_t GetSkippedCount();
+
+    /**
+     * @brief Sets both counters back to 0
+     */
+    void ResetCounters();
+  };
+
+  /**
+   * @brief The state cache of the GL context used by the engine
+   */
+  extern StateCache& GetStateCache();
+}
+
+#endif
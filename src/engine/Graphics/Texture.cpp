@@ -5,8 +5,9 @@
  */
 
 #include "Texture.hpp"
+#include "Backend.hpp"
+#include "StateCache.hpp"
 #include <GLES3/gl3.h>
-#include <emscripten.h>
 #include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -18,18 +19,8 @@ Engine::Graphics::Texture::Texture(const char* path) {
 
 unsigned Engine::Graphics::Texture::LoadTexture() {
 
-  if (m_request.req_state == 0) {
-    m_request.req_state = 1;
-    emscripten_async_wget_data(m_filename, (void*)&m_request,
-      [](void* arg, void* d, int s) {
-        AssetRequest* req = (AssetRequest*)arg;
-        req->data = new unsigned char[s];
-        memcpy((void*)req->data, d, s);
-        req->size = s;
-        req->req_state = 2;
-      }, nullptr);
-  }
-  //emscripten_wget_data(m_filename, (void**)&data, &size, nullptr);
+  if (m_request.req_state == 0)
+    GetBackend().FetchFile(m_filename, m_request);
 
   while (m_request.req_state == 1) return 0;
 
@@ -45,17 +36,18 @@ unsigned Engine::Graphics::Texture::LoadTexture() {
     return 0;
   }
 
-  glGenTextures(1, &m_texture);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
+  Backend& backend = GetBackend();
+  m_texture = backend.CreateTexture();
+  GetStateCache().BindTexture(0, GL_TEXTURE_2D, m_texture);
 
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  backend.TexParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  backend.TexParameter(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  backend.TexParameter(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  backend.TexParameter(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_dimensions[0], m_dimensions[1], 0,
-    GL_RGBA, GL_UNSIGNED_BYTE, textureData);
-  glGenerateMipmap(GL_TEXTURE_2D);
+  backend.TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_dimensions[0],
+    m_dimensions[1], GL_RGBA, GL_UNSIGNED_BYTE, textureData);
+  backend.GenerateMipmap(GL_TEXTURE_2D);
 
   STBI_FREE(textureData);
   return m_texture;
@@ -0,0 +1,104 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "TextureArray.hpp"
+#include "Backend.hpp"
+#include "StateCache.hpp"
+#include <GLES3/gl3.h>
+#include <iostream>
+
+#include <stb_image.h>
+
+Engine::Graphics::TextureArray::TextureArray(
+  std::initializer_list<const char*> paths) :
+  m_filenames(paths.begin(), paths.end()), m_requests(paths.size()) {}
+
+Engine::Graphics::TextureArray::TextureArray(
+  const std::vector<std::string>& paths) : m_filenames(paths),
+  m_requests(paths.size()) {}
+
+unsigned Engine::Graphics::TextureArray::LoadTexture() {
+  bool loaded = true;
+
+  for (size_t i = 0; i < m_requests.size(); i++) {
+    AssetRequest& request = m_requests[i];
+
+    if (request.req_state == 0)
+      GetBackend().FetchFile(m_filenames[i].c_str(), request);
+
+    loaded = loaded && request.req_state == 2;
+  }
+
+  if (!loaded) return 0;
+
+  Backend& backend = GetBackend();
+  m_texture = backend.CreateTexture();
+  GetStateCache().BindTexture(0, GL_TEXTURE_2D_ARRAY, m_texture);
+
+  backend.TexParameter(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S,
+    GL_CLAMP_TO_EDGE);
+  backend.TexParameter(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T,
+    GL_CLAMP_TO_EDGE);
+  backend.TexParameter(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  backend.TexParameter(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  bool allocated = false;
+  for (size_t i = 0; i < m_requests.size(); i++) {
+    int dimensions[2];
+    unsigned char* textureData = stbi_load_from_memory(m_requests[i].data,
+      m_requests[i].size, &dimensions[0], &dimensions[1], nullptr, 4);
+
+    delete[] m_requests[i].data;
+    m_requests[i].data = nullptr;
+
+    if (textureData == nullptr) {
+      std::cerr << "ERROR: Failed to load image name: " << m_filenames[i]
+        << std::endl;
+      continue;
+    }
+
+    // The first layer decides the size of the whole texture
+    if (!allocated) {
+      allocated = true;
+      m_dimensions[0] = dimensions[0];
+      m_dimensions[1] = dimensions[1];
+      backend.TexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, m_dimensions[0],
+        m_dimensions[1], m_requests.size());
+    }
+
+    if (dimensions[0] != m_dimensions[0] || dimensions[1] != m_dimensions[1]) {
+      std::cerr << "ERROR: " << m_filenames[i] << " does not have the same "
+        << "size as the first layer" << std::endl;
+      stbi_image_free(textureData);
+      continue;
+    }
+
+    backend.TexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, m_dimensions[0],
+      m_dimensions[1], 1, GL_RGBA, GL_UNSIGNED_BYTE, textureData);
+
+    stbi_image_free(textureData);
+  }
+
+  if (!allocated) {
+    std::cerr << "ERROR: No layer of the texture array could be loaded"
+      << std::endl;
+    GetStateCache().DeleteTextures(1, &m_texture);
+    m_texture = 0;
+  }
+
+  return m_texture;
+}
+
+unsigned Engine::Graphics::TextureArray::GetTexture() {
+  if (m_texture == NOT_REQUESTED)
+    return LoadTexture();
+
+  return m_texture;
+}
+
+unsigned Engine::Graphics::TextureArray::GetLayerCount() {
+  return m_filenames.size();
+}
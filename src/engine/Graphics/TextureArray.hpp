@@ -0,0 +1,83 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_TEXTUREARRAY
+#define ENGINE_TEXTUREARRAY
+
+#include "../Utils.hpp"
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief A stack of same sized images loaded into a single texture
+   *
+   * Each image is a layer of a `GL_TEXTURE_2D_ARRAY`. This is meant for
+   * texture atlas pages, so that sprites on different pages can still be
+   * drawn together. Like `Texture`, the images are fetched when the texture is
+   * first requested, and the texture is ready once every layer has loaded.
+   *
+   * @warning Every image must have the same dimensions
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::TextureArray pages({"Assets/atlas0.png",
+   *   "Assets/atlas1.png"});
+   * ```
+   */
+  class TextureArray {
+    private:
+
+    /**
+     * @brief The id of the texture until its layers have been requested
+     */
+    static constexpr unsigned int NOT_REQUESTED = ~0u;
+
+    unsigned int m_texture = NOT_REQUESTED;
+    int m_dimensions[2];
+    std::vector<std::string> m_filenames;
+    std::vector<AssetRequest> m_requests;
+
+    /**
+     * @brief Fetches the layers, and uploads them once they are all loaded
+     */
+    unsigned LoadTexture();
+
+    public:
+
+    /**
+     * @brief Takes the paths to every layer of the texture
+     *
+     * @param paths The paths of the images in layer order
+     */
+    TextureArray(std::initializer_list<const char*> paths);
+
+    /**
+     * @brief Takes the paths to every layer of the texture
+     *
+     * @param paths The paths of the images in layer order
+     */
+    TextureArray(const std::vector<std::string>& paths);
+
+    /**
+     * @brief Returns the id of the texture, or 0 if it is still loading
+     *
+     * If no layer could be loaded, an error is printed once and 0 is returned
+     * from then on, so the sprites using the texture are skipped.
+     */
+    unsigned GetTexture();
+
+    /**
+     * @brief Returns the amount of layers in the texture
+     */
+    unsigned GetLayerCount();
+  };
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "TextureAtlas.hpp"
+#include "Backend.hpp"
+#include <cstring>
+#include <iostream>
+
+#define ATLAS_TABLE_VERSION 1
+
+/**
+ * Reads a little endian 32 bit value (WebAssembly is little endian)
+ */
+template <typename T>
+static T ReadValue(const unsigned char* data) {
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+Engine::Graphics::TextureAtlas::TextureAtlas(const char* path) :
+  m_path(path) {}
+
+Engine::Graphics::TextureAtlas::~TextureAtlas() {
+  delete[] m_request.data;
+}
+
+bool Engine::Graphics::TextureAtlas::LoadTable() {
+  if (m_request.req_state == 0)
+    GetBackend().FetchFile((m_path + ".catl").c_str(), m_request);
+
+  if (m_request.req_state != 2)
+    return false;
+
+  if (ReadTable(m_request.data, m_request.size) == FAILURE)
+    std::cerr << "ERROR: " << m_path << ".catl is not a valid atlas table"
+      << std::endl;
+
+  delete[] m_request.data;
+  m_request.data = nullptr;
+  m_loaded = true;
+
+  return true;
+}
+
+Engine::Success Engine::Graphics::TextureAtlas::ReadTable(
+  const unsigned char* data, size_t size) {
+  if (size < 16 || memcmp(data, "CATL", 4) != 0
+    || ReadValue<uint32_t>(data + 4) != ATLAS_TABLE_VERSION)
+    return FAILURE;
+
+  uint32_t pageCount = ReadValue<uint32_t>(data + 8);
+  uint32_t regionCount = ReadValue<uint32_t>(data + 12);
+  if (size < 16 + (size_t)pageCount * 8 + (size_t)regionCount * 24)
+    return FAILURE;
+
+  // The pages all have the same size, so only their count is needed
+  std::vector<std::string> pages;
+  for (uint32_t i = 0; i < pageCount; i++)
+    pages.push_back(m_path + "_" + std::to_string(i) + ".png");
+  m_pages = std::make_unique<TextureArray>(pages);
+
+  const unsigned char* region = data + 16 + pageCount * 8;
+  m_regions.reserve(regionCount);
+  for (uint32_t i = 0; i < regionCount; i++, region += 24) {
+    AtlasRegion& entry = m_regions[ReadValue<uint32_t>(region)];
+    entry.Page = ReadValue<uint32_t>(region + 4);
+    for (int j = 0; j < 4; j++)
+      entry.UV[j] = ReadValue<float>(region + 8 + j * 4);
+  }
+
+  return SUCCESS;
+}
+
+const Engine::Graphics::AtlasRegion* Engine::Graphics::TextureAtlas::GetRegion(
+  uint32_t hash) {
+  if (!m_loaded && !LoadTable())
+    return nullptr;
+
+  auto region = m_regions.find(hash);
+  return region != m_regions.end() ? &region->second : nullptr;
+}
+
+const Engine::Graphics::AtlasRegion* Engine::Graphics::TextureAtlas::GetRegion(
+  std::string_view name) {
+  return GetRegion(HashName(name));
+}
+
+Engine::Graphics::TextureArray* Engine::Graphics::TextureAtlas::GetPages() {
+  if (!m_loaded && !LoadTable())
+    return nullptr;
+
+  return m_pages.get();
+}
+
+size_t Engine::Graphics::TextureAtlas::GetRegionCount() {
+  if (!m_loaded)
+    LoadTable();
+
+  return m_regions.size();
+}
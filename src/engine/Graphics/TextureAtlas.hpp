@@ -0,0 +1,122 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_TEXTUREATLAS
+#define ENGINE_TEXTUREATLAS
+
+#include "TextureArray.hpp"
+#include "../Utils.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Engine::Graphics {
+
+  /**
+   * @brief Where a sprite is stored in an atlas
+   *
+   * The UV rectangle is `{u0, v0, u1, v1}`, the same layout as `Sprite::UV`.
+   */
+  struct AtlasRegion {
+    unsigned Page;
+    float UV[4];
+  };
+
+  /**
+   * @brief Sprites packed into a few pages by `carp build -a`
+   *
+   * The atlas is made of a UV table (`<path>.catl`) and its pages
+   * (`<path>_0.png`, `<path>_1.png`, ...). The table is fetched when the atlas
+   * is first used, and the pages are then loaded into a single `TextureArray`,
+   * so the sprites of every page can be drawn together by a `SpriteBatch`.
+   *
+   * Sprites are looked up by the hash of their name, which is their path in
+   * the sprite folder without the extension.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Graphics::TextureAtlas atlas("Assets/sprites");
+   *
+   * const Engine::Graphics::AtlasRegion* idle = atlas.GetRegion("player/idle");
+   * if (idle != nullptr)
+   *   batch.Draw(*atlas.GetPages(), idle->Page, sprite);
+   * ```
+   */
+  class TextureAtlas {
+    private:
+    std::string m_path;
+    AssetRequest m_request;
+    bool m_loaded = false;
+
+    std::unordered_map<uint32_t, AtlasRegion> m_regions;
+    std::unique_ptr<TextureArray> m_pages;
+
+    /**
+     * @brief Fetches the table, and reads it once it has loaded
+     *
+     * @return if the table is ready
+     */
+    bool LoadTable();
+
+    /**
+     * @brief Reads the regions and the pages out of the table
+     */
+    Success ReadTable(const unsigned char* data, size_t size);
+
+    public:
+
+    /**
+     * @brief Hashes a sprite name the same way as the atlas packer (FNV-1a)
+     */
+    static constexpr uint32_t HashName(std::string_view name) {
+      uint32_t hash = 0x811c9dc5u;
+      for (char c : name) {
+        hash ^= (unsigned char)c;
+        hash *= 0x01000193u;
+      }
+      return hash;
+    }
+
+    /**
+     * @brief The default constructor
+     *
+     * @param path the path of the atlas without an extension
+     */
+    TextureAtlas(const char* path);
+    ~TextureAtlas();
+
+    /**
+     * @brief Returns the region of a sprite, or null if it is not in the atlas
+     * or the table is still loading
+     *
+     * @param hash the hash of the sprite name, see `HashName`
+     */
+    const AtlasRegion* GetRegion(uint32_t hash);
+
+    /**
+     * @brief Returns the region of a sprite, or null if it is not in the atlas
+     * or the table is still loading
+     *
+     * @param name the name of the sprite
+     */
+    const AtlasRegion* GetRegion(std::string_view name);
+
+    /**
+     * @brief Returns the pages of the atlas, or null while the table loads
+     */
+    TextureArray* GetPages();
+
+    /**
+     * @brief Returns the amount of sprites in the atlas
+     */
+    size_t GetRegionCount();
+  };
+}
+
+#endif
@@ -17,21 +17,19 @@ void Engine::Input::InputManager::Update() {
   }
 }
 
-void Engine::Input::InputManager::AddAxis(const char* axis, InputParams positive, InputParams negative) {
-  m_axes.emplace(axis, (Axis){new Input(positive), new Input(negative)});
+void Engine::Input::InputManager::AddAxis(Engine::StringId axis, InputParams positive, InputParams negative) {
+  m_axes.Emplace(axis, Axis{new Input(positive), new Input(negative)});
 }
 
-float Engine::Input::InputManager::GetAxis(const char* axis) { 
-  Engine::Input::Input* positive = m_axes.at(axis).positive;
-  Engine::Input::Input* negative = m_axes.at(axis).negative;
-
-  return positive->Strength() - negative->Strength();
+float Engine::Input::InputManager::GetAxis(Engine::StringId axis) { 
+  Axis& entry = m_axes.at(axis);
+  return entry.positive->Strength() - entry.negative->Strength();
 }
 
-void Engine::Input::InputManager::AddInput(const char* name, InputParams input) {
-  m_axes.emplace(name, (Axis){new Input(input), nullptr});
+void Engine::Input::InputManager::AddInput(Engine::StringId name, InputParams input) {
+  m_axes.Emplace(name, Axis{new Input(input), nullptr});
 }
 
-Engine::Input::Input* Engine::Input::InputManager::GetInput(const char* name) {
+Engine::Input::Input* Engine::Input::InputManager::GetInput(Engine::StringId name) {
   return m_axes.at(name).positive;
 }
\ No newline at end of file
@@ -8,7 +8,8 @@
 #define ENGINE_INPUTMANAGER
 
 #include "Input.hpp"
-#include <map>
+#include "../FlatHashMap.hpp"
+#include "../StringId.hpp"
 
 #include <emscripten/html5.h>
 
@@ -49,7 +50,7 @@ namespace Engine::Input {
       Input* negative;
     }; 
 
-    std::map<const char*, Axis> m_axes;  
+    FlatHashMap<StringId, Axis> m_axes;
 
     public:
 
@@ -77,28 +78,28 @@ namespace Engine::Input {
      * If both positive and negative are down, the axis will be set to 0 because
      * the inputs will cancel out
      */
-    void AddAxis(const char* axis, InputParams positive, InputParams negative);
+    void AddAxis(StringId axis, InputParams positive, InputParams negative);
 
     /**
      * @brief Returns the value of the axis at the frame with the given name
      * 
      * @return The value of the axis between -1 and 1
      */
-    float GetAxis(const char* axis);
+    float GetAxis(StringId axis);
 
     /**
      * @brief Adds a single input to the input manager
      * 
      * This can be accessed later using the `GetInput` function
      */
-    void AddInput(const char* name, InputParams input);
+    void AddInput(StringId name, InputParams input);
 
     /**
      * @brief Returns the value of the input at the frame with the given name
      * 
      * @return The value of the input between 0 and 1
      */
-    Input* GetInput(const char* name);
+    Input* GetInput(StringId name);
   };
 }
 
@@ -0,0 +1,906 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file Math.hpp
+ * @brief Vectors, matrices and quaternions for the game engine
+ *
+ * Everything is defined in this header so that it can be inlined wherever it
+ * is used. When the engine is compiled with WebAssembly SIMD (`-msimd128`),
+ * matrix products and the batch kernels work on 4 floats at a time, with
+ * the same results as the scalar code used everywhere else.
+ *
+ * Matrices are column-major like OpenGL, and angles are in degrees.
+ */
+
+#ifndef ENGINE_MATH
+#define ENGINE_MATH
+
+#include <cmath>
+#include <cstddef>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#define ENGINE_SIMD
+#endif
+
+namespace Engine {
+
+  constexpr float PI = 3.14159265358979323846f;
+  constexpr float DEGREES_TO_RADIANS = PI / 180.0f;
+  constexpr float RADIANS_TO_DEGREES = 180.0f / PI;
+
+  /**
+   * @brief A 2D vector struct with overloaded operators
+   */
+  struct Vec2f {
+    float x;
+    float y;
+
+    /**
+     * @brief Add two Vec2f objects together
+     */
+    constexpr Vec2f operator+(const Vec2f& rhs) const {
+      return {x + rhs.x, y + rhs.y};
+    }
+
+    /**
+     * @brief Subtract two Vec2f objects
+     */
+    constexpr Vec2f operator-(const Vec2f& rhs) const {
+      return {x - rhs.x, y - rhs.y};
+    }
+
+    /**
+     * @brief Compute scalar multiplication
+     */
+    constexpr Vec2f operator*(const float& rhs) const {
+      return {x * rhs, y * rhs};
+    }
+
+    /**
+     * @brief Compute multiplication in parallel
+     */
+    constexpr Vec2f operator*(const Vec2f& rhs) const {
+      return {x * rhs.x, y * rhs.y};
+    }
+
+    /**
+     * @brief Scalar division
+     */
+    constexpr Vec2f operator/(const float& rhs) const {
+      return {x / rhs, y / rhs};
+    }
+
+    constexpr bool operator==(const Vec2f& rhs) const {
+      return x == rhs.x && y == rhs.y;
+    }
+
+    /**
+     * @brief Returns the squared length of the vector
+     */
+    constexpr float lengthSquared() const {
+      return x * x + y * y;
+    }
+
+    /**
+     * @brief Returns the length of the vector
+     */
+    float length() const {
+      return sqrtf(lengthSquared());
+    }
+  };
+
+  /**
+   * @brief A 3D vector struct with overloaded operators
+   */
+  struct Vec3f {
+    float x;
+    float y;
+    float z;
+
+    /**
+     * @brief Adds two Vec3f objects
+     */
+    constexpr Vec3f operator+(const Vec3f& rhs) const {
+      return {x + rhs.x, y + rhs.y, z + rhs.z};
+    }
+
+    /**
+     * @brief Subtracts two Vec3f objects
+     */
+    constexpr Vec3f operator-(const Vec3f& rhs) const {
+      return {x - rhs.x, y - rhs.y, z - rhs.z};
+    }
+
+    /**
+     * @brief Negates the vector
+     */
+    constexpr Vec3f operator-() const {
+      return {-x, -y, -z};
+    }
+
+    /**
+     * @brief Compute scalar multiplication
+     */
+    constexpr Vec3f operator*(const float& rhs) const {
+      return {x * rhs, y * rhs, z * rhs};
+    }
+
+    /**
+     * @brief Computes Multiplication in parallel
+     */
+    constexpr Vec3f operator*(const Vec3f& rhs) const {
+      return {x * rhs.x, y * rhs.y, z * rhs.z};
+    }
+
+    /**
+     * @brief Scalar division
+     */
+    constexpr Vec3f operator/(const float& rhs) const {
+      return {x / rhs, y / rhs, z / rhs};
+    }
+
+    constexpr bool operator==(const Vec3f& rhs) const {
+      return x == rhs.x && y == rhs.y && z == rhs.z;
+    }
+
+    /**
+     * @brief Returns the squared length of the vector
+     */
+    constexpr float lengthSquared() const {
+      return x * x + y * y + z * z;
+    }
+
+    /**
+     * @brief Returns the length of the vector
+     */
+    float length() const {
+      return sqrtf(lengthSquared());
+    }
+  };
+
+  /**
+   * @brief A 4D vector, aligned to be loaded as a single SIMD register
+   */
+  struct alignas(16) Vec4f {
+    float x;
+    float y;
+    float z;
+    float w;
+
+    constexpr Vec4f operator+(const Vec4f& rhs) const {
+      return {x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w};
+    }
+
+    constexpr Vec4f operator-(const Vec4f& rhs) const {
+      return {x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w};
+    }
+
+    constexpr Vec4f operator*(const float& rhs) const {
+      return {x * rhs, y * rhs, z * rhs, w * rhs};
+    }
+
+    constexpr Vec4f operator*(const Vec4f& rhs) const {
+      return {x * rhs.x, y * rhs.y, z * rhs.z, w * rhs.w};
+    }
+
+    constexpr bool operator==(const Vec4f& rhs) const {
+      return x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w;
+    }
+  };
+
+  /**
+   * @brief Returns the dot product of two vectors
+   */
+  constexpr float Dot(Vec2f a, Vec2f b) {
+    return a.x * b.x + a.y * b.y;
+  }
+
+  /**
+   * @brief Returns the dot product of two vectors
+   */
+  constexpr float Dot(Vec3f a, Vec3f b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+  }
+
+  /**
+   * @brief Returns the dot product of two vectors
+   */
+  constexpr float Dot(Vec4f a, Vec4f b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+  }
+
+  /**
+   * @brief Returns the cross product of two vectors
+   */
+  constexpr Vec3f Cross(Vec3f a, Vec3f b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+      a.x * b.y - a.y * b.x};
+  }
+
+  /**
+   * @brief returns the inverse square root of a float
+   *
+   * To normalize many vectors at once, see `NormalizeVectors`.
+   *
+   * @param x The float to take the inverse square root of
+   * @return The inverse square root
+   */
+  inline float InvSQRT(float x) {
+    return 1.0f / sqrtf(x);
+  }
+
+  /**
+   * @brief Returns the vector scaled to a length of 1, or the zero vector
+   */
+  inline Vec3f Normalize(Vec3f v) {
+    float lengthSquared = v.lengthSquared();
+    return lengthSquared > 0.0f ? v * InvSQRT(lengthSquared) : v;
+  }
+
+  /**
+   * @brief Multiplies two column-major 4x4 matrices (out = a * b)
+   *
+   * `out` may not be `a` or `b`.
+   */
+  inline void MultiplyMatrices(const float* a, const float* b, float* out) {
+    #ifdef ENGINE_SIMD
+    v128_t a0 = wasm_v128_load(a);
+    v128_t a1 = wasm_v128_load(a + 4);
+    v128_t a2 = wasm_v128_load(a + 8);
+    v128_t a3 = wasm_v128_load(a + 12);
+
+    // Each column of the result mixes the columns of a
+    for (int column = 0; column < 4; column++) {
+      const float* c = b + column * 4;
+      v128_t result = wasm_f32x4_mul(a0, wasm_f32x4_splat(c[0]));
+      result = wasm_f32x4_add(result, wasm_f32x4_mul(a1, wasm_f32x4_splat(c[1])));
+      result = wasm_f32x4_add(result, wasm_f32x4_mul(a2, wasm_f32x4_splat(c[2])));
+      result = wasm_f32x4_add(result, wasm_f32x4_mul(a3, wasm_f32x4_splat(c[3])));
+      wasm_v128_store(out + column * 4, result);
+    }
+    #else
+    for (int column = 0; column < 4; column++)
+      for (int row = 0; row < 4; row++)
+        out[column * 4 + row] = a[row] * b[column * 4]
+          + a[4 + row] * b[column * 4 + 1]
+          + a[8 + row] * b[column * 4 + 2]
+          + a[12 + row] * b[column * 4 + 3];
+    #endif
+  }
+
+  /**
+   * @brief A column-major 3x3 matrix
+   */
+  struct Mat3f {
+    float m[9];
+
+    /**
+     * @brief Returns the identity matrix
+     */
+    static constexpr Mat3f Identity() {
+      return {{1, 0, 0, 0, 1, 0, 0, 0, 1}};
+    }
+
+    constexpr Vec3f operator*(const Vec3f& v) const {
+      return {
+        m[0] * v.x + m[3] * v.y + m[6] * v.z,
+        m[1] * v.x + m[4] * v.y + m[7] * v.z,
+        m[2] * v.x + m[5] * v.y + m[8] * v.z
+      };
+    }
+
+    constexpr Mat3f operator*(const Mat3f& rhs) const {
+      Mat3f result{};
+      for (int column = 0; column < 3; column++)
+        for (int row = 0; row < 3; row++)
+          result.m[column * 3 + row] = m[row] * rhs.m[column * 3]
+            + m[3 + row] * rhs.m[column * 3 + 1]
+            + m[6 + row] * rhs.m[column * 3 + 2];
+      return result;
+    }
+
+    /**
+     * @brief Returns the transpose, which is the inverse of a rotation
+     */
+    constexpr Mat3f Transposed() const {
+      return {{m[0], m[3], m[6], m[1], m[4], m[7], m[2], m[5], m[8]}};
+    }
+  };
+
+  /**
+   * @brief A column-major 4x4 matrix, ready to be uploaded to OpenGL
+   */
+  struct alignas(16) Mat4f {
+    float m[16];
+
+    /**
+     * @brief Returns the identity matrix
+     */
+    static constexpr Mat4f Identity() {
+      return {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+    }
+
+    /**
+     * @brief Returns a matrix that moves points by an offset
+     */
+    static constexpr Mat4f Translation(Vec3f offset) {
+      return {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0,
+        offset.x, offset.y, offset.z, 1}};
+    }
+
+    /**
+     * @brief Returns a matrix that scales along each axis
+     */
+    static constexpr Mat4f Scaling(Vec3f scale) {
+      return {{scale.x, 0, 0, 0, 0, scale.y, 0, 0, 0, 0, scale.z, 0,
+        0, 0, 0, 1}};
+    }
+
+    Mat4f operator*(const Mat4f& rhs) const {
+      Mat4f result;
+      MultiplyMatrices(m, rhs.m, result.m);
+      return result;
+    }
+
+    constexpr Vec4f operator*(const Vec4f& v) const {
+      return {
+        m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+        m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w
+      };
+    }
+
+    /**
+     * @brief Transforms a point, including the translation
+     */
+    constexpr Vec3f TransformPoint(Vec3f p) const {
+      return {
+        m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+        m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+        m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]
+      };
+    }
+
+    /**
+     * @brief Transforms a direction, ignoring the translation
+     */
+    constexpr Vec3f TransformVector(Vec3f v) const {
+      return {
+        m[0] * v.x + m[4] * v.y + m[8] * v.z,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z
+      };
+    }
+
+    /**
+     * @brief Returns the upper left 3x3 matrix (rotation and scale)
+     */
+    constexpr Mat3f ToMat3() const {
+      return {{m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10]}};
+    }
+  };
+
+  /**
+   * @brief A rotation stored as a unit quaternion
+   *
+   * Quaternions compose and interpolate without the gimbal lock of Euler
+   * angles. The Euler angles used by the engine are applied as
+   * `rotateX * rotateY * rotateZ`.
+   *
+   * A quaternion is built from all 4 components, so that Euler angles given
+   * in braces (`{0, 90, 0}`) are never mistaken for one.
+   */
+  struct Quatf {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 1.0f;
+
+    constexpr Quatf() = default;
+    constexpr Quatf(float x, float y, float z, float w)
+      : x(x), y(y), z(z), w(w) {}
+
+    /**
+     * @brief Returns the rotation that does nothing
+     */
+    static constexpr Quatf Identity() {
+      return {0.0f, 0.0f, 0.0f, 1.0f};
+    }
+
+    /**
+     * @brief Returns a rotation around an axis
+     *
+     * @param axis a unit vector
+     * @param degrees the angle of the rotation
+     */
+    static Quatf FromAxisAngle(Vec3f axis, float degrees) {
+      float half = degrees * DEGREES_TO_RADIANS * 0.5f;
+      float s = sinf(half);
+      return {axis.x * s, axis.y * s, axis.z * s, cosf(half)};
+    }
+
+    /**
+     * @brief Returns the rotation of Euler angles in degrees
+     */
+    static Quatf FromEuler(Vec3f degrees) {
+      float hx = degrees.x * DEGREES_TO_RADIANS * 0.5f;
+      float hy = degrees.y * DEGREES_TO_RADIANS * 0.5f;
+      float hz = degrees.z * DEGREES_TO_RADIANS * 0.5f;
+      float cx = cosf(hx), sx = sinf(hx);
+      float cy = cosf(hy), sy = sinf(hy);
+      float cz = cosf(hz), sz = sinf(hz);
+
+      // rotateX * rotateY * rotateZ
+      return {
+        sx * cy * cz + cx * sy * sz,
+        cx * sy * cz - sx * cy * sz,
+        cx * cy * sz + sx * sy * cz,
+        cx * cy * cz - sx * sy * sz
+      };
+    }
+
+    /**
+     * @brief Returns the rotation of a 3x3 rotation matrix
+     *
+     * @param r a matrix without scale
+     */
+    static Quatf FromMat3(const Mat3f& r) {
+      // r(row, column) = r.m[column * 3 + row]
+      float trace = r.m[0] + r.m[4] + r.m[8];
+      if (trace > 0.0f) {
+        float s = sqrtf(trace + 1.0f) * 2.0f;
+        return {(r.m[5] - r.m[7]) / s, (r.m[6] - r.m[2]) / s,
+          (r.m[1] - r.m[3]) / s, 0.25f * s};
+      }
+
+      // Divide by the largest component to stay precise
+      if (r.m[0] > r.m[4] && r.m[0] > r.m[8]) {
+        float s = sqrtf(1.0f + r.m[0] - r.m[4] - r.m[8]) * 2.0f;
+        return {0.25f * s, (r.m[3] + r.m[1]) / s, (r.m[6] + r.m[2]) / s,
+          (r.m[5] - r.m[7]) / s};
+      }
+
+      if (r.m[4] > r.m[8]) {
+        float s = sqrtf(1.0f + r.m[4] - r.m[0] - r.m[8]) * 2.0f;
+        return {(r.m[3] + r.m[1]) / s, 0.25f * s, (r.m[7] + r.m[5]) / s,
+          (r.m[6] - r.m[2]) / s};
+      }
+
+      float s = sqrtf(1.0f + r.m[8] - r.m[0] - r.m[4]) * 2.0f;
+      return {(r.m[6] + r.m[2]) / s, (r.m[7] + r.m[5]) / s, 0.25f * s,
+        (r.m[1] - r.m[3]) / s};
+    }
+
+    /**
+     * @brief Returns the Euler angles in degrees of the rotation
+     *
+     * Several angles describe the same rotation, so the angles given to
+     * `FromEuler` may not come back unchanged.
+     */
+    Vec3f ToEuler() const {
+      Mat3f r = ToMat3();
+      float sinY = fmaxf(-1.0f, fminf(1.0f, r.m[6]));
+
+      // At y = +-90 degrees, x and z turn around the same axis (gimbal lock)
+      if (fabsf(sinY) > 0.99999f)
+        return {0.0f, asinf(sinY) * RADIANS_TO_DEGREES,
+          atan2f(r.m[1], r.m[4]) * RADIANS_TO_DEGREES};
+
+      return {
+        atan2f(-r.m[7], r.m[8]) * RADIANS_TO_DEGREES,
+        asinf(sinY) * RADIANS_TO_DEGREES,
+        atan2f(-r.m[3], r.m[0]) * RADIANS_TO_DEGREES
+      };
+    }
+
+    /**
+     * @brief Combines two rotations, `rhs` being applied first
+     */
+    constexpr Quatf operator*(const Quatf& rhs) const {
+      return {
+        w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+        w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+        w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w,
+        w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z
+      };
+    }
+
+    constexpr bool operator==(const Quatf& rhs) const {
+      return x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w;
+    }
+
+    /**
+     * @brief Returns the inverse of a unit quaternion
+     */
+    constexpr Quatf Conjugate() const {
+      return {-x, -y, -z, w};
+    }
+
+    /**
+     * @brief Returns the quaternion scaled to a length of 1
+     */
+    Quatf Normalized() const {
+      float lengthSquared = x * x + y * y + z * z + w * w;
+      if (lengthSquared == 0.0f)
+        return Identity();
+
+      float inverse = InvSQRT(lengthSquared);
+      return {x * inverse, y * inverse, z * inverse, w * inverse};
+    }
+
+    /**
+     * @brief Rotates a vector
+     */
+    constexpr Vec3f Rotate(Vec3f v) const {
+      Vec3f axis = {x, y, z};
+      Vec3f t = Cross(axis, v) * 2.0f;
+      return v + t * w + Cross(axis, t);
+    }
+
+    /**
+     * @brief Returns the rotation as a 3x3 matrix
+     */
+    constexpr Mat3f ToMat3() const {
+      float xx = x * x, yy = y * y, zz = z * z;
+      float xy = x * y, xz = x * z, yz = y * z;
+      float wx = w * x, wy = w * y, wz = w * z;
+      return {{
+        1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy),
+        2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx),
+        2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy)
+      }};
+    }
+
+    /**
+     * @brief Returns the rotation as a 4x4 matrix
+     */
+    constexpr Mat4f ToMat4() const {
+      Mat3f r = ToMat3();
+      return {{r.m[0], r.m[1], r.m[2], 0, r.m[3], r.m[4], r.m[5], 0,
+        r.m[6], r.m[7], r.m[8], 0, 0, 0, 0, 1}};
+    }
+  };
+
+  /**
+   * @brief Returns the dot product of two quaternions
+   */
+  constexpr float Dot(Quatf a, Quatf b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+  }
+
+  /**
+   * @brief Interpolates two rotations along the shortest arc
+   *
+   * @param a the rotation at 0
+   * @param b the rotation at 1
+   * @param t the progress between both rotations
+   */
+  inline Quatf Slerp(Quatf a, Quatf b, float t) {
+    float cosine = Dot(a, b);
+
+    // q and -q are the same rotation, take the closest one
+    if (cosine < 0.0f) {
+      b = {-b.x, -b.y, -b.z, -b.w};
+      cosine = -cosine;
+    }
+
+    float wa = 1.0f - t, wb = t;
+
+    // Close rotations are interpolated linearly to avoid dividing by 0
+    if (cosine < 0.9995f) {
+      float angle = acosf(cosine);
+      float inverseSine = 1.0f / sinf(angle);
+      wa = sinf(wa * angle) * inverseSine;
+      wb = sinf(wb * angle) * inverseSine;
+    }
+
+    return Quatf{a.x * wa + b.x * wb, a.y * wa + b.y * wb,
+      a.z * wa + b.z * wb, a.w * wa + b.w * wb}.Normalized();
+  }
+
+  /**
+   * @brief Builds translate * rotate * scale into a column-major matrix
+   *
+   * @param out An array of 16 floats to write the matrix into
+   */
+  constexpr void ComposeMatrix(Vec3f position, Quatf rotation, Vec3f scale,
+    float* out) {
+    Mat3f r = rotation.ToMat3();
+    for (int column = 0; column < 3; column++) {
+      float s = column == 0 ? scale.x : column == 1 ? scale.y : scale.z;
+      out[column * 4] = r.m[column * 3] * s;
+      out[column * 4 + 1] = r.m[column * 3 + 1] * s;
+      out[column * 4 + 2] = r.m[column * 3 + 2] * s;
+      out[column * 4 + 3] = 0.0f;
+    }
+
+    out[12] = position.x;
+    out[13] = position.y;
+    out[14] = position.z;
+    out[15] = 1.0f;
+  }
+
+  /**
+   * @brief An axis aligned bounding box
+   *
+   * A box whose minimum is above its maximum is empty, which is what
+   * `Empty()` returns so that the first point expanded sets both corners.
+   */
+  struct BoundingBox {
+    Vec3f min;
+    Vec3f max;
+
+    /**
+     * @brief Returns a box that contains nothing
+     */
+    static constexpr BoundingBox Empty() {
+      return {{INFINITY, INFINITY, INFINITY},
+        {-INFINITY, -INFINITY, -INFINITY}};
+    }
+
+    constexpr bool IsEmpty() const {
+      return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    constexpr Vec3f Center() const {
+      return (min + max) * 0.5f;
+    }
+
+    /**
+     * @brief Returns half of the size of the box along each axis
+     */
+    constexpr Vec3f Extents() const {
+      return (max - min) * 0.5f;
+    }
+
+    /**
+     * @brief Grows the box to contain a point
+     */
+    void Expand(Vec3f point) {
+      min = {fminf(min.x, point.x), fminf(min.y, point.y),
+        fminf(min.z, point.z)};
+      max = {fmaxf(max.x, point.x), fmaxf(max.y, point.y),
+        fmaxf(max.z, point.z)};
+    }
+
+    /**
+     * @brief Returns the box containing both boxes
+     */
+    BoundingBox Union(const BoundingBox& other) const {
+      return {
+        {fminf(min.x, other.min.x), fminf(min.y, other.min.y),
+          fminf(min.z, other.min.z)},
+        {fmaxf(max.x, other.max.x), fmaxf(max.y, other.max.y),
+          fmaxf(max.z, other.max.z)}
+      };
+    }
+
+    /**
+     * @brief Returns the box grown by a margin in every direction
+     */
+    constexpr BoundingBox Fattened(float margin) const {
+      return {min - Vec3f{margin, margin, margin},
+        max + Vec3f{margin, margin, margin}};
+    }
+
+    constexpr float SurfaceArea() const {
+      return 2.0f * ((max.x - min.x) * (max.y - min.y)
+        + (max.y - min.y) * (max.z - min.z)
+        + (max.z - min.z) * (max.x - min.x));
+    }
+
+    constexpr bool Contains(const BoundingBox& other) const {
+      return min.x <= other.min.x && min.y <= other.min.y
+        && min.z <= other.min.z && other.max.x <= max.x
+        && other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    constexpr bool Overlaps(const BoundingBox& other) const {
+      return min.x <= other.max.x && other.min.x <= max.x
+        && min.y <= other.max.y && other.min.y <= max.y
+        && min.z <= other.max.z && other.min.z <= max.z;
+    }
+
+    /**
+     * @brief Returns the squared distance from a point to the box
+     *
+     * Points inside the box are at a distance of 0.
+     */
+    float DistanceSquared(Vec3f point) const {
+      Vec3f d = {
+        fmaxf(fmaxf(min.x - point.x, point.x - max.x), 0.0f),
+        fmaxf(fmaxf(min.y - point.y, point.y - max.y), 0.0f),
+        fmaxf(fmaxf(min.z - point.z, point.z - max.z), 0.0f)
+      };
+      return d.lengthSquared();
+    }
+
+    /**
+     * @brief Returns how far along a ray the box starts
+     *
+     * @param origin where the ray starts
+     * @param inverseDirection 1 divided by each component of the direction
+     * @param maxDistance the length of the ray
+     * @return The distance, 0 if the ray starts inside, or infinity if the
+     * ray misses
+     */
+    float RayDistance(Vec3f origin, Vec3f inverseDirection,
+      float maxDistance) const {
+      // fminf and fmaxf ignore the NaN of rays along a face of the box
+      Vec3f t1 = {(min.x - origin.x) * inverseDirection.x,
+        (min.y - origin.y) * inverseDirection.y,
+        (min.z - origin.z) * inverseDirection.z};
+      Vec3f t2 = {(max.x - origin.x) * inverseDirection.x,
+        (max.y - origin.y) * inverseDirection.y,
+        (max.z - origin.z) * inverseDirection.z};
+      float enter = fmaxf(fmaxf(fminf(t1.x, t2.x), fminf(t1.y, t2.y)),
+        fmaxf(fminf(t1.z, t2.z), 0.0f));
+      float exit = fminf(fminf(fmaxf(t1.x, t2.x), fmaxf(t1.y, t2.y)),
+        fminf(fmaxf(t1.z, t2.z), maxDistance));
+      return enter <= exit ? enter : INFINITY;
+    }
+
+    /**
+     * @brief Returns the box containing this box once transformed
+     *
+     * @param matrix a column-major matrix of 16 floats
+     */
+    BoundingBox Transformed(const float* matrix) const {
+      if (IsEmpty())
+        return *this;
+
+      // The extents along each world axis add up the absolute columns
+      Vec3f center = Center();
+      Vec3f extents = Extents();
+      const float* m = matrix;
+      Vec3f worldCenter = {
+        m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+        m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+        m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]
+      };
+      Vec3f worldExtents = {
+        fabsf(m[0]) * extents.x + fabsf(m[4]) * extents.y
+          + fabsf(m[8]) * extents.z,
+        fabsf(m[1]) * extents.x + fabsf(m[5]) * extents.y
+          + fabsf(m[9]) * extents.z,
+        fabsf(m[2]) * extents.x + fabsf(m[6]) * extents.y
+          + fabsf(m[10]) * extents.z
+      };
+      return {worldCenter - worldExtents, worldCenter + worldExtents};
+    }
+  };
+
+  /**
+   * @brief A bounding sphere, empty when its radius is negative
+   */
+  struct BoundingSphere {
+    Vec3f center;
+    float radius;
+
+    /**
+     * @brief Returns the sphere containing this sphere once transformed
+     *
+     * Non-uniform scales grow the sphere by the largest scale.
+     *
+     * @param matrix a column-major matrix of 16 floats
+     */
+    BoundingSphere Transformed(const float* matrix) const {
+      const float* m = matrix;
+      float scale = fmaxf(m[0] * m[0] + m[1] * m[1] + m[2] * m[2],
+        fmaxf(m[4] * m[4] + m[5] * m[5] + m[6] * m[6],
+        m[8] * m[8] + m[9] * m[9] + m[10] * m[10]));
+      return {{
+        m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+        m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+        m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]
+      }, radius * sqrtf(scale)};
+    }
+  };
+
+  #ifdef ENGINE_SIMD
+  /**
+   * @brief Splits 4 packed Vec3f into one register per component
+   */
+  inline void LoadVec3x4(const Vec3f* v, v128_t& x, v128_t& y, v128_t& z) {
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    v128_t a = wasm_v128_load(&v[0].x);
+    v128_t b = wasm_v128_load(&v[1].y);
+    v128_t c = wasm_v128_load(&v[2].z);
+    x = wasm_i32x4_shuffle(wasm_i32x4_shuffle(a, b, 0, 3, 6, 7), c, 0, 1, 2, 5);
+    y = wasm_i32x4_shuffle(wasm_i32x4_shuffle(a, b, 1, 4, 7, 0), c, 0, 1, 2, 6);
+    z = wasm_i32x4_shuffle(wasm_i32x4_shuffle(a, b, 2, 5, 0, 0), c, 0, 1, 4, 7);
+  }
+
+  /**
+   * @brief Packs one register per component back into 4 Vec3f
+   */
+  inline void StoreVec3x4(Vec3f* v, v128_t x, v128_t y, v128_t z) {
+    v128_t a = wasm_i32x4_shuffle(wasm_i32x4_shuffle(x, y, 0, 4, 1, 5), z, 0, 1, 4, 2);
+    v128_t b = wasm_i32x4_shuffle(wasm_i32x4_shuffle(y, z, 1, 5, 2, 6), x, 0, 1, 6, 2);
+    v128_t c = wasm_i32x4_shuffle(wasm_i32x4_shuffle(z, x, 2, 7, 3, 3), y, 0, 1, 7, 2);
+    wasm_v128_store(&v[0].x, a);
+    wasm_v128_store(&v[1].y, b);
+    wasm_v128_store(&v[2].z, c);
+  }
+  #endif
+
+  /**
+   * @brief Transforms many points by the same matrix
+   *
+   * @param matrix the transformation, including its translation
+   * @param points the points to transform
+   * @param out where the transformed points are written, may be `points`
+   * @param count the amount of points
+   */
+  inline void TransformPoints(const Mat4f& matrix, const Vec3f* points,
+    Vec3f* out, size_t count) {
+    size_t i = 0;
+
+    #ifdef ENGINE_SIMD
+    // 4 points at a time, one component per register
+    const float* m = matrix.m;
+    for (; i + 4 <= count; i += 4) {
+      v128_t x, y, z;
+      LoadVec3x4(&points[i], x, y, z);
+
+      v128_t rx = wasm_f32x4_add(wasm_f32x4_add(
+        wasm_f32x4_mul(x, wasm_f32x4_splat(m[0])),
+        wasm_f32x4_mul(y, wasm_f32x4_splat(m[4]))), wasm_f32x4_add(
+        wasm_f32x4_mul(z, wasm_f32x4_splat(m[8])), wasm_f32x4_splat(m[12])));
+      v128_t ry = wasm_f32x4_add(wasm_f32x4_add(
+        wasm_f32x4_mul(x, wasm_f32x4_splat(m[1])),
+        wasm_f32x4_mul(y, wasm_f32x4_splat(m[5]))), wasm_f32x4_add(
+        wasm_f32x4_mul(z, wasm_f32x4_splat(m[9])), wasm_f32x4_splat(m[13])));
+      v128_t rz = wasm_f32x4_add(wasm_f32x4_add(
+        wasm_f32x4_mul(x, wasm_f32x4_splat(m[2])),
+        wasm_f32x4_mul(y, wasm_f32x4_splat(m[6]))), wasm_f32x4_add(
+        wasm_f32x4_mul(z, wasm_f32x4_splat(m[10])), wasm_f32x4_splat(m[14])));
+
+      StoreVec3x4(&out[i], rx, ry, rz);
+    }
+    #endif
+
+    for (; i < count; i++)
+      out[i] = matrix.TransformPoint(points[i]);
+  }
+
+  /**
+   * @brief Scales many vectors to a length of 1
+   *
+   * Vectors with a length of 0 are left unchanged.
+   */
+  inline void NormalizeVectors(Vec3f* vectors, size_t count) {
+    size_t i = 0;
+
+    #ifdef ENGINE_SIMD
+    const v128_t zero = wasm_f32x4_splat(0.0f);
+    const v128_t one = wasm_f32x4_splat(1.0f);
+
+    for (; i + 4 <= count; i += 4) {
+      v128_t x, y, z;
+      LoadVec3x4(&vectors[i], x, y, z);
+
+      v128_t lengthSquared = wasm_f32x4_add(wasm_f32x4_add(
+        wasm_f32x4_mul(x, x), wasm_f32x4_mul(y, y)), wasm_f32x4_mul(z, z));
+
+      // Zero vectors are divided by 1 instead
+      v128_t length = wasm_v128_bitselect(one, wasm_f32x4_sqrt(lengthSquared),
+        wasm_f32x4_eq(lengthSquared, zero));
+
+      StoreVec3x4(&vectors[i], wasm_f32x4_div(x, length),
+        wasm_f32x4_div(y, length), wasm_f32x4_div(z, length));
+    }
+    #endif
+
+    for (; i < count; i++)
+      vectors[i] = Normalize(vectors[i]);
+  }
+}
+
+#endif
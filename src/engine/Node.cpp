@@ -6,23 +6,47 @@
 
 #include "Node.hpp"
 
-Engine::Node::Node(std::string name) {
-  m_name = name;
+bool Engine::Node::s_flatTraversal = false;
+uint64_t Engine::Node::s_structureVersion = 0;
+
+Engine::Node::Node(std::string_view name) {
+  m_name = StringId::Intern(name);
   m_parent = nullptr;
   m_enabled = true;
   m_nodeType = "Node";
+  m_handle = GetNodeRegistry().Register(this);
 }
 
 Engine::Node::~Node() {
   for (Node* child : m_children)
     if (child->m_parent != nullptr)
-      delete child;
+      Free(child);
+
+  GetNodeRegistry().Unregister(m_handle);
+  s_structureVersion++;
+}
+
+void Engine::Node::Free(Node* node) {
+  NodePoolBase* pool = node->m_pool;
+  if (pool == nullptr) {
+    delete node;
+    return;
+  }
+
+  // With multiple inheritance the node is not at the start of its memory
+  void* memory = dynamic_cast<void*>(node);
+  node->~Node();
+  pool->Release(memory);
 }
 
 size_t Engine::Node::AddChild(Node* child) {
   child->m_parent = this;
+  child->m_childIndex = m_children.size();
+  child->AttachTransforms();
   child->Init();
   m_children.push_back(child);
+  s_structureVersion++;
+  OnChildAdded(child);
   return m_children.size() - 1;
 }
 
@@ -30,19 +54,96 @@ Engine::Node* Engine::Node::GetChild(size_t index) {
   return m_children[index];
 }
 
+Engine::Node* Engine::Node::GetParent() {
+  return m_parent;
+}
+
+size_t Engine::Node::GetChildCount() {
+  return m_children.size();
+}
+
 Engine::Success Engine::Node::RemoveChild(size_t index) {
-  m_children[index]->OnDisable();
-  delete m_children[index];
-  m_children.erase(m_children.begin() + index);
-  m_children.shrink_to_fit();
+  if (index >= m_children.size())
+    return FAILURE;
+
+  Free(DetachChild(index, false));
   return SUCCESS;
 }
 
+Engine::Node* Engine::Node::DetachChild(size_t index, bool keepOrder) {
+  Node* child = m_children[index];
+  OnChildRemoved(child);
+  child->OnDisable();
+
+  if (keepOrder) {
+    m_children.erase(m_children.begin() + index);
+    for (size_t i = index; i < m_children.size(); i++)
+      m_children[i]->m_childIndex = i;
+  } else {
+    m_children[index] = m_children.back();
+    m_children[index]->m_childIndex = index;
+    m_children.pop_back();
+  }
+
+  s_structureVersion++;
+  return child;
+}
+
+Engine::NodeHandle Engine::Node::GetHandle() {
+  return m_handle;
+}
+
+void Engine::Node::Destroy() {
+  if (m_destroyed)
+    return;
+
+  m_destroyed = true;
+  s_structureVersion++;
+  GetNodeRegistry().QueueDestroy(m_handle);
+}
+
+bool Engine::Node::IsDestroyed() {
+  return m_destroyed;
+}
+
+size_t Engine::Node::FlushDestroyed() {
+  NodeRegistry& registry = GetNodeRegistry();
+  size_t count = 0;
+
+  // Destructors may destroy more nodes, which are flushed in the same frame
+  while (registry.GetPendingCount() > 0) {
+    for (NodeHandle handle : registry.TakePending()) {
+      // Nodes destroyed with an ancestor are already gone
+      Node* node = registry.Get(handle);
+      if (node == nullptr)
+        continue;
+
+      if (node->m_parent != nullptr)
+        node->m_parent->RemoveChild(node->m_childIndex);
+      else
+        Free(node);
+      count++;
+    }
+  }
+
+  return count;
+}
+
+uint64_t Engine::Node::GetStructureVersion() {
+  return s_structureVersion;
+}
+
+void Engine::Node::SetDrawsChildren(bool drawsChildren) {
+  m_drawsChildren = drawsChildren;
+  s_structureVersion++;
+}
+
 Engine::Success Engine::Node::SetEnabled(bool enabled) {
   if (m_enabled == enabled)
     return FAILURE;
 
   m_enabled = enabled;
+  s_structureVersion++;
 
   if (enabled)
     OnEnable();
@@ -52,6 +153,10 @@ Engine::Success Engine::Node::SetEnabled(bool enabled) {
   return SUCCESS;
 }
 
+bool Engine::Node::IsEnabled() {
+  return m_enabled;
+}
+
 void Engine::Node::OnEnable() {
     for (Node* child : m_children)
         child->OnEnable();
@@ -62,16 +167,31 @@ void Engine::Node::OnDisable() {
         child->OnDisable();
 }
 
+void Engine::Node::AttachTransforms() {
+  for (Node* child : m_children)
+    child->AttachTransforms();
+}
+
+void Engine::Node::OnChildAdded(Node* child) {}
+
+void Engine::Node::OnChildRemoved(Node* child) {}
+
 void Engine::Node::Init() {}
 
 void Engine::Node::Draw() {
+  if (s_flatTraversal)
+    return;
+
   for (Node* child : m_children)
-    if (child->m_enabled)
+    if (child->m_enabled && !child->m_destroyed)
       child->Draw();
 }
 
 void Engine::Node::Update(float dt) {
+  if (s_flatTraversal)
+    return;
+
   for (Node* child : m_children)
-    if (child->m_enabled)
+    if (child->m_enabled && !child->m_destroyed)
       child->Update(dt);
 }
@@ -8,8 +8,10 @@
 #define ENGINE_NODE
 
 #include "Utils.hpp"
+#include "NodePool.hpp"
+#include "StringId.hpp"
 #include <vector>
-#include <string>
+#include <string_view>
 
 namespace Engine {
 
@@ -38,27 +40,78 @@ namespace Engine {
    * }
    * ```
    *
+   * Nodes spawned and despawned often can be allocated from a pool with
+   * `CreateNode`, and referred to through a `NodeHandle`. `Destroy` removes a
+   * node at the end of the frame, so it is safe to call from `Update`.
+   *
    * @author Roberto Selles
    */
   class Node{
     private:
 
+    template <typename T>
+    friend class NodePool;
+    friend class SceneArena;
+    friend class SceneTraversal;
+
     bool m_enabled;
+    bool m_destroyed = false;
+    bool m_drawsChildren = false;
     std::vector<Node*> m_children;
 
+    // The index of the node in the children of its parent
+    size_t m_childIndex = 0;
+
+    NodeHandle m_handle;
+    NodePoolBase* m_pool = nullptr;
+
+    /**
+     * @brief Destructs a node and frees it, or returns it to its pool
+     */
+    static void Free(Node* node);
+
+    /**
+     * @brief Takes a child out of the children without freeing it
+     *
+     * @param keepOrder if the children after it are shifted back, instead of
+     * the last child taking its place
+     */
+    Node* DetachChild(size_t index, bool keepOrder);
+
+    // Set while a SceneTraversal visits the nodes, which stops the recursion
+    static bool s_flatTraversal;
+
+    // Bumped by every change to the shape of any hierarchy
+    static uint64_t s_structureVersion;
+
     protected:
 
     Node* m_parent;
 
+    /**
+     * @brief Makes the node draw its children itself
+     *
+     * A scene traversal does not draw the children of such nodes, and
+     * `Node::Draw` still recurses when it is called from them. Use it for
+     * nodes that skip, reorder or batch the draws of their children.
+     *
+     * @param drawsChildren True if the node draws its children
+     */
+    void SetDrawsChildren(bool drawsChildren);
+
     public:
 
     const char* m_nodeType;
-    std::string m_name;
+
+    /**
+     * @brief The name of the node, interned once for all nodes sharing it
+     */
+    StringId m_name;
 
     /**
      * @brief Default constructor
      */
-    Node(std::string name);
+    Node(std::string_view name);
 
     /**
      * @brief Default destructor
@@ -83,13 +136,59 @@ namespace Engine {
     Node* GetChild(size_t index);
 
     /**
-     * @brief Removes the child at the specified index
+     * @brief Returns the parent of the node, or null if it has none
+     */
+    Node* GetParent();
+
+    /**
+     * @brief Returns the amount of children of the node
+     */
+    size_t GetChildCount();
+
+    /**
+     * @brief Removes and destroys the child at the specified index
+     *
+     * The last child takes the place of the removed one, so this does not
+     * shift the other children.
      *
      * @param index The index of the child to remove
      * @return SUCCESS if the child was removed, FAILURE otherwise
      */
     Success RemoveChild(size_t index);
 
+    /**
+     * @brief Returns a handle that resolves to null once the node is gone
+     */
+    NodeHandle GetHandle();
+
+    /**
+     * @brief Queues the node to be removed from its parent and destroyed at
+     * the end of the frame
+     *
+     * The node is no longer updated or drawn, but stays valid until then.
+     */
+    void Destroy();
+
+    /**
+     * @brief Returns true if the node is queued for destruction
+     */
+    bool IsDestroyed();
+
+    /**
+     * @brief Destroys the nodes queued by `Destroy`
+     *
+     * The game calls this at the end of every frame.
+     *
+     * @return The amount of nodes destroyed
+     */
+    static size_t FlushDestroyed();
+
+    /**
+     * @brief Returns a number that changes every time a child is added or
+     * removed, or a node is enabled, disabled or destroyed
+     */
+    static uint64_t GetStructureVersion();
+
     /**
      * @brief Toggles the state of the node.
      *
@@ -101,6 +200,11 @@ namespace Engine {
      */
     Success SetEnabled(bool enabled = true);
 
+    /**
+     * @brief Returns true if the node is enabled
+     */
+    bool IsEnabled();
+
     /**
      * @brief Overridable enable method for the node.
      *
@@ -115,6 +219,28 @@ namespace Engine {
      */
     virtual void OnDisable();
 
+    /**
+     * @brief Overridable method called after a child is added to the node
+     *
+     * @param child The child that was added
+     */
+    virtual void OnChildAdded(Node* child);
+
+    /**
+     * @brief Overridable method called before a child is removed from the node
+     *
+     * @param child The child that is being removed
+     */
+    virtual void OnChildRemoved(Node* child);
+
+    /**
+     * @brief Attaches the transforms of the game objects in the subtree to
+     * the closest game object above them
+     *
+     * This is called when the node gets a new parent.
+     */
+    virtual void AttachTransforms();
+
     // Behaviour Methods //
 
     virtual void Init();
@@ -122,6 +248,9 @@ namespace Engine {
     /**
      * @brief Overridable draw method for the node
      *
+     * When the scene is drawn by a `SceneTraversal`, the children are drawn
+     * by the traversal and this method does not recurse.
+     *
      * @warning To maintain recursiveness, this method must be called in each method override
      */
     virtual void Draw();
@@ -129,6 +258,9 @@ namespace Engine {
     /**
      * @brief Overridable update method for the node
      *
+     * When the scene is updated by a `SceneTraversal`, the children are
+     * updated by the traversal and this method does not recurse.
+     *
      * @warning To maintain recursiveness, this method must be called in each method override
      */
     virtual void Update(float dt);
@@ -0,0 +1,65 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "NodePool.hpp"
+
+Engine::Node* Engine::NodeHandle::Get() const {
+  return GetNodeRegistry().Get(*this);
+}
+
+Engine::NodeHandle Engine::NodeRegistry::Register(Node* node) {
+  uint32_t index;
+  if (!m_freeSlots.empty()) {
+    index = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  } else {
+    index = m_slots.size();
+    m_slots.push_back({nullptr, 0});
+  }
+
+  m_slots[index].node = node;
+  return {index, m_slots[index].generation};
+}
+
+void Engine::NodeRegistry::Unregister(NodeHandle handle) {
+  if (Get(handle) == nullptr)
+    return;
+
+  m_slots[handle.index].node = nullptr;
+  m_slots[handle.index].generation++;
+  m_freeSlots.push_back(handle.index);
+}
+
+Engine::Node* Engine::NodeRegistry::Get(NodeHandle handle) const {
+  if (handle.index >= m_slots.size())
+    return nullptr;
+
+  const Slot& slot = m_slots[handle.index];
+  return slot.generation == handle.generation ? slot.node : nullptr;
+}
+
+void Engine::NodeRegistry::QueueDestroy(NodeHandle handle) {
+  m_pending.push_back(handle);
+}
+
+std::vector<Engine::NodeHandle> Engine::NodeRegistry::TakePending() {
+  std::vector<NodeHandle> pending;
+  pending.swap(m_pending);
+  return pending;
+}
+
+size_t Engine::NodeRegistry::GetPendingCount() const {
+  return m_pending.size();
+}
+
+size_t Engine::NodeRegistry::GetNodeCount() const {
+  return m_slots.size() - m_freeSlots.size();
+}
+
+Engine::NodeRegistry& Engine::GetNodeRegistry() {
+  static NodeRegistry registry;
+  return registry;
+}
@@ -0,0 +1,232 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_NODEPOOL
+#define ENGINE_NODEPOOL
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+
+  class Node;
+
+  /**
+   * @brief A reference to a node that can tell when the node is gone
+   *
+   * The index points to a slot of the `NodeRegistry`, and the generation is
+   * bumped every time the slot is freed, so a handle to a destroyed node
+   * resolves to null instead of dangling, even once its slot is reused.
+   */
+  struct NodeHandle {
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+
+    bool operator==(const NodeHandle& other) const = default;
+
+    /**
+     * @brief Returns the node, or null if it was destroyed
+     */
+    Node* Get() const;
+  };
+
+  /**
+   * @brief A handle that never resolves to a node
+   */
+  constexpr NodeHandle INVALID_NODE = {};
+
+  /**
+   * @brief The table every node registers itself in to get a handle
+   *
+   * It also holds the nodes waiting for `Node::FlushDestroyed`.
+   */
+  class NodeRegistry {
+    private:
+
+    struct Slot {
+      Node* node;
+      uint32_t generation;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<NodeHandle> m_pending;
+
+    public:
+
+    /**
+     * @brief Gives a node a slot, reusing the ones freed first
+     */
+    NodeHandle Register(Node* node);
+
+    /**
+     * @brief Frees the slot of a node, which invalidates its handles
+     */
+    void Unregister(NodeHandle handle);
+
+    /**
+     * @brief Returns the node of a handle, or null if it was destroyed
+     */
+    Node* Get(NodeHandle handle) const;
+
+    /**
+     * @brief Queues a node to be destroyed at the end of the frame
+     */
+    void QueueDestroy(NodeHandle handle);
+
+    /**
+     * @brief Moves the queued nodes out of the registry
+     */
+    std::vector<NodeHandle> TakePending();
+
+    /**
+     * @brief Returns the amount of nodes queued for destruction
+     */
+    size_t GetPendingCount() const;
+
+    /**
+     * @brief Returns the amount of nodes alive
+     */
+    size_t GetNodeCount() const;
+  };
+
+  /**
+   * @brief Returns the registry shared by every node
+   */
+  extern NodeRegistry& GetNodeRegistry();
+
+  /**
+   * @brief The memory a node allocated from a pool goes back to
+   */
+  class NodePoolBase {
+    public:
+    virtual ~NodePoolBase() = default;
+
+    /**
+     * @brief Returns the memory of a node that was already destructed
+     *
+     * @param node the address of the most derived object, which is not the
+     * address of its `Node` when the node has several bases
+     */
+    virtual void Release(void* node) = 0;
+  };
+
+  /**
+   * @brief A slab allocator for nodes of a single type
+   *
+   * Nodes are constructed in slabs of `SLAB_SIZE` slots, and the slots of
+   * destroyed nodes are kept in a free list, so spawning and despawning
+   * thousands of nodes a second does not go through `new` and `delete`.
+   * The slabs are never freed, a pool keeps the memory of its busiest frame.
+   *
+   * Nodes from a pool are owned by their parent like any other node, and
+   * go back to the pool when they are destroyed.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Bullet* bullet = Engine::CreateNode<Bullet>("Bullet", direction);
+   * scene.AddChild(bullet);
+   *
+   * // Later, from the bullet itself
+   * Destroy();
+   * ```
+   */
+  template <typename T>
+  class NodePool : public NodePoolBase {
+    private:
+    static constexpr size_t SLAB_SIZE = 256;
+
+    union Slot {
+      Slot* next;
+      alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_slabs;
+    Slot* m_free = nullptr;
+    size_t m_liveCount = 0;
+
+    public:
+
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * @brief Constructs a node in a free slot
+     *
+     * @param args The arguments of the constructor of the node
+     */
+    template <typename... Args>
+    T* Create(Args&&... args) {
+      if (m_free == nullptr) {
+        m_slabs.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+        Slot* slab = m_slabs.back().get();
+        for (size_t i = 0; i < SLAB_SIZE; i++)
+          slab[i].next = i + 1 < SLAB_SIZE ? &slab[i + 1] : m_free;
+        m_free = slab;
+      }
+
+      Slot* slot = m_free;
+      m_free = slot->next;
+      m_liveCount++;
+
+      T* node = new (slot->storage) T(std::forward<Args>(args)...);
+      node->m_pool = this;
+      return node;
+    }
+
+    void Release(void* node) override {
+      Slot* slot = (Slot*)node;
+      slot->next = m_free;
+      m_free = slot;
+      m_liveCount--;
+    }
+
+    /**
+     * @brief Returns the amount of nodes alive in the pool
+     */
+    size_t GetLiveCount() const {
+      return m_liveCount;
+    }
+
+    /**
+     * @brief Returns the amount of slots allocated
+     */
+    size_t GetCapacity() const {
+      return m_slabs.size() * SLAB_SIZE;
+    }
+  };
+
+  /**
+   * @brief Returns the pool of a node type
+   *
+   * The pool is never destroyed, it lives until the program exits. Static
+   * and global scenes can be destroyed after function-local statics, and
+   * they still give their nodes back to the pool.
+   */
+  template <typename T>
+  NodePool<T>& GetNodePool() {
+    static NodePool<T>* pool = new NodePool<T>();
+    return *pool;
+  }
+
+  /**
+   * @brief Creates a node in the pool of its type
+   *
+   * @param args The arguments of the constructor of the node
+   */
+  template <typename T, typename... Args>
+  T* CreateNode(Args&&... args) {
+    return GetNodePool<T>().Create(std::forward<Args>(args)...);
+  }
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SceneArena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+Engine::SceneArena::SceneArena(size_t blockSize) {
+  m_blockSize = blockSize;
+}
+
+Engine::SceneArena::~SceneArena() {
+  Release();
+}
+
+void* Engine::SceneArena::Allocate(size_t size, size_t alignment) {
+  uintptr_t address = ((uintptr_t)m_cursor + alignment - 1)
+    & ~(uintptr_t)(alignment - 1);
+
+  if (m_cursor == nullptr || address + size > (uintptr_t)m_end) {
+    size_t blockSize = std::max(m_blockSize, size + alignment);
+    m_blocks.push_back({std::unique_ptr<unsigned char[]>(
+      new unsigned char[blockSize]), blockSize});
+    unsigned char* block = m_blocks.back().data.get();
+    address = ((uintptr_t)block + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    // Large objects get a block of their own, the current one stays in use
+    if (blockSize > m_blockSize && m_cursor != nullptr) {
+      m_usedBytes += size;
+      return (void*)address;
+    }
+
+    m_end = block + blockSize;
+  }
+
+  m_cursor = (unsigned char*)(address + size);
+  m_usedBytes += size;
+  return (void*)address;
+}
+
+void Engine::SceneArena::Release(void*) {}
+
+void Engine::SceneArena::Release() {
+  // Nodes go from the top of their hierarchy, which destroys their children
+  for (NodeHandle handle : m_nodes) {
+    Node* node = handle.Get();
+    if (node == nullptr)
+      continue;
+
+    // Nodes attached outside of the arena leave their siblings in order
+    Node* parent = node->GetParent();
+    if (parent == nullptr)
+      Node::Free(node);
+    else if (!Owns(parent))
+      Node::Free(parent->DetachChild(node->m_childIndex, true));
+  }
+
+  for (auto it = m_destructors.rbegin(); it != m_destructors.rend(); it++)
+    it->destruct(it->object);
+
+  m_nodes.clear();
+  m_destructors.clear();
+  m_blocks.clear();
+  m_cursor = nullptr;
+  m_end = nullptr;
+  m_usedBytes = 0;
+}
+
+bool Engine::SceneArena::Owns(const void* pointer) const {
+  for (const Block& block : m_blocks)
+    if (pointer >= block.data.get() && pointer < block.data.get() + block.size)
+      return true;
+
+  return false;
+}
+
+size_t Engine::SceneArena::GetUsedBytes() const {
+  return m_usedBytes;
+}
+
+size_t Engine::SceneArena::GetCapacity() const {
+  size_t capacity = 0;
+  for (const Block& block : m_blocks)
+    capacity += block.size;
+
+  return capacity;
+}
@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_SCENEARENA
+#define ENGINE_SCENEARENA
+
+#include "Node.hpp"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+
+  /**
+   * @brief The default size of the blocks of a scene arena, in bytes
+   */
+  constexpr size_t SCENE_ARENA_BLOCK_SIZE = 256 * 1024;
+
+  /**
+   * @brief A bump allocator that holds everything a scene is made of
+   *
+   * Nodes, meshes and any other data of a scene are placed one after the
+   * other in large blocks, and all of it is released at once when the scene
+   * is unloaded, instead of freeing every node one by one.
+   *
+   * Only the destructors that do something are remembered and run on
+   * release. The nodes still alive are destroyed from the top of their
+   * hierarchy, so every node is destructed once, children included, even if
+   * it is not part of the arena. Nodes attached to a parent outside of the
+   * arena are taken out of its children, keeping the order of the children
+   * left. Nodes of the arena removed earlier are
+   * destructed as usual, their memory is only reused once the arena is
+   * released.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * class Level : public Scene {
+   *   public:
+   *   Level(SceneArena& arena) : Scene("Level") {
+   *     Graphics::Cube* mesh = arena.Create<Graphics::Cube>();
+   *     for (int i = 0; i < 1000; i++)
+   *       AddChild(arena.Create<MeshObject>("Crate", mesh));
+   *   }
+   * };
+   *
+   * auto arena = std::make_unique<SceneArena>();
+   * Level* level = arena->Create<Level>(*arena);
+   * game.AddScene("Level", level, std::move(arena));
+   * ```
+   */
+  class SceneArena : public NodePoolBase {
+    private:
+
+    struct Block {
+      std::unique_ptr<unsigned char[]> data;
+      size_t size;
+    };
+
+    struct Destructor {
+      void (*destruct)(void* object);
+      void* object;
+    };
+
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    unsigned char* m_cursor = nullptr;
+    unsigned char* m_end = nullptr;
+    size_t m_usedBytes = 0;
+
+    std::vector<NodeHandle> m_nodes;
+    std::vector<Destructor> m_destructors;
+
+    public:
+
+    /**
+     * @brief Creates an empty arena
+     *
+     * @param blockSize The size of the blocks the arena allocates, larger
+     * objects get a block of their own
+     */
+    SceneArena(size_t blockSize = SCENE_ARENA_BLOCK_SIZE);
+    SceneArena(const SceneArena&) = delete;
+    SceneArena& operator=(const SceneArena&) = delete;
+
+    /**
+     * @brief Releases the arena
+     */
+    ~SceneArena();
+
+    /**
+     * @brief Returns uninitialized memory that lives as long as the arena
+     *
+     * @param size The size in bytes
+     * @param alignment A power of two
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Constructs an object in the arena
+     *
+     * Nodes are destroyed with their hierarchy on release, other objects are
+     * destructed in the reverse order of their creation.
+     *
+     * @param args The arguments of the constructor of the object
+     */
+    template <typename T, typename... Args>
+    T* Create(Args&&... args) {
+      T* object = new (Allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+
+      if constexpr (std::is_base_of_v<Node, T>) {
+        object->m_pool = this;
+        m_nodes.push_back(object->GetHandle());
+      } else if constexpr (!std::is_trivially_destructible_v<T>) {
+        m_destructors.push_back({[](void* p) { ((T*)p)->~T(); }, object});
+      }
+
+      return object;
+    }
+
+    /**
+     * @brief Does nothing, the memory of nodes is only reused on release
+     */
+    void Release(void* node) override;
+
+    /**
+     * @brief Destroys everything in the arena and frees its memory
+     */
+    void Release();
+
+    /**
+     * @brief Returns true if the memory belongs to the arena
+     */
+    bool Owns(const void* pointer) const;
+
+    /**
+     * @brief Returns the amount of bytes allocated from the arena
+     */
+    size_t GetUsedBytes() const;
+
+    /**
+     * @brief Returns the amount of bytes held by the blocks of the arena
+     */
+    size_t GetCapacity() const;
+  };
+}
+
+#endif
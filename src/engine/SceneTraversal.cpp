@@ -0,0 +1,180 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SceneTraversal.hpp"
+
+std::unordered_map<std::type_index, Engine::SceneTraversal::UpdateFunction>&
+  Engine::SceneTraversal::GetRegisteredUpdates() {
+  static std::unordered_map<std::type_index, UpdateFunction> updates;
+  return updates;
+}
+
+Engine::SceneTraversal::UpdateFunction
+  Engine::SceneTraversal::FindUpdate(std::type_index type) {
+  auto& updates = GetRegisteredUpdates();
+  auto update = updates.find(type);
+  if (update == updates.end())
+    return UpdateVirtual;
+
+  return update->second;
+}
+
+void Engine::SceneTraversal::RegisterUpdate(std::type_index type,
+  UpdateFunction update) {
+  GetRegisteredUpdates()[type] = update;
+}
+
+bool Engine::SceneTraversal::IsVisitable(NodeHandle handle, Node* root) {
+  // A node disabled, destroyed or removed takes its descendants with it
+  for (Node* node = handle.Get(); node != nullptr; node = node->m_parent) {
+    if (!node->m_enabled || node->m_destroyed)
+      return false;
+
+    if (node == root)
+      return true;
+  }
+
+  return false;
+}
+
+void Engine::SceneTraversal::UpdateVirtual(const std::vector<Node*>& nodes,
+  const std::vector<NodeHandle>& handles, Node* root, uint64_t version,
+  float dt) {
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (Node::s_structureVersion != version
+      && !IsVisitable(handles[i], root))
+      continue;
+
+    nodes[i]->Update(dt);
+  }
+}
+
+void Engine::SceneTraversal::SkipUpdate(const std::vector<Node*>& nodes,
+  const std::vector<NodeHandle>& handles, Node* root, uint64_t version,
+  float dt) {}
+
+Engine::SceneTraversal::SceneTraversal(Node* root) {
+  m_root = root;
+}
+
+void Engine::SceneTraversal::SetRoot(Node* root) {
+  m_root = root;
+  m_built = false;
+}
+
+Engine::Node* Engine::SceneTraversal::GetRoot() {
+  return m_root;
+}
+
+void Engine::SceneTraversal::Rebuild() {
+  m_drawOrder.clear();
+  m_drawHandles.clear();
+  m_groupOrder.clear();
+  for (UpdateGroup& group : m_groups) {
+    group.nodes.clear();
+    group.handles.clear();
+  }
+
+  // Depth first, with the children pushed backwards to keep their order
+  std::vector<std::pair<Node*, bool>> stack;
+  if (m_root != nullptr)
+    stack.push_back({m_root, true});
+
+  while (!stack.empty()) {
+    auto [node, drawn] = stack.back();
+    stack.pop_back();
+
+    std::type_index type = typeid(*node);
+    auto index = m_groupIndices.find(type);
+    if (index == m_groupIndices.end()) {
+      index = m_groupIndices.emplace(type, m_groups.size()).first;
+      m_groups.push_back({type, UpdateVirtual, {}, {}});
+    }
+
+    UpdateGroup& group = m_groups[index->second];
+    if (group.nodes.empty()) {
+      group.update = FindUpdate(type);
+      m_groupOrder.push_back(index->second);
+    }
+    group.nodes.push_back(node);
+    group.handles.push_back(node->m_handle);
+
+    if (drawn) {
+      m_drawOrder.push_back(node);
+      m_drawHandles.push_back(node->m_handle);
+    }
+
+    bool childrenDrawn = drawn && !node->m_drawsChildren;
+    for (size_t i = node->m_children.size(); i-- > 0;) {
+      Node* child = node->m_children[i];
+      if (child->m_enabled && !child->m_destroyed)
+        stack.push_back({child, childrenDrawn});
+    }
+  }
+
+  m_version = Node::s_structureVersion;
+  m_built = true;
+  m_rebuildCount++;
+}
+
+void Engine::SceneTraversal::Refresh() {
+  if (!m_built || m_version != Node::s_structureVersion)
+    Rebuild();
+}
+
+void Engine::SceneTraversal::Update(float dt) {
+  Refresh();
+
+  // Types that appear first in the hierarchy are updated first
+  Node::s_flatTraversal = true;
+  for (size_t index : m_groupOrder) {
+    UpdateGroup& group = m_groups[index];
+    group.update(group.nodes, group.handles, m_root, m_version, dt);
+  }
+  Node::s_flatTraversal = false;
+}
+
+void Engine::SceneTraversal::Draw() {
+  Refresh();
+
+  Node::s_flatTraversal = true;
+  for (size_t i = 0; i < m_drawOrder.size(); i++) {
+    Node* node = m_drawOrder[i];
+    if (Node::s_structureVersion != m_version
+      && !IsVisitable(m_drawHandles[i], m_root))
+      continue;
+
+    // Nodes that draw their children recurse as usual
+    if (node->m_drawsChildren) {
+      Node::s_flatTraversal = false;
+      node->Draw();
+      Node::s_flatTraversal = true;
+    } else {
+      node->Draw();
+    }
+  }
+  Node::s_flatTraversal = false;
+}
+
+size_t Engine::SceneTraversal::GetNodeCount() {
+  Refresh();
+
+  size_t count = 0;
+  for (UpdateGroup& group : m_groups)
+    count += group.nodes.size();
+
+  return count;
+}
+
+size_t Engine::SceneTraversal::GetGroupCount() {
+  Refresh();
+
+  return m_groupOrder.size();
+}
+
+size_t Engine::SceneTraversal::GetRebuildCount() {
+  return m_rebuildCount;
+}
@@ -0,0 +1,189 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_SCENETRAVERSAL
+#define ENGINE_SCENETRAVERSAL
+
+#include "Node.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+
+  /**
+   * @brief Updates and draws a scene from flat arrays instead of recursing
+   *
+   * The enabled nodes of the scene are gathered once into arrays, which are
+   * only rebuilt after a change to the shape of the scene (see
+   * `Node::GetStructureVersion`). Nodes are drawn in the order of the
+   * hierarchy, parents first, as `Node::Draw` would. Updates are grouped by
+   * the concrete type of the nodes, in the order of the hierarchy within
+   * each type, so each group runs as a tight loop over nodes of one type.
+   *
+   * Types registered with `RegisterType` are updated without virtual calls,
+   * and types that do not override `Update` are skipped altogether. Other
+   * types still get a virtual call per node.
+   *
+   * While the traversal runs, `Node::Update` and `Node::Draw` do not recurse,
+   * so overrides that call them keep working. Nodes that draw their children
+   * themselves call `SetDrawsChildren`, and their children are left to them.
+   *
+   * Nodes removed, disabled or destroyed during the frame are skipped for
+   * the rest of it, along with their descendants, and nodes added during the
+   * frame are visited from the next one.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::SceneTraversal::RegisterType<Bullet>();
+   *
+   * Engine::SceneTraversal traversal(&level);
+   * traversal.Update(dt);
+   * traversal.Draw();
+   * ```
+   */
+  class SceneTraversal {
+    private:
+
+    typedef void (*UpdateFunction)(const std::vector<Node*>& nodes,
+      const std::vector<NodeHandle>& handles, Node* root, uint64_t version,
+      float dt);
+
+    struct UpdateGroup {
+      std::type_index type;
+      UpdateFunction update;
+      std::vector<Node*> nodes;
+      std::vector<NodeHandle> handles;
+    };
+
+    Node* m_root = nullptr;
+    uint64_t m_version = 0;
+    bool m_built = false;
+    size_t m_rebuildCount = 0;
+
+    std::vector<Node*> m_drawOrder;
+    std::vector<NodeHandle> m_drawHandles;
+
+    // The groups are kept between rebuilds, the order is the one of the
+    // first node of each type in the hierarchy
+    std::vector<UpdateGroup> m_groups;
+    std::vector<size_t> m_groupOrder;
+    std::unordered_map<std::type_index, size_t> m_groupIndices;
+
+    static std::unordered_map<std::type_index, UpdateFunction>&
+      GetRegisteredUpdates();
+
+    /**
+     * @brief Returns the update loop registered for a type, or the virtual
+     * one if it has none
+     */
+    static UpdateFunction FindUpdate(std::type_index type);
+
+    static void RegisterUpdate(std::type_index type, UpdateFunction update);
+
+    /**
+     * @brief Returns true if a node can still be visited in this frame
+     *
+     * The node must still be under the root, with every node up to it
+     * enabled and not destroyed.
+     */
+    static bool IsVisitable(NodeHandle handle, Node* root);
+
+    static void UpdateVirtual(const std::vector<Node*>& nodes,
+      const std::vector<NodeHandle>& handles, Node* root, uint64_t version,
+      float dt);
+
+    template <typename T>
+    static void UpdateAs(const std::vector<Node*>& nodes,
+      const std::vector<NodeHandle>& handles, Node* root, uint64_t version,
+      float dt) {
+      for (size_t i = 0; i < nodes.size(); i++) {
+        if (Node::s_structureVersion != version
+          && !IsVisitable(handles[i], root))
+          continue;
+
+        static_cast<T*>(nodes[i])->T::Update(dt);
+      }
+    }
+
+    static void SkipUpdate(const std::vector<Node*>& nodes,
+      const std::vector<NodeHandle>& handles, Node* root, uint64_t version,
+      float dt);
+
+    void Rebuild();
+
+    /**
+     * @brief Rebuilds the arrays if the shape of any scene changed
+     */
+    void Refresh();
+
+    public:
+
+    /**
+     * @brief Creates a traversal of a scene
+     *
+     * @param root The scene to traverse *(optional)*
+     */
+    SceneTraversal(Node* root = nullptr);
+
+    /**
+     * @brief Changes the scene to traverse
+     */
+    void SetRoot(Node* root);
+
+    /**
+     * @brief Returns the scene traversed
+     */
+    Node* GetRoot();
+
+    /**
+     * @brief Updates every enabled node of the scene
+     */
+    void Update(float dt);
+
+    /**
+     * @brief Draws every enabled node of the scene
+     */
+    void Draw();
+
+    /**
+     * @brief Returns the amount of nodes updated each frame
+     */
+    size_t GetNodeCount();
+
+    /**
+     * @brief Returns the amount of node types in the scene
+     */
+    size_t GetGroupCount();
+
+    /**
+     * @brief Returns the amount of times the arrays were rebuilt
+     */
+    size_t GetRebuildCount();
+
+    /**
+     * @brief Updates the nodes of a type without virtual calls
+     *
+     * Register the types that are most common in your scenes. The type
+     * must be the exact type of the nodes, not one they derive from.
+     */
+    template <typename T>
+    static void RegisterType() {
+      static_assert(std::is_base_of_v<Node, T>, "Only nodes can be traversed");
+
+      if constexpr (std::is_same_v<decltype(&T::Update),
+        decltype(&Node::Update)>)
+        RegisterUpdate(typeid(T), SkipUpdate);
+      else
+        RegisterUpdate(typeid(T), UpdateAs<T>);
+    }
+  };
+}
+
+#endif
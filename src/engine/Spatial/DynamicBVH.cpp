@@ -0,0 +1,382 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "DynamicBVH.hpp"
+#include <algorithm>
+#include <queue>
+
+// How far ahead a moving box is stretched, in frames of displacement
+#define DISPLACEMENT_MULTIPLIER 4.0f
+
+Engine::Spatial::DynamicBVH::DynamicBVH(float margin) : m_margin(margin) {}
+
+int32_t Engine::Spatial::DynamicBVH::AllocateNode() {
+  if (m_freeList == NULL_NODE) {
+    m_nodes.push_back({});
+    m_freeList = m_nodes.size() - 1;
+    m_nodes[m_freeList].parent = NULL_NODE;
+  }
+
+  int32_t node = m_freeList;
+  m_freeList = m_nodes[node].parent;
+  m_nodes[node].parent = NULL_NODE;
+  m_nodes[node].child1 = NULL_NODE;
+  m_nodes[node].child2 = NULL_NODE;
+  m_nodes[node].height = 0;
+  m_nodes[node].userData = 0;
+  return node;
+}
+
+void Engine::Spatial::DynamicBVH::FreeNode(int32_t node) {
+  m_nodes[node].parent = m_freeList;
+  m_nodes[node].height = -1;
+  m_freeList = node;
+}
+
+void Engine::Spatial::DynamicBVH::InsertLeaf(int32_t leaf) {
+  if (m_root == NULL_NODE) {
+    m_root = leaf;
+    m_nodes[leaf].parent = NULL_NODE;
+    return;
+  }
+
+  // Walk down to the sibling that adds the least surface area
+  BoundingBox leafBox = m_nodes[leaf].box;
+  int32_t index = m_root;
+  while (!m_nodes[index].IsLeaf()) {
+    const TreeNode& node = m_nodes[index];
+    float area = node.box.SurfaceArea();
+    float combinedArea = node.box.Union(leafBox).SurfaceArea();
+
+    // Pairing with this node makes a new parent with the combined box
+    float cost = 2.0f * combinedArea;
+
+    // Going further down grows this node and every node above it
+    float inheritanceCost = 2.0f * (combinedArea - area);
+
+    float childCosts[2];
+    int32_t children[2] = {node.child1, node.child2};
+    for (int i = 0; i < 2; i++) {
+      const TreeNode& child = m_nodes[children[i]];
+      float grownArea = child.box.Union(leafBox).SurfaceArea();
+      childCosts[i] = (child.IsLeaf() ? grownArea
+        : grownArea - child.box.SurfaceArea()) + inheritanceCost;
+    }
+
+    if (cost < childCosts[0] && cost < childCosts[1])
+      break;
+
+    index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+  }
+
+  int32_t sibling = index;
+  int32_t oldParent = m_nodes[sibling].parent;
+  int32_t newParent = AllocateNode();
+  m_nodes[newParent].parent = oldParent;
+  m_nodes[newParent].box = leafBox.Union(m_nodes[sibling].box);
+  m_nodes[newParent].height = m_nodes[sibling].height + 1;
+  m_nodes[newParent].child1 = sibling;
+  m_nodes[newParent].child2 = leaf;
+  m_nodes[sibling].parent = newParent;
+  m_nodes[leaf].parent = newParent;
+
+  if (oldParent == NULL_NODE)
+    m_root = newParent;
+  else if (m_nodes[oldParent].child1 == sibling)
+    m_nodes[oldParent].child1 = newParent;
+  else
+    m_nodes[oldParent].child2 = newParent;
+
+  // Refit and rebalance the ancestors
+  for (index = m_nodes[leaf].parent; index != NULL_NODE;
+    index = m_nodes[index].parent) {
+    index = Balance(index);
+    TreeNode& node = m_nodes[index];
+    node.height = 1 + std::max(m_nodes[node.child1].height,
+      m_nodes[node.child2].height);
+    node.box = m_nodes[node.child1].box.Union(m_nodes[node.child2].box);
+  }
+}
+
+void Engine::Spatial::DynamicBVH::RemoveLeaf(int32_t leaf) {
+  if (leaf == m_root) {
+    m_root = NULL_NODE;
+    return;
+  }
+
+  int32_t parent = m_nodes[leaf].parent;
+  int32_t grandParent = m_nodes[parent].parent;
+  int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2
+    : m_nodes[parent].child1;
+
+  // The sibling takes the place of the parent
+  FreeNode(parent);
+  m_nodes[sibling].parent = grandParent;
+  if (grandParent == NULL_NODE) {
+    m_root = sibling;
+    return;
+  }
+
+  if (m_nodes[grandParent].child1 == parent)
+    m_nodes[grandParent].child1 = sibling;
+  else
+    m_nodes[grandParent].child2 = sibling;
+
+  for (int32_t index = grandParent; index != NULL_NODE;
+    index = m_nodes[index].parent) {
+    index = Balance(index);
+    TreeNode& node = m_nodes[index];
+    node.height = 1 + std::max(m_nodes[node.child1].height,
+      m_nodes[node.child2].height);
+    node.box = m_nodes[node.child1].box.Union(m_nodes[node.child2].box);
+  }
+}
+
+int32_t Engine::Spatial::DynamicBVH::Balance(int32_t a) {
+  if (m_nodes[a].IsLeaf() || m_nodes[a].height < 2)
+    return a;
+
+  int32_t b = m_nodes[a].child1;
+  int32_t c = m_nodes[a].child2;
+  int32_t balance = m_nodes[c].height - m_nodes[b].height;
+  if (balance >= -1 && balance <= 1)
+    return a;
+
+  // The deeper child (up) replaces a, which takes its shallower grandchild
+  bool rotateC = balance > 1;
+  int32_t up = rotateC ? c : b;
+  int32_t other = rotateC ? b : c;
+  int32_t f = m_nodes[up].child1;
+  int32_t g = m_nodes[up].child2;
+
+  m_nodes[up].child1 = a;
+  m_nodes[up].parent = m_nodes[a].parent;
+  m_nodes[a].parent = up;
+
+  int32_t upParent = m_nodes[up].parent;
+  if (upParent == NULL_NODE)
+    m_root = up;
+  else if (m_nodes[upParent].child1 == a)
+    m_nodes[upParent].child1 = up;
+  else
+    m_nodes[upParent].child2 = up;
+
+  // The taller grandchild stays under up
+  int32_t kept = m_nodes[f].height > m_nodes[g].height ? f : g;
+  int32_t moved = kept == f ? g : f;
+  m_nodes[up].child2 = kept;
+  if (rotateC)
+    m_nodes[a].child2 = moved;
+  else
+    m_nodes[a].child1 = moved;
+  m_nodes[moved].parent = a;
+
+  m_nodes[a].box = m_nodes[other].box.Union(m_nodes[moved].box);
+  m_nodes[a].height = 1 + std::max(m_nodes[other].height,
+    m_nodes[moved].height);
+  m_nodes[up].box = m_nodes[a].box.Union(m_nodes[kept].box);
+  m_nodes[up].height = 1 + std::max(m_nodes[a].height,
+    m_nodes[kept].height);
+  return up;
+}
+
+int32_t Engine::Spatial::DynamicBVH::CreateProxy(const BoundingBox& box,
+  uint32_t userData) {
+  int32_t proxy = AllocateNode();
+  m_nodes[proxy].box = box.Fattened(m_margin);
+  m_nodes[proxy].userData = userData;
+  InsertLeaf(proxy);
+  m_proxyCount++;
+  return proxy;
+}
+
+void Engine::Spatial::DynamicBVH::DestroyProxy(int32_t proxy) {
+  RemoveLeaf(proxy);
+  FreeNode(proxy);
+  m_proxyCount--;
+}
+
+bool Engine::Spatial::DynamicBVH::MoveProxy(int32_t proxy,
+  const BoundingBox& box, Vec3f displacement) {
+  BoundingBox fatBox = box.Fattened(m_margin);
+
+  // Stretched where the box is heading
+  Vec3f d = displacement * DISPLACEMENT_MULTIPLIER;
+  fatBox.min = fatBox.min + Vec3f{fminf(d.x, 0.0f), fminf(d.y, 0.0f),
+    fminf(d.z, 0.0f)};
+  fatBox.max = fatBox.max + Vec3f{fmaxf(d.x, 0.0f), fmaxf(d.y, 0.0f),
+    fmaxf(d.z, 0.0f)};
+
+  const BoundingBox& treeBox = m_nodes[proxy].box;
+  if (treeBox.Contains(box)) {
+    // Still inside, unless the stored box is much too large
+    if (fatBox.Fattened(4.0f * m_margin).Contains(treeBox))
+      return false;
+  }
+
+  RemoveLeaf(proxy);
+  m_nodes[proxy].box = fatBox;
+  InsertLeaf(proxy);
+  return true;
+}
+
+uint32_t Engine::Spatial::DynamicBVH::GetUserData(int32_t proxy) {
+  return m_nodes[proxy].userData;
+}
+
+void Engine::Spatial::DynamicBVH::SetUserData(int32_t proxy,
+  uint32_t userData) {
+  m_nodes[proxy].userData = userData;
+}
+
+const Engine::BoundingBox& Engine::Spatial::DynamicBVH::GetFatBox(
+  int32_t proxy) {
+  return m_nodes[proxy].box;
+}
+
+void Engine::Spatial::DynamicBVH::Query(const BoundingBox& box,
+  const QueryCallback& callback) {
+  if (m_root == NULL_NODE)
+    return;
+
+  m_stack.clear();
+  m_stack.push_back(m_root);
+  while (!m_stack.empty()) {
+    int32_t index = m_stack.back();
+    m_stack.pop_back();
+
+    const TreeNode& node = m_nodes[index];
+    if (!node.box.Overlaps(box))
+      continue;
+
+    if (node.IsLeaf()) {
+      if (!callback(index))
+        return;
+    } else {
+      m_stack.push_back(node.child1);
+      m_stack.push_back(node.child2);
+    }
+  }
+}
+
+void Engine::Spatial::DynamicBVH::Query(const Graphics::Frustum& frustum,
+  const QueryCallback& callback) {
+  if (m_root == NULL_NODE)
+    return;
+
+  m_stack.clear();
+  m_stack.push_back(m_root);
+  while (!m_stack.empty()) {
+    int32_t index = m_stack.back();
+    m_stack.pop_back();
+
+    const TreeNode& node = m_nodes[index];
+    if (!frustum.IsVisible(node.box))
+      continue;
+
+    if (node.IsLeaf()) {
+      if (!callback(index))
+        return;
+    } else {
+      m_stack.push_back(node.child1);
+      m_stack.push_back(node.child2);
+    }
+  }
+}
+
+void Engine::Spatial::DynamicBVH::RayCast(Vec3f origin, Vec3f direction,
+  float maxDistance, const RayCastCallback& callback) {
+  float length = direction.length();
+  if (m_root == NULL_NODE || length == 0.0f)
+    return;
+
+  direction = direction / length;
+  Vec3f inverse = {1.0f / direction.x, 1.0f / direction.y,
+    1.0f / direction.z};
+
+  m_stack.clear();
+  m_stack.push_back(m_root);
+  while (!m_stack.empty()) {
+    int32_t index = m_stack.back();
+    m_stack.pop_back();
+
+    const TreeNode& node = m_nodes[index];
+    if (node.box.RayDistance(origin, inverse, maxDistance) == INFINITY)
+      continue;
+
+    if (node.IsLeaf()) {
+      float distance = callback(index, maxDistance);
+      if (distance == 0.0f)
+        return;
+
+      maxDistance = fminf(maxDistance, distance);
+      continue;
+    }
+
+    // The nearer child is popped first
+    float enter1 = m_nodes[node.child1].box.RayDistance(origin, inverse,
+      maxDistance);
+    float enter2 = m_nodes[node.child2].box.RayDistance(origin, inverse,
+      maxDistance);
+    int32_t child1 = node.child1, child2 = node.child2;
+    if (enter1 > enter2) {
+      std::swap(child1, child2);
+      std::swap(enter1, enter2);
+    }
+
+    if (enter2 != INFINITY)
+      m_stack.push_back(child2);
+    if (enter1 != INFINITY)
+      m_stack.push_back(child1);
+  }
+}
+
+int32_t Engine::Spatial::DynamicBVH::FindNearest(Vec3f point,
+  const DistanceCallback& callback, float maxDistance) {
+  if (m_root == NULL_NODE)
+    return NULL_NODE;
+
+  // Nodes ordered by the squared distance to their box, closest first
+  typedef std::pair<float, int32_t> Candidate;
+  std::priority_queue<Candidate, std::vector<Candidate>,
+    std::greater<Candidate>> candidates;
+  candidates.push({m_nodes[m_root].box.DistanceSquared(point), m_root});
+
+  float best = maxDistance * maxDistance;
+  int32_t nearest = NULL_NODE;
+  while (!candidates.empty()) {
+    Candidate candidate = candidates.top();
+    candidates.pop();
+    if (candidate.first >= best)
+      break;
+
+    const TreeNode& node = m_nodes[candidate.second];
+    if (node.IsLeaf()) {
+      float distance = callback(candidate.second);
+      if (distance < best) {
+        best = distance;
+        nearest = candidate.second;
+      }
+      continue;
+    }
+
+    for (int32_t child : {node.child1, node.child2}) {
+      float distance = m_nodes[child].box.DistanceSquared(point);
+      if (distance < best)
+        candidates.push({distance, child});
+    }
+  }
+
+  return nearest;
+}
+
+int32_t Engine::Spatial::DynamicBVH::GetHeight() {
+  return m_root == NULL_NODE ? 0 : m_nodes[m_root].height;
+}
+
+size_t Engine::Spatial::DynamicBVH::GetProxyCount() {
+  return m_proxyCount;
+}
@@ -0,0 +1,207 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_DYNAMICBVH
+#define ENGINE_DYNAMICBVH
+
+#include "../Utils.hpp"
+#include "../Graphics/Frustum.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Engine::Spatial {
+
+  /**
+   * @brief The index given to no node of the tree
+   */
+  constexpr int32_t NULL_NODE = -1;
+
+  /**
+   * @brief A bounding volume hierarchy of boxes that can move
+   *
+   * Every box (a proxy) is a leaf of a binary tree, and every other node
+   * holds the box around its two children. Queries skip the branches whose
+   * box misses, so they take logarithmic time instead of scanning every box.
+   *
+   * Leaves are stored with fattened boxes. A proxy that moves only changes
+   * the tree when it leaves its fat box, and its new box is stretched in the
+   * direction it moved. New leaves go where they grow the surface area of the
+   * tree the least, and the branches are rebalanced with rotations on the
+   * way back up, so the tree stays shallow even when boxes are added in
+   * order.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::Spatial::DynamicBVH tree;
+   * int32_t proxy = tree.CreateProxy({{0, 0, 0}, {1, 1, 1}}, 7);
+   * tree.MoveProxy(proxy, {{5, 0, 0}, {6, 1, 1}}, {5, 0, 0});
+   * tree.Query({{4, 0, 0}, {8, 2, 2}}, [&](int32_t hit) {
+   *   std::cout << tree.GetUserData(hit) << std::endl;
+   *   return true;
+   * });
+   * ```
+   */
+  class DynamicBVH {
+    public:
+
+    /**
+     * @brief Called for each proxy found, returns false to stop the query
+     */
+    typedef std::function<bool(int32_t proxy)> QueryCallback;
+
+    /**
+     * @brief Called for each proxy whose fat box the ray crosses
+     *
+     * Returns the distance of the hit to shorten the ray, the distance given
+     * to ignore the proxy, or 0 to stop.
+     */
+    typedef std::function<float(int32_t proxy, float maxDistance)>
+      RayCastCallback;
+
+    /**
+     * @brief Returns the squared distance from the query point to a proxy
+     */
+    typedef std::function<float(int32_t proxy)> DistanceCallback;
+
+    private:
+    struct TreeNode {
+      BoundingBox box;
+      uint32_t userData;
+
+      // The next free node once the node is freed
+      int32_t parent;
+      int32_t child1;
+      int32_t child2;
+
+      // 0 for leaves, -1 for free nodes
+      int32_t height;
+
+      bool IsLeaf() const {
+        return child1 == NULL_NODE;
+      }
+    };
+
+    std::vector<TreeNode> m_nodes;
+    int32_t m_root = NULL_NODE;
+    int32_t m_freeList = NULL_NODE;
+    size_t m_proxyCount = 0;
+    float m_margin;
+
+    // Nodes left to visit by a query
+    std::vector<int32_t> m_stack;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+
+    /**
+     * @brief Places a leaf next to the sibling that grows the tree the least
+     */
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+
+    /**
+     * @brief Rotates the node if one branch is 2 levels deeper than the other
+     *
+     * @return The node that replaced it
+     */
+    int32_t Balance(int32_t node);
+
+    public:
+
+    /**
+     * @brief Creates an empty tree
+     *
+     * @param margin how far the boxes are fattened in every direction
+     */
+    DynamicBVH(float margin = 0.1f);
+
+    /**
+     * @brief Adds a box to the tree
+     *
+     * @param box the box to track
+     * @param userData a value returned with `GetUserData`
+     * @return The proxy of the box, which is also its leaf
+     */
+    int32_t CreateProxy(const BoundingBox& box, uint32_t userData);
+
+    /**
+     * @brief Removes a box from the tree
+     */
+    void DestroyProxy(int32_t proxy);
+
+    /**
+     * @brief Moves a box
+     *
+     * @param proxy the box to move
+     * @param box the new box
+     * @param displacement how far the box moved, to predict the next move
+     * @return true if the leaf was reinserted
+     */
+    bool MoveProxy(int32_t proxy, const BoundingBox& box,
+      Vec3f displacement = {0.0f, 0.0f, 0.0f});
+
+    uint32_t GetUserData(int32_t proxy);
+    void SetUserData(int32_t proxy, uint32_t userData);
+
+    /**
+     * @brief Returns the fattened box stored for a proxy
+     */
+    const BoundingBox& GetFatBox(int32_t proxy);
+
+    /**
+     * @brief Finds the proxies whose fat box overlaps a box
+     */
+    void Query(const BoundingBox& box, const QueryCallback& callback);
+
+    /**
+     * @brief Finds the proxies whose fat box may be visible in a frustum
+     */
+    void Query(const Graphics::Frustum& frustum,
+      const QueryCallback& callback);
+
+    /**
+     * @brief Finds the proxies crossed by a ray
+     *
+     * Each hit shortens the ray, so the branches past the closest hit so far
+     * are skipped. The nearer child of each node is visited first.
+     *
+     * @param origin where the ray starts
+     * @param direction the direction of the ray, of any length
+     * @param maxDistance the length of the ray
+     * @param callback tests a proxy and returns the distance of its hit
+     */
+    void RayCast(Vec3f origin, Vec3f direction, float maxDistance,
+      const RayCastCallback& callback);
+
+    /**
+     * @brief Finds the proxy closest to a point
+     *
+     * The branches are visited from the closest box, and skipped once they
+     * are further than the best proxy found.
+     *
+     * @param point the point to search around
+     * @param callback returns the squared distance from the point to a proxy
+     * @param maxDistance the distance past which nothing is returned
+     * @return The closest proxy, or `NULL_NODE`
+     */
+    int32_t FindNearest(Vec3f point, const DistanceCallback& callback,
+      float maxDistance = INFINITY);
+
+    /**
+     * @brief Returns the height of the tree, 0 when it holds a single leaf
+     */
+    int32_t GetHeight();
+
+    /**
+     * @brief Returns the amount of boxes in the tree
+     */
+    size_t GetProxyCount();
+  };
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SceneIndex.hpp"
+#include "../GameObject.hpp"
+
+Engine::BoundingBox Engine::Spatial::SceneIndex::WorldBounds(
+  GameObject* object) {
+  return object->GetLocalBounds().Transformed(object->GetWorldMatrix());
+}
+
+bool Engine::Spatial::SceneIndex::Accepts(GameObject* object, Node* scene) {
+  Node* root = object;
+  for (Node* node = object; node != nullptr; node = node->GetParent()) {
+    if (!node->IsEnabled() || node->IsDestroyed())
+      return false;
+    root = node;
+  }
+
+  return scene == nullptr || root == scene;
+}
+
+void Engine::Spatial::SceneIndex::RefitEntry(Entry& entry) {
+  entry.version = GetTransformPool().GetVersion(
+    entry.object->GetTransformHandle());
+  BoundingBox bounds = WorldBounds(entry.object);
+
+  // An object whose bounds were cleared keeps its last box
+  if (bounds.IsEmpty())
+    return;
+
+  m_tree.MoveProxy(entry.proxy, bounds,
+    bounds.Center() - entry.bounds.Center());
+  entry.bounds = bounds;
+}
+
+void Engine::Spatial::SceneIndex::Track(GameObject* object) {
+  if (IsTracked(object))
+    return;
+
+  // Objects without bounds are checked again by every update
+  if (object->GetLocalBounds().IsEmpty()) {
+    m_pending.insert(object);
+    return;
+  }
+
+  m_pending.erase(object);
+  BoundingBox bounds = WorldBounds(object);
+  uint32_t index = m_entries.size();
+  m_entries.push_back({object, m_tree.CreateProxy(bounds, index), bounds,
+    GetTransformPool().GetVersion(object->GetTransformHandle())});
+  m_lookup[object] = index;
+}
+
+void Engine::Spatial::SceneIndex::Untrack(GameObject* object) {
+  m_pending.erase(object);
+
+  auto found = m_lookup.find(object);
+  if (found == m_lookup.end())
+    return;
+
+  uint32_t index = found->second;
+  m_tree.DestroyProxy(m_entries[index].proxy);
+  m_lookup.erase(found);
+
+  // The last entry takes the place of the removed one
+  if (index != m_entries.size() - 1) {
+    m_entries[index] = m_entries.back();
+    m_tree.SetUserData(m_entries[index].proxy, index);
+    m_lookup[m_entries[index].object] = index;
+  }
+  m_entries.pop_back();
+}
+
+bool Engine::Spatial::SceneIndex::IsTracked(GameObject* object) {
+  return m_lookup.find(object) != m_lookup.end();
+}
+
+void Engine::Spatial::SceneIndex::Update() {
+  TransformPool& pool = GetTransformPool();
+  pool.Update();
+
+  for (auto pending = m_pending.begin(); pending != m_pending.end();) {
+    GameObject* object = *pending;
+    if (object->GetLocalBounds().IsEmpty()) {
+      ++pending;
+      continue;
+    }
+
+    pending = m_pending.erase(pending);
+    Track(object);
+  }
+
+  // Only the objects whose world matrix was recomputed can have moved
+  for (Entry& entry : m_entries)
+    if (pool.GetVersion(entry.object->GetTransformHandle()) != entry.version)
+      RefitEntry(entry);
+}
+
+void Engine::Spatial::SceneIndex::Refit(GameObject* object) {
+  auto found = m_lookup.find(object);
+  if (found != m_lookup.end())
+    RefitEntry(m_entries[found->second]);
+}
+
+void Engine::Spatial::SceneIndex::QueryBox(const BoundingBox& box,
+  std::vector<GameObject*>& out, Node* scene) {
+  m_tree.Query(box, [&](int32_t proxy) {
+    const Entry& entry = m_entries[m_tree.GetUserData(proxy)];
+    if (entry.bounds.Overlaps(box) && Accepts(entry.object, scene))
+      out.push_back(entry.object);
+    return true;
+  });
+}
+
+void Engine::Spatial::SceneIndex::QueryFrustum(
+  const Graphics::Frustum& frustum, std::vector<GameObject*>& out,
+  Node* scene) {
+  m_tree.Query(frustum, [&](int32_t proxy) {
+    const Entry& entry = m_entries[m_tree.GetUserData(proxy)];
+    if (frustum.IsVisible(entry.bounds) && Accepts(entry.object, scene))
+      out.push_back(entry.object);
+    return true;
+  });
+}
+
+Engine::Spatial::SceneIndex::RayHit Engine::Spatial::SceneIndex::RayCast(
+  Vec3f origin, Vec3f direction, float maxDistance, Node* scene) {
+  RayHit hit;
+  float length = direction.length();
+  if (length == 0.0f)
+    return hit;
+
+  Vec3f inverse = {length / direction.x, length / direction.y,
+    length / direction.z};
+  m_tree.RayCast(origin, direction, maxDistance,
+    [&](int32_t proxy, float distance) {
+    const Entry& entry = m_entries[m_tree.GetUserData(proxy)];
+    float enter = entry.bounds.RayDistance(origin, inverse, distance);
+    if (enter == INFINITY || !Accepts(entry.object, scene))
+      return distance;
+
+    hit = {entry.object, enter};
+
+    // A ray starting inside a box cannot get any closer hit
+    return enter;
+  });
+  return hit;
+}
+
+Engine::GameObject* Engine::Spatial::SceneIndex::FindNearest(Vec3f point,
+  float maxDistance, Node* scene) {
+  int32_t proxy = m_tree.FindNearest(point, [&](int32_t proxy) {
+    const Entry& entry = m_entries[m_tree.GetUserData(proxy)];
+    return Accepts(entry.object, scene) ? entry.bounds.DistanceSquared(point)
+      : INFINITY;
+  }, maxDistance);
+  return proxy == NULL_NODE ? nullptr
+    : m_entries[m_tree.GetUserData(proxy)].object;
+}
+
+size_t Engine::Spatial::SceneIndex::GetObjectCount() {
+  return m_entries.size();
+}
+
+Engine::Spatial::DynamicBVH& Engine::Spatial::SceneIndex::GetTree() {
+  return m_tree;
+}
+
+Engine::Spatial::SceneIndex& Engine::Spatial::GetSceneIndex() {
+  static SceneIndex index;
+  return index;
+}
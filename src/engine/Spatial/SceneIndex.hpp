@@ -0,0 +1,194 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_SCENEINDEX
+#define ENGINE_SCENEINDEX
+
+#include "DynamicBVH.hpp"
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Engine {
+  class GameObject;
+  class Node;
+}
+
+namespace Engine::Spatial {
+
+  /**
+   * @brief Finds the game objects in a region of the world
+   *
+   * Every game object with bounds (see `GameObject::GetLocalBounds`) is
+   * tracked once it is added to a parent, and untracked when it is destroyed.
+   * Objects added before they have bounds are tracked by the first update
+   * after their bounds stop being empty. The world box of each object is kept
+   * in a `DynamicBVH`, so queries skip whole regions instead of scanning
+   * every node of the scene.
+   *
+   * `Update` refits the boxes of the objects whose transform changed, as
+   * told by `TransformPool::GetVersion`. The game calls it once per frame
+   * after the transform pool, and before the scene is drawn. Objects whose
+   * bounds change without moving must be refit with `Refit`.
+   *
+   * There is one index for the whole game. Queries skip the objects that are
+   * disabled or destroyed, or under a node that is, and can be limited to the
+   * objects of one scene.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * std::vector<GameObject*> nearby;
+   * GetSceneIndex().QueryBox({{-5, -5, -5}, {5, 5, 5}}, nearby);
+   * RayHit hit = GetSceneIndex().RayCast(camera.GetGlobalPosition(), {0, 0, 1}, 100);
+   * if (hit.object != nullptr)
+   *   hit.object->SetEnabled(false);
+   * ```
+   */
+  class SceneIndex {
+    private:
+    struct Entry {
+      GameObject* object;
+      int32_t proxy;
+
+      // The world box and transform version of the object at the last
+      // refit
+      BoundingBox bounds;
+      uint32_t version;
+    };
+
+    DynamicBVH m_tree;
+
+    // The data of each proxy is the index of its entry
+    std::vector<Entry> m_entries;
+    std::unordered_map<GameObject*, uint32_t> m_lookup;
+
+    // Objects added to a parent while their bounds were empty
+    std::unordered_set<GameObject*> m_pending;
+
+    /**
+     * @brief Returns the world box of an object
+     */
+    static BoundingBox WorldBounds(GameObject* object);
+
+    /**
+     * @brief Returns true if a query in a scene should find an object
+     *
+     * @param scene the root the object must be under, or null for any
+     */
+    static bool Accepts(GameObject* object, Node* scene);
+
+    /**
+     * @brief Moves the box of an entry to the world box of its object
+     */
+    void RefitEntry(Entry& entry);
+
+    public:
+
+    /**
+     * @brief The closest object crossed by a ray
+     */
+    struct RayHit {
+      /**
+       * @brief The object hit, or null if the ray hit nothing
+       */
+      GameObject* object = nullptr;
+
+      /**
+       * @brief How far along the ray the box of the object starts
+       */
+      float distance = INFINITY;
+    };
+
+    /**
+     * @brief Adds an object to the index
+     *
+     * Objects with empty bounds wait until `Update` finds them a box.
+     */
+    void Track(GameObject* object);
+
+    /**
+     * @brief Removes an object from the index
+     */
+    void Untrack(GameObject* object);
+
+    /**
+     * @brief Returns true if the object is in the index
+     */
+    bool IsTracked(GameObject* object);
+
+    /**
+     * @brief Refits the boxes of the objects that moved since the last
+     * update, and tracks the waiting objects that got bounds
+     *
+     * Objects that stay inside their fattened box do not change the tree.
+     */
+    void Update();
+
+    /**
+     * @brief Refits the box of an object whose bounds changed
+     */
+    void Refit(GameObject* object);
+
+    /**
+     * @brief Finds the objects whose box overlaps a box
+     *
+     * @param box the box in world space
+     * @param out the vector the objects are added to
+     * @param scene the scene to search, or null for every scene
+     */
+    void QueryBox(const BoundingBox& box, std::vector<GameObject*>& out,
+      Node* scene = nullptr);
+
+    /**
+     * @brief Finds the objects whose box may be visible in a frustum
+     *
+     * @param frustum the frustum in world space
+     * @param out the vector the objects are added to
+     * @param scene the scene to search, or null for every scene
+     */
+    void QueryFrustum(const Graphics::Frustum& frustum,
+      std::vector<GameObject*>& out, Node* scene = nullptr);
+
+    /**
+     * @brief Finds the closest object whose box is crossed by a ray
+     *
+     * @param origin where the ray starts
+     * @param direction the direction of the ray, of any length
+     * @param maxDistance the length of the ray
+     * @param scene the scene to search, or null for every scene
+     */
+    RayHit RayCast(Vec3f origin, Vec3f direction, float maxDistance,
+      Node* scene = nullptr);
+
+    /**
+     * @brief Finds the object whose box is closest to a point
+     *
+     * @param point the point to search around
+     * @param maxDistance the distance past which nothing is returned
+     * @param scene the scene to search, or null for every scene
+     * @return The closest object, or null
+     */
+    GameObject* FindNearest(Vec3f point, float maxDistance = INFINITY,
+      Node* scene = nullptr);
+
+    /**
+     * @brief Returns the amount of objects in the index
+     */
+    size_t GetObjectCount();
+
+    /**
+     * @brief Returns the tree of the index
+     */
+    DynamicBVH& GetTree();
+  };
+
+  /**
+   * @brief Returns the index of every game object of the game
+   */
+  SceneIndex& GetSceneIndex();
+}
+
+#endif
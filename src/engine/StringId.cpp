@@ -0,0 +1,69 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "StringId.hpp"
+#include "FlatHashMap.hpp"
+#include <deque>
+#include <iostream>
+
+#ifdef ENGINE_THREADING
+#include <mutex>
+#endif
+
+namespace {
+  struct InternTable {
+    // A deque never moves its strings, so `c_str` stays valid
+    std::deque<std::string> strings;
+    Engine::FlatHashMap<Engine::StringId, const char*> lookup;
+
+    #ifdef ENGINE_THREADING
+    std::mutex mutex;
+    #endif
+  };
+
+  InternTable& GetInternTable() {
+    static InternTable table;
+    return table;
+  }
+}
+
+Engine::StringId Engine::StringId::Intern(std::string_view string) {
+  StringId id(string);
+  InternTable& table = GetInternTable();
+
+  #ifdef ENGINE_THREADING
+  std::lock_guard<std::mutex> lock(table.mutex);
+  #endif
+
+  auto [entry, inserted] = table.lookup.Emplace(id);
+  if (inserted) {
+    entry->second = table.strings.emplace_back(string).c_str();
+  } else if (string != entry->second) {
+    std::cerr << "ERROR: \"" << string << "\" has the same id as \""
+      << entry->second << "\"" << std::endl;
+  }
+
+  return id;
+}
+
+const char* Engine::StringId::c_str() const {
+  InternTable& table = GetInternTable();
+
+  #ifdef ENGINE_THREADING
+  std::lock_guard<std::mutex> lock(table.mutex);
+  #endif
+
+  const char* const* string = table.lookup.Find(*this);
+  return string != nullptr ? *string : "";
+}
+
+std::ostream& Engine::operator<<(std::ostream& stream, StringId id) {
+  const char* string = id.c_str();
+  if (*string == '\0' && id != StringId())
+    return stream << "#" << std::hex << id.GetHash() << std::dec;
+
+  return stream << string;
+}
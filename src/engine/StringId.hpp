@@ -0,0 +1,109 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_STRINGID
+#define ENGINE_STRINGID
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Engine {
+
+  /**
+   * @brief A string reduced to its hash, compared and hashed in O(1)
+   *
+   * The hash is FNV-1a, the same as `TextureAtlas::HashName`, and is computed
+   * at compile time for literals. Two ids are equal when their strings are,
+   * whichever translation unit they come from.
+   *
+   * Constructing an id only hashes the string. Use `Intern` where the string
+   * itself has to be kept, such as names and uniforms: the string is stored
+   * once, `c_str` returns it, and a different string with the same hash is
+   * reported as an error.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * using namespace Engine::Literals;
+   *
+   * constexpr Engine::StringId jump = "Jump"_id;
+   * Engine::StringId name = Engine::StringId::Intern(playerName);
+   * ```
+   */
+  class StringId {
+    private:
+    uint32_t m_hash = 0;
+
+    static constexpr uint32_t Hash(std::string_view string) {
+      uint32_t hash = 0x811c9dc5u;
+      for (char c : string) {
+        hash ^= (unsigned char)c;
+        hash *= 0x01000193u;
+      }
+      return hash;
+    }
+
+    public:
+
+    /**
+     * @brief The id of the empty string
+     */
+    constexpr StringId() : m_hash(Hash("")) {}
+
+    constexpr StringId(std::string_view string) : m_hash(Hash(string)) {}
+    constexpr StringId(const char* string)
+      : m_hash(Hash(std::string_view(string))) {}
+    StringId(const std::string& string) : m_hash(Hash(string)) {}
+
+    /**
+     * @brief Returns the id of a string and keeps the string for `c_str`
+     */
+    static StringId Intern(std::string_view string);
+
+    /**
+     * @brief Returns the hash of the string
+     */
+    constexpr uint32_t GetHash() const {
+      return m_hash;
+    }
+
+    /**
+     * @brief Returns the interned string, or an empty string if it was never
+     * interned
+     */
+    const char* c_str() const;
+
+    constexpr bool operator==(const StringId& other) const = default;
+  };
+
+  /**
+   * @brief Writes the interned string, or the hash if it was never interned
+   */
+  extern std::ostream& operator<<(std::ostream& stream, StringId id);
+
+  namespace Literals {
+
+    /**
+     * @brief Hashes a literal at compile time: `"Jump"_id`
+     */
+    consteval StringId operator""_id(const char* string, size_t length) {
+      return StringId(std::string_view(string, length));
+    }
+  }
+}
+
+template <>
+struct std::hash<Engine::StringId> {
+  size_t operator()(Engine::StringId id) const {
+    return id.GetHash();
+  }
+};
+
+#endif
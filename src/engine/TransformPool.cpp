@@ -0,0 +1,287 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "TransformPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+static const float IDENTITY[16] = {
+  1, 0, 0, 0,
+  0, 1, 0, 0,
+  0, 0, 1, 0,
+  0, 0, 0, 1
+};
+
+/**
+ * Reorders an array of slots, `order` giving the old slot of each new slot
+ */
+template <typename T>
+static void Permute(std::vector<T>& values, const std::vector<uint32_t>& order,
+  size_t stride = 1) {
+  std::vector<T> sorted(order.size() * stride);
+  for (size_t i = 0; i < order.size(); i++)
+    std::copy_n(&values[order[i] * stride], stride, &sorted[i * stride]);
+  values.swap(sorted);
+}
+
+void Engine::TransformPool::Sort() {
+  size_t slotCount = m_handles.size();
+
+  // The children of destroyed transforms become roots
+  for (size_t i = 0; i < slotCount; i++)
+    if (m_parents[i] != NO_PARENT
+      && m_handles[m_parents[i]] == INVALID_TRANSFORM) {
+      m_parents[i] = NO_PARENT;
+      m_dirty[i] = 1;
+    }
+
+  // Depth of each slot, following the parents that are not resolved yet
+  std::vector<uint32_t> depths(slotCount, NO_PARENT);
+  std::vector<uint32_t> chain;
+  uint32_t maxDepth = 0;
+  for (size_t i = 0; i < slotCount; i++) {
+    uint32_t slot = i;
+    while (depths[slot] == NO_PARENT && m_parents[slot] != NO_PARENT) {
+      chain.push_back(slot);
+      slot = m_parents[slot];
+    }
+
+    if (depths[slot] == NO_PARENT)
+      depths[slot] = 0;
+
+    for (; !chain.empty(); chain.pop_back()) {
+      depths[chain.back()] = depths[slot] + 1;
+      slot = chain.back();
+    }
+
+    maxDepth = std::max(maxDepth, depths[i]);
+  }
+
+  // Counting sort by depth, which keeps the order of each level
+  std::vector<uint32_t> starts(maxDepth + 2, 0);
+  for (size_t i = 0; i < slotCount; i++)
+    if (m_handles[i] != INVALID_TRANSFORM)
+      starts[depths[i] + 1]++;
+
+  for (uint32_t depth = 0; depth <= maxDepth; depth++)
+    starts[depth + 1] += starts[depth];
+
+  std::vector<uint32_t> order(starts[maxDepth + 1]);
+  std::vector<uint32_t> newSlots(slotCount, NO_PARENT);
+  for (size_t i = 0; i < slotCount; i++)
+    if (m_handles[i] != INVALID_TRANSFORM) {
+      newSlots[i] = starts[depths[i]]++;
+      order[newSlots[i]] = i;
+    }
+
+  Permute(m_positionX, order);
+  Permute(m_positionY, order);
+  Permute(m_positionZ, order);
+  Permute(m_scaleX, order);
+  Permute(m_scaleY, order);
+  Permute(m_scaleZ, order);
+  Permute(m_rotationX, order);
+  Permute(m_rotationY, order);
+  Permute(m_rotationZ, order);
+  Permute(m_rotationW, order);
+  Permute(m_world, order, 16);
+  Permute(m_dirty, order);
+  Permute(m_versions, order);
+  Permute(m_handles, order);
+  Permute(m_parents, order);
+
+  for (uint32_t& parent : m_parents)
+    if (parent != NO_PARENT)
+      parent = newSlots[parent];
+
+  for (size_t i = 0; i < m_handles.size(); i++)
+    m_slots[m_handles[i]] = i;
+
+  m_unordered = false;
+}
+
+void Engine::TransformPool::MarkDirty(TransformHandle handle) {
+  m_dirty[m_slots[handle]] = 1;
+  m_changed = true;
+}
+
+Engine::TransformHandle Engine::TransformPool::Create() {
+  TransformHandle handle;
+  if (!m_freeHandles.empty()) {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  } else {
+    handle = m_slots.size();
+    m_slots.push_back(0);
+  }
+
+  // Roots can go anywhere, so new slots are appended
+  m_slots[handle] = m_handles.size();
+  m_positionX.push_back(0.0f);
+  m_positionY.push_back(0.0f);
+  m_positionZ.push_back(0.0f);
+  m_scaleX.push_back(1.0f);
+  m_scaleY.push_back(1.0f);
+  m_scaleZ.push_back(1.0f);
+  m_rotationX.push_back(0.0f);
+  m_rotationY.push_back(0.0f);
+  m_rotationZ.push_back(0.0f);
+  m_rotationW.push_back(1.0f);
+  m_world.insert(m_world.end(), IDENTITY, IDENTITY + 16);
+  m_parents.push_back(NO_PARENT);
+  m_dirty.push_back(0);
+  m_versions.push_back(0);
+  m_handles.push_back(handle);
+  return handle;
+}
+
+void Engine::TransformPool::Destroy(TransformHandle handle) {
+  // The slot is removed by the next sort
+  uint32_t slot = m_slots[handle];
+  m_handles[slot] = INVALID_TRANSFORM;
+  m_parents[slot] = NO_PARENT;
+  m_dirty[slot] = 0;
+  m_freeHandles.push_back(handle);
+
+  m_unordered = true;
+  m_changed = true;
+}
+
+void Engine::TransformPool::SetParent(TransformHandle handle,
+  TransformHandle parent) {
+  uint32_t slot = m_slots[handle];
+  uint32_t parentSlot = parent != INVALID_TRANSFORM ? m_slots[parent]
+    : NO_PARENT;
+  if (m_parents[slot] == parentSlot)
+    return;
+
+  m_parents[slot] = parentSlot;
+
+  // The order only breaks when the parent comes after its new child
+  if (parentSlot != NO_PARENT && parentSlot > slot)
+    m_unordered = true;
+
+  MarkDirty(handle);
+}
+
+Engine::TransformHandle Engine::TransformPool::GetParent(
+  TransformHandle handle) {
+  uint32_t parent = m_parents[m_slots[handle]];
+  return parent != NO_PARENT ? m_handles[parent] : INVALID_TRANSFORM;
+}
+
+Engine::Vec3f Engine::TransformPool::GetPosition(TransformHandle handle) {
+  uint32_t slot = m_slots[handle];
+  return {m_positionX[slot], m_positionY[slot], m_positionZ[slot]};
+}
+
+void Engine::TransformPool::SetPosition(TransformHandle handle,
+  Vec3f position) {
+  uint32_t slot = m_slots[handle];
+  m_positionX[slot] = position.x;
+  m_positionY[slot] = position.y;
+  m_positionZ[slot] = position.z;
+  MarkDirty(handle);
+}
+
+Engine::Vec3f Engine::TransformPool::GetScale(TransformHandle handle) {
+  uint32_t slot = m_slots[handle];
+  return {m_scaleX[slot], m_scaleY[slot], m_scaleZ[slot]};
+}
+
+void Engine::TransformPool::SetScale(TransformHandle handle, Vec3f scale) {
+  uint32_t slot = m_slots[handle];
+  m_scaleX[slot] = scale.x;
+  m_scaleY[slot] = scale.y;
+  m_scaleZ[slot] = scale.z;
+  MarkDirty(handle);
+}
+
+Engine::Quatf Engine::TransformPool::GetRotation(TransformHandle handle) {
+  uint32_t slot = m_slots[handle];
+  return {m_rotationX[slot], m_rotationY[slot], m_rotationZ[slot],
+    m_rotationW[slot]};
+}
+
+void Engine::TransformPool::SetRotation(TransformHandle handle,
+  Quatf rotation) {
+  uint32_t slot = m_slots[handle];
+  m_rotationX[slot] = rotation.x;
+  m_rotationY[slot] = rotation.y;
+  m_rotationZ[slot] = rotation.z;
+  m_rotationW[slot] = rotation.w;
+  MarkDirty(handle);
+}
+
+Engine::Transform Engine::TransformPool::GetLocal(TransformHandle handle) {
+  return {GetPosition(handle), GetScale(handle), GetRotation(handle)};
+}
+
+void Engine::TransformPool::SetLocal(TransformHandle handle,
+  const Transform& transform) {
+  SetPosition(handle, transform.Position);
+  SetScale(handle, transform.Scale);
+  SetRotation(handle, transform.Rotation);
+}
+
+const float* Engine::TransformPool::GetWorldMatrix(TransformHandle handle) {
+  Update();
+  return &m_world[m_slots[handle] * 16];
+}
+
+uint32_t Engine::TransformPool::GetVersion(TransformHandle handle) {
+  return m_versions[m_slots[handle]];
+}
+
+size_t Engine::TransformPool::Update() {
+  if (!m_changed)
+    return 0;
+
+  if (m_unordered)
+    Sort();
+
+  size_t recomputed = 0;
+  size_t slotCount = m_handles.size();
+  float* world = m_world.data();
+  uint8_t* dirty = m_dirty.data();
+  const uint32_t* parents = m_parents.data();
+
+  // Parents come first, so their matrices are final when a child reads them
+  for (size_t i = 0; i < slotCount; i++) {
+    uint32_t parent = parents[i];
+    if (parent != NO_PARENT)
+      dirty[i] |= dirty[parent];
+
+    if (!dirty[i])
+      continue;
+
+    float local[16];
+    ComposeMatrix({m_positionX[i], m_positionY[i], m_positionZ[i]},
+      {m_rotationX[i], m_rotationY[i], m_rotationZ[i], m_rotationW[i]},
+      {m_scaleX[i], m_scaleY[i], m_scaleZ[i]}, local);
+
+    if (parent == NO_PARENT)
+      memcpy(&world[i * 16], local, sizeof(local));
+    else
+      MultiplyMatrices(&world[parent * 16], local, &world[i * 16]);
+
+    m_versions[i]++;
+    recomputed++;
+  }
+
+  std::fill(m_dirty.begin(), m_dirty.end(), 0);
+  m_changed = false;
+  return recomputed;
+}
+
+size_t Engine::TransformPool::GetSlotCount() {
+  return m_handles.size();
+}
+
+Engine::TransformPool& Engine::GetTransformPool() {
+  static Engine::TransformPool transformPool;
+  return transformPool;
+}
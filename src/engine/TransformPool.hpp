@@ -0,0 +1,171 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ENGINE_TRANSFORMPOOL
+#define ENGINE_TRANSFORMPOOL
+
+#include "Utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+  /**
+   * @brief A handle to a transform stored in the transform pool
+   */
+  typedef uint32_t TransformHandle;
+
+  /**
+   * @brief The handle given to no transform
+   */
+  constexpr TransformHandle INVALID_TRANSFORM = 0xFFFFFFFF;
+
+  /**
+   * @brief Stores the transforms of every game object as arrays
+   *
+   * Positions, scales and rotations (quaternions) are kept in one array per
+   * component (structure of arrays), and the world matrices in a single contiguous
+   * array. Slots are sorted by depth in the hierarchy, so a parent always
+   * comes before its children and every world matrix is computed in one
+   * linear pass. The pass only touches the slots that moved or whose parent
+   * moved, and it is skipped entirely when nothing changed. Matrices are
+   * multiplied with wasm SIMD when the engine is compiled with `-msimd128`.
+   *
+   * Game objects own a slot each and go through the pool in their
+   * accessors, so most code never uses it directly. Handles stay valid when
+   * the slots are sorted again.
+   *
+   * ## Example
+   *
+   * ```cpp
+   * Engine::TransformPool& pool = Engine::GetTransformPool();
+   * Engine::TransformHandle parent = pool.Create();
+   * Engine::TransformHandle child = pool.Create();
+   * pool.SetParent(child, parent);
+   * pool.SetPosition(parent, {0, 1, 0});
+   * pool.Update();
+   * const float* world = pool.GetWorldMatrix(child);
+   * ```
+   */
+  class TransformPool {
+    private:
+    static constexpr uint32_t NO_PARENT = 0xFFFFFFFF;
+
+    // Slot data, ordered by depth
+    std::vector<float> m_positionX, m_positionY, m_positionZ;
+    std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+    std::vector<float> m_rotationX, m_rotationY, m_rotationZ, m_rotationW;
+    std::vector<float> m_world;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint8_t> m_dirty;
+    std::vector<uint32_t> m_versions;
+    std::vector<TransformHandle> m_handles;
+
+    // Handle data
+    std::vector<uint32_t> m_slots;
+    std::vector<TransformHandle> m_freeHandles;
+
+    bool m_changed = false;
+    bool m_unordered = false;
+
+    /**
+     * @brief Sorts the slots by depth so that parents come first
+     *
+     * Free slots are removed, and the children of destroyed transforms
+     * become roots.
+     */
+    void Sort();
+
+    /**
+     * @brief Marks a slot to be recomputed by the next update
+     */
+    void MarkDirty(TransformHandle handle);
+
+    public:
+
+    /**
+     * @brief Creates a transform at the origin without a parent
+     */
+    TransformHandle Create();
+
+    /**
+     * @brief Frees a transform
+     *
+     * Its children become roots, and the handle may be given to the next
+     * transform created.
+     */
+    void Destroy(TransformHandle handle);
+
+    /**
+     * @brief Sets the transform the handle is relative to
+     *
+     * @param handle the transform to move
+     * @param parent the new parent, or `INVALID_TRANSFORM` to make it a root
+     */
+    void SetParent(TransformHandle handle, TransformHandle parent);
+
+    /**
+     * @brief Returns the parent of a transform, or `INVALID_TRANSFORM`
+     */
+    TransformHandle GetParent(TransformHandle handle);
+
+    Vec3f GetPosition(TransformHandle handle);
+    void SetPosition(TransformHandle handle, Vec3f position);
+    Vec3f GetScale(TransformHandle handle);
+    void SetScale(TransformHandle handle, Vec3f scale);
+    Quatf GetRotation(TransformHandle handle);
+    void SetRotation(TransformHandle handle, Quatf rotation);
+
+    /**
+     * @brief Returns the position, scale and rotation relative to the parent
+     */
+    Transform GetLocal(TransformHandle handle);
+
+    /**
+     * @brief Sets the position, scale and rotation relative to the parent
+     */
+    void SetLocal(TransformHandle handle, const Transform& transform);
+
+    /**
+     * @brief Returns the column-major world matrix of a transform
+     *
+     * The pool is updated first if anything changed.
+     *
+     * @warning The pointer is only valid until the next transform is created
+     * or the next update.
+     */
+    const float* GetWorldMatrix(TransformHandle handle);
+
+    /**
+     * @brief Returns a number that changes every time the world matrix of a
+     * transform is recomputed
+     *
+     * Comparing it to the number seen before tells if the transform moved,
+     * including through one of its parents.
+     */
+    uint32_t GetVersion(TransformHandle handle);
+
+    /**
+     * @brief Recomputes the world matrices that changed since the last update
+     *
+     * @return The amount of world matrices that were recomputed
+     */
+    size_t Update();
+
+    /**
+     * @brief Returns the amount of slots, including the free ones
+     */
+    size_t GetSlotCount();
+  };
+
+  /**
+   * @brief The pool holding the transforms of every game object
+   */
+  extern TransformPool& GetTransformPool();
+}
+
+#endif
@@ -7,44 +7,6 @@
 #include "Utils.hpp"
 #include <cmath>
 
-#define M_PI 3.14159265358979323846
-
-// 2D Vector Operations
-
-Engine::Vec2f Engine::Vec2f::operator+(const Engine::Vec2f& rhs) {
-  return {x + rhs.x, y + rhs.y};
-}
-
-Engine::Vec2f Engine::Vec2f::operator*(const float& rhs) {
-  return {x * rhs, y * rhs};
-}
-
-Engine::Vec2f Engine::Vec2f::operator*(const Vec2f& rhs) {
-  return {x * rhs.x, y * rhs.y};
-}
-
-// 3D Vector Operations
-
-Engine::Vec3f Engine::Vec3f::operator+(const Engine::Vec3f& rhs) {
-  return {x + rhs.x, y + rhs.y, z + rhs.z};
-}
-
-Engine::Vec3f Engine::Vec3f::operator*(const float& rhs) {
-  return {x * rhs, y * rhs, z * rhs};
-}
-
-Engine::Vec3f Engine::Vec3f::operator*(const Vec3f& rhs) {
-  return {x * rhs.x, y * rhs.y, z * rhs.z};
-}
-
-float Engine::Vec3f::lengthSquared() {
-  return x * x + y * y + z * z;
-}
-
-bool Engine::Vec3f::operator==(const Engine::Vec3f& rhs) {
-  return x == rhs.x && y == rhs.y && z == rhs.z;
-}
-
 // Vector Rotations
 
 Engine::Vec2f Engine::Rotate(Vec2f v, float angle) {
@@ -66,7 +28,6 @@ Engine::Vec3f Engine::Rotate(Vec3f v, Vec3f angle) {
   };
 }
 
-float Engine::InvSQRT(float x) {
-  // There is a better way to do this
-  return 1.0f / sqrt(x);
-}
\ No newline at end of file
+void Engine::ComposeTransform(const Transform& transform, float* out) {
+  ComposeMatrix(transform.Position, transform.Rotation, transform.Scale, out);
+}
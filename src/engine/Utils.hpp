@@ -13,6 +13,8 @@
 #ifndef ENGINE_UTILS
 #define ENGINE_UTILS
 
+#include "Math.hpp"
+
 namespace Engine {
   /**
    * A generic success type that determines the stabitility of the code.
@@ -44,82 +46,15 @@ namespace Engine {
   } AssetRequest;
 
   /**
-   * @brief A 2D vector struct with overloaded operators
-   */
-  struct Vec2f {
-    float x;
-    float y;
-
-    // /**
-    //  * Assign a Vec2f
-    //  */
-    // Vec2f operator=(const Vec2f& rhs);
-
-    /**
-     * @brief Add two Vec2f objects together
-     */
-    Vec2f operator+(const Vec2f& rhs);
-
-    // /**
-    //  * Subtract two Vec2f objects
-    //  */
-    // Vec2f operator-(const Vec2f& rhs);
-
-    /**
-     * @brief Compute scalar multiplication
-     */
-    Vec2f operator*(const float& rhs);
-
-    /**
-     * @brief Compute multiplication in parallel
-     */
-    Vec2f operator*(const Vec2f& rhs);
-
-    // /**
-    //  * Dot product calculation
-    //  */
-    // Vec2f operator*(const Vec2f& rhs);
-
-    // /**
-    //  * Scalar division
-    //  */
-    // Vec2f operator/(const float& rhs);
-
-    // /**
-    //  * Negate a Vec2f
-    //  */
-    // Vec2f operator-();
-  };
-
-  /**
-   * @brief A 3D vector struct with overloaded operators
+   * @brief The position, scale and rotation of an object
+   *
+   * Rotations given as Euler angles in degrees are converted with
+   * `Quatf::FromEuler`.
    */
-  struct Vec3f {
-    float x;
-    float y;
-    float z;
-
-    /**
-     * @brief Adds two Vec3f objects
-     */
-    Vec3f operator+(const Vec3f& rhs);
-
-    /**
-     * @brief Compute scalar multiplication
-     */
-    Vec3f operator*(const float& rhs);
-
-    /**
-     * @brief Computes Multiplication in parallel
-     */
-    Vec3f operator*(const Vec3f& rhs);
-
-    /**
-     * @brief Returns the length of the vector
-     */
-    float lengthSquared();
-
-    bool operator==(const Vec3f& rhs);
+  struct Transform {
+    Vec3f Position{0.0f, 0.0f, 0.0f};
+    Vec3f Scale{1.0f, 1.0f, 1.0f};
+    Quatf Rotation;
   };
 
   /**
@@ -151,14 +86,15 @@ namespace Engine {
   Vec3f Rotate(Vec3f v, Vec3f angle);
 
   /**
-   * @brief returns the inverse square root of a float
+   * @brief Builds the transformation matrix of a transform
    *
-   * TODO: Use SIMD Instrinsics to accelerate the calculation
+   * The matrix is column-major (ready for OpenGL) and is equivalent to
+   * translate * rotate * scale.
    *
-   * @param x The float to take the inverse square root of
-   * @return The inverse square root
+   * @param transform The transform to convert
+   * @param out An array of 16 floats to write the matrix into
    */
-  float InvSQRT(float x);
+  void ComposeTransform(const Transform& transform, float* out);
 }
 
 #endif
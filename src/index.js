@@ -43,9 +43,14 @@ program
   .description(
     "build the project using the configuration in tableconf.json or the default configuration. If no step are defined, the complete build process will be used.",
   )
+  .option("-a, --atlas", "Pack the sprite folders in tableconf.json into atlases")
   .option("-c, --compile", "Compile the .cpp files into wasm .o files")
   .option("-l, --link", "Link all the files together")
   .option("-d, --debug", "Enable debug mode when linking the files")
+  .option(
+    "-t, --threading",
+    "Build with threads so that draws can be recorded on worker threads",
+  )
   .option("-L, --lib", "Compile the code as an emscripten friendly library")
   .option(
     "-p, --package",
@@ -65,11 +70,13 @@ program
       return;
     }
     build.buildGame({
+      runAtlas: options.atlas,
       runBuild: options.compile,
       runLink: options.link,
       runPackage: options.package,
       mainFile: options.main,
       debug: options.debug,
+      threading: options.threading,
       libMode: options.lib,
     });
   });
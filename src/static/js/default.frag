@@ -1,17 +1,19 @@
+#version 300 es
 precision mediump float;
 
-varying vec2 v_UV;
-varying vec3 v_Normal;
-uniform mat4 u_Transform;
+in vec2 v_UV;
+in vec3 v_Normal;
 
 uniform sampler2D u_Color;
 
+out vec4 fragColor;
+
 void main() {
-    vec4 image = texture2D(u_Color, v_UV);
+    vec4 image = texture(u_Color, v_UV);
     if (image.a < 0.1)
         discard;
 
     float lighting = dot(v_Normal, vec3(-0.1, -0.5, 1.0) / sqrt(2.26));
 
-    gl_FragColor = image * vec4(vec3(lighting), 1.0);
+    fragColor = image * vec4(vec3(lighting), 1.0);
 }
@@ -0,0 +1,28 @@
+#version 300 es
+precision mediump float;
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_UV;
+layout(location = 2) in vec3 a_Normal;
+layout(location = 3) in mat4 a_Model;
+
+layout(std140) uniform FrameConstants {
+  mat4 u_View;
+  mat4 u_Projection;
+  mat4 u_ViewProjection;
+  vec4 u_Window;
+};
+
+out vec2 v_UV;
+out vec3 v_Normal;
+
+void main() {
+  mat3 normal_transform = mat3(a_Model[0].xyz, a_Model[1].xyz, a_Model[2].xyz);
+
+  gl_Position = u_ViewProjection * a_Model * vec4(a_Position, 1.0);
+
+  v_UV = a_UV;
+
+  v_Normal = normal_transform * a_Normal;
+  v_Normal = v_Normal / length(v_Normal);
+}
@@ -0,0 +1,14 @@
+#version 300 es
+precision mediump float;
+
+in vec2 v_UV;
+in vec4 v_Tint;
+flat in float v_Layer;
+
+uniform sampler2D u_Color;
+
+out vec4 fragColor;
+
+void main() {
+  fragColor = texture(u_Color, v_UV) * v_Tint;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#version 300 es
+precision mediump float;
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_UV;
+layout(location = 2) in vec4 a_Tint;
+layout(location = 3) in float a_Layer;
+
+layout(std140) uniform FrameConstants {
+  mat4 u_View;
+  mat4 u_Projection;
+  mat4 u_ViewProjection;
+  vec4 u_Window;
+};
+
+out vec2 v_UV;
+out vec4 v_Tint;
+flat out float v_Layer;
+
+void main() {
+  gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+
+  v_UV = a_UV;
+  v_Tint = a_Tint;
+  v_Layer = a_Layer;
+}
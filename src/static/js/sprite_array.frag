@@ -0,0 +1,15 @@
+#version 300 es
+precision mediump float;
+precision mediump sampler2DArray;
+
+in vec2 v_UV;
+in vec4 v_Tint;
+flat in float v_Layer;
+
+uniform sampler2DArray u_Color;
+
+out vec4 fragColor;
+
+void main() {
+  fragColor = texture(u_Color, vec3(v_UV, v_Layer)) * v_Tint;
+}
\ No newline at end of file
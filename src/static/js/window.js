@@ -181,7 +181,7 @@ window.addEventListener("resize", () => {
 
   game.canvases["canvas"].width = window.innerWidth;
   game.canvases["canvas"].height = window.innerHeight;
-  game.gl["canvas"].viewport(0, 0, window.innerWidth, window.innerHeight);
+  // The renderer updates the viewport at the start of the next frame
 });
 
 // Game Loop
@@ -0,0 +1,269 @@
+#include <Testing.hpp>
+#include <ECS/World.hpp>
+#include <ECS/EntityObject.hpp>
+#include <ECS/WorldNode.hpp>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+using namespace Engine::ECS;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("ECS Tests")};
+
+struct Position {
+    float x, y, z;
+};
+
+struct Velocity {
+    float x, y, z;
+};
+
+struct Health {
+    int points;
+};
+
+// A large component, so its archetype spans many chunks
+struct Cargo {
+    double items[32];
+};
+
+// A node with the same data as a simulated entity, for comparison
+class Particle : public Node {
+    public:
+    Position position = {0, 0, 0};
+    Velocity velocity = {1, 2, 3};
+
+    Particle() : Node("Particle") {}
+
+    void Update(float dt) override {
+        position.x += velocity.x * dt;
+        position.y += velocity.y * dt;
+        position.z += velocity.z * dt;
+    }
+};
+
+double Microseconds(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main() {
+    runner.addTest("Keep Components When Changing Archetype", []() {
+        World world;
+        Entity entity = world.Create(Position{1, 2, 3});
+        runner.Assert(world.Has<Position>(entity) && !world.Has<Velocity>(entity), "The entity should only have a position!");
+
+        world.Add(entity, Velocity{4, 5, 6});
+        world.Add(entity, Health{10});
+        world.Remove<Velocity>(entity);
+
+        Position* position = world.Get<Position>(entity);
+        runner.Assert(position != nullptr && position->x == 1 && position->y == 2 && position->z == 3, "The position should survive the moves!");
+        runner.Assert(world.Get<Health>(entity)->points == 10, "The health should survive the moves!");
+        runner.Assert(!world.Has<Velocity>(entity), "The velocity should be removed!");
+
+        world.Add(entity, Health{20});
+        runner.Assert(world.Get<Health>(entity)->points == 20, "Adding a component again should replace it!");
+        runner.Assert(world.GetArchetypeCount() == 4, "The archetypes should be shared!");
+    });
+
+    runner.addTest("Invalidate Destroyed Entities", []() {
+        World world;
+        Entity first = world.Create(Health{1});
+        world.Destroy(first);
+        runner.Assert(!world.IsAlive(first) && world.Get<Health>(first) == nullptr, "A destroyed entity should not resolve!");
+
+        Entity second = world.Create(Health{2});
+        runner.Assert(second.index == first.index && !(second == first), "A reused slot should have a new generation!");
+        runner.Assert(!world.IsAlive(first) && world.IsAlive(second), "An old id should not resolve to a new entity!");
+        runner.Assert(!world.IsAlive(INVALID_ENTITY), "The invalid entity should never be alive!");
+        runner.Assert(world.GetEntityCount() == 1, "Only one entity should be alive!");
+    });
+
+    runner.addTest("Fill The Holes Left Across Chunks", []() {
+        World world;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 1000; i++)
+            entities.push_back(world.Create(Cargo{{(double)i}}, Health{i}));
+
+        for (int i = 0; i < 1000; i += 2)
+            world.Destroy(entities[i]);
+
+        bool kept = true;
+        for (int i = 1; i < 1000; i += 2)
+            kept &= world.Get<Cargo>(entities[i])->items[0] == i && world.Get<Health>(entities[i])->points == i;
+        runner.Assert(kept, "The entities left should keep their components!");
+
+        size_t chunks = 0;
+        size_t count = 0;
+        world.EachChunk<Cargo>([&](size_t size, const Entity* ids, Cargo* cargo) {
+            chunks++;
+            count += size;
+        });
+        runner.Assert(count == 500 && chunks > 1, "The entities left should be packed in chunks!");
+    });
+
+    runner.addTest("Query Entities With Components", []() {
+        World world;
+        for (int i = 0; i < 10; i++)
+            world.Create(Position{(float)i, 0, 0});
+        for (int i = 0; i < 20; i++)
+            world.Create(Position{0, 0, 0}, Velocity{1, 1, 1});
+        for (int i = 0; i < 30; i++)
+            world.Create(Position{0, 0, 0}, Velocity{1, 1, 1}, Health{100});
+        world.Create(Health{1});
+
+        runner.Assert(world.Count<Position>() == 60 && world.Count<Position, Velocity>() == 50 && world.Count<Health>() == 31, "The counts should match the queries!");
+
+        int visited = 0;
+        world.Each<Position, Velocity>([&](Entity entity, Position& position, Velocity& velocity) {
+            position.x += velocity.x;
+            visited++;
+        });
+        runner.Assert(visited == 50, "Only the entities with both components should be visited!");
+
+        float total = 0;
+        world.Each<Position>([&](Entity entity, Position& position) {
+            total += position.x;
+        });
+        runner.Assert(total == 45 + 50, "The changes should be written to the components!");
+    });
+
+    runner.addTest("Defer Changes While Iterating", []() {
+        World world;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 100; i++)
+            entities.push_back(world.Create(Health{i % 2 == 0 ? 0 : 10}));
+
+        int visited = 0;
+        world.Each<Health>([&](Entity entity, Health& health) {
+            visited++;
+            if (health.points == 0)
+                world.Destroy(entity);
+            else
+                world.Add(entity, Velocity{0, 0, 0});
+            world.Create(Position{0, 0, 0});
+        });
+        runner.Assert(visited == 100, "Every entity should be visited once!");
+        runner.Assert(world.Count<Health>() == 50 && world.Count<Health, Velocity>() == 50, "The changes should apply after the iteration!");
+        runner.Assert(world.Count<Position>() == 100 && world.GetEntityCount() == 150, "The created entities should get their components!");
+        runner.Assert(!world.IsAlive(entities[0]) && world.IsAlive(entities[1]), "The destroyed entities should be gone!");
+    });
+
+    runner.addTest("Run Systems In Order", []() {
+        World world;
+        std::string order;
+        world.AddSystem("Render", [&](World&, float) { order += "C"; }, 10);
+        world.AddSystem("Input", [&](World&, float) { order += "A"; }, -10);
+        world.AddSystem("Physics", [&](World&, float) { order += "B"; });
+        world.AddSystem("Audio", [&](World&, float) { order += "b"; });
+
+        world.Update(0.016f);
+        runner.Assert(order == "ABbC", "Systems should run by order, then as added!");
+
+        runner.Assert(world.RemoveSystem("Physics") == SUCCESS && world.RemoveSystem("Physics") == FAILURE, "A system should be removed once!");
+        order.clear();
+        world.Update(0.016f);
+        runner.Assert(order == "AbC", "A removed system should not run!");
+    });
+
+    runner.addTest("Move Game Objects From Systems", []() {
+        World world;
+        Scene scene("Scene");
+        EntityObject* object = new EntityObject("Unit", world);
+        world.Get<Transform>(object->GetEntity())->Position = {1, 0, 0};
+        scene.AddChild(new WorldNode("Simulation", world));
+        scene.AddChild(object);
+
+        world.AddSystem("Move", [](World& world, float dt) {
+            world.Each<Transform, Velocity>([dt](Entity, Transform& transform, Velocity& velocity) {
+                transform.Position.x += velocity.x * dt;
+            });
+        });
+        world.Add(object->GetEntity(), Velocity{2, 0, 0});
+
+        scene.Update(0.5f);
+        runner.Assert(std::fabs(object->GetGlobalPosition().x - 2) < 1e-5f, "The object should follow its entity!");
+
+        Entity entity = object->GetEntity();
+        NodeHandle handle = object->GetHandle();
+        world.Destroy(entity);
+        runner.Assert(object->IsDestroyed(), "Destroying the entity should destroy the object!");
+        Node::FlushDestroyed();
+        runner.Assert(handle.Get() == nullptr && scene.GetChildCount() == 1, "The object should be removed at the end of the frame!");
+
+        EntityObject* other = new EntityObject("Other", world);
+        entity = other->GetEntity();
+        scene.RemoveChild(scene.AddChild(other));
+        runner.Assert(!world.IsAlive(entity), "Deleting the object should destroy its entity!");
+    });
+
+    runner.addTest("Leave Static Entity Objects Alone", []() {
+        World world;
+        Scene scene("Scene");
+        EntityObject* object = new EntityObject("Static", world);
+        EntityObject* moving = new EntityObject("Moving", world);
+        scene.AddChild(new WorldNode("Simulation", world));
+        scene.AddChild(object);
+        scene.AddChild(moving);
+        world.Add(moving->GetEntity(), Velocity{1, 0, 0});
+        world.AddSystem("Move", [](World& world, float dt) {
+            world.Each<Transform, Velocity>([dt](Entity, Transform& transform, Velocity& velocity) {
+                transform.Position.x += velocity.x * dt;
+            });
+        });
+
+        scene.Update(0.5f);
+        TransformPool& pool = GetTransformPool();
+        pool.Update();
+        uint32_t version = pool.GetVersion(object->GetTransformHandle());
+        uint32_t movingVersion = pool.GetVersion(moving->GetTransformHandle());
+
+        scene.Update(0.5f);
+        runner.Assert(pool.Update() == 1, "Only the moving object should be recomputed!");
+        runner.Assert(pool.GetVersion(object->GetTransformHandle()) == version, "The static object should keep its world matrix!");
+        runner.Assert(pool.GetVersion(moving->GetTransformHandle()) != movingVersion, "The moving object should be recomputed!");
+    });
+
+    runner.addTest("Simulate More Entities Than Nodes", []() {
+        const int count = 100000;
+
+        Scene scene("Scene");
+        for (int i = 0; i < count; i++)
+            scene.AddChild(new Particle());
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 10; frame++)
+            scene.Update(0.016f);
+        double nodes = Microseconds(start);
+
+        World world;
+        for (int i = 0; i < count; i++)
+            world.Create(Position{0, 0, 0}, Velocity{1, 2, 3});
+        world.AddSystem("Move", [](World& world, float dt) {
+            world.EachChunk<Position, Velocity>([dt](size_t size, const Entity*, Position* position, Velocity* velocity) {
+                for (size_t i = 0; i < size; i++) {
+                    position[i].x += velocity[i].x * dt;
+                    position[i].y += velocity[i].y * dt;
+                    position[i].z += velocity[i].z * dt;
+                }
+            });
+        });
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 10; frame++)
+            world.Update(0.016f);
+        double entities = Microseconds(start);
+
+        float x = 0;
+        world.Each<Position>([&](Entity, Position& position) {
+            x = position.x;
+        });
+        runner.Assert(std::fabs(x - 0.16f) < 1e-4f, "Every entity should have moved!");
+
+        runner.DebugLog(std::to_string(count) + " objects moved in " + std::to_string(nodes / 10) + "us as nodes, " + std::to_string(entities / 10) + "us as entities");
+    });
+
+    return 0;
+}
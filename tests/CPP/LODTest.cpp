@@ -0,0 +1,142 @@
+#include <Testing.hpp>
+#include <Graphics/MeshSimplifier.hpp>
+#include <GameObjects/LODGroup.hpp>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Engine;
+using namespace Engine::Graphics;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("LOD Tests")};
+
+// A flat grid of quads, 1 unit wide, with UVs stretched over it
+class Grid : public Mesh {
+    public:
+    Grid(int size) {
+        for (int y = 0; y < size; y++)
+            for (int x = 0; x < size; x++) {
+                float x0 = (float)x / size - 0.5f, x1 = (float)(x + 1) / size - 0.5f;
+                float y0 = (float)y / size - 0.5f, y1 = (float)(y + 1) / size - 0.5f;
+                AddQuad({x0, y0, 0, x0 + 0.5f, y0 + 0.5f}, {x1, y0, 0, x1 + 0.5f, y0 + 0.5f},
+                    {x1, y1, 0, x1 + 0.5f, y1 + 0.5f}, {x0, y1, 0, x0 + 0.5f, y1 + 0.5f});
+            }
+    }
+};
+
+// A sphere of radius 1 with a UV seam where the longitude wraps around
+class Sphere : public Mesh {
+    public:
+    Sphere(int rings, int segments) {
+        auto point = [&](int ring, int segment) {
+            float theta = PI * ring / rings, phi = 2 * PI * segment / segments;
+            return Vertex{sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi),
+                (float)segment / segments, (float)ring / rings};
+        };
+
+        for (int ring = 0; ring < rings; ring++)
+            for (int segment = 0; segment < segments; segment++) {
+                Vertex a = point(ring, segment), b = point(ring, segment + 1);
+                Vertex c = point(ring + 1, segment + 1), d = point(ring + 1, segment);
+                if (ring != 0)
+                    AddTriangle(a, b, d);
+                if (ring != rings - 1)
+                    AddTriangle(b, c, d);
+            }
+    }
+};
+
+size_t TriangleCount(Mesh& mesh) {
+    return mesh.GetIndexCount() / 3;
+}
+
+// The largest distance of a vertex from the surface of the unit sphere
+float SphereError(Mesh& mesh) {
+    const Vertex* vertices = (const Vertex*)mesh.GetVertices();
+    float error = 0;
+    for (size_t i = 0; i < mesh.GetVertexCount(); i++) {
+        float radius = sqrtf(vertices[i].x * vertices[i].x + vertices[i].y * vertices[i].y + vertices[i].z * vertices[i].z);
+        error = fmaxf(error, fabsf(radius - 1.0f));
+    }
+    return error;
+}
+
+int main() {
+    runner.addTest("Collapse A Flat Grid Without Moving It", []() {
+        Grid grid(16);
+        MeshSimplifier simplifier(grid);
+        runner.Assert(simplifier.GetTriangleCount() == 512, "The grid should have 512 triangles, not " + std::to_string(simplifier.GetTriangleCount()));
+
+        size_t left = simplifier.Simplify(2);
+        std::unique_ptr<Mesh> simple = simplifier.CreateMesh();
+        runner.Assert(left == 2 && TriangleCount(*simple) == 2, "The grid should become a single quad, not " + std::to_string(left) + " triangles!");
+        runner.Assert(simplifier.GetError() < 1e-4f, "A flat grid should not move, error " + std::to_string(simplifier.GetError()));
+
+        BoundingBox box = simple->GetBoundingBox();
+        runner.Assert(box.min == Vec3f{-0.5f, -0.5f, 0} && box.max == Vec3f{0.5f, 0.5f, 0}, "The borders of the grid should stay in place!");
+
+        const Vertex* vertices = (const Vertex*)simple->GetVertices();
+        for (size_t i = 0; i < simple->GetVertexCount(); i++) {
+            runner.Assert(vertices[i].u == vertices[i].x + 0.5f && vertices[i].v == vertices[i].y + 0.5f, "The UVs should follow the corners they belong to!");
+            runner.Assert(vertices[i].nz == 1.0f, "The normals should still face up!");
+        }
+    });
+
+    runner.addTest("Build A Chain Of Levels Close To The Surface", []() {
+        Sphere sphere(24, 48);
+        size_t triangles = TriangleCount(sphere);
+
+        std::vector<std::unique_ptr<Mesh>> levels = MeshSimplifier::GenerateLODs(sphere, 4);
+        runner.Assert(levels.size() == 4, "There should be 4 levels, not " + std::to_string(levels.size()));
+        for (size_t i = 0; i < levels.size(); i++) {
+            size_t expected = triangles >> (i + 1);
+            runner.Assert(TriangleCount(*levels[i]) <= expected && TriangleCount(*levels[i]) > expected * 9 / 10, "Level " + std::to_string(i) + " has " + std::to_string(TriangleCount(*levels[i])) + " triangles, expected about " + std::to_string(expected));
+        }
+
+        runner.Assert(SphereError(*levels[0]) < 0.02f, "The first level should barely move, error " + std::to_string(SphereError(*levels[0])));
+        runner.Assert(SphereError(*levels[3]) < 0.15f, "The last level should still look like a sphere, error " + std::to_string(SphereError(*levels[3])));
+
+        // A triangle stretched over the whole texture means the seam was torn
+        const Vertex* vertices = (const Vertex*)levels[3]->GetVertices();
+        const unsigned short* indices = levels[3]->GetIndices();
+        for (size_t i = 0; i < levels[3]->GetIndexCount(); i += 3) {
+            float minU = fminf(vertices[indices[i]].u, fminf(vertices[indices[i + 1]].u, vertices[indices[i + 2]].u));
+            float maxU = fmaxf(vertices[indices[i]].u, fmaxf(vertices[indices[i + 1]].u, vertices[indices[i + 2]].u));
+            runner.Assert(maxU - minU < 0.5f, "The UV seam should stay in place!");
+        }
+    });
+
+    runner.addTest("Stop At The Error Bound", []() {
+        Sphere sphere(24, 48);
+        MeshSimplifier simplifier(sphere);
+        size_t left = simplifier.Simplify(0, 0.01f);
+
+        runner.Assert(left > 0 && left < TriangleCount(sphere), "Some triangles should be collapsed, " + std::to_string(left) + " left");
+        runner.Assert(simplifier.GetError() <= 0.01f, "The error went over the bound: " + std::to_string(simplifier.GetError()));
+        runner.Assert(simplifier.Simplify(0, 0.01f) == left, "Simplifying again should not go further!");
+    });
+
+    runner.addTest("Switch Levels With Hysteresis", []() {
+        Grid high(4), low(1);
+        LODGroup group("Group");
+        group.AddLevel(&high, 0.25f);
+        group.AddLevel(&low, 0.1f);
+
+        runner.Assert(group.SelectLevel(0.5f) == 0, "A large object should use the first level!");
+        runner.Assert(group.SelectLevel(0.24f) == 0, "Right below the threshold should not switch yet!");
+        runner.Assert(group.SelectLevel(0.2f) == 1, "Well below the threshold should switch!");
+        runner.Assert(group.SelectLevel(0.26f) == 1, "Right above the threshold should not switch back yet!");
+        runner.Assert(group.SelectLevel(0.3f) == 0, "Well above the threshold should switch back!");
+        runner.Assert(group.SelectLevel(0.01f) == 2, "Nothing should be drawn below the last threshold!");
+
+        // An orthographic camera that fits 10 units in the height of the canvas
+        float viewProjection[16] = {0.2f, 0, 0, 0, 0, 0.2f, 0, 0, 0, 0, 0.01f, 0, 0, 0, 0, 1};
+        float size = group.GetScreenSize(viewProjection);
+        runner.Assert(fabsf(size - 0.2f * sqrtf(0.5f)) < 1e-5f, "Wrong screen size: " + std::to_string(size));
+
+        group.SetScale({4, 4, 4});
+        runner.Assert(fabsf(group.GetScreenSize(viewProjection) - 4 * size) < 1e-5f, "The screen size should grow with the scale!");
+    });
+
+    return 0;
+}
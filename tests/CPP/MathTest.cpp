@@ -0,0 +1,191 @@
+#include <Testing.hpp>
+#include <Utils.hpp>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace Engine;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("Math Tests")};
+
+static_assert(Dot(Vec3f{1, 2, 3}, Vec3f{4, 5, 6}) == 32, "Vectors should be usable in constant expressions");
+static_assert(sizeof(Vec3f) == 12, "Vec3f must stay packed for vertex data");
+
+bool Near(float a, float b) {
+    return fabsf(a - b) < 1e-4f;
+}
+
+bool Near(Vec3f a, Vec3f b) {
+    return Near(a.x, b.x) && Near(a.y, b.y) && Near(a.z, b.z);
+}
+
+bool NearMatrix(const float* a, const float* b) {
+    for (int i = 0; i < 16; i++)
+        if (!Near(a[i], b[i]))
+            return false;
+    return true;
+}
+
+// The Euler matrix as a product of the rotations around each axis
+Mat4f EulerMatrix(Vec3f degrees) {
+    float x = degrees.x * DEGREES_TO_RADIANS, y = degrees.y * DEGREES_TO_RADIANS, z = degrees.z * DEGREES_TO_RADIANS;
+    Mat4f rx = {{1, 0, 0, 0, 0, cosf(x), sinf(x), 0, 0, -sinf(x), cosf(x), 0, 0, 0, 0, 1}};
+    Mat4f ry = {{cosf(y), 0, -sinf(y), 0, 0, 1, 0, 0, sinf(y), 0, cosf(y), 0, 0, 0, 0, 1}};
+    Mat4f rz = {{cosf(z), sinf(z), 0, 0, -sinf(z), cosf(z), 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+    return rx * ry * rz;
+}
+
+std::string ToString(Vec3f v) {
+    return "<" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ">";
+}
+
+// The scalar matrix product the engine used before
+void ReferenceMultiply(const float* a, const float* b, float* out) {
+    for (int column = 0; column < 4; column++)
+        for (int row = 0; row < 4; row++) {
+            out[column * 4 + row] = 0;
+            for (int k = 0; k < 4; k++)
+                out[column * 4 + row] += a[k * 4 + row] * b[column * 4 + k];
+        }
+}
+
+double Microseconds(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main() {
+    runner.addTest("Vector Operations", []() {
+        Vec3f a = {1, 2, 3};
+        Vec3f b = {4, 5, 6};
+        runner.Assert(a + b == Vec3f{5, 7, 9} && b - a == Vec3f{3, 3, 3}, "Wrong sum or difference!");
+        runner.Assert(Cross({1, 0, 0}, {0, 1, 0}) == Vec3f{0, 0, 1}, "X cross Y should be Z!");
+        runner.Assert(Near(Normalize({3, 0, 4}), {0.6f, 0, 0.8f}), "Wrong normalized vector!");
+        runner.Assert(Normalize({0, 0, 0}) == Vec3f{0, 0, 0}, "The zero vector should stay zero!");
+        runner.Assert(Near(Vec2f{3, 4}.length(), 5), "Wrong length!");
+    });
+
+    runner.addTest("Quaternions Match Euler Matrices", []() {
+        Vec3f angles = {30, -45, 120};
+        Mat4f expected = Mat4f::Translation({1, 2, 3}) * EulerMatrix(angles) * Mat4f::Scaling({2, 1, 0.5f});
+        float composed[16];
+        ComposeTransform({{1, 2, 3}, {2, 1, 0.5f}, Quatf::FromEuler(angles)}, composed);
+        runner.Assert(NearMatrix(expected.m, composed), "The quaternion matrix differs from the Euler matrix!");
+
+        Vec3f fromMatrix = Quatf::FromMat3(expected.ToMat3() * Mat3f{{0.5f, 0, 0, 0, 1, 0, 0, 0, 2}}).ToEuler();
+        runner.Assert(Near(fromMatrix, angles), "Expected " + ToString(angles) + ", got " + ToString(fromMatrix));
+
+        Vec3f back = Quatf::FromEuler(angles).ToEuler();
+        runner.Assert(Near(back, angles), "Expected " + ToString(angles) + ", got " + ToString(back));
+
+        Quatf q = Quatf::FromAxisAngle({0, 0, 1}, 90);
+        runner.Assert(Near(q.Rotate({1, 0, 0}), {0, 1, 0}), "Expected <0, 1, 0>, got " + ToString(q.Rotate({1, 0, 0})));
+        runner.Assert(Near((q * q.Conjugate()).Rotate({1, 2, 3}), {1, 2, 3}), "A rotation and its inverse should cancel!");
+    });
+
+    runner.addTest("Slerp Between Rotations", []() {
+        Quatf a = Quatf::Identity();
+        Quatf b = Quatf::FromAxisAngle({0, 1, 0}, 90);
+        Quatf half = Slerp(a, b, 0.5f);
+        runner.Assert(Near(half.ToEuler(), {0, 45, 0}), "Expected <0, 45, 0>, got " + ToString(half.ToEuler()));
+
+        // -b is the same rotation, the shortest arc must still be taken
+        Quatf negated = {-b.x, -b.y, -b.z, -b.w};
+        runner.Assert(Near(Slerp(a, negated, 0.5f).ToEuler(), {0, 45, 0}), "Slerp took the long way around!");
+    });
+
+    runner.addTest("Multiply Matrices", []() {
+        Mat4f a, b;
+        for (int i = 0; i < 16; i++) {
+            a.m[i] = (float)(i * 7 % 11) - 5;
+            b.m[i] = (float)(i * 3 % 13) * 0.5f;
+        }
+
+        float expected[16];
+        ReferenceMultiply(a.m, b.m, expected);
+        runner.Assert(NearMatrix((a * b).m, expected), "Wrong matrix product!");
+        runner.Assert(NearMatrix((Mat4f::Identity() * a).m, a.m), "The identity should not change the matrix!");
+    });
+
+    runner.addTest("Transform Points", []() {
+        // 7 points run through the 4-wide path and the scalar tail
+        Mat4f matrix;
+        ComposeTransform({{1, 2, 3}, {2, 2, 2}, Quatf::FromEuler({0, 90, 0})}, matrix.m);
+        std::vector<Vec3f> points;
+        for (int i = 0; i < 7; i++)
+            points.push_back({(float)i, (float)(i * 2), (float)-i});
+
+        std::vector<Vec3f> out(points.size());
+        TransformPoints(matrix, points.data(), out.data(), points.size());
+        for (size_t i = 0; i < points.size(); i++)
+            runner.Assert(Near(out[i], matrix.TransformPoint(points[i])), "Point " + std::to_string(i) + " got " + ToString(out[i]));
+
+        TransformPoints(matrix, points.data(), points.data(), points.size());
+        runner.Assert(Near(points[6], out[6]), "Points should be transformable in place!");
+    });
+
+    runner.addTest("Normalize Vectors", []() {
+        std::vector<Vec3f> vectors = {{3, 0, 4}, {0, 0, 0}, {0, -2, 0}, {1, 1, 1}, {0, 0, 10}, {0, 0, 0}};
+        NormalizeVectors(vectors.data(), vectors.size());
+        runner.Assert(Near(vectors[0], {0.6f, 0, 0.8f}) && Near(vectors[2], {0, -1, 0}), "Wrong normalized vectors!");
+        runner.Assert(vectors[1] == Vec3f{0, 0, 0} && vectors[5] == Vec3f{0, 0, 0}, "Zero vectors should stay zero!");
+        runner.Assert(Near(vectors[3].lengthSquared(), 1) && Near(vectors[4], {0, 0, 1}), "Wrong normalized vectors!");
+    });
+
+    runner.addTest("Benchmark Against The Scalar Code", []() {
+        const size_t count = 100000;
+        std::vector<Vec3f> points(count);
+        for (size_t i = 0; i < count; i++)
+            points[i] = {(float)(i % 17), (float)(i % 5) - 2, (float)(i % 3) + 1};
+
+        // Rotating one point at a time, as Utils::Rotate does
+        Vec3f angles = {0.3f, 1.2f, -0.7f};
+        std::vector<Vec3f> rotated(count);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < count; i++)
+            rotated[i] = Rotate(points[i], angles);
+        double rotateTime = Microseconds(start);
+
+        // Rotate turns by the opposite angles, in radians
+        Mat4f matrix = Quatf::FromEuler(angles * -RADIANS_TO_DEGREES).ToMat4();
+        std::vector<Vec3f> transformed(count);
+        start = std::chrono::high_resolution_clock::now();
+        TransformPoints(matrix, points.data(), transformed.data(), count);
+        double transformTime = Microseconds(start);
+
+        std::vector<Vec3f> normalized = points;
+        start = std::chrono::high_resolution_clock::now();
+        for (Vec3f& v : normalized)
+            v = v * InvSQRT(v.lengthSquared());
+        double invSqrtTime = Microseconds(start);
+
+        normalized = points;
+        start = std::chrono::high_resolution_clock::now();
+        NormalizeVectors(normalized.data(), count);
+        double normalizeTime = Microseconds(start);
+
+        float matrices[32], product[16];
+        for (int i = 0; i < 32; i++)
+            matrices[i] = (float)i / 32;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            ReferenceMultiply(matrices, matrices + 16, product);
+            matrices[0] = product[5];
+        }
+        double referenceTime = Microseconds(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            MultiplyMatrices(matrices, matrices + 16, product);
+            matrices[0] = product[5];
+        }
+        double multiplyTime = Microseconds(start);
+
+        runner.DebugLog("100000 points: " + std::to_string(rotateTime) + "us with Rotate, " + std::to_string(transformTime) + "us with TransformPoints");
+        runner.DebugLog("100000 vectors: " + std::to_string(invSqrtTime) + "us with InvSQRT, " + std::to_string(normalizeTime) + "us with NormalizeVectors");
+        runner.DebugLog("100000 matrices: " + std::to_string(referenceTime) + "us with loops, " + std::to_string(multiplyTime) + "us with MultiplyMatrices");
+
+        runner.Assert(Near(rotated[count - 1], transformed[count - 1]), "Expected " + ToString(rotated[count - 1]) + ", got " + ToString(transformed[count - 1]));
+    });
+
+    return 0;
+}
@@ -0,0 +1,506 @@
+#include <Testing.hpp>
+#include <Node.hpp>
+#include <NodePool.hpp>
+#include <Graphics/RenderQueue.hpp>
+#include <SceneArena.hpp>
+#include <SceneTraversal.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace Engine;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("Node Tests")};
+
+// A node that counts its updates and tells when it is destructed
+class Counter : public Node {
+    public:
+    int updates = 0;
+    int* destructed;
+
+    Counter(std::string name, int* destructed = nullptr) : Node(name), destructed(destructed) {}
+
+    ~Counter() {
+        if (destructed != nullptr)
+            (*destructed)++;
+    }
+
+    void Update(float dt) override {
+        updates++;
+        Node::Update(dt);
+    }
+};
+
+// A node the size of a typical bullet, spawned by the thousands
+class Bullet : public Node {
+    public:
+    float position[3] = {0, 0, 0};
+    float velocity[3] = {1, 0, 0};
+
+    Bullet() : Node("Bullet") {}
+};
+
+// A node whose Node base is not at the start of the object
+class Emitter : public Graphics::QueueDrawable, public Node {
+    public:
+    Emitter() : Node("Emitter") {}
+
+    void ExecuteDraw(unsigned int batch) override {}
+};
+
+// Per-scene data that is not a node
+struct Waypoints {
+    float points[2000] = {0};
+    int* destructed;
+
+    Waypoints(int* destructed) : destructed(destructed) {}
+
+    ~Waypoints() {
+        (*destructed)++;
+    }
+};
+
+// A tree of heap nodes 4 levels deep, like a large level
+void BuildLevel(Node* root, int depth, SceneArena* arena) {
+    for (int i = 0; i < 10; i++) {
+        Node* child = arena != nullptr ? (Node*)arena->Create<Bullet>() : new Bullet();
+        root->AddChild(child);
+        if (depth > 1)
+            BuildLevel(child, depth - 1, arena);
+    }
+}
+
+// Nodes that write down when they are updated and drawn
+std::vector<std::string> updateLog, drawLog;
+
+class Logger : public Node {
+    public:
+    Logger(std::string name) : Node(name) {}
+
+    void Update(float dt) override {
+        updateLog.push_back(m_name.c_str());
+        Node::Update(dt);
+    }
+
+    void Draw() override {
+        drawLog.push_back(m_name.c_str());
+        Node::Draw();
+    }
+};
+
+class OtherLogger : public Logger {
+    public:
+    OtherLogger(std::string name) : Logger(name) {}
+};
+
+// A node that only draws its first child
+class FirstOnly : public Logger {
+    public:
+    FirstOnly(std::string name) : Logger(name) {
+        SetDrawsChildren(true);
+    }
+
+    void Draw() override {
+        drawLog.push_back(m_name.c_str());
+        if (GetChildCount() > 0)
+            GetChild(0)->Draw();
+    }
+};
+
+// A node that removes a sibling while the scene is being updated
+class Remover : public Node {
+    public:
+    Remover() : Node("Remover") {}
+
+    void Update(float dt) override {
+        if (GetParent()->GetChildCount() > 1)
+            GetParent()->RemoveChild(1);
+    }
+};
+
+// A node that disables or destroys another node while the scene is being
+// updated
+class Disabler : public Node {
+    public:
+    Node* target;
+    bool destroy;
+
+    Disabler(Node* target, bool destroy) : Node("Disabler"), target(target), destroy(destroy) {}
+
+    void Update(float dt) override {
+        if (destroy)
+            target->Destroy();
+        else
+            target->SetEnabled(false);
+    }
+};
+
+// A particle that moves in its update, the kind of node there are thousands of
+class Particle : public Node {
+    public:
+    float position = 0;
+
+    Particle() : Node("Particle") {}
+
+    void Update(float dt) override {
+        position += dt;
+        Node::Update(dt);
+    }
+};
+
+// A tree of particles 4 levels deep
+void BuildParticles(Node* root, int depth) {
+    for (int i = 0; i < 10; i++) {
+        Node* child = CreateNode<Particle>();
+        root->AddChild(child);
+        if (depth > 1)
+            BuildParticles(child, depth - 1);
+    }
+}
+
+// A scene destroyed at exit, after the function-local statics
+Node staticRoot("Static Root");
+
+double Microseconds(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main() {
+    runner.addTest("Invalidate Handles Of Destroyed Nodes", []() {
+        Scene* scene = new Scene("Scene");
+        int destructed = 0;
+        Counter* node = CreateNode<Counter>("Counter", &destructed);
+        scene->AddChild(node);
+
+        NodeHandle handle = node->GetHandle();
+        runner.Assert(handle.Get() == node, "The handle should resolve to the node!");
+
+        node->Destroy();
+        scene->Update(0.016f);
+        runner.Assert(handle.Get() == node && destructed == 0, "The node should live until the end of the frame!");
+        runner.Assert(node->updates == 0, "A destroyed node should not be updated!");
+
+        runner.Assert(Node::FlushDestroyed() == 1, "One node should be destroyed!");
+        runner.Assert(handle.Get() == nullptr && destructed == 1, "The handle should not resolve anymore!");
+        runner.Assert(scene->GetChildCount() == 0, "The node should be removed from its parent!");
+
+        // The slot is reused with a new generation
+        Counter* next = CreateNode<Counter>("Counter");
+        scene->AddChild(next);
+        runner.Assert(handle.Get() == nullptr && next->GetHandle().Get() == next, "An old handle should not resolve to a new node!");
+        runner.Assert(INVALID_NODE.Get() == nullptr, "The invalid handle should never resolve!");
+
+        delete scene;
+        runner.Assert(GetNodePool<Counter>().GetLiveCount() == 0, "Deleting the scene should return its children to the pool!");
+    });
+
+    runner.addTest("Remove Children Without Shifting Them", []() {
+        Scene scene("Scene");
+        std::vector<Counter*> children;
+        for (int i = 0; i < 6; i++) {
+            children.push_back(CreateNode<Counter>("Counter"));
+            scene.AddChild(children.back());
+        }
+
+        runner.Assert(scene.RemoveChild(1) == SUCCESS, "The child should be removed!");
+        runner.Assert(scene.GetChildCount() == 5 && scene.GetChild(1) == children[5], "The last child should take the place of the removed one!");
+        runner.Assert(scene.RemoveChild(5) == FAILURE, "Removing past the end should fail!");
+
+        // The moved child still knows where it is
+        children[5]->Destroy();
+        children[3]->Destroy();
+        Node::FlushDestroyed();
+
+        std::vector<Node*> left;
+        for (size_t i = 0; i < scene.GetChildCount(); i++)
+            left.push_back(scene.GetChild(i));
+        std::sort(left.begin(), left.end());
+        std::vector<Node*> expected = {children[0], children[2], children[4]};
+        std::sort(expected.begin(), expected.end());
+        runner.Assert(left == expected, "The wrong children were removed!");
+    });
+
+    runner.addTest("Destroy A Parent And Its Children In The Same Frame", []() {
+        Scene scene("Scene");
+        int destructed = 0;
+        Counter* parent = CreateNode<Counter>("Parent", &destructed);
+        Counter* child = CreateNode<Counter>("Child", &destructed);
+        scene.AddChild(parent);
+        parent->AddChild(child);
+
+        NodeHandle childHandle = child->GetHandle();
+        parent->Destroy();
+        child->Destroy();
+        child->Destroy();
+
+        runner.Assert(Node::FlushDestroyed() == 1, "The child should go with its parent!");
+        runner.Assert(destructed == 2 && childHandle.Get() == nullptr, "Both nodes should be destructed once!");
+        runner.Assert(GetNodeRegistry().GetPendingCount() == 0, "Nothing should be left to destroy!");
+    });
+
+    runner.addTest("Reuse Pool Slots", []() {
+        Scene scene("Scene");
+        NodePool<Bullet>& pool = GetNodePool<Bullet>();
+
+        for (int frame = 0; frame < 10; frame++) {
+            for (int i = 0; i < 1000; i++)
+                scene.AddChild(CreateNode<Bullet>());
+            for (size_t i = 0; i < scene.GetChildCount(); i++)
+                scene.GetChild(i)->Destroy();
+            Node::FlushDestroyed();
+        }
+
+        runner.Assert(pool.GetLiveCount() == 0, "Every bullet should be back in the pool!");
+        runner.Assert(pool.GetCapacity() < 2000, "The pool should reuse its slots, it holds " + std::to_string(pool.GetCapacity()));
+    });
+
+    runner.addTest("Keep Pools Alive For Static Scenes", []() {
+        // The child goes back to its pool when the program exits
+        Bullet* bullet = CreateNode<Bullet>();
+        staticRoot.AddChild(bullet);
+        runner.Assert(staticRoot.GetChild(0) == bullet, "The static scene should hold the pooled node!");
+    });
+
+    runner.addTest("Pool Nodes With Several Bases", []() {
+        Scene scene("Scene");
+        NodePool<Emitter>& pool = GetNodePool<Emitter>();
+
+        Emitter* first = CreateNode<Emitter>();
+        scene.AddChild(first);
+        runner.Assert((void*)first != (void*)static_cast<Node*>(first), "The Node base should not be at the start of the emitter!");
+
+        first->Destroy();
+        Node::FlushDestroyed();
+        Emitter* second = CreateNode<Emitter>();
+        scene.AddChild(second);
+        runner.Assert(second == first, "The freed slot should be reused as is!");
+
+        for (int i = 0; i < 300; i++)
+            scene.AddChild(CreateNode<Emitter>());
+        for (size_t i = 0; i < scene.GetChildCount(); i++)
+            scene.GetChild(i)->Destroy();
+        Node::FlushDestroyed();
+        runner.Assert(pool.GetLiveCount() == 0 && pool.GetCapacity() == 512, "Every emitter should be back in the pool!");
+    });
+
+    runner.addTest("Benchmark Spawning Against New And Delete", []() {
+        Scene scene("Scene");
+        const int count = 5000;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 20; frame++) {
+            for (int i = 0; i < count; i++)
+                scene.AddChild(new Bullet());
+            while (scene.GetChildCount() > 0)
+                scene.RemoveChild(0);
+        }
+        double heap = Microseconds(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 20; frame++) {
+            for (int i = 0; i < count; i++)
+                scene.AddChild(CreateNode<Bullet>());
+            for (size_t i = 0; i < scene.GetChildCount(); i++)
+                scene.GetChild(i)->Destroy();
+            Node::FlushDestroyed();
+        }
+        double pooled = Microseconds(start);
+
+        runner.DebugLog(std::to_string(count) + " nodes spawned and removed per frame: " + std::to_string(heap / 20) + "us with new, " + std::to_string(pooled / 20) + "us pooled");
+    });
+
+    runner.addTest("Release A Scene Arena At Once", []() {
+        int destructed = 0;
+        SceneArena arena(4096);
+
+        Scene* scene = arena.Create<Scene>("Level");
+        Counter* parent = arena.Create<Counter>("Parent", &destructed);
+        Counter* child = arena.Create<Counter>("Child", &destructed);
+        Counter* pooled = CreateNode<Counter>("Pooled", &destructed);
+        arena.Create<Waypoints>(&destructed);
+        int* trivial = arena.Create<int>(7);
+
+        // The child was created before its parent was added anywhere
+        scene->AddChild(parent);
+        parent->AddChild(child);
+        child->AddChild(pooled);
+
+        runner.Assert(arena.Owns(scene) && arena.Owns(trivial) && !arena.Owns(pooled), "Only the arena objects should be in the arena!");
+        runner.Assert(arena.GetCapacity() > 12000 && arena.GetUsedBytes() > 8000, "The waypoints should get a block of their own!");
+
+        NodeHandle handle = child->GetHandle();
+        arena.Release();
+        runner.Assert(destructed == 4, "Every object with a destructor should be destructed once, not " + std::to_string(destructed) + " times!");
+        runner.Assert(handle.Get() == nullptr && GetNodePool<Counter>().GetLiveCount() == 0, "The nodes should be gone!");
+        runner.Assert(arena.GetUsedBytes() == 0 && arena.GetCapacity() == 0, "The memory should be freed!");
+    });
+
+    runner.addTest("Release Arena Nodes Attached Outside Of It", []() {
+        int destructed = 0;
+        Scene scene("Scene");
+        {
+            SceneArena arena;
+            scene.AddChild(arena.Create<Counter>("Visitor", &destructed));
+            arena.Create<Counter>("Removed", &destructed)->Destroy();
+            Node::FlushDestroyed();
+        }
+
+        runner.Assert(destructed == 2 && scene.GetChildCount() == 0, "The arena should take its nodes back from the scene!");
+
+        // The children of the scene keep their order
+        Counter* first = new Counter("First");
+        Counter* second = new Counter("Second");
+        Counter* third = new Counter("Third");
+        {
+            SceneArena arena;
+            scene.AddChild(first);
+            scene.AddChild(arena.Create<Counter>("Visitor"));
+            scene.AddChild(second);
+            scene.AddChild(third);
+        }
+
+        runner.Assert(scene.GetChildCount() == 3 && scene.GetChild(0) == first && scene.GetChild(1) == second && scene.GetChild(2) == third, "The children left should keep their order!");
+    });
+
+    runner.addTest("Benchmark Unloading A Level", []() {
+        Scene* heapLevel = new Scene("Level");
+        BuildLevel(heapLevel, 4, nullptr);
+        auto start = std::chrono::high_resolution_clock::now();
+        delete heapLevel;
+        double heap = Microseconds(start);
+
+        SceneArena arena;
+        BuildLevel(arena.Create<Scene>("Level"), 4, &arena);
+        start = std::chrono::high_resolution_clock::now();
+        arena.Release();
+        double released = Microseconds(start);
+
+        runner.DebugLog("11110 nodes unloaded in " + std::to_string(heap) + "us with delete, " + std::to_string(released) + "us with an arena");
+    });
+
+    runner.addTest("Traverse The Scene Like The Recursion", []() {
+        Logger scene("Scene");
+        Logger* a = CreateNode<Logger>("A");
+        OtherLogger* b = CreateNode<OtherLogger>("B");
+        Logger* c = CreateNode<Logger>("C");
+        OtherLogger* d = CreateNode<OtherLogger>("D");
+        Logger* hidden = CreateNode<Logger>("Hidden");
+        scene.AddChild(a);
+        a->AddChild(b);
+        b->AddChild(c);
+        scene.AddChild(d);
+        d->AddChild(hidden);
+        hidden->SetEnabled(false);
+
+        updateLog.clear();
+        drawLog.clear();
+        scene.Update(0.016f);
+        scene.Draw();
+        std::vector<std::string> recursiveDraws = drawLog;
+
+        updateLog.clear();
+        drawLog.clear();
+        SceneTraversal traversal(&scene);
+        traversal.Update(0.016f);
+        traversal.Draw();
+
+        runner.Assert(drawLog == recursiveDraws, "The draws should be in the order of the hierarchy!");
+        runner.Assert(updateLog == std::vector<std::string>{"Scene", "A", "C", "B", "D"}, "The updates should be grouped by type!");
+        runner.Assert(traversal.GetNodeCount() == 5 && traversal.GetGroupCount() == 2, "The disabled node should not be traversed!");
+    });
+
+    runner.addTest("Rebuild Only When The Scene Changes", []() {
+        Logger scene("Scene");
+        Logger* child = CreateNode<Logger>("Child");
+        scene.AddChild(child);
+
+        SceneTraversal traversal(&scene);
+        for (int frame = 0; frame < 10; frame++)
+            traversal.Update(0.016f);
+        runner.Assert(traversal.GetRebuildCount() == 1, "The arrays should be built once, not " + std::to_string(traversal.GetRebuildCount()) + " times!");
+
+        child->SetEnabled(false);
+        updateLog.clear();
+        traversal.Update(0.016f);
+        runner.Assert(traversal.GetRebuildCount() == 2 && updateLog == std::vector<std::string>{"Scene"}, "Disabling a node should rebuild the arrays!");
+
+        child->SetEnabled(true);
+        child->Destroy();
+        updateLog.clear();
+        traversal.Update(0.016f);
+        runner.Assert(updateLog == std::vector<std::string>{"Scene"}, "A destroyed node should not be updated!");
+        Node::FlushDestroyed();
+    });
+
+    runner.addTest("Leave Children To The Nodes That Draw Them", []() {
+        Logger scene("Scene");
+        FirstOnly* group = CreateNode<FirstOnly>("Group");
+        scene.AddChild(group);
+        group->AddChild(CreateNode<Logger>("First"));
+        group->AddChild(CreateNode<Logger>("Second"));
+        group->GetChild(0)->AddChild(CreateNode<Logger>("Grandchild"));
+
+        SceneTraversal traversal(&scene);
+        updateLog.clear();
+        drawLog.clear();
+        traversal.Update(0.016f);
+        traversal.Draw();
+
+        runner.Assert(drawLog == std::vector<std::string>{"Scene", "Group", "First", "Grandchild"}, "The group should draw its own children!");
+        runner.Assert(updateLog.size() == 5, "Every child should still be updated!");
+    });
+
+    runner.addTest("Skip Nodes Removed During The Update", []() {
+        Node scene("Scene");
+        int destructed = 0;
+        scene.AddChild(CreateNode<Remover>());
+        scene.AddChild(CreateNode<Counter>("Victim", &destructed));
+
+        SceneTraversal traversal(&scene);
+        traversal.Update(0.016f);
+        runner.Assert(destructed == 1 && scene.GetChildCount() == 1, "The sibling should be removed!");
+        traversal.Update(0.016f);
+        runner.Assert(traversal.GetNodeCount() == 2, "The arrays should be rebuilt after the removal!");
+    });
+
+    runner.addTest("Skip The Descendants Of Nodes Disabled During The Update", []() {
+        for (bool destroy : {false, true}) {
+            Node scene("Scene");
+            Node* group = new Node("Group");
+            Counter* counter = new Counter("Counter");
+            scene.AddChild(new Disabler(group, destroy));
+            scene.AddChild(group);
+            group->AddChild(counter);
+
+            SceneTraversal traversal(&scene);
+            traversal.Update(0.016f);
+            runner.Assert(counter->updates == 0, destroy ? "The child of a destroyed node should be skipped!" : "The child of a disabled node should be skipped!");
+            Node::FlushDestroyed();
+        }
+    });
+
+    runner.addTest("Benchmark Traversal Against Recursion", []() {
+        SceneTraversal::RegisterType<Particle>();
+        Node scene("Scene");
+        BuildParticles(&scene, 4);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 100; frame++)
+            scene.Update(0.016f);
+        double recursive = Microseconds(start);
+
+        SceneTraversal traversal(&scene);
+        traversal.Update(0.016f);
+        start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 100; frame++)
+            traversal.Update(0.016f);
+        double flat = Microseconds(start);
+
+        Particle* first = (Particle*)scene.GetChild(0);
+        runner.Assert(fabsf(first->position - 201 * 0.016f) < 1e-3f, "Every frame should update the particles once!");
+        runner.DebugLog("11110 nodes updated in " + std::to_string(recursive / 100) + "us recursively, " + std::to_string(flat / 100) + "us from the traversal");
+    });
+
+    return 0;
+}
@@ -0,0 +1,530 @@
+#include <Testing.hpp>
+#include <Graphics/Renderer.hpp>
+#include <Graphics/RecordingBackend.hpp>
+#include <Graphics/SpriteBatch.hpp>
+#include <Graphics/StateCache.hpp>
+#include <GameObjects/ParallelGroup.hpp>
+#include <GameObjects/StaticBatch.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("Renderer Tests")};
+
+// Keeps the vec2 uploads and the size of the draws, to check what was drawn
+class InspectingBackend : public Graphics::RecordingBackend {
+    public:
+    std::vector<float> vec2Values;
+    std::vector<int> drawSizes;
+
+    void DrawElements(unsigned mode, int count, unsigned type, size_t offset) override {
+        drawSizes.push_back(count);
+        RecordingBackend::DrawElements(mode, count, type, offset);
+    }
+
+    void Uniform(unsigned type, int location, int count, const float* values) override {
+        if (type == GL_FLOAT_VEC2)
+            vec2Values.insert(vec2Values.end(), values, values + 2 * count);
+        RecordingBackend::Uniform(type, location, count, values);
+    }
+
+    using RecordingBackend::Uniform;
+};
+
+InspectingBackend backend;
+
+class QuadMesh : public Graphics::Mesh {
+    public:
+    QuadMesh() {
+        AddQuad({-1, -1, 0, 0, 0}, {1, -1, 0, 1, 0}, {1, 1, 0, 1, 1}, {-1, 1, 0, 0, 1});
+    }
+};
+
+QuadMesh quad;
+
+Graphics::Renderer& GetRenderer() {
+    static Graphics::Renderer renderer;
+    return renderer;
+}
+
+// A node that draws the quad with the state it is given
+class Tile : public Node {
+    public:
+    Vec3f position;
+
+    Tile(Vec3f position) : Node("Tile"), position(position) {}
+
+    void Draw() override {
+        GetRenderer().DrawMesh(&quad, position);
+    }
+};
+
+// The meshes are spread over the view so that none of them is culled
+void DrawFrame(unsigned meshCount) {
+    Graphics::Renderer& renderer = GetRenderer();
+    renderer.BeginFrame();
+    for (unsigned i = 0; i < meshCount; i++)
+        renderer.DrawMesh(&quad, {(float)(i % 100) * 0.01f, (float)(i / 100) * 0.01f, 10.0f});
+    renderer.Flush();
+}
+
+int main() {
+    Graphics::SetBackend(backend);
+
+    runner.addTest("Create Without A GPU", []() {
+        GetRenderer();
+        runner.Assert(backend.CountCommands("CreateContext") == 1, "The context was not created through the backend!");
+    });
+
+    runner.addTest("Draw Meshes", []() {
+        backend.ClearCommands();
+        DrawFrame(100);
+        runner.Assert(backend.CountCommands("DrawElements") == 100, "Every mesh should be drawn once!");
+        runner.Assert(backend.CountCommands("UseProgram") == 1, "The program should only be bound once!");
+        runner.Assert(backend.CountCommands("BindVertexArray") == 1, "The mesh should only be bound once!");
+    });
+
+    runner.addTest("Upload Meshes Once", []() {
+        backend.ClearCommands();
+        DrawFrame(100);
+        runner.Assert(backend.CountCommands("BufferData") == 0, "The mesh was uploaded again!");
+        runner.Assert(backend.CountCommands("CompileShader") == 0, "The shader was compiled again!");
+
+        // The frame constants and one transform per draw
+        size_t expected = sizeof(Graphics::FrameConstantsData) + 100 * 16 * sizeof(float);
+        runner.Assert(backend.GetPayloadSize() == expected, "Expected " + std::to_string(expected) + " bytes, got " + std::to_string(backend.GetPayloadSize()));
+    });
+
+    runner.addTest("Draw Instances", []() {
+        std::vector<Transform> instances(1000);
+        for (size_t i = 0; i < instances.size(); i++)
+            instances[i].Position = {(float)i, 0.0f, 10.0f};
+
+        backend.ClearCommands();
+        Graphics::Renderer& renderer = GetRenderer();
+        renderer.BeginFrame();
+        renderer.DrawMeshInstanced(&quad, instances);
+        renderer.Flush();
+
+        runner.Assert(backend.CountCommands("DrawElementsInstanced") == 1, "The instances should be drawn at once!");
+        runner.Assert(backend.CountCommands("BufferData") == 1, "The instances should be uploaded at once!");
+    });
+
+    runner.addTest("Compute Mesh Bounds", []() {
+        const BoundingBox& box = quad.GetBoundingBox();
+        runner.Assert(box.min == Vec3f{-1, -1, 0} && box.max == Vec3f{1, 1, 0}, "Wrong bounding box!");
+
+        const BoundingSphere& sphere = quad.GetBoundingSphere();
+        runner.Assert(sphere.center == Vec3f{0, 0, 0} && fabsf(sphere.radius - sqrtf(2.0f)) < 1e-5f, "Wrong bounding sphere!");
+
+        float world[16];
+        ComposeTransform({{5, 0, 0}, {2, 1, 1}}, world);
+        BoundingBox moved = box.Transformed(world);
+        runner.Assert(moved.min == Vec3f{3, -1, 0} && moved.max == Vec3f{7, 1, 0}, "Wrong transformed box!");
+    });
+
+    runner.addTest("Reject Parameters Of The Wrong Type", []() {
+        // The recording backend reports u_Window as a vec2
+        Graphics::Material wrong(&Graphics::DefaultShader());
+        float scale = 3.0f;
+        wrong.CreateParameter("u_Window", Graphics::FLOAT);
+        wrong.SetParameter("u_Window", &scale);
+
+        backend.ClearCommands();
+        runner.Assert(wrong.ApplyMaterialParams() == FAILURE, "A float should not be bound to a vec2!");
+        runner.Assert(backend.CountCommands("Uniform") == 0, "The mismatched parameter should not be uploaded!");
+
+        Graphics::Material right(&Graphics::DefaultShader());
+        float size[2] = {123.0f, 456.0f};
+        right.CreateParameter("u_Window", Graphics::VEC2);
+        right.SetParameter("u_Window", size);
+
+        backend.ClearCommands();
+        runner.Assert(right.ApplyMaterialParams() == SUCCESS, "A vec2 should be bound to a vec2!");
+        runner.Assert(backend.CountCommands("Uniform") == 1 && backend.GetPayloadSize() == sizeof(size), "The vec2 should be uploaded once!");
+    });
+
+    runner.addTest("Skip Redundant State Changes", []() {
+        Graphics::StateCache& cache = Graphics::GetStateCache();
+        cache.Reset();
+        cache.ResetCounters();
+        backend.ClearCommands();
+
+        cache.UseProgram(5);
+        cache.UseProgram(5);
+        cache.SetBlend(true);
+        cache.SetBlend(true);
+        cache.Viewport(0, 0, 800, 600);
+        cache.Viewport(0, 0, 800, 600);
+        runner.Assert(backend.CountCommands("UseProgram") == 1 && backend.CountCommands("Enable") == 1 && backend.CountCommands("Viewport") == 1, "Setting a value twice should only reach GL once!");
+
+        // Binding a texture only selects its unit when the binding changes
+        cache.BindTexture(0, GL_TEXTURE_2D, 7);
+        cache.BindTexture(1, GL_TEXTURE_2D, 7);
+        cache.BindTexture(0, GL_TEXTURE_2D, 7);
+        runner.Assert(backend.CountCommands("BindTexture") == 2 && backend.CountCommands("ActiveTexture") == 2, "Each unit should be bound once!");
+
+        // The element buffer belongs to the vertex array
+        cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 3);
+        cache.BindVertexArray(4);
+        cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 3);
+        runner.Assert(backend.CountCommands("BindBuffer") == 2, "Changing the vertex array should forget the element buffer!");
+
+        runner.Assert(cache.GetIssuedCount() == 10 && cache.GetSkippedCount() == 4, "Expected 10 issued and 4 skipped calls, got " + std::to_string(cache.GetIssuedCount()) + " and " + std::to_string(cache.GetSkippedCount()));
+        cache.Reset();
+    });
+
+    runner.addTest("Forget Deleted Objects", []() {
+        Graphics::StateCache& cache = Graphics::GetStateCache();
+        cache.Reset();
+        backend.ClearCommands();
+
+        // GL can give the name of a deleted object to the next one
+        unsigned texture = 7;
+        cache.BindTexture(0, GL_TEXTURE_2D, texture);
+        cache.DeleteTextures(1, &texture);
+        cache.BindTexture(0, GL_TEXTURE_2D, texture);
+        runner.Assert(backend.CountCommands("BindTexture") == 2, "A new texture with the same name should be bound!");
+
+        cache.UseProgram(9);
+        cache.DeleteProgram(9);
+        cache.UseProgram(9);
+        runner.Assert(backend.CountCommands("UseProgram") == 2, "A new program with the same name should be bound!");
+
+        {
+            Graphics::Shader shader;
+            cache.UseProgram(shader.GetShaderProgram());
+        }
+        runner.Assert(backend.CountCommands("DeleteProgram") == 2, "Deleting a shader should delete its program!");
+        cache.Reset();
+    });
+
+    runner.addTest("Pack Sort Keys", []() {
+        Graphics::Shader* shader = (Graphics::Shader*)0x1000;
+        uint64_t opaque = Graphics::RenderQueue::MakeKey(5, false, shader, nullptr, nullptr, 0.5f);
+        runner.Assert((opaque >> 57) == 5 && ((opaque >> 56) & 1) == 0, "The layer should be in the top bits!");
+        runner.Assert((opaque & 0xFFFFFF) == (uint64_t)(0.5f * 0xFFFFFF), "Opaque keys should end with the depth!");
+        runner.Assert(((opaque >> 24) & 0x3FFFFF) == 0 && ((opaque >> 46) & 0x3FF) != 0, "Only the shader should be in the state!");
+
+        uint64_t transparent = Graphics::RenderQueue::MakeKey(5, true, shader, nullptr, nullptr, 0.25f);
+        runner.Assert(((transparent >> 56) & 1) == 1, "Transparent keys should have the blend bit!");
+        runner.Assert(((transparent >> 32) & 0xFFFFFF) == 0xFFFFFF - (uint64_t)(0.25f * 0xFFFFFF), "Transparent keys should invert the depth!");
+
+        uint64_t clamped = Graphics::RenderQueue::MakeKey(200, false, nullptr, nullptr, nullptr, 2.0f);
+        runner.Assert(clamped == ((uint64_t)(200 & 0x7F) << 57 | 0xFFFFFF), "The layer and depth should be clamped!");
+    });
+
+    runner.addTest("Sort Draws By Key", []() {
+        // These addresses have different shader hashes
+        Graphics::Shader* first = (Graphics::Shader*)0x1000;
+        Graphics::Shader* second = (Graphics::Shader*)0x2000;
+
+        struct Draw {
+            unsigned char layer;
+            bool transparent;
+            Graphics::Shader* shader;
+            float depth;
+        };
+        const Draw draws[] = {
+            {1, false, first, 0.1f},
+            {0, true, first, 0.2f},
+            {0, false, second, 0.3f},
+            {0, true, second, 0.9f},
+            {0, false, first, 0.8f},
+            {0, false, second, 0.05f},
+            {0, false, first, 0.4f},
+        };
+
+        Graphics::RenderQueue queue;
+        for (const Draw& draw : draws) {
+            Graphics::DrawCommand command = {};
+            command.shader = draw.shader;
+            command.key = Graphics::RenderQueue::MakeKey(draw.layer, draw.transparent, draw.shader, nullptr, nullptr, draw.depth);
+            queue.Push(command);
+        }
+
+        const std::vector<uint32_t>& order = queue.Sort();
+        runner.Assert(order.size() == 7, "Every draw should be sorted!");
+        runner.Assert(order[6] == 0, "Higher layers should be drawn last!");
+        runner.Assert(order[4] == 3 && order[5] == 1, "Transparent draws should come after opaque ones, back to front!");
+
+        // The opaque draws of the layer are grouped by shader, front to back
+        bool grouped = queue.GetCommand(order[0]).shader == queue.GetCommand(order[1]).shader
+            && queue.GetCommand(order[2]).shader == queue.GetCommand(order[3]).shader;
+        runner.Assert(grouped, "Opaque draws should be grouped by shader!");
+        bool frontToBack = (order[0] == 5 && order[1] == 2) || (order[0] == 6 && order[1] == 4);
+        runner.Assert(frontToBack && (order[2] == 5 || order[2] == 6), "Opaque draws with the same shader should be drawn front to back!");
+        queue.Clear();
+    });
+
+    runner.addTest("Snapshot Material Parameters", []() {
+        Graphics::Renderer& renderer = GetRenderer();
+        Graphics::Material material(&Graphics::DefaultShader());
+        float size[2] = {1.0f, 2.0f};
+        material.CreateParameter("u_Window", Graphics::VEC2);
+        material.SetParameter("u_Window", size);
+
+        backend.vec2Values.clear();
+        renderer.BeginFrame();
+        renderer.UseMaterial(&material);
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, 10.0f});
+        size[0] = 3.0f;
+        size[1] = 4.0f;
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, 20.0f});
+        renderer.UseShader(Graphics::DefaultShader());
+        renderer.Flush();
+
+        const std::vector<float>& values = backend.vec2Values;
+        bool recorded = values.size() >= 4 && values[values.size() - 4] == 1.0f && values[values.size() - 3] == 2.0f
+            && values[values.size() - 2] == 3.0f && values[values.size() - 1] == 4.0f;
+        runner.Assert(recorded, "Each draw should use the values it was recorded with!");
+    });
+
+    runner.addTest("Batch Static Meshes", []() {
+        Graphics::Renderer& renderer = GetRenderer();
+        Graphics::Material material(&Graphics::DefaultShader());
+        StaticBatch batch("Batch");
+        std::vector<MeshObject*> objects;
+        for (int i = 0; i < 100; i++) {
+            MeshObject* object = new MeshObject("Quad", &quad, i < 60 ? nullptr : &material);
+            object->SetPosition({(float)(i % 10) * 0.01f, (float)(i / 10) * 0.01f, 10.0f});
+            object->Static = true;
+            batch.AddChild(object);
+            objects.push_back(object);
+        }
+
+        backend.ClearCommands();
+        renderer.BeginFrame();
+        for (MeshObject* object : objects)
+            renderer.DrawMesh(object->GetMesh(), object->GetWorldMatrix());
+        renderer.Flush();
+        runner.Assert(backend.CountCommands("DrawElements") == 100, "Every mesh should be drawn on its own!");
+
+        backend.ClearCommands();
+        renderer.BeginFrame();
+        batch.DrawBatches(renderer);
+        renderer.UseShader(Graphics::DefaultShader());
+        renderer.Flush();
+        runner.Assert(batch.GetDrawCount() == 2, "The meshes should be merged by material!");
+        runner.Assert(backend.CountCommands("DrawElements") == 2, "Expected 2 draws, got " + std::to_string(backend.CountCommands("DrawElements")));
+
+        // Removing the last mesh of a material removes its draw
+        for (int i = 60; i < 100; i++)
+            batch.RemoveChild(60);
+
+        backend.ClearCommands();
+        renderer.BeginFrame();
+        batch.DrawBatches(renderer);
+        renderer.Flush();
+        runner.Assert(batch.GetDrawCount() == 1 && backend.CountCommands("DrawElements") == 1, "The batch should only draw what is left!");
+    });
+
+    runner.addTest("Batch Sprites By Texture", []() {
+        // A 2x2 image the textures can load from the working directory
+        std::ofstream("sprite.ppm", std::ios::binary).write("P6 2 2 255\n\xff\x00\x00\x00\xff\x00\x00\x00\xff\xff\xff\xff", 23);
+
+        Graphics::Renderer& renderer = GetRenderer();
+        Graphics::Texture first("sprite.ppm");
+        Graphics::Texture second("sprite.ppm");
+        Graphics::SpriteBatch batch;
+
+        // Sprites sharing a depth share a draw, whatever order they come in
+        backend.drawSizes.clear();
+        renderer.BeginFrame();
+        batch.Begin();
+        for (int i = 0; i < 10; i++) {
+            Graphics::Sprite sprite;
+            sprite.Position = {(float)i * 0.01f, 0};
+            sprite.Depth = 10;
+            batch.Draw(i % 2 == 0 ? first : second, sprite);
+        }
+        batch.End(renderer);
+        renderer.Flush();
+
+        runner.Assert(batch.GetDrawCount() == 2, "Expected 2 draws, got " + std::to_string(batch.GetDrawCount()));
+        runner.Assert(backend.drawSizes == std::vector<int>{30, 30}, "Each texture should draw its 5 sprites at once!");
+
+        // Sprites are drawn back to front, even if it splits the textures
+        backend.drawSizes.clear();
+        renderer.BeginFrame();
+        batch.Begin();
+        const float depths[] = {10, 30, 20, 10};
+        for (int i = 0; i < 4; i++) {
+            Graphics::Sprite sprite;
+            sprite.Depth = depths[i];
+            sprite.Size = {(float)(i + 1), 1};
+            batch.Draw(i == 2 ? second : first, sprite);
+        }
+        batch.End(renderer);
+        renderer.Flush();
+
+        runner.Assert(batch.GetDrawCount() == 3, "Expected 3 draws, got " + std::to_string(batch.GetDrawCount()));
+        runner.Assert(backend.drawSizes == std::vector<int>{6, 6, 12}, "The sprites should be drawn back to front!");
+
+        std::remove("sprite.ppm");
+    });
+
+    runner.addTest("Skip Texture Arrays Without Layers", []() {
+        Graphics::TextureArray missing({"missing0.png", "missing1.png"});
+
+        backend.ClearCommands();
+        runner.Assert(missing.GetTexture() == 0, "A texture array without layers should not be used!");
+        runner.Assert(backend.CountCommands("DeleteTextures") == 1, "The texture should be deleted!");
+        runner.Assert(missing.GetTexture() == 0 && backend.CountCommands("CreateTexture") == 1, "The layers should not be loaded again!");
+    });
+
+    runner.addTest("Record The Same Draws On Threads", []() {
+        Graphics::Renderer& renderer = GetRenderer();
+        Graphics::Material material(&Graphics::DefaultShader());
+        float size[2] = {5.0f, 6.0f};
+        material.CreateParameter("u_Window", Graphics::VEC2);
+        material.SetParameter("u_Window", size);
+
+        ParallelGroup group("Group");
+        for (int i = 0; i < 100; i++)
+            group.AddChild(new Tile({(float)(i % 10) * 0.01f, (float)(i / 10) * 0.01f, 10.0f + i * 0.1f}));
+
+        // The children draw with the state set before the group, and the
+        // draw after the group with the state left by the children
+        auto record = [&](unsigned threadCount) {
+            group.SetThreadCount(threadCount);
+            backend.ClearCommands();
+            renderer.BeginFrame();
+            renderer.UseMaterial(&material);
+            renderer.SetLayer(2);
+            group.DrawChildren(renderer);
+            renderer.DrawMesh(&quad, {0.0f, 0.0f, 5.0f});
+            renderer.SetLayer(0);
+            renderer.UseShader(Graphics::DefaultShader());
+            renderer.Flush();
+
+            std::vector<std::string> calls;
+            for (const Graphics::RecordedCommand& command : backend.GetCommands())
+                calls.push_back(std::string(command.name) + " " + std::to_string(command.payloadSize));
+            return calls;
+        };
+
+        record(1);
+        std::vector<std::string> sequential = record(1);
+        runner.Assert(record(4) == sequential, "The threads should record the same draws as one thread!");
+        runner.Assert(record(4) == sequential, "The workers should record the same draws in the next frame!");
+        runner.Assert(record(3) == sequential, "The workers should record the same draws once restarted!");
+    });
+
+    runner.addTest("Cull Meshes Outside Of The View", []() {
+        Graphics::Renderer& renderer = GetRenderer();
+        std::vector<Transform> instances(10);
+        for (size_t i = 0; i < instances.size(); i++)
+            instances[i].Position = {100.0f, (float)i, 10.0f};
+
+        backend.ClearCommands();
+        renderer.BeginFrame();
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, 10.0f});
+        renderer.DrawMesh(&quad, {100.0f, 0.0f, 10.0f});
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, -50.0f});
+        renderer.DrawMeshInstanced(&quad, instances);
+        renderer.Flush();
+
+        runner.Assert(backend.CountCommands("DrawElements") == 1, "Only the mesh in front of the camera should be drawn!");
+        runner.Assert(backend.CountCommands("DrawElementsInstanced") == 1, "Instanced draws should not be culled!");
+        runner.Assert(renderer.GetCulledCount() == 2, "Expected 2 culled draws, got " + std::to_string(renderer.GetCulledCount()));
+
+        backend.ClearCommands();
+        renderer.SetFrustumCulling(false);
+        renderer.BeginFrame();
+        renderer.DrawMesh(&quad, {100.0f, 0.0f, 10.0f});
+        renderer.Flush();
+        renderer.SetFrustumCulling(true);
+        runner.Assert(backend.CountCommands("DrawElements") == 1, "Culling should be disabled!");
+    });
+
+    runner.addTest("Cull Meshes Behind Occluders", []() {
+        // A wall over the middle of the view, close to the camera
+        Graphics::Renderer& renderer = GetRenderer();
+        float wall[16];
+        ComposeTransform({{0, 0, 5}, {0.5f, 0.5f, 1}}, wall);
+
+        backend.ClearCommands();
+        renderer.BeginFrame();
+        renderer.DrawMesh(&quad, wall);
+        renderer.AddOccluder(&quad, wall);
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, 50.0f}, {0.2f, 0.2f, 1.0f});
+        renderer.DrawMesh(&quad, {0.6f, 0.0f, 50.0f}, {0.2f, 0.2f, 1.0f});
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, 2.0f}, {0.2f, 0.2f, 1.0f});
+        renderer.Flush();
+
+        runner.Assert(renderer.GetOccludedCount() == 1, "Expected 1 hidden draw, got " + std::to_string(renderer.GetOccludedCount()));
+        runner.Assert(backend.CountCommands("DrawElements") == 3, "The wall, the mesh past its edge and the mesh in front should be drawn!");
+
+        // The depth pyramid keeps the furthest depth, so a box over the edge
+        // of the wall is never hidden
+        Graphics::OcclusionBuffer& occlusion = renderer.GetOcclusionBuffer();
+        runner.Assert(occlusion.IsOccluded({{-0.4f, -0.4f, 20}, {0.4f, 0.4f, 30}}), "A box behind the wall should be hidden!");
+        runner.Assert(!occlusion.IsOccluded({{-0.4f, -0.4f, 20}, {0.55f, 0.4f, 30}}), "A box past the edge of the wall should be visible!");
+        runner.Assert(!occlusion.IsOccluded({{-0.4f, -0.4f, 4}, {0.4f, 0.4f, 30}}), "A box crossing the wall should be visible!");
+
+        // Without occluders the next frame draws everything
+        backend.ClearCommands();
+        renderer.BeginFrame();
+        renderer.DrawMesh(&quad, {0.0f, 0.0f, 50.0f}, {0.2f, 0.2f, 1.0f});
+        renderer.Flush();
+        runner.Assert(renderer.GetOccludedCount() == 0 && backend.CountCommands("DrawElements") == 1, "Occluders should only last one frame!");
+    });
+
+    runner.addTest("Benchmark Occlusion Culling 10000 Draws", []() {
+        // A city block behind a wall, where frustum culling keeps every draw
+        Graphics::Renderer& renderer = GetRenderer();
+        float wall[16];
+        ComposeTransform({{0, 0, 5}, {1.5f, 1.5f, 1}}, wall);
+
+        backend.ClearCommands();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 10; frame++) {
+            renderer.BeginFrame();
+            renderer.DrawMesh(&quad, wall);
+            renderer.AddOccluder(&quad, wall);
+            for (unsigned i = 0; i < 10000; i++)
+                renderer.DrawMesh(&quad, {(float)(i % 100) * 0.02f - 1.0f, (float)(i / 100) * 0.02f - 1.0f, 20.0f + (float)(i % 7)}, {0.01f, 0.01f, 1.0f});
+            renderer.Flush();
+        }
+        double time = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / 10;
+
+        runner.DebugLog(std::to_string(renderer.GetOccludedCount()) + " of 10000 draws hidden, " + std::to_string(time) + "us per frame");
+        runner.Assert(renderer.GetCulledCount() == 0 && renderer.GetOccludedCount() == 10000, "Every draw behind the wall should be hidden!");
+        runner.Assert(backend.CountCommands("DrawElements") == 10, "Only the wall should be drawn!");
+    });
+
+    runner.addTest("Benchmark Culling 10000 Draws", []() {
+        // A large level where only the mesh at the origin is in view
+        Graphics::Renderer& renderer = GetRenderer();
+        backend.ClearCommands();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 10; frame++) {
+            renderer.BeginFrame();
+            for (unsigned i = 0; i < 10000; i++)
+                renderer.DrawMesh(&quad, {(float)(i % 100) * 4.0f - 200.0f, (float)(i / 100) * 4.0f, 10.0f});
+            renderer.Flush();
+        }
+        double time = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / 10;
+
+        runner.DebugLog(std::to_string(renderer.GetCulledCount()) + " of 10000 draws culled, " + std::to_string(time) + "us per frame");
+        runner.Assert(backend.CountCommands("DrawElements") == 10 * (10000 - renderer.GetCulledCount()), "The culled draws were executed!");
+        runner.Assert(renderer.GetCulledCount() > 9900, "Most draws should be culled!");
+    });
+
+    runner.addTest("Benchmark 10000 Draws", []() {
+        backend.ClearCommands();
+        for (int frame = 0; frame < 10; frame++)
+            DrawFrame(10000);
+
+        runner.DebugLog(std::to_string(backend.GetCommandCount() / 10) + " backend calls and " + std::to_string(backend.GetPayloadSize() / 10) + " bytes per frame");
+        runner.Assert(backend.CountCommands("DrawElements") == 100000, "Every mesh should be drawn once!");
+    });
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <Testing.hpp>
+#include <Graphics/Renderer.hpp>
+#include <Graphics/SoftwareBackend.hpp>
+#include <Graphics/StateCache.hpp>
+#include <algorithm>
+
+using namespace Engine;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("Software Renderer Tests")};
+Graphics::SoftwareBackend backend;
+
+class QuadMesh : public Graphics::Mesh {
+    public:
+    QuadMesh() {
+        AddQuad({-1, -1, 0, 0, 0}, {1, -1, 0, 1, 0}, {1, 1, 0, 1, 1}, {-1, 1, 0, 0, 1});
+    }
+};
+
+QuadMesh quad;
+
+// A triangle whose right corner is far outside of the guard band, with its
+// top edge through the center of the canvas
+class FarMesh : public Graphics::Mesh {
+    public:
+    FarMesh() {
+        AddTriangle({-1, 0.5f, 0, 0, 0}, {-1, -1, 0, 0, 1}, {100000, -50000, 0, 1, 0});
+    }
+};
+
+FarMesh far;
+
+Graphics::Renderer& GetRenderer() {
+    static Graphics::Renderer renderer;
+    return renderer;
+}
+
+// The quads are 120 pixels wide on a 320 x 240 canvas, at (100, 60)
+void DrawQuads(std::initializer_list<Vec3f> positions, Vec3f rotation = {0, 0, 0}) {
+    Graphics::Renderer& renderer = GetRenderer();
+    renderer.ClearBuffer();
+    renderer.BeginFrame();
+    for (Vec3f position : positions)
+        renderer.DrawMesh(&quad, position, {0.5f, 0.5f, 1.0f}, rotation);
+    renderer.Flush();
+}
+
+unsigned OverdrawAt(int x, int y) {
+    return backend.GetOverdrawBuffer()[y * backend.GetWidth() + x];
+}
+
+int main() {
+    backend.SetCanvasSize(320, 240);
+    Graphics::SetBackend(backend);
+
+    runner.addTest("Rasterize A Quad", []() {
+        DrawQuads({{0.0f, 0.0f, 10.0f}});
+
+        const Graphics::RasterStats& stats = backend.GetStats();
+        runner.Assert(stats.triangles == 2, "Expected 2 triangles, got " + std::to_string(stats.triangles));
+        runner.Assert(stats.shadedFragments == 120 * 120, "Expected 14400 fragments, got " + std::to_string(stats.shadedFragments));
+
+        // The pixels on the shared edge belong to a single triangle
+        const std::vector<unsigned>& overdraw = backend.GetOverdrawBuffer();
+        runner.Assert(*std::max_element(overdraw.begin(), overdraw.end()) == 1, "A pixel was shaded twice!");
+        runner.Assert(OverdrawAt(100, 60) == 1 && OverdrawAt(219, 179) == 1, "The corners of the quad were not drawn!");
+        runner.Assert(OverdrawAt(99, 60) == 0 && OverdrawAt(220, 179) == 0, "Pixels outside of the quad were drawn!");
+    });
+
+    runner.addTest("Clear The Buffers", []() {
+        DrawQuads({});
+
+        const std::vector<unsigned char>& color = backend.GetColorBuffer();
+        runner.Assert(color[0] == 24 && color[3] == 255, "The color buffer was not cleared to the clear color!");
+        runner.Assert(backend.GetDepthBuffer()[0] == 1.0f, "The depth buffer was not cleared!");
+        runner.Assert(backend.GetStats().shadedFragments == 0, "The stats were not reset!");
+    });
+
+    runner.addTest("Test Depth", []() {
+        // The far quad is hidden by the near quad drawn before it
+        DrawQuads({{0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 50.0f}});
+        runner.Assert(backend.GetStats().fragments == 2 * 120 * 120, "Both quads should be rasterized!");
+        runner.Assert(backend.GetStats().shadedFragments == 120 * 120, "The hidden quad should fail the depth test!");
+
+        float nearDepth = backend.GetDepthBuffer()[120 * 320 + 160];
+        DrawQuads({{0.0f, 0.0f, 50.0f}});
+        float farDepth = backend.GetDepthBuffer()[120 * 320 + 160];
+        runner.Assert(nearDepth < farDepth, "The near quad should be closer!");
+    });
+
+    runner.addTest("Sort Opaque Draws", []() {
+        // Submitted from back to front, the quads are drawn from front to back
+        DrawQuads({{0.0f, 0.0f, 50.0f}, {0.0f, 0.0f, 10.0f}});
+        runner.Assert(backend.GetStats().fragments == 2 * 120 * 120, "Both quads should be rasterized!");
+        runner.Assert(OverdrawAt(160, 120) == 1, "The far quad should not be shaded!");
+    });
+
+    runner.addTest("Measure Overdraw", []() {
+        // Without the depth test, every quad is shaded
+        Graphics::GetStateCache().SetDepthTest(false);
+        DrawQuads({{0.0f, 0.0f, 50.0f}, {0.0f, 0.0f, 10.0f}});
+        Graphics::GetStateCache().SetDepthTest(true);
+
+        runner.Assert(backend.GetStats().shadedFragments == 2 * 120 * 120, "Both quads should be shaded!");
+        runner.Assert(OverdrawAt(160, 120) == 2, "The center should be shaded twice!");
+    });
+
+    runner.addTest("Cull Back Faces", []() {
+        DrawQuads({{0.0f, 0.0f, 10.0f}}, {0.0f, 180.0f, 0.0f});
+        runner.Assert(backend.GetStats().culledTriangles == 2, "The back of the quad should be culled!");
+        runner.Assert(backend.GetStats().shadedFragments == 0, "Culled triangles were drawn!");
+    });
+
+    runner.addTest("Clip Triangles Behind The Near Plane", []() {
+        // Without frustum culling, the quad behind the camera reaches the backend
+        GetRenderer().SetFrustumCulling(false);
+        DrawQuads({{0.0f, 0.0f, -10.0f}});
+        GetRenderer().SetFrustumCulling(true);
+        runner.Assert(backend.GetStats().triangles == 0, "The quad behind the camera should be clipped!");
+
+        // Tilted through the near plane, the front half of the quad is left
+        DrawQuads({{0.0f, 0.0f, 0.0f}}, {45.0f, 0.0f, 0.0f});
+        runner.Assert(backend.GetStats().triangles == 2, "The quad crossing the near plane should be clipped, not dropped!");
+        runner.Assert(backend.GetStats().shadedFragments > 0, "The front of the quad should be drawn!");
+        runner.Assert(backend.GetStats().fragments == backend.GetStats().shadedFragments, "Clipped fragments should not be rasterized!");
+    });
+
+    runner.addTest("Clip Triangles To The Guard Band", []() {
+        Graphics::Renderer& renderer = GetRenderer();
+        renderer.ClearBuffer();
+        renderer.BeginFrame();
+        renderer.DrawMesh(&far, {0.0f, 0.0f, 10.0f}, {1.0f, 1.0f, 1.0f});
+        renderer.Flush();
+
+        // The top edge keeps its slope of -1/2, and crosses x = 220 at y = 90
+        runner.Assert(backend.GetStats().triangles == 1, "The triangle should be drawn!");
+        runner.Assert(OverdrawAt(220, 85) == 1 && OverdrawAt(300, 45) == 1, "The pixels under the top edge should be drawn!");
+        runner.Assert(OverdrawAt(220, 95) == 0 && OverdrawAt(300, 55) == 0, "The top edge should not move!");
+    });
+
+    runner.addTest("Benchmark 100 Full Quads", []() {
+        Graphics::GetStateCache().SetDepthTest(false);
+        Graphics::Renderer& renderer = GetRenderer();
+        renderer.ClearBuffer();
+        renderer.BeginFrame();
+        for (int i = 0; i < 100; i++)
+            renderer.DrawMesh(&quad, {0.0f, 0.0f, 10.0f + i * 0.5f}, {2.0f, 2.0f, 1.0f});
+        renderer.Flush();
+        Graphics::GetStateCache().SetDepthTest(true);
+
+        float overdraw = (float)backend.GetStats().shadedFragments / (320 * 240);
+        runner.DebugLog(std::to_string(backend.GetStats().shadedFragments) + " fragments shaded, " + std::to_string(overdraw) + " per pixel");
+        runner.Assert(OverdrawAt(160, 120) == 100, "Every quad should be shaded over the last one!");
+    });
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+#include <Testing.hpp>
+#include <GameObject.hpp>
+#include <Spatial/DynamicBVH.hpp>
+#include <Spatial/SceneIndex.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace Engine;
+using namespace Engine::Spatial;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("Spatial Tests")};
+
+// A game object with a box of 1 around its position
+class BoxObject : public GameObject {
+    public:
+    BoxObject(std::string name) : GameObject(name) {}
+
+    BoundingBox GetLocalBounds() override {
+        return {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}};
+    }
+};
+
+// A game object whose box can grow, starting without one
+class GrowingObject : public GameObject {
+    public:
+    float size = 0;
+
+    GrowingObject(std::string name) : GameObject(name) {}
+
+    BoundingBox GetLocalBounds() override {
+        if (size == 0)
+            return BoundingBox::Empty();
+        return {{-size, -size, -size}, {size, size, size}};
+    }
+};
+
+// Boxes of varying sizes scattered over a cube of 100
+std::vector<BoundingBox> RandomBoxes(size_t count) {
+    std::vector<BoundingBox> boxes;
+    uint32_t seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1664525 + 1013904223;
+        return (float)(seed >> 8) / (float)(1 << 24);
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        Vec3f center = {next() * 100, next() * 100, next() * 100};
+        Vec3f extents = {0.1f + next(), 0.1f + next(), 0.1f + next()};
+        boxes.push_back({center - extents, center + extents});
+    }
+    return boxes;
+}
+
+std::vector<uint32_t> Sorted(std::vector<uint32_t> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+double Microseconds(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main() {
+    runner.addTest("Query Boxes Like A Linear Scan", []() {
+        std::vector<BoundingBox> boxes = RandomBoxes(500);
+        DynamicBVH tree(0.0f);
+        for (size_t i = 0; i < boxes.size(); i++)
+            tree.CreateProxy(boxes[i], i);
+
+        BoundingBox query = {{20, 20, 20}, {45, 40, 60}};
+        std::vector<uint32_t> found, expected;
+        tree.Query(query, [&](int32_t proxy) {
+            found.push_back(tree.GetUserData(proxy));
+            return true;
+        });
+        for (size_t i = 0; i < boxes.size(); i++)
+            if (boxes[i].Overlaps(query))
+                expected.push_back(i);
+
+        runner.Assert(!expected.empty(), "The query should overlap some boxes!");
+        runner.Assert(Sorted(found) == expected, "Found " + std::to_string(found.size()) + " boxes, expected " + std::to_string(expected.size()));
+
+        // Frustum of an orthographic camera seeing x, y in [0, 50] and z in [0, 100]
+        Mat4f projection = Mat4f::Scaling({1.0f / 25, 1.0f / 25, 1.0f / 50}) * Mat4f::Translation({-25, -25, -50});
+        Graphics::Frustum frustum(projection.m);
+        found.clear();
+        expected.clear();
+        tree.Query(frustum, [&](int32_t proxy) {
+            found.push_back(tree.GetUserData(proxy));
+            return true;
+        });
+        for (size_t i = 0; i < boxes.size(); i++)
+            if (frustum.IsVisible(boxes[i]))
+                expected.push_back(i);
+
+        runner.Assert(Sorted(found) == expected, "Found " + std::to_string(found.size()) + " boxes in the frustum, expected " + std::to_string(expected.size()));
+    });
+
+    runner.addTest("Ray Cast And Find The Nearest Box", []() {
+        std::vector<BoundingBox> boxes = RandomBoxes(500);
+        DynamicBVH tree;
+        for (size_t i = 0; i < boxes.size(); i++)
+            tree.CreateProxy(boxes[i], i);
+
+        for (int ray = 0; ray < 20; ray++) {
+            Vec3f origin = {-10, (float)ray * 5, (float)ray * 4 + 5};
+            Vec3f direction = {1, 0.05f, 0.1f};
+            Vec3f inverse = {1 / direction.x, 1 / direction.y, 1 / direction.z};
+            float length = direction.length();
+
+            // The distances along the normalized direction
+            float expected = INFINITY;
+            for (const BoundingBox& box : boxes)
+                expected = fminf(expected, box.RayDistance(origin, inverse, 200 / length) * length);
+
+            float closest = INFINITY;
+            Vec3f unitInverse = inverse * length;
+            tree.RayCast(origin, direction, 200, [&](int32_t proxy, float maxDistance) {
+                float distance = boxes[tree.GetUserData(proxy)].RayDistance(origin, unitInverse, maxDistance);
+                if (distance == INFINITY)
+                    return maxDistance;
+                closest = fminf(closest, distance);
+                return distance;
+            });
+
+            runner.Assert(closest == expected || fabsf(closest - expected) < 1e-3f, "Ray " + std::to_string(ray) + " hit at " + std::to_string(closest) + ", expected " + std::to_string(expected));
+        }
+
+        for (int point = 0; point < 20; point++) {
+            Vec3f p = {(float)point * 6 - 10, 50, (float)(point % 7) * 20};
+            size_t expected = 0;
+            for (size_t i = 1; i < boxes.size(); i++)
+                if (boxes[i].DistanceSquared(p) < boxes[expected].DistanceSquared(p))
+                    expected = i;
+
+            int32_t nearest = tree.FindNearest(p, [&](int32_t proxy) {
+                return boxes[tree.GetUserData(proxy)].DistanceSquared(p);
+            });
+            runner.Assert(nearest != NULL_NODE && boxes[tree.GetUserData(nearest)].DistanceSquared(p) == boxes[expected].DistanceSquared(p), "Wrong nearest box for point " + std::to_string(point));
+        }
+
+        runner.Assert(tree.FindNearest({500, 500, 500}, [&](int32_t proxy) { return boxes[tree.GetUserData(proxy)].DistanceSquared({500, 500, 500}); }, 10) == NULL_NODE, "Nothing should be found past the max distance!");
+    });
+
+    runner.addTest("Stay Balanced While Boxes Move", []() {
+        // Boxes added in order would make a list without rotations
+        DynamicBVH tree;
+        std::vector<int32_t> proxies;
+        for (int i = 0; i < 1024; i++)
+            proxies.push_back(tree.CreateProxy({{(float)i, 0, 0}, {(float)i + 0.5f, 1, 1}}, i));
+
+        runner.Assert(tree.GetHeight() <= 20, "The tree is too deep: " + std::to_string(tree.GetHeight()));
+
+        // Small moves stay inside the fat boxes
+        runner.Assert(!tree.MoveProxy(proxies[11], {{11.05f, 0, 0}, {11.55f, 1, 1}}, {0.05f, 0, 0}), "A small move should not change the tree!");
+        runner.Assert(tree.MoveProxy(proxies[11], {{600, 0, 0}, {600.5f, 1, 1}}, {590, 0, 0}), "A large move should reinsert the box!");
+
+        for (int i = 0; i < 1024; i += 2)
+            tree.DestroyProxy(proxies[i]);
+
+        bool found = false;
+        tree.Query({{599, -1, -1}, {602, 2, 2}}, [&](int32_t proxy) {
+            found = tree.GetUserData(proxy) == 11;
+            return !found;
+        });
+        runner.Assert(tree.GetProxyCount() == 512 && tree.GetHeight() <= 20, "Wrong tree after removing half of the boxes!");
+        runner.Assert(found, "The moved box should be found at its new place!");
+    });
+
+    runner.addTest("Track Game Objects", []() {
+        SceneIndex& index = GetSceneIndex();
+        size_t before = index.GetObjectCount();
+        {
+            Scene scene("Scene");
+            BoxObject* a = new BoxObject("A");
+            BoxObject* b = new BoxObject("B");
+            GameObject* empty = new GameObject("Empty");
+            scene.AddChild(a);
+            scene.AddChild(empty);
+            empty->AddChild(b);
+            a->SetPosition({10, 0, 0});
+            empty->SetPosition({0, 20, 0});
+            index.Update();
+
+            runner.Assert(index.IsTracked(a) && index.IsTracked(b) && !index.IsTracked(empty), "Only the objects with bounds should be tracked!");
+
+            std::vector<GameObject*> found;
+            index.QueryBox({{9, -1, -1}, {11, 1, 1}}, found);
+            runner.Assert(found.size() == 1 && found[0] == a, "The box should only find A!");
+
+            // Moving the parent moves the box of its child
+            empty->SetPosition({50, 0, 0});
+            index.Update();
+            SceneIndex::RayHit hit = index.RayCast({0, 0, 0}, {1, 0, 0}, 100);
+            runner.Assert(hit.object == a && fabsf(hit.distance - 9.5f) < 1e-4f, "The ray should hit A first!");
+            hit = index.RayCast({20, 0, 0}, {2, 0, 0}, 100);
+            runner.Assert(hit.object == b && fabsf(hit.distance - 29.5f) < 1e-4f, "The ray should hit B at its new place!");
+            runner.Assert(index.FindNearest({45, 3, 0}) == b, "B should be the nearest object!");
+            runner.Assert(index.RayCast({0, 5, 0}, {1, 0, 0}, 100).object == nullptr, "The ray should miss!");
+        }
+
+        runner.Assert(index.GetObjectCount() == before, "Destroyed objects should be untracked!");
+    });
+
+    runner.addTest("Track Objects Once They Have Bounds", []() {
+        SceneIndex& index = GetSceneIndex();
+        Scene scene("Scene");
+        GrowingObject* object = new GrowingObject("Growing");
+        scene.AddChild(object);
+        index.Update();
+        runner.Assert(!index.IsTracked(object), "An object without bounds should not be tracked!");
+
+        object->size = 1;
+        index.Update();
+        runner.Assert(index.IsTracked(object), "The object should be tracked once it has bounds!");
+
+        // Only moves refit the boxes, bounds that grow need a refit
+        std::vector<GameObject*> found;
+        object->size = 5;
+        index.Update();
+        index.QueryBox({{3, 3, 3}, {4, 4, 4}}, found);
+        runner.Assert(found.empty(), "An object that did not move should keep its box!");
+        index.Refit(object);
+        index.QueryBox({{3, 3, 3}, {4, 4, 4}}, found);
+        runner.Assert(found.size() == 1 && found[0] == object, "The refit box should be found!");
+
+        object->SetPosition({100, 0, 0});
+        index.Update();
+        runner.Assert(index.FindNearest({100, 0, 0}, 1) == object, "The moved object should be refit!");
+    });
+
+    runner.addTest("Filter Queries By Scene And State", []() {
+        SceneIndex& index = GetSceneIndex();
+        Scene first("First");
+        Scene second("Second");
+        GameObject* group = new GameObject("Group");
+        BoxObject* a = new BoxObject("A");
+        BoxObject* b = new BoxObject("B");
+        first.AddChild(group);
+        group->AddChild(a);
+        second.AddChild(b);
+        index.Update();
+
+        std::vector<GameObject*> found;
+        const BoundingBox box = {{-1, -1, -1}, {1, 1, 1}};
+        index.QueryBox(box, found);
+        runner.Assert(found.size() == 2, "Both scenes should be searched by default!");
+
+        found.clear();
+        index.QueryBox(box, found, &second);
+        runner.Assert(found.size() == 1 && found[0] == b, "Only the second scene should be searched!");
+        runner.Assert(index.RayCast({-10, 0, 0}, {1, 0, 0}, 100, &first).object == a, "The ray should only hit the first scene!");
+
+        // Disabling the parent hides its children
+        group->SetEnabled(false);
+        runner.Assert(index.FindNearest({0, 0, 0}, 10, &first) == nullptr, "Objects under a disabled node should be skipped!");
+
+        b->Destroy();
+        runner.Assert(index.RayCast({-10, 0, 0}, {1, 0, 0}, 100).object == nullptr, "Destroyed objects should be skipped!");
+        Node::FlushDestroyed();
+    });
+
+    runner.addTest("Benchmark Against A Linear Scan", []() {
+        const size_t count = 10000;
+        std::vector<BoundingBox> boxes = RandomBoxes(count);
+        DynamicBVH tree;
+        for (size_t i = 0; i < count; i++)
+            tree.CreateProxy(boxes[i], i);
+
+        size_t scanned = 0, queried = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int q = 0; q < 100; q++) {
+            BoundingBox query = {{(float)q, 40, 40}, {(float)q + 5, 45, 45}};
+            for (const BoundingBox& box : boxes)
+                scanned += box.Overlaps(query);
+        }
+        double scanTime = Microseconds(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int q = 0; q < 100; q++) {
+            BoundingBox query = {{(float)q, 40, 40}, {(float)q + 5, 45, 45}};
+            tree.Query(query, [&](int32_t proxy) {
+                queried += boxes[tree.GetUserData(proxy)].Overlaps(query);
+                return true;
+            });
+        }
+        double treeTime = Microseconds(start);
+
+        runner.DebugLog("100 queries over 10000 boxes: " + std::to_string(scanTime) + "us scanning, " + std::to_string(treeTime) + "us with the tree of height " + std::to_string(tree.GetHeight()));
+        runner.Assert(scanned == queried, "Found " + std::to_string(queried) + " boxes, expected " + std::to_string(scanned));
+    });
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <Testing.hpp>
+#include <StringId.hpp>
+#include <FlatHashMap.hpp>
+#include <Node.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+using namespace Engine::Literals;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("StringId Tests")};
+
+int main() {
+    runner.addTest("Match Ids From Any Copy Of A String", []() {
+        constexpr StringId literal = "Player"_id;
+        static_assert(literal.GetHash() == StringId("Player").GetHash(), "Literals should hash at compile time!");
+
+        std::string name = "Play";
+        name += "er";
+        runner.Assert(StringId(name) == literal && StringId(name.c_str()) == literal, "Ids of equal strings should be equal!");
+        runner.Assert(!(StringId("player") == literal), "Ids of different strings should differ!");
+    });
+
+    runner.addTest("Keep Interned Strings", []() {
+        runner.Assert(std::string(StringId("Never Interned").c_str()).empty(), "An id that was never interned has no string!");
+
+        std::string name = "Enemy";
+        StringId id = StringId::Intern(name);
+        name = "Changed";
+        runner.Assert(std::string(id.c_str()) == "Enemy" && id.c_str() == StringId::Intern("Enemy").c_str(), "The string should be stored once!");
+
+        Node node("Boss");
+        runner.Assert(node.m_name == "Boss"_id && std::string(node.m_name.c_str()) == "Boss", "Node names should be interned!");
+    });
+
+    runner.addTest("Find Keys In A Flat Hash Map", []() {
+        FlatHashMap<StringId, int> map;
+        std::vector<std::string> keys;
+        for (int i = 0; i < 1000; i++)
+            keys.push_back("Key" + std::to_string(i));
+
+        for (int i = 0; i < 1000; i++)
+            map[keys[i]] = i;
+        runner.Assert(map.Size() == 1000 && !map.Emplace(keys[5], 0).second, "Every key should be inserted once!");
+
+        // Erasing shifts the collided keys back, they must stay reachable
+        for (int i = 0; i < 1000; i += 3)
+            runner.Assert(map.Erase(keys[i]), "The key should be erased!");
+
+        bool found = true;
+        for (int i = 0; i < 1000; i++) {
+            int* value = map.Find(keys[i]);
+            found &= i % 3 == 0 ? value == nullptr : value != nullptr && *value == i;
+        }
+        runner.Assert(found && map.Size() == 666, "Only the erased keys should be gone!");
+
+        size_t count = 0;
+        for (auto& [key, value] : map)
+            count += value % 3 != 0;
+        runner.Assert(count == 666, "Iteration should visit every entry!");
+
+        FlatHashMap<StringId, std::unique_ptr<int>> owners;
+        owners.Emplace("Arena", std::make_unique<int>(3));
+        runner.Assert(**owners.Find("Arena") == 3 && owners.Erase("Arena") && owners.Empty(), "Values may be move only!");
+    });
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <Testing.hpp>
+#include <GameObject.hpp>
+#include <TransformPool.hpp>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace Engine;
+
+Testing::TestRunner& runner{Testing::TestRunner::getInstance("Transform Tests")};
+TransformPool& pool{GetTransformPool()};
+
+bool Near(Vec3f a, Vec3f b) {
+    return fabsf(a.x - b.x) < 1e-4f && fabsf(a.y - b.y) < 1e-4f && fabsf(a.z - b.z) < 1e-4f;
+}
+
+std::string ToString(Vec3f v) {
+    return "<" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ">";
+}
+
+int main() {
+    runner.addTest("Inherit The Parent Transform", []() {
+        Scene scene("Scene");
+        GameObject* parent = new GameObject("Parent");
+        GameObject* child = new GameObject("Child");
+        scene.AddChild(parent);
+        parent->AddChild(child);
+
+        parent->SetPosition({10, 0, 0});
+        parent->SetEulerRotation({0, 0, 90});
+        parent->SetScale({2, 2, 2});
+        child->SetPosition({1, 0, 0});
+        pool.Update();
+
+        runner.Assert(Near(child->GetGlobalPosition(), {10, 2, 0}), "Expected <10, 2, 0>, got " + ToString(child->GetGlobalPosition()));
+        runner.Assert(Near(child->GetGlobalEulerRotation(), {0, 0, 90}), "Expected <0, 0, 90>, got " + ToString(child->GetGlobalEulerRotation()));
+        runner.Assert(Near(child->GetPosition(), {1, 0, 0}), "The local position should not change!");
+    });
+
+    runner.addTest("Rotate With Quaternions", []() {
+        Scene scene("Scene");
+        GameObject* parent = new GameObject("Parent");
+        GameObject* child = new GameObject("Child");
+        scene.AddChild(parent);
+        parent->AddChild(child);
+        child->SetPosition({1, 0, 0});
+
+        // Two quarter turns around y, then halfway back with slerp
+        parent->Rotate(Quatf::FromAxisAngle({0, 1, 0}, 90));
+        parent->Rotate(Quatf::FromAxisAngle({0, 1, 0}, 90));
+        runner.Assert(Near(child->GetGlobalPosition(), {-1, 0, 0}), "Expected <-1, 0, 0>, got " + ToString(child->GetGlobalPosition()));
+
+        parent->SetRotation(Slerp(Quatf::Identity(), parent->GetRotation(), 0.5f));
+        runner.Assert(Near(child->GetGlobalPosition(), {0, 0, -1}), "Expected <0, 0, -1>, got " + ToString(child->GetGlobalPosition()));
+        runner.Assert(Near(parent->GetEulerRotation(), {0, 90, 0}), "Expected <0, 90, 0>, got " + ToString(parent->GetEulerRotation()));
+    });
+
+    runner.addTest("Recompute Moved Objects Without An Update", []() {
+        Scene scene("Scene");
+        GameObject* parent = new GameObject("Parent");
+        GameObject* child = new GameObject("Child");
+        scene.AddChild(parent);
+        parent->AddChild(child);
+        pool.Update();
+
+        parent->SetPosition({0, 5, 0});
+        runner.Assert(Near(child->GetGlobalPosition(), {0, 5, 0}), "The child did not follow its parent!");
+    });
+
+    runner.addTest("Skip Objects That Did Not Move", []() {
+        Scene scene("Scene");
+        GameObject* moving = new GameObject("Moving");
+        GameObject* still = new GameObject("Still");
+        scene.AddChild(moving);
+        scene.AddChild(still);
+        moving->AddChild(new GameObject("MovingChild"));
+        still->AddChild(new GameObject("StillChild"));
+        pool.Update();
+
+        moving->SetPosition({1, 0, 0});
+        size_t recomputed = pool.Update();
+        runner.Assert(recomputed == 2, "Expected the moved object and its child to be recomputed, got " + std::to_string(recomputed));
+        runner.Assert(pool.Update() == 0, "Nothing should be recomputed once nothing moves!");
+    });
+
+    runner.addTest("Sort Parents Before Children", []() {
+        // The child is created first, so its slot comes before its parent
+        Scene scene("Scene");
+        GameObject* child = new GameObject("Child");
+        GameObject* parent = new GameObject("Parent");
+        scene.AddChild(parent);
+        parent->AddChild(child);
+
+        parent->SetPosition({0, 0, 3});
+        child->SetPosition({1, 0, 0});
+        runner.Assert(Near(child->GetGlobalPosition(), {1, 0, 3}), "Expected <1, 0, 3>, got " + ToString(child->GetGlobalPosition()));
+    });
+
+    runner.addTest("Orphan The Children Of Destroyed Transforms", []() {
+        TransformHandle parent = pool.Create();
+        TransformHandle child = pool.Create();
+        pool.SetParent(child, parent);
+        pool.SetPosition(parent, {5, 0, 0});
+        pool.SetPosition(child, {1, 0, 0});
+        pool.Update();
+
+        size_t slots = pool.GetSlotCount();
+        pool.Destroy(parent);
+        const float* world = pool.GetWorldMatrix(child);
+        runner.Assert(world[12] == 1.0f, "The child should become a root!");
+        runner.Assert(pool.GetParent(child) == INVALID_TRANSFORM, "The child still has a parent!");
+        runner.Assert(pool.GetSlotCount() == slots - 1, "The slot of the destroyed transform was not freed!");
+        pool.Destroy(child);
+    });
+
+    runner.addTest("Benchmark 50000 Objects", []() {
+        Scene scene("Scene");
+        std::vector<GameObject*> objects;
+        for (int i = 0; i < 500; i++) {
+            GameObject* parent = new GameObject("Parent");
+            scene.AddChild(parent);
+            for (int j = 0; j < 99; j++) {
+                GameObject* child = new GameObject("Child");
+                child->SetPosition({(float)j, 0, 0});
+                parent->AddChild(child);
+                objects.push_back(child);
+            }
+            objects.push_back(parent);
+        }
+        pool.Update();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 100; frame++)
+            pool.Update();
+        auto still = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < 100; frame++) {
+            for (GameObject* object : objects)
+                object->SetEulerRotation({0, (float)frame, 0});
+            pool.Update();
+        }
+        auto moving = std::chrono::high_resolution_clock::now();
+
+        runner.DebugLog(std::to_string(std::chrono::duration<double, std::micro>(still - start).count() / 100) + "us per frame without moves, "
+            + std::to_string(std::chrono::duration<double, std::micro>(moving - still).count() / 100) + "us when everything moves");
+
+        // The second child is one unit along the x axis of its rotated parent
+        float angle = 99.0f * M_PI / 180.0f;
+        Vec3f expected = {cosf(angle), 0, -sinf(angle)};
+        runner.Assert(Near(objects[1]->GetGlobalPosition(), expected), "Expected " + ToString(expected) + ", got " + ToString(objects[1]->GetGlobalPosition()));
+    });
+
+    return 0;
+}
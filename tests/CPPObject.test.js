@@ -25,14 +25,30 @@ describe("Testing the CPPObject with src/engine/Game.cpp", () => {
 
     expect(deps).toStrictEqual([
       path.normalize("src/engine/Node.cpp"),
+      path.normalize("src/engine/SceneArena.cpp"),
+      path.normalize("src/engine/SceneTraversal.cpp"),
       path.normalize("src/engine/Graphics/Renderer.cpp"),
+      path.normalize("src/engine/TransformPool.cpp"),
+      path.normalize("src/engine/Spatial/SceneIndex.cpp"),
       path.normalize("src/engine/Utils.cpp"),
+      path.normalize("src/engine/NodePool.cpp"),
+      path.normalize("src/engine/StringId.cpp"),
       path.normalize("src/engine/Graphics/Mesh.cpp"),
       path.normalize("src/engine/Graphics/Shader.cpp"),
       path.normalize("src/engine/Graphics/Texture.cpp"),
       path.normalize("src/engine/Graphics/Material.cpp"),
+      path.normalize("src/engine/Graphics/RenderQueue.cpp"),
+      path.normalize("src/engine/Graphics/FrameConstants.cpp"),
+      path.normalize("src/engine/Graphics/CommandBuffer.cpp"),
       path.normalize("src/engine/GameObject.cpp"),
       path.normalize("src/engine/GameObjects/Camera.cpp"),
+      path.normalize("src/engine/Graphics/StateCache.cpp"),
+      path.normalize("src/engine/Graphics/Backend.cpp"),
+      path.normalize("src/engine/Graphics/GLBackend.cpp"),
+      path.normalize("src/engine/Graphics/RecordingBackend.cpp"),
+      path.normalize("src/engine/Spatial/DynamicBVH.cpp"),
+      path.normalize("src/engine/Graphics/Frustum.cpp"),
+      path.normalize("src/engine/Graphics/OcclusionBuffer.cpp"),
     ]);
   });
 });
@@ -48,6 +64,8 @@ describe("Testing the CPPObject with src/engine/UI/UIButton.cpp", () => {
       path.normalize("src/engine/UI/UIElement.cpp"),
       path.normalize("src/engine/Node.cpp"),
       path.normalize("src/engine/Utils.cpp"),
+      path.normalize("src/engine/NodePool.cpp"),
+      path.normalize("src/engine/StringId.cpp"),
     ]);
   });
 });
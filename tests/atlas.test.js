@@ -0,0 +1,99 @@
+const atlas = require("../src/atlas");
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+
+describe("Testing the atlas packer", () => {
+  test("Hash names with FNV-1a", () => {
+    expect(atlas.hashName("")).toBe(0x811c9dc5);
+    expect(atlas.hashName("a")).toBe(0xe40c292c);
+    expect(atlas.hashName("foobar")).toBe(0xbf9cf968);
+  });
+
+  test("Encode and decode a PNG", () => {
+    const pixels = Buffer.alloc(3 * 2 * 4);
+    for (let i = 0; i < pixels.length; i++) pixels[i] = (i * 37) & 0xff;
+
+    const image = atlas.decodePNG(atlas.encodePNG(3, 2, pixels));
+    expect(image.width).toBe(3);
+    expect(image.height).toBe(2);
+    expect(image.pixels.equals(pixels)).toBe(true);
+  });
+
+  test("Pack sprites without overlaps", () => {
+    let sprites = [];
+    for (let i = 0; i < 200; i++)
+      sprites.push({
+        name: `sprite${i}`,
+        width: 4 + ((i * 7) % 29),
+        height: 4 + ((i * 13) % 23),
+      });
+
+    const padding = 1;
+    const placements = atlas.packSprites(sprites, 128, padding);
+    expect(placements.length).toBe(sprites.length);
+
+    for (const a of placements) {
+      expect(a.x - padding).toBeGreaterThanOrEqual(0);
+      expect(a.y - padding).toBeGreaterThanOrEqual(0);
+      expect(a.x + a.width + padding).toBeLessThanOrEqual(128);
+      expect(a.y + a.height + padding).toBeLessThanOrEqual(128);
+
+      for (const b of placements) {
+        if (a == b || a.page != b.page) continue;
+        const overlaps =
+          a.x - padding < b.x + b.width + padding &&
+          b.x - padding < a.x + a.width + padding &&
+          a.y - padding < b.y + b.height + padding &&
+          b.y - padding < a.y + a.height + padding;
+        expect(overlaps).toBe(false);
+      }
+    }
+  });
+
+  test("Reject sprites bigger than a page", () => {
+    expect(() =>
+      atlas.packSprites([{ name: "big", width: 65, height: 8 }], 64),
+    ).toThrow();
+  });
+
+  test("Pack a folder into pages and a UV table", () => {
+    const folder = fs.mkdtempSync(path.join(os.tmpdir(), "atlas-"));
+    fs.mkdirSync(path.join(folder, "sprites", "player"), { recursive: true });
+
+    const red = Buffer.alloc(8 * 8 * 4);
+    for (let i = 0; i < red.length; i += 4) red.set([255, 0, 0, 255], i);
+    fs.writeFileSync(
+      path.join(folder, "sprites", "player", "idle.png"),
+      atlas.encodePNG(8, 8, red),
+    );
+    fs.writeFileSync(
+      path.join(folder, "sprites", "tile.png"),
+      atlas.encodePNG(16, 4, Buffer.alloc(16 * 4 * 4, 255)),
+    );
+
+    const output = path.join(folder, "out", "atlas");
+    const result = atlas.packAtlas(path.join(folder, "sprites"), output, {
+      pageSize: 32,
+      padding: 1,
+    });
+    expect(result).toStrictEqual({ pages: 1, sprites: 2 });
+
+    const table = atlas.readTable(fs.readFileSync(output + ".catl"));
+    expect(table.pages).toStrictEqual([{ width: 32, height: 32 }]);
+
+    const idle = table.entries.get(atlas.hashName("player/idle"));
+    expect(idle.page).toBe(0);
+    expect((idle.uv[2] - idle.uv[0]) * 32).toBeCloseTo(8);
+    expect((idle.uv[3] - idle.uv[1]) * 32).toBeCloseTo(8);
+
+    // The sprite is copied where the table points to
+    const page = atlas.decodePNG(fs.readFileSync(output + "_0.png"));
+    const x = Math.round(idle.uv[0] * 32);
+    const y = Math.round(idle.uv[1] * 32);
+    const pixel = page.pixels.subarray((y * 32 + x) * 4, (y * 32 + x) * 4 + 4);
+    expect([...pixel]).toStrictEqual([255, 0, 0, 255]);
+
+    fs.rmSync(folder, { recursive: true, force: true });
+  });
+});